@@ -25,6 +25,9 @@
  *
  *  pi@raspberrypi $ sudo ./SkyView
  *
+ * Voice alerts go to ALSA "default" PCM device. Use -a option to select
+ * another one, e.g. "-a null" to run without a sound card.
+ *
  */
 
 #if defined(RASPBERRY_PI)
@@ -51,6 +54,8 @@
 #include <alsa/asoundlib.h>
 #include <sndfile.h>
 #include <string.h>
+#include <dirent.h>
+#include <pthread.h>
 
 #include <iostream>
 
@@ -225,8 +230,12 @@ static void RPi_loop()
 
 }
 
+static void TTS_fini();
+
 static void RPi_fini()
 {
+  TTS_fini();
+
   fprintf( stderr, "Program termination.\n" );
   exit(EXIT_SUCCESS);
 }
@@ -446,93 +455,421 @@ static void RPi_DB_fini()
   }
 }
 
-static void play_file(snd_pcm_t *pcm_handle, char *filename, short int* buf, snd_pcm_uframes_t frames)
+/*
+ * Voice alerts engine.
+ *
+ * Clips of selected voice pack are loaded into RAM once and the PCM device
+ * stays open. Playback runs in a separate thread, main loop only puts
+ * a message into a small priority queue and never waits for the audio.
+ * A message of higher priority pre-empts the one that is being spoken.
+ */
+#define TTS_SAMPLE_RATE       22050
+#define TTS_QUEUE_SIZE        4
+#define TTS_MESSAGE_LEN       80
+#define TTS_MAX_CLIPS         64
+#define TTS_WORD_LEN          24
+
+typedef struct tts_clip_struct {
+  char          word[TTS_WORD_LEN];
+  short int     *data;
+  sf_count_t    frames;
+} tts_clip_t;
+
+typedef struct tts_message_struct {
+  bool          busy;
+  int8_t        priority;
+  unsigned long queued;       /* ms */
+  char          text[TTS_MESSAGE_LEN];
+} tts_message_t;
+
+typedef struct tts_stats_struct {
+  uint32_t      spoken;
+  uint32_t      dropped;
+  uint32_t      preempted;
+  unsigned long latency;      /* ms, last message */
+  unsigned long latency_max;  /* ms */
+} tts_stats_t;
+
+static const char *TTS_device = PCM_DEVICE;
+
+static pthread_t       tts_thread;
+static pthread_mutex_t tts_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  tts_cond    = PTHREAD_COND_INITIALIZER;
+static bool            tts_running = false;
+static bool            tts_preempt = false;
+static int8_t          tts_current = -1;
+
+static tts_message_t   tts_queue[TTS_QUEUE_SIZE];
+static tts_clip_t      tts_clips[TTS_MAX_CLIPS];
+static int             tts_clips_num = 0;
+static uint8_t         tts_voice     = VOICE_OFF;
+static tts_stats_t     tts_stats;
+
+static const char *TTS_voice_subdir(uint8_t voice)
 {
-    int pcmrc;
-    int readcount;
+  return voice == VOICE_1 ? VOICE1_SUBDIR :
+        (voice == VOICE_2 ? VOICE2_SUBDIR :
+        (voice == VOICE_3 ? VOICE3_SUBDIR :
+         "" ));
+}
 
-    SF_INFO sfinfo;
-    SNDFILE *infile = NULL;
+static void TTS_unload()
+{
+  for (int i = 0; i < tts_clips_num; i++) {
+    free(tts_clips[i].data);
+  }
+  tts_clips_num = 0;
+  tts_voice     = VOICE_OFF;
+}
 
-    infile = sf_open(filename, SFM_READ, &sfinfo);
+static void TTS_load(uint8_t voice)
+{
+  char dirname[MAX_FILENAME_LEN];
+  char filename[MAX_FILENAME_LEN];
+  size_t suffix_len = strlen(WAV_FILE_SUFFIX);
 
-    while ((readcount = sf_readf_short(infile, buf, frames))>0) {
+  TTS_unload();
 
-        pcmrc = snd_pcm_writei(pcm_handle, buf, readcount);
-        if (pcmrc == -EPIPE) {
-            fprintf(stderr, "Underrun!\n");
-            snd_pcm_prepare(pcm_handle);
-        }
-        else if (pcmrc < 0) {
-            fprintf(stderr, "Error writing to PCM device: %s\n", snd_strerror(pcmrc));
-        }
-        else if (pcmrc != readcount) {
-            fprintf(stderr,"PCM write difffers from file read.\n");
-        }
+  snprintf(dirname, sizeof(dirname), "%s%s",
+           WAV_FILE_PREFIX, TTS_voice_subdir(voice));
+
+  DIR *dir = opendir(dirname);
+  if (dir == NULL) {
+    fprintf(stderr, "Unable to open voice directory %s\n", dirname);
+    return;
+  }
+
+  struct dirent *entry;
+
+  while ((entry = readdir(dir)) != NULL && tts_clips_num < TTS_MAX_CLIPS) {
+    size_t len = strlen(entry->d_name);
+
+    if (len <= suffix_len || len - suffix_len >= TTS_WORD_LEN ||
+        strcmp(entry->d_name + len - suffix_len, WAV_FILE_SUFFIX)) {
+      continue;
+    }
+
+    snprintf(filename, sizeof(filename), "%s%s", dirname, entry->d_name);
+
+    SF_INFO sfinfo;
+    memset(&sfinfo, 0, sizeof(sfinfo));
+
+    SNDFILE *infile = sf_open(filename, SFM_READ, &sfinfo);
+    if (infile == NULL) {
+      continue;
+    }
+
+    if (sfinfo.channels != 1 || sfinfo.samplerate != TTS_SAMPLE_RATE) {
+      fprintf(stderr, "%s: unexpected format, skipped\n", filename);
+      sf_close(infile);
+      continue;
     }
 
+    tts_clip_t *clip = &tts_clips[tts_clips_num];
+
+    clip->data   = (short int *) malloc(sfinfo.frames * sizeof(short int));
+    clip->frames = clip->data == NULL ? 0 :
+                   sf_readf_short(infile, clip->data, sfinfo.frames);
     sf_close(infile);
+
+    if (clip->frames <= 0) {
+      free(clip->data);
+      continue;
+    }
+
+    memcpy(clip->word, entry->d_name, len - suffix_len);
+    clip->word[len - suffix_len] = 0;
+    tts_clips_num++;
+  }
+
+  closedir(dir);
+
+  tts_voice = voice;
 }
 
-static void RPi_TTS(char *message)
+static tts_clip_t *TTS_clip(const char *word)
+{
+  for (int i = 0; i < tts_clips_num; i++) {
+    if (!strcmp(tts_clips[i].word, word)) {
+      return &tts_clips[i];
+    }
+  }
+
+  return NULL;
+}
+
+static snd_pcm_t *TTS_PCM_open(snd_pcm_uframes_t *frames)
 {
   snd_pcm_t *pcm_handle;
   snd_pcm_hw_params_t *params;
-  snd_pcm_uframes_t frames;
-  short int* buf = NULL;
   int dir;
-  int channels = 1;
 
-  char filename[MAX_FILENAME_LEN];
+  /* Open the PCM device in playback mode */
+  if (snd_pcm_open(&pcm_handle, TTS_device, SND_PCM_STREAM_PLAYBACK, 0) < 0) {
+    fprintf(stderr, "Unable to open PCM device %s\n", TTS_device);
+    return NULL;
+  }
 
-  if (!strcmp(message, "POST")) {
-    if (hw_info.display == DISPLAY_EPD_2_7) {
-      /* keep boot-time SkyView logo on the screen for 7 seconds */
-      delay(7000);
+  /* Allocate parameters object and fill it with default values*/
+  snd_pcm_hw_params_alloca(&params);
+  snd_pcm_hw_params_any(pcm_handle, params);
+  /* Set parameters */
+  snd_pcm_hw_params_set_access(pcm_handle, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+  snd_pcm_hw_params_set_format(pcm_handle, params, SND_PCM_FORMAT_S16_LE);
+  snd_pcm_hw_params_set_channels(pcm_handle, params, 1);
+  snd_pcm_hw_params_set_rate(pcm_handle, params, TTS_SAMPLE_RATE, 0);
+
+  /* Write parameters */
+  if (snd_pcm_hw_params(pcm_handle, params) < 0) {
+    fprintf(stderr, "Unable to configure PCM device %s\n", TTS_device);
+    snd_pcm_close(pcm_handle);
+    return NULL;
+  }
+
+  /* Size of single period */
+  snd_pcm_hw_params_get_period_size(params, frames, &dir);
+
+  return pcm_handle;
+}
+
+/* called with tts_mutex held */
+static int TTS_next()
+{
+  int ndx = -1;
+
+  for (int i = 0; i < TTS_QUEUE_SIZE; i++) {
+    if (tts_queue[i].busy &&
+        (ndx < 0 ||
+         tts_queue[i].priority >  tts_queue[ndx].priority ||
+        (tts_queue[i].priority == tts_queue[ndx].priority &&
+         tts_queue[i].queued   <  tts_queue[ndx].queued))) {
+      ndx = i;
     }
-  } else if (settings->voice != VOICE_OFF) {
+  }
 
-    /* Open the PCM device in playback mode */
-    snd_pcm_open(&pcm_handle, PCM_DEVICE, SND_PCM_STREAM_PLAYBACK, 0);
+  return ndx;
+}
 
-    /* Allocate parameters object and fill it with default values*/
-    snd_pcm_hw_params_alloca(&params);
-    snd_pcm_hw_params_any(pcm_handle, params);
-    /* Set parameters */
-    snd_pcm_hw_params_set_access(pcm_handle, params, SND_PCM_ACCESS_RW_INTERLEAVED);
-    snd_pcm_hw_params_set_format(pcm_handle, params, SND_PCM_FORMAT_S16_LE);
-    snd_pcm_hw_params_set_channels(pcm_handle, params, 1);
-    snd_pcm_hw_params_set_rate(pcm_handle, params, 22050, 0);
+static bool TTS_is_preempted()
+{
+  bool rval;
 
-    /* Write parameters */
-    snd_pcm_hw_params(pcm_handle, params);
+  pthread_mutex_lock(&tts_mutex);
+  rval = tts_preempt || !tts_running;
+  pthread_mutex_unlock(&tts_mutex);
 
-    /* Allocate buffer to hold single period */
-    snd_pcm_hw_params_get_period_size(params, &frames, &dir);
+  return rval;
+}
 
-    buf = (short int *) malloc(frames * channels * sizeof(short int));
+/* returns false when the message has been pre-empted */
+static bool TTS_play(snd_pcm_t *pcm_handle, snd_pcm_uframes_t frames,
+                     tts_clip_t *clip, unsigned long queued, bool *first)
+{
+  sf_count_t offset = 0;
 
-    char *word = strtok (message, " ");
+  while (offset < clip->frames) {
+    snd_pcm_uframes_t count = clip->frames - offset;
 
-    while (word != NULL)
-    {
-        strcpy(filename, WAV_FILE_PREFIX);
-        strcat(filename,  settings->voice == VOICE_1 ? VOICE1_SUBDIR :
-                         (settings->voice == VOICE_2 ? VOICE2_SUBDIR :
-                         (settings->voice == VOICE_3 ? VOICE3_SUBDIR :
-                          "" )));
-        strcat(filename, word);
-        strcat(filename, WAV_FILE_SUFFIX);
-        play_file(pcm_handle, filename, buf, frames);
-        word = strtok (NULL, " ");
-
-        /* Poll input source(s) */
-        Input_loop();
+    if (count > frames) {
+      count = frames;
+    }
+
+    int pcmrc = snd_pcm_writei(pcm_handle, clip->data + offset, count);
+
+    if (pcmrc == -EPIPE) {
+      fprintf(stderr, "Underrun!\n");
+      snd_pcm_prepare(pcm_handle);
+      continue;
+    } else if (pcmrc < 0) {
+      fprintf(stderr, "Error writing to PCM device: %s\n", snd_strerror(pcmrc));
+      return true;
+    }
+
+    if (*first) {
+      snd_pcm_sframes_t delay = 0;
+
+      snd_pcm_delay(pcm_handle, &delay);
+      tts_stats.latency = millis() - queued +
+                          (delay > 0 ? delay * 1000 / TTS_SAMPLE_RATE : 0);
+      if (tts_stats.latency > tts_stats.latency_max) {
+        tts_stats.latency_max = tts_stats.latency;
+      }
+      *first = false;
+    }
+
+    offset += pcmrc;
+
+    if (TTS_is_preempted()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+static void *TTS_Thread(void *arg)
+{
+  snd_pcm_t *pcm_handle = NULL;
+  snd_pcm_uframes_t frames = 0;
+  tts_message_t msg;
+
+  while (true) {
+    pthread_mutex_lock(&tts_mutex);
+    int ndx = -1;
+    while (tts_running && (ndx = TTS_next()) < 0) {
+      pthread_cond_wait(&tts_cond, &tts_mutex);
+    }
+    if (!tts_running) {
+      pthread_mutex_unlock(&tts_mutex);
+      break;
+    }
+    msg = tts_queue[ndx];
+    tts_queue[ndx].busy = false;
+    tts_current = msg.priority;
+    tts_preempt = false;
+    pthread_mutex_unlock(&tts_mutex);
+
+    if (settings->voice != tts_voice) {
+      TTS_load(settings->voice);
+    }
+
+    if (pcm_handle == NULL) {
+      pcm_handle = TTS_PCM_open(&frames);
+    }
+
+    if (pcm_handle != NULL && frames > 0) {
+      bool first = true;
+      bool completed = true;
+      char *save;
+      char *word = strtok_r(msg.text, " ", &save);
+
+      while (word != NULL && completed) {
+        tts_clip_t *clip = TTS_clip(word);
+
+        if (clip != NULL) {
+          completed = TTS_play(pcm_handle, frames, clip, msg.queued, &first);
+        }
+        word = strtok_r(NULL, " ", &save);
+      }
+
+      if (completed) {
+        snd_pcm_drain(pcm_handle);
+        tts_stats.spoken++;
+      } else {
+        snd_pcm_drop(pcm_handle);
+        tts_stats.preempted++;
+      }
+      snd_pcm_prepare(pcm_handle);
     }
 
-    snd_pcm_drain(pcm_handle);
+    pthread_mutex_lock(&tts_mutex);
+    tts_current = -1;
+    pthread_mutex_unlock(&tts_mutex);
+  }
+
+  if (pcm_handle != NULL) {
+    snd_pcm_drop(pcm_handle);
     snd_pcm_close(pcm_handle);
-    free(buf);
+  }
+
+  TTS_unload();
+
+  return NULL;
+}
+
+static void TTS_setup()
+{
+  if (tts_running || settings->voice == VOICE_OFF) {
+    return;
+  }
+
+  memset(tts_queue,  0, sizeof(tts_queue));
+  memset(&tts_stats, 0, sizeof(tts_stats));
+
+  /* pre-load voice pack before the first alert */
+  TTS_load(settings->voice);
+
+  tts_running = true;
+  if (pthread_create(&tts_thread, NULL, TTS_Thread, NULL) != 0) {
+    fprintf(stderr, "Unable to start voice thread\n");
+    tts_running = false;
+    TTS_unload();
+  }
+}
+
+static void TTS_fini()
+{
+  if (!tts_running) {
+    return;
+  }
+
+  pthread_mutex_lock(&tts_mutex);
+  tts_running = false;
+  pthread_cond_signal(&tts_cond);
+  pthread_mutex_unlock(&tts_mutex);
+
+  pthread_join(tts_thread, NULL);
+
+  fprintf(stderr, "Voice alerts: %u spoken, %u pre-empted, %u dropped, "
+                  "latency %lu ms (max %lu ms)\n",
+                  tts_stats.spoken, tts_stats.preempted, tts_stats.dropped,
+                  tts_stats.latency, tts_stats.latency_max);
+}
+
+static void TTS_enqueue(const char *message, int8_t priority)
+{
+  pthread_mutex_lock(&tts_mutex);
+
+  int ndx = -1;
+
+  for (int i = 0; i < TTS_QUEUE_SIZE; i++) {
+    if (!tts_queue[i].busy) {
+      ndx = i;
+      break;
+    }
+    /* the lowest priority and the oldest one is a victim when full */
+    if (ndx < 0 ||
+        tts_queue[i].priority <  tts_queue[ndx].priority ||
+       (tts_queue[i].priority == tts_queue[ndx].priority &&
+        tts_queue[i].queued   <  tts_queue[ndx].queued)) {
+      ndx = i;
+    }
+  }
+
+  if (tts_queue[ndx].busy) {
+    tts_stats.dropped++;
+    if (tts_queue[ndx].priority > priority) {
+      pthread_mutex_unlock(&tts_mutex);
+      return;
+    }
+  }
+
+  tts_queue[ndx].busy     = true;
+  tts_queue[ndx].priority = priority;
+  tts_queue[ndx].queued   = millis();
+  strncpy(tts_queue[ndx].text, message, sizeof(tts_queue[ndx].text) - 1);
+  tts_queue[ndx].text[sizeof(tts_queue[ndx].text) - 1] = 0;
+
+  if (tts_current >= 0 && priority > tts_current) {
+    tts_preempt = true;
+  }
+
+  pthread_cond_signal(&tts_cond);
+  pthread_mutex_unlock(&tts_mutex);
+}
+
+static void RPi_TTS(char *message)
+{
+  if (!strcmp(message, "POST")) {
+    TTS_setup();
+
+    if (hw_info.display == DISPLAY_EPD_2_7) {
+      /* keep boot-time SkyView logo on the screen for 7 seconds */
+      delay(7000);
+    }
+  } else if (settings->voice != VOICE_OFF) {
+    TTS_setup();
+    TTS_enqueue(message, Traffic_Voice_AlarmLevel);
   }
 }
 
@@ -758,9 +1095,10 @@ int main(int argc, char *argv[])
   bool isSysVinit = false;
   int opt;
 
-  while ((opt = getopt(argc, argv, "b")) != -1) {
+  while ((opt = getopt(argc, argv, "ba:")) != -1) {
       switch (opt) {
       case 'b': isSysVinit = true; break;
+      case 'a': TTS_device = optarg; break;
       default: break;
       }
   }
@@ -29,6 +29,9 @@
 traffic_t ThisAircraft, Container[MAX_TRACKING_OBJECTS], fo, EmptyFO;
 traffic_by_dist_t traffic[MAX_TRACKING_OBJECTS];
 
+/* alarm level of traffic in the latest voice message */
+int8_t Traffic_Voice_AlarmLevel = 0;
+
 static unsigned long UpdateTrafficTimeMarker = 0;
 static unsigned long Traffic_Voice_TimeMarker = 0;
 
@@ -256,6 +259,7 @@ static void Traffic_Voice()
       traffic[i].fop->alert |= TRAFFIC_ALERT_VOICE;
       traffic[i].fop->timestamp = now();
 
+      Traffic_Voice_AlarmLevel = traffic[i].fop->AlarmLevel;
       SoC->TTS(message);
 
       /* Speak up of one aircraft at a time */
@@ -84,5 +84,6 @@ int  traffic_cmp_by_distance(const void *, const void *);
 
 extern traffic_t ThisAircraft, Container[MAX_TRACKING_OBJECTS], fo, EmptyFO;
 extern traffic_by_dist_t traffic[MAX_TRACKING_OBJECTS];
+extern int8_t Traffic_Voice_AlarmLevel;
 
 #endif /* TRAFFICHELPER_H */
@@ -212,6 +212,9 @@ extern PCF8563_Class *rtc;
 
 #define DEBUG_POWER 0
 
+/* frame time, bytes pushed and heap change of the radar view to Serial */
+//#define ENABLE_RADAR_STATS
+
 #define EB_S76G_1_3
 
 #if (defined(CONFIG_IDF_TARGET_ESP32S2) || defined(CONFIG_IDF_TARGET_ESP32S3)) && \
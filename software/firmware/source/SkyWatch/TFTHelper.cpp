@@ -130,6 +130,28 @@ void TFT_Clear_Screen()
   tft->fillScreen(TFT_NAVY);
 }
 
+/*
+ * The 1-bit full screen layer is shared by all the views and is kept
+ * allocated for the whole run, instead of a new heap block every frame.
+ * It is re-created only if it has been lost or the screen size differs.
+ */
+bool TFT_Layer_ready()
+{
+  if (sprite == NULL) {
+    return false;
+  }
+
+  if (sprite->created() &&
+      sprite->width()  == tft->width() &&
+      sprite->height() == tft->height()) {
+    return true;
+  }
+
+  sprite->deleteSprite();
+
+  return sprite->createSprite(tft->width(), tft->height()) != NULL;
+}
+
 byte TFT_setup()
 {
   byte rval = DISPLAY_NONE;
@@ -161,6 +183,7 @@ byte TFT_setup()
 
     sprite = new TFT_eSprite(tft);
     sprite->setColorDepth(1);
+    TFT_Layer_ready();
 
     if (hw_info.model == SOFTRF_MODEL_SKYWATCH &&
         hw_info.baro  == BARO_MODULE_NONE) {
@@ -58,6 +58,7 @@ void TFT_fini(const char *);
 void TFT_Up();
 void TFT_Down();
 void TFT_Message(const char *, const char *);
+bool TFT_Layer_ready();
 void TFT_Mode_Cycle();
 void TFT_info1();
 
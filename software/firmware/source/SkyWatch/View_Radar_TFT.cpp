@@ -42,19 +42,91 @@ enum {
 static int view_state_curr = STATE_RVIEW_NONE;
 static int view_state_prev = STATE_RVIEW_NONE;
 
-static void TFT_Draw_Radar()
+/*
+ * Static part of the radar (rings, ownship, labels) lives in the
+ * persistent 1-bit layer and is pushed to the screen only when it changes.
+ * Every frame the rows covered by previous targets are restored
+ * from the layer, then the targets are drawn on top.
+ */
+typedef struct radar_bg_struct {
+  bool     valid;
+  int      zoom;
+  uint8_t  orientation;
+  uint8_t  units;
+  int      track;
+} radar_bg_t;
+
+typedef struct radar_band_struct {
+  int16_t  y0;
+  int16_t  y1;
+} radar_band_t;
+
+/* last frame: draw time, bytes pushed to the screen, heap change */
+typedef struct radar_stats_struct {
+  uint32_t frame_us;
+  uint32_t bytes;
+  uint32_t full;      /* full redraws since setup */
+  int32_t  heap;
+} radar_stats_t;
+
+static radar_bg_t    radar_bg    = { false };
+static radar_band_t  radar_bands[MAX_TRACKING_OBJECTS];
+static int           radar_bands_num = 0;
+static radar_stats_t radar_stats = { 0 };
+
+#define RADAR_MARK_SIZE   6 /* half of target marker height, pixels */
+#define RADAR_TRACK_STEP  5 /* COG label resolution in track-up, degrees */
+
+static void TFT_Radar_Invalidate()
+{
+  radar_bg.valid  = false;
+  radar_bands_num = 0;
+}
+
+static void TFT_Radar_Push_Rows(int16_t y0, int16_t y1)
+{
+  int16_t h = y1 - y0 + 1;
+
+  sprite->pushSprite(0, y0, 0, y0, sprite->width(), h);
+  radar_stats.bytes += (uint32_t) sprite->width() * h * 2;
+}
+
+/* restore rows under previous targets, overlapping bands are merged */
+static void TFT_Radar_Restore()
+{
+  for (int i = 1; i < radar_bands_num; i++) {
+    radar_band_t b = radar_bands[i];
+    int j = i - 1;
+
+    while (j >= 0 && radar_bands[j].y0 > b.y0) {
+      radar_bands[j + 1] = radar_bands[j];
+      j--;
+    }
+    radar_bands[j + 1] = b;
+  }
+
+  int i = 0;
+
+  while (i < radar_bands_num) {
+    int16_t y0 = radar_bands[i].y0;
+    int16_t y1 = radar_bands[i].y1;
+
+    for (i++; i < radar_bands_num && radar_bands[i].y0 <= y1 + 1; i++) {
+      y1 = maxof2(y1, radar_bands[i].y1);
+    }
+    TFT_Radar_Push_Rows(y0, y1);
+  }
+
+  radar_bands_num = 0;
+}
+
+static void TFT_Radar_Background(uint16_t radius, int track)
 {
-  int16_t  tbx, tby;
   uint16_t tbw, tbh;
   uint16_t x;
   uint16_t y;
   char cog_text[6];
 
-  /* divider is a half of full scale */
-  int32_t divider = 2000; 
-
-  sprite->createSprite(tft->width(), tft->height());
-
   sprite->fillSprite(TFT_BLACK);
   sprite->setTextColor(TFT_WHITE);
 
@@ -70,43 +142,6 @@ static void TFT_Draw_Radar()
 
   uint16_t radar_center_x = radar_w / 2;
   uint16_t radar_center_y = radar_y + radar_w / 2;
-  uint16_t radius = radar_w / 2 - 1;
-
-  if (settings->m.units == UNITS_METRIC || settings->m.units == UNITS_MIXED) {
-    switch(TFT_zoom)
-    {
-    case ZOOM_LOWEST:
-      divider = 10000; /* 20 KM */
-      break;
-    case ZOOM_LOW:
-      divider =  5000; /* 10 KM */
-      break;
-    case ZOOM_HIGH:
-      divider =  1000; /*  2 KM */
-      break;
-    case ZOOM_MEDIUM:
-    default:
-      divider =  2000;  /* 4 KM */
-      break;
-    }
-  } else {
-    switch(TFT_zoom)
-    {
-    case ZOOM_LOWEST:
-      divider = 9260;  /* 10 NM */
-      break;
-    case ZOOM_LOW:
-      divider = 4630;  /*  5 NM */
-      break;
-    case ZOOM_HIGH:
-      divider =  926;  /*  1 NM */
-      break;
-    case ZOOM_MEDIUM:  /*  2 NM */
-    default:
-      divider = 1852;
-      break;
-    }
-  }
 
   sprite->drawCircle(  radar_center_x, radar_center_y,
                         radius, TFT_WHITE);
@@ -169,7 +204,7 @@ static void TFT_Draw_Radar()
     sprite->setCursor(x , y);
     sprite->print("B");
 
-    snprintf(cog_text, sizeof(cog_text), "%03d", ThisAircraft.Track);
+    snprintf(cog_text, sizeof(cog_text), "%03d", track);
     tbw = sprite->textWidth(cog_text);
     tbh = sprite->fontHeight();
     x = radar_x + (radar_w - tbw) / 2;
@@ -203,10 +238,99 @@ static void TFT_Draw_Radar()
                   TFT_zoom == ZOOM_MEDIUM ? " 2 NM" :
                   TFT_zoom == ZOOM_HIGH   ? " 1 NM" : "");
   }
+}
+
+static void TFT_Draw_Radar()
+{
+  /* divider is a half of full scale */
+  int32_t divider = 2000; 
+
+  uint32_t start_us = micros();
+  int32_t  heap     = SoC->getFreeHeap();
+
+  radar_stats.bytes = 0;
+
+  if (!TFT_Layer_ready()) {
+    return;
+  }
+
+  uint16_t radar_w = sprite->width();
+  uint16_t radar_center_x = radar_w / 2;
+  uint16_t radar_center_y = radar_w / 2;
+  uint16_t radius = radar_w / 2 - 1;
+
+  if (settings->m.units == UNITS_METRIC || settings->m.units == UNITS_MIXED) {
+    switch(TFT_zoom)
+    {
+    case ZOOM_LOWEST:
+      divider = 10000; /* 20 KM */
+      break;
+    case ZOOM_LOW:
+      divider =  5000; /* 10 KM */
+      break;
+    case ZOOM_HIGH:
+      divider =  1000; /*  2 KM */
+      break;
+    case ZOOM_MEDIUM:
+    default:
+      divider =  2000;  /* 4 KM */
+      break;
+    }
+  } else {
+    switch(TFT_zoom)
+    {
+    case ZOOM_LOWEST:
+      divider = 9260;  /* 10 NM */
+      break;
+    case ZOOM_LOW:
+      divider = 4630;  /*  5 NM */
+      break;
+    case ZOOM_HIGH:
+      divider =  926;  /*  1 NM */
+      break;
+    case ZOOM_MEDIUM:  /*  2 NM */
+    default:
+      divider = 1852;
+      break;
+    }
+  }
+
+  /*
+   * In track-up mode the background carries the COG label. The label is
+   * rounded to RADAR_TRACK_STEP so that a wandering track does not
+   * cause a full redraw on every frame.
+   */
+  int track = 0;
+
+  if (settings->m.orientation == DIRECTION_TRACK_UP) {
+    track = ((ThisAircraft.Track + RADAR_TRACK_STEP / 2) / RADAR_TRACK_STEP) *
+            RADAR_TRACK_STEP;
+    track %= 360;
+  }
 
   tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
-  sprite->pushSprite(0, 0);
-  sprite->deleteSprite();
+
+  if (!radar_bg.valid                                ||
+      radar_bg.zoom        != TFT_zoom               ||
+      radar_bg.orientation != settings->m.orientation ||
+      radar_bg.units       != settings->m.units      ||
+      radar_bg.track       != track) {
+
+    TFT_Radar_Background(radius, track);
+
+    sprite->pushSprite(0, 0);
+    radar_stats.bytes += (uint32_t) sprite->width() * sprite->height() * 2;
+    radar_stats.full++;
+
+    radar_bg.valid       = true;
+    radar_bg.zoom        = TFT_zoom;
+    radar_bg.orientation = settings->m.orientation;
+    radar_bg.units       = settings->m.units;
+    radar_bg.track       = track;
+    radar_bands_num      = 0;
+  } else {
+    TFT_Radar_Restore();
+  }
 
   for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
     if (Container[i].ID && (now() - Container[i].timestamp) <= TFT_EXPIRATION_TIME) {
@@ -252,6 +376,18 @@ static void TFT_Draw_Radar()
                       (Container[i].AlarmLevel == ALARM_LEVEL_IMPORTANT ?
                        TFT_YELLOW : TFT_GREEN);
 
+      int16_t y0 = radar_center_y - y - RADAR_MARK_SIZE;
+      int16_t y1 = radar_center_y - y + RADAR_MARK_SIZE;
+
+      if (y1 < 0 || y0 >= (int16_t) sprite->height()) {
+        continue;
+      }
+
+      radar_bands[radar_bands_num].y0 = maxof2(y0, 0);
+      radar_bands[radar_bands_num].y1 = y1 < sprite->height() ?
+                                        y1 : sprite->height() - 1;
+      radar_bands_num++;
+
       if        (Container[i].RelativeVertical >   TFT_RADAR_V_THRESHOLD) {
         tft->fillTriangle(radar_center_x + x - 4, radar_center_y - y + 3,
                           radar_center_x + x    , radar_center_y - y - 5,
@@ -269,15 +405,24 @@ static void TFT_Draw_Radar()
       }
     }
   }
+
+  radar_stats.frame_us = micros() - start_us;
+  radar_stats.heap     = (int32_t) SoC->getFreeHeap() - heap;
+
+#if defined(ENABLE_RADAR_STATS)
+  Serial.print(F("Radar: "));
+  Serial.print(radar_stats.frame_us); Serial.print(F(" us, "));
+  Serial.print(radar_stats.bytes);    Serial.print(F(" bytes, "));
+  Serial.print(radar_stats.full);     Serial.print(F(" full, heap "));
+  Serial.println(radar_stats.heap);
+#endif /* ENABLE_RADAR_STATS */
 }
 
 void TFT_radar_setup()
 {
   TFT_zoom = settings->m.zoom;
 
-  uint16_t radar_x = 0;
-  uint16_t radar_y = 0;
-  uint16_t radar_w = tft->width();
+  TFT_Radar_Invalidate();
 }
 
 void TFT_radar_loop()
@@ -324,6 +469,8 @@ void TFT_radar_loop()
     if (view_state_curr != view_state_prev) {
        TFT_Clear_Screen();
        view_state_prev = view_state_curr;
+       /* the layer may have been used by another view */
+       TFT_Radar_Invalidate();
     }
     TFT_Draw_Radar();
   }
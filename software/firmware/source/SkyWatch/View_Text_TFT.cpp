@@ -173,7 +173,9 @@ static void TFT_Draw_Text()
      Serial.println(micros()-start);
 #endif
 
-    sprite->createSprite(tft->width(), tft->height());
+    if (!TFT_Layer_ready()) {
+      return;
+    }
 
     sprite->fillSprite(TFT_BLACK);
     sprite->setTextColor(TFT_WHITE);
@@ -272,7 +274,6 @@ static void TFT_Draw_Text()
 
     tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
     sprite->pushSprite(0, 0);
-    sprite->deleteSprite();
   }
 }
 
@@ -55,7 +55,9 @@ void TFT_time_loop()
              now.hour, now.minute, now.second);
   }
 
-  sprite->createSprite(tft->width(), tft->height());
+  if (!TFT_Layer_ready()) {
+    return;
+  }
 
   sprite->fillSprite(TFT_BLACK);
   sprite->setTextColor(TFT_WHITE);
@@ -79,7 +81,6 @@ void TFT_time_loop()
 
   tft->setBitmapColor(TFT_WHITE, TFT_NAVY);
   sprite->pushSprite(0, 0);
-  sprite->deleteSprite();
 }
 
 void TFT_time_next()
@@ -70,6 +70,7 @@
 #define RELAY_SRC_PORT  (RELAY_DST_PORT - 1)
 
 #define GDL90_DST_PORT    4000
+#define GDL90_TCP_PORT    4000
 #define NMEA_UDP_PORT     10110
 #define NMEA_TCP_PORT     2000
 
@@ -112,34 +113,31 @@
 #define ENABLE_AHRS
 #endif /* PREMIUM_PACKAGE */
 
-typedef struct UFO {
-    uint8_t   raw[34];
-    time_t    timestamp;
+#if defined(RASPBERRY_PI)
+/* raw frames of targets are relayed and exported with JSON */
+#define ENABLE_UFO_RAW
+#endif /* RASPBERRY_PI */
 
-    uint8_t   protocol;
+#define UFO_RAW_SIZE      34
 
+/*
+ * Fields that the alarm, display and export loops scan every cycle
+ * come first, widest first, so that the record has no padding.
+ * The tail from 'rssi' on is seldom used and is not cleared when
+ * a table entry expires, see Traffic_Clear().
+ */
+typedef struct UFO {
+    time_t    timestamp;
     uint32_t  addr;
-    uint8_t   addr_type;
+
     float     latitude;
     float     longitude;
     float     altitude;
     float     pressure_altitude;
     float     course;     /* CoG */
     float     speed;      /* ground speed in knots */
-    uint8_t   aircraft_type;
-
     float     vs; /* feet per minute */
 
-    bool      stealth;
-    bool      no_track;
-
-    int8_t    ns[4];
-    int8_t    ew[4];
-
-    float     geoid_separation; /* metres */
-    uint16_t  hdop; /* cm */
-    int8_t    rssi; /* SX1276 only */
-
     /* 'legacy' specific data */
     float     distance;
     float     bearing;
@@ -148,10 +146,46 @@ typedef struct UFO {
     /* bitmap of issued voice/tone/ble/... alerts */
     uint8_t   alert;
 
+    uint8_t   protocol;
+    uint8_t   addr_type;
+    uint8_t   aircraft_type;
+    bool      stealth;
+    bool      no_track;
+
+    /* cold part */
+    int8_t    rssi; /* SX1276 only */
+    float     geoid_separation; /* metres */
+    uint16_t  hdop; /* cm */
+
+    int8_t    ns[4];
+    int8_t    ew[4];
+
     /* ADS-B (ES, UAT, GDL90) specific data */
     uint8_t   callsign[8];
+
+#if defined(ENABLE_UFO_RAW)
+    uint8_t   raw[UFO_RAW_SIZE];
+#endif /* ENABLE_UFO_RAW */
 } ufo_t;
 
+/*
+ * Ownship as one pass of the radio part sees it: position, validity
+ * of the fix and the GNSS time base of the slots, taken together.
+ * The PLL time base is that of Time_PLL at the moment of the view.
+ */
+typedef struct ownship_view_struct {
+    ufo_t         fo;         /* ThisAircraft, MSL altitude */
+    bool          valid;      /* isValidFix() */
+    time_t        fix_time;   /* UTC of the last GNSS time, whole seconds */
+    unsigned long time_ms;    /* millis() when the time was taken */
+    unsigned long date_ms;    /* millis() when the date (RMC) was taken */
+    unsigned long pps_ms;     /* SoC->get_PPS_TimeMarker() */
+    bool          pll_locked; /* Time_PLL_locked() */
+    uint32_t      pll_sec;    /* UTC second that begins at pll_us */
+    unsigned long pll_us;     /* micros() at start of that second */
+    int32_t       pll_period_q8; /* micros() per UTC second, Q24.8 */
+} ownship_view_t;
+
 typedef struct hardware_info {
     byte  model;
     byte  revision;
@@ -175,6 +209,8 @@ typedef struct IODev_ops_struct {
   int (*available)(void);
   int (*read)(void);
   size_t (*write)(const uint8_t *buffer, size_t size);
+  int (*availableForWrite)(void);    /* optional, room in Tx buffer */
+  struct output_queue_struct *queue; /* optional, see src/system/Output.h */
 } IODev_ops_t;
 
 typedef struct DB_ops_struct {
@@ -102,6 +102,9 @@
 #include "src/TTNHelper.h"
 #include "src/TrafficHelper.h"
 #include "src/system/Recorder.h"
+#include "src/system/Output.h"
+#include "src/system/Tasks.h"
+#include "src/system/Profiler.h"
 
 #if defined(ENABLE_AHRS)
 #include "src/driver/AHRS.h"
@@ -119,6 +122,9 @@
 
 ufo_t ThisAircraft;
 
+/* of the UI side; the radio task reads its published copy */
+static ownship_view_t Ownship;
+
 hardware_info_t hw_info = {
   .model    = DEFAULT_SOFTRF_MODEL,
   .revision = 0,
@@ -189,6 +195,9 @@ void setup()
   {
     hw_info.gnss = GNSS_setup();
     ThisAircraft.aircraft_type = settings->aircraft_type;
+#if defined(ENABLE_PROBE_CACHE)
+    Probe_Cache_update();
+#endif /* ENABLE_PROBE_CACHE */
   }
   ThisAircraft.protocol = settings->rf_protocol;
   ThisAircraft.stealth  = settings->stealth;
@@ -211,6 +220,8 @@ void setup()
      SoC->Bluetooth_ops->setup();
   }
 
+  Output_setup();
+
   OTA_setup();
   Web_setup();
   NMEA_setup();
@@ -249,12 +260,39 @@ void setup()
   SoC->post_init();
 
   SoC->WDT_setup();
+
+#if defined(ENABLE_PROFILER)
+  Profiler_setup();
+#endif /* ENABLE_PROFILER */
+
+#if defined(ENABLE_RADIO_TASK)
+  if (settings->mode == SOFTRF_MODE_NORMAL &&
+      Tasks_setup(normal_radio_pass, normal_ui_pass)) {
+    Traffic_Detach();
+  }
+#endif /* ENABLE_RADIO_TASK */
 }
 
 void loop()
 {
+#if defined(ENABLE_PROFILER)
+  Profiler_loop();
+#endif /* ENABLE_PROFILER */
+
+#if defined(ENABLE_RADIO_TASK)
+  if (Tasks_Split) {
+    Tasks_Radio_loop();
+    return;
+  }
+#endif /* ENABLE_RADIO_TASK */
+
+  /* normal_ownship() keeps the view in normal mode */
+  if (settings->mode != SOFTRF_MODE_NORMAL) {
+    GNSS_Ownship_View(&Ownship, &ThisAircraft, isValidFix());
+  }
+
   // Do common RF stuff first
-  RF_loop();
+  PROFILE(PROF_RF, RF_loop(&Ownship));
 
   switch (settings->mode)
   {
@@ -284,8 +322,15 @@ void loop()
     break;
   }
 
+  common_ui();
+
+  yield();
+}
+
+void common_ui()
+{
   // Show status info on tiny OLED display
-  SoC->Display_loop();
+  PROFILE(PROF_DISPLAY, SoC->Display_loop());
 
   // battery status LED
   LED_loop();
@@ -294,7 +339,7 @@ void loop()
   WiFi_loop();
 
   // Handle Web
-  Web_loop();
+  PROFILE(PROF_WEB, Web_loop());
 
   // Handle OTA update.
   OTA_loop();
@@ -315,17 +360,21 @@ void loop()
      SoC->UART_ops->loop();
   }
 
-  Battery_loop();
+  PROFILE(PROF_IO, Output_loop());
+
+  PROFILE(PROF_BATTERY, Battery_loop());
 
   SoC->Button_loop();
 
   Time_loop();
-
-  yield();
 }
 
 void shutdown(int reason)
 {
+#if defined(ENABLE_RADIO_TASK)
+  Tasks_fini();
+#endif /* ENABLE_RADIO_TASK */
+
   SoC->WDT_fini();
 
   SoC->swSer_enableRx(false);
@@ -365,59 +414,118 @@ void shutdown(int reason)
 
 void normal()
 {
-  bool success;
+  normal_ownship();
+  normal_radio(&Ownship);
+  normal_output();
+}
 
-  Baro_loop();
+#if defined(ENABLE_RADIO_TASK)
+/* radio task, high priority on its own core */
+void normal_radio_pass()
+{
+  /* last consistent copy is kept when UI side is halfway through an update */
+  static ownship_view_t own;
+
+  Tasks_Ownship_get(&own);
+
+  PROFILE(PROF_RF, RF_loop(&own));
+  normal_radio(&own);
+  Traffic_Publish();
+}
+
+/* UI task, the other core */
+void normal_ui_pass()
+{
+  Tasks_Dispatch();
+  Traffic_Snapshot();
+
+  normal_ownship();
+  normal_output();
+  common_ui();
+}
+#endif /* ENABLE_RADIO_TASK */
+
+void normal_ownship()
+{
+  PROFILE(PROF_BARO, Baro_loop());
 
 #if defined(ENABLE_AHRS)
   AHRS_loop();
 #endif /* ENABLE_AHRS */
 
-  GNSS_loop();
+  PROFILE(PROF_GNSS, GNSS_loop());
 
   ThisAircraft.timestamp = now();
   if (isValidFix()) {
-    ThisAircraft.latitude  = gnss.location.lat();
-    ThisAircraft.longitude = gnss.location.lng();
-    ThisAircraft.altitude  = gnss.altitude.meters();
-    ThisAircraft.course    = gnss.course.deg();
-    ThisAircraft.speed     = gnss.speed.knots();
-    ThisAircraft.hdop      = (uint16_t) gnss.hdop.value();
-    ThisAircraft.geoid_separation = gnss.separation.meters();
+    /* ThisAircraft never holds the ellipsoid height, not even for a moment */
+    ufo_t fix = ThisAircraft;
+
+#if defined(ENABLE_UBX_PVT)
+    if (!GNSS_PVT_Ownship(&fix))
+#endif /* ENABLE_UBX_PVT */
+    {
+      fix.latitude  = gnss.location.lat();
+      fix.longitude = gnss.location.lng();
+      fix.altitude  = gnss.altitude.meters();
+      fix.course    = gnss.course.deg();
+      fix.speed     = gnss.speed.knots();
+      fix.hdop      = (uint16_t) gnss.hdop.value();
+      fix.geoid_separation = gnss.separation.meters();
+    }
 
 #if !defined(EXCLUDE_EGM96)
     /*
      * When geoidal separation is zero or not available - use approx. EGM96 value
      */
-    if (ThisAircraft.geoid_separation == 0.0) {
-      ThisAircraft.geoid_separation = (float) LookupSeparation(
-                                                ThisAircraft.latitude,
-                                                ThisAircraft.longitude
-                                              );
+    if (fix.geoid_separation == 0.0) {
+      fix.geoid_separation = (float) LookupSeparation(fix.latitude,
+                                                      fix.longitude);
       /* we can assume the GPS unit is giving ellipsoid height */
-      ThisAircraft.altitude -= ThisAircraft.geoid_separation;
+      fix.altitude -= fix.geoid_separation;
     }
 #endif /* EXCLUDE_EGM96 */
 
-    RF_Transmit(RF_Encode(&ThisAircraft), true);
+    ThisAircraft = fix;
   }
 
-  success = RF_Receive();
+  GNSS_Ownship_View(&Ownship, &ThisAircraft, isValidFix());
+
+#if defined(ENABLE_RADIO_TASK)
+  /* radio task works from a copy, with or without a fix */
+  Tasks_Ownship_publish(&Ownship);
+#endif /* ENABLE_RADIO_TASK */
+}
+
+/* the whole pass works from one view of ownship, see GNSS_Ownship_View() */
+void normal_radio(ownship_view_t *own)
+{
+  bool success;
+
+  if (own->valid) {
+    PROFILE(PROF_TX, RF_Transmit(RF_Encode(&own->fo), true));
+  }
+
+  PROFILE(PROF_RX, success = RF_Receive());
 
 #if DEBUG
   success = true;
 #endif
 
-  if (success && isValidFix()) ParseData();
+  if (success && own->valid) PROFILE(PROF_PARSE, ParseData(&own->fo));
 
 #if defined(ENABLE_TTN)
   TTN_loop();
 #endif
 
-  if (isValidFix()) {
-    Traffic_loop();
+  if (own->valid) {
+    PROFILE(PROF_TRAFFIC, Traffic_loop(&own->fo));
   }
 
+  ClearExpired(&own->fo);
+}
+
+void normal_output()
+{
   if (isTimeToDisplay()) {
     if (isValidFix()) {
       LED_DisplayTraffic();
@@ -430,17 +538,17 @@ void normal()
   Sound_loop();
 
   if (isTimeToExport()) {
-    NMEA_Export();
-    GDL90_Export();
-    D1090_Export();
+    PROFILE(PROF_EXPORT, {
+      NMEA_Export();
+      GDL90_Export();
+      D1090_Export();
+    });
 
     ExportTimeMarker = millis();
   }
 
   // Handle Air Connect
-  NMEA_loop();
-
-  ClearExpired();
+  PROFILE(PROF_NMEA, NMEA_loop());
 }
 
 #if !defined(EXCLUDE_MAVLINK)
@@ -469,14 +577,14 @@ void uav()
 
   success = RF_Receive();
 
-  if (success && isValidMAVFix()) ParseData();
+  if (success && isValidMAVFix()) ParseData(&ThisAircraft);
 
   if (isTimeToExport() && isValidMAVFix()) {
     MAVLinkShareTraffic();
     ExportTimeMarker = millis();
   }
 
-  ClearExpired();
+  ClearExpired(&ThisAircraft);
 }
 #endif /* EXCLUDE_MAVLINK */
 
@@ -496,15 +604,12 @@ void bridge()
   if(success)
   {
     size_t rx_size = RF_Payload_Size(settings->rf_protocol);
-    rx_size = rx_size > sizeof(fo.raw) ? sizeof(fo.raw) : rx_size;
-
-    memset(fo.raw, 0, sizeof(fo.raw));
-    memcpy(fo.raw, RxBuffer, rx_size);
+    rx_size = rx_size > UFO_RAW_SIZE ? UFO_RAW_SIZE : rx_size;
 
     if (settings->nmea_p) {
       StdOut.print(F("$PSRFI,"));
-      StdOut.print((unsigned long) now());    StdOut.print(F(","));
-      StdOut.print(Bin2Hex(fo.raw, rx_size)); StdOut.print(F(","));
+      StdOut.print((unsigned long) now());     StdOut.print(F(","));
+      StdOut.print(Bin2Hex(RxBuffer, rx_size)); StdOut.print(F(","));
       StdOut.println(RF_last_rssi);
     }
 
@@ -527,15 +632,12 @@ void watchout()
 
   if (success) {
     size_t rx_size = RF_Payload_Size(settings->rf_protocol);
-    rx_size = rx_size > sizeof(fo.raw) ? sizeof(fo.raw) : rx_size;
-
-    memset(fo.raw, 0, sizeof(fo.raw));
-    memcpy(fo.raw, RxBuffer, rx_size);
+    rx_size = rx_size > UFO_RAW_SIZE ? UFO_RAW_SIZE : rx_size;
 
     if (settings->nmea_p) {
       StdOut.print(F("$PSRFI,"));
-      StdOut.print((unsigned long) now());    StdOut.print(F(","));
-      StdOut.print(Bin2Hex(fo.raw, rx_size)); StdOut.print(F(","));
+      StdOut.print((unsigned long) now());     StdOut.print(F(","));
+      StdOut.print(Bin2Hex(RxBuffer, rx_size)); StdOut.print(F(","));
       StdOut.println(RF_last_rssi);
     }
   }
@@ -603,7 +705,7 @@ void txrx_test()
 #if DEBUG_TIMING
   parse_start_ms = millis();
 #endif
-  if (success) ParseData();
+  if (success) ParseData(&ThisAircraft);
 #if DEBUG_TIMING
   parse_end_ms = millis();
 #endif
@@ -612,7 +714,7 @@ void txrx_test()
   TTN_loop();
 #endif
 
-  Traffic_loop();
+  Traffic_loop(&ThisAircraft);
 
 #if DEBUG_TIMING
   led_start_ms = millis();
@@ -699,7 +801,7 @@ void txrx_test()
   // Handle Air Connect
   NMEA_loop();
 
-  ClearExpired();
+  ClearExpired(&ThisAircraft);
 }
 
 #endif /* EXCLUDE_TEST_MODE */
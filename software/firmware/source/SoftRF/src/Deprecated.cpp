@@ -231,7 +231,7 @@ void rx_test_loop()
 
   success = RF_Receive();
 
-  if (success) ParseData();
+  if (success) ParseData(&ThisAircraft);
 
   if (isTimeToDisplay()) {
     LED_DisplayTraffic();
@@ -246,7 +246,7 @@ void rx_test_loop()
     ExportTimeMarker = millis();
   }
 
-  ClearExpired();
+  ClearExpired(&ThisAircraft);
 }
 #endif
 
@@ -359,7 +359,8 @@ const rfchip_ops_t s7xg_ops = {
   s7xg_channel,
   s7xg_receive,
   s7xg_transmit,
-  s7xg_shutdown
+  s7xg_shutdown,
+  NULL
 };
 #endif /* USE_S7XG_DRIVER */
 
@@ -22,13 +22,64 @@
 #include "driver/GNSS.h"
 #include "driver/Sound.h"
 #include "ui/Web.h"
+#include "system/Tasks.h"
 #include "protocol/radio/Legacy.h"
+#include "protocol/radio/FANET.h"
 
 unsigned long UpdateTrafficTimeMarker = 0;
 
 ufo_t fo, Container[MAX_TRACKING_OBJECTS], EmptyFO;
 traffic_by_dist_t traffic_by_dist[MAX_TRACKING_OBJECTS];
 
+#if defined(ENABLE_RADIO_TASK)
+/*
+ * With the radio task running, entries are kept in a table of its own.
+ * Every entry is published into a sequence locked slot, Container[] is
+ * the copy that UI side reads. See Traffic_Publish().
+ */
+typedef struct traffic_slot_struct {
+  task_seq_t  seq;
+  ufo_t       fo;
+  uint8_t     duplicates;   /* see Traffic_Fusion_Duplicates() */
+} traffic_slot_t;
+
+static ufo_t          Radio_Table[MAX_TRACKING_OBJECTS];
+static traffic_slot_t Traffic_Shared[MAX_TRACKING_OBJECTS];
+static uint32_t       Traffic_View_Seq[MAX_TRACKING_OBJECTS];
+static uint8_t        Traffic_View_Duplicates[MAX_TRACKING_OBJECTS];
+static bool           Table_dirty = false;
+
+static ufo_t *Table = Container;
+
+#define Traffic_Touch()   Table_dirty = true
+
+/*
+ * Counters of the radio side are kept apart the same way and published
+ * under a sequence lock of their own, Traffic_Snapshot() brings them
+ * into Traffic_Prefilter_Stats and Traffic_Fusion_Stats.merged.
+ */
+typedef struct traffic_stats_slot_struct {
+  task_seq_t                seq;
+  traffic_prefilter_stats_t prefilter;
+  uint32_t                  merged;
+} traffic_stats_slot_t;
+
+static traffic_prefilter_stats_t Radio_Prefilter_Stats;
+static uint32_t                  Radio_Fusion_Merged;
+static traffic_stats_slot_t      Stats_Shared;
+static uint32_t                  Stats_View_Seq;
+
+static traffic_prefilter_stats_t *Prefilter_Stats = &Traffic_Prefilter_Stats;
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+static uint32_t *Fusion_Merged = &Traffic_Fusion_Stats.merged;
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+#else
+#define Table             Container
+#define Traffic_Touch()   {}
+#define Prefilter_Stats   (&Traffic_Prefilter_Stats)
+#define Fusion_Merged     (&Traffic_Fusion_Stats.merged)
+#endif /* ENABLE_RADIO_TASK */
+
 static int8_t (*Alarm_Level)(ufo_t *, ufo_t *);
 
 /*
@@ -119,63 +170,394 @@ static int8_t Alarm_Legacy(ufo_t *this_aircraft, ufo_t *fop)
   return rval;
 }
 
-void Traffic_Update(ufo_t *fop)
+void Traffic_Update(ufo_t *this_aircraft, ufo_t *fop)
 {
-  fop->distance = gnss.distanceBetween( ThisAircraft.latitude,
-                                        ThisAircraft.longitude,
+  fop->distance = gnss.distanceBetween( this_aircraft->latitude,
+                                        this_aircraft->longitude,
                                         fop->latitude,
                                         fop->longitude);
 
-  fop->bearing  = gnss.courseTo( ThisAircraft.latitude,
-                                 ThisAircraft.longitude,
+  fop->bearing  = gnss.courseTo( this_aircraft->latitude,
+                                 this_aircraft->longitude,
                                  fop->latitude,
                                  fop->longitude);
 
   if (Alarm_Level) {
-    fop->alarm_level = (*Alarm_Level)(&ThisAircraft, fop);
+    fop->alarm_level = (*Alarm_Level)(this_aircraft, fop);
   }
 }
 
-bool Traffic_Add(ufo_t *fop)
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+/*
+ * Traffic fusion.
+ *
+ * One aircraft is often heard via several links (Legacy, OGNTP, ADS-L,
+ * 1090ES ...) and sometimes under different addresses. Every Container[]
+ * entry is a fused track that remembers its recent sources.
+ * A report is associated with a track either by one of the source
+ * addresses (with the same address type) or, for a link that does not
+ * feed the track yet, by position/velocity gating.
+ * Kinematics come from the freshest report, pressure altitude
+ * preferably from ADS-B and climb rate preferably from FLARM-like links.
+ */
+typedef struct traffic_source_struct {
+  uint32_t  addr;
+  uint8_t   addr_type;
+  uint8_t   protocol;
+  time_t    timestamp;
+} traffic_source_t;
+
+typedef struct traffic_fusion_struct {
+  uint32_t          addr;       /* identity of Container[] entry */
+  traffic_source_t  src[TRAFFIC_FUSION_SOURCES];
+  uint8_t           alt_protocol;
+  time_t            alt_time;
+  uint8_t           vs_protocol;
+  time_t            vs_time;
+} traffic_fusion_t;
+
+static traffic_fusion_t Traffic_Fusion[MAX_TRACKING_OBJECTS];
+traffic_fusion_stats_t  Traffic_Fusion_Stats;
+
+static bool Traffic_is_ADSB(uint8_t protocol)
+{
+  return protocol == RF_PROTOCOL_ADSB_1090 || protocol == RF_PROTOCOL_ADSB_UAT;
+}
+
+static bool Traffic_is_stable(uint8_t addr_type)
+{
+  return addr_type == ADDR_TYPE_ICAO || addr_type == ADDR_TYPE_FLARM;
+}
+
+static bool Traffic_Source_live(traffic_source_t *s, time_t this_moment)
+{
+  return s->addr && (this_moment - s->timestamp) <= ENTRY_EXPIRATION_TIME;
+}
+
+static traffic_fusion_t *Traffic_Fusion_Entry(int i)
+{
+  traffic_fusion_t *f = &Traffic_Fusion[i];
+
+  /* the entry has been written past the fusion (cleared, expired, ...) */
+  if (f->addr != Table[i].addr || f->src[0].addr == 0) {
+    memset(f, 0, sizeof(traffic_fusion_t));
+    f->addr             = Table[i].addr;
+    f->src[0].addr      = Table[i].addr;
+    f->src[0].addr_type = Table[i].addr_type;
+    f->src[0].protocol  = Table[i].protocol;
+    f->src[0].timestamp = Table[i].timestamp;
+    f->alt_protocol     = f->vs_protocol = Table[i].protocol;
+    f->alt_time         = f->vs_time     = Table[i].timestamp;
+  }
+
+  return f;
+}
+
+static int Traffic_Fusion_Live(int i)
+{
+  if (Table[i].addr == 0 || Traffic_Fusion[i].addr != Table[i].addr) {
+    return 0;
+  }
+
+  int count = 0;
+  time_t this_moment = now();
+
+  for (int k=0; k < TRAFFIC_FUSION_SOURCES; k++) {
+    if (Traffic_Source_live(&Traffic_Fusion[i].src[k], this_moment)) {
+      count++;
+    }
+  }
+
+  return count > 1 ? count - 1 : 0;
+}
+
+/* reports of Container[i] that fusion has saved, for the exporters */
+int Traffic_Fusion_Duplicates(int i)
+{
+#if defined(ENABLE_RADIO_TASK)
+  /* the fusion state is of the radio task, UI side reads the published count */
+  if (!Tasks_isRadio()) {
+    return Container[i].addr ? Traffic_View_Duplicates[i] : 0;
+  }
+#endif /* ENABLE_RADIO_TASK */
+
+  return Traffic_Fusion_Live(i);
+}
+
+/* kinematic consistency of a report with a track */
+static float Traffic_Gate(ufo_t *t, ufo_t *fop)
+{
+  float dt = (float) (fop->timestamp - t->timestamp);
+  if (dt < 0.0 || dt > TRAFFIC_VECTOR_UPDATE_INTERVAL) {
+    return -1.0;
+  }
+
+  float dN = (fop->latitude  - t->latitude)  * 111320.0;
+  float dE = (fop->longitude - t->longitude) * 111320.0 *
+             cosf(radians(t->latitude));
+
+  /* extrapolate the track, timestamps have 1 second resolution */
+  float v  = t->speed * _GPS_MPS_PER_KNOT;
+  dN -= v * dt * cosf(radians(t->course));
+  dE -= v * dt * sinf(radians(t->course));
+
+  float residual = sqrtf(dN * dN + dE * dE);
+  if (residual > TRAFFIC_FUSION_GATE_H + v) {
+    return -1.0;
+  }
+
+  float dAlt = (t->pressure_altitude != 0.0 && fop->pressure_altitude != 0.0) ?
+               fabs(fop->pressure_altitude - t->pressure_altitude) :
+               fabs(fop->altitude - t->altitude) / 2;
+  if (dAlt > TRAFFIC_FUSION_GATE_V) {
+    return -1.0;
+  }
+
+  if (fabs(fop->speed - t->speed) > 10.0 + 0.2 * t->speed) {
+    return -1.0;
+  }
+
+  if (t->speed > 20.0 && fop->speed > 20.0) {
+    float dCourse = fabs(fop->course - t->course);
+    if (dCourse > 180.0) {
+      dCourse = 360.0 - dCourse;
+    }
+    if (dCourse > 20.0) {
+      return -1.0;
+    }
+  }
+
+  return residual;
+}
+
+/* stealth/privacy and random addresses do not identify an aircraft */
+static bool Traffic_Addr_is_hidden(uint8_t addr_type)
+{
+  return addr_type == ADDR_TYPE_RANDOM || addr_type == ADDR_TYPE_ANONYMOUS;
+}
+
+static int Traffic_Fusion_Match(ufo_t *fop)
+{
+  time_t this_moment = now();
+  int i;
+
+  /* association by address */
+  for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    if (Table[i].addr == 0) {
+      continue;
+    }
+    if (Table[i].addr == fop->addr &&
+        Table[i].addr_type == fop->addr_type) {
+      return i;
+    }
+    if (Traffic_Fusion[i].addr != Table[i].addr) {
+      continue;
+    }
+    for (int k=0; k < TRAFFIC_FUSION_SOURCES; k++) {
+      traffic_source_t *s = &Traffic_Fusion[i].src[k];
+      if (s->addr == fop->addr && s->addr_type == fop->addr_type &&
+          Traffic_Source_live(s, this_moment)) {
+        return i;
+      }
+    }
+  }
+
+  /* association by position and velocity */
+  int   best     = -1;
+  float best_res = 0;
+
+  for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    ufo_t *t = &Table[i];
+
+    if (t->addr == 0 || (this_moment - t->timestamp) > ENTRY_EXPIRATION_TIME) {
+      continue;
+    }
+
+    /*
+     * Two known addresses that differ are two aircraft, whatever the
+     * gate says. Only a random or anonymous side may be joined by position.
+     */
+    if (!Traffic_Addr_is_hidden(t->addr_type) &&
+        !Traffic_Addr_is_hidden(fop->addr_type)) {
+      continue;
+    }
+
+    /* a link that already feeds the track reports another aircraft */
+    traffic_fusion_t *f = Traffic_Fusion_Entry(i);
+    bool same_link = false;
+
+    for (int k=0; k < TRAFFIC_FUSION_SOURCES; k++) {
+      if (f->src[k].protocol == fop->protocol &&
+          Traffic_Source_live(&f->src[k], this_moment)) {
+        same_link = true;
+        break;
+      }
+    }
+    if (same_link) {
+      continue;
+    }
+
+    float res = Traffic_Gate(t, fop);
+    if (res >= 0.0 && (best < 0 || res < best_res)) {
+      best     = i;
+      best_res = res;
+    }
+  }
+
+  return best;
+}
+
+static void Traffic_Fusion_Merge(int i, ufo_t *fop)
+{
+  traffic_fusion_t *f = Traffic_Fusion_Entry(i);
+  ufo_t *t = &Table[i];
+  ufo_t prev = *t;
+  time_t this_moment = now();
+  int k, slot = -1;
+
+  for (k=0; k < TRAFFIC_FUSION_SOURCES; k++) {
+    traffic_source_t *s = &f->src[k];
+
+    if (s->addr == fop->addr && s->addr_type == fop->addr_type &&
+        s->protocol == fop->protocol) {
+      slot = k;
+      break;
+    }
+    if (slot < 0 && !Traffic_Source_live(s, this_moment)) {
+      slot = k;
+    }
+  }
+
+  bool other = false;
+
+  for (k=0; k < TRAFFIC_FUSION_SOURCES; k++) {
+    if (k != slot && Traffic_Source_live(&f->src[k], this_moment)) {
+      other = true;
+    }
+  }
+  if (other) {
+    (*Fusion_Merged)++;
+  }
+
+  if (slot >= 0) {
+    f->src[slot].addr      = fop->addr;
+    f->src[slot].addr_type = fop->addr_type;
+    f->src[slot].protocol  = fop->protocol;
+    f->src[slot].timestamp = fop->timestamp;
+  }
+
+  /* kinematics from the freshest report */
+  *t = *fop;
+  t->alert = prev.alert;
+
+  if (!other) {
+    f->addr         = t->addr;
+    f->alt_protocol = f->vs_protocol = fop->protocol;
+    f->alt_time     = f->vs_time     = fop->timestamp;
+    return;
+  }
+
+  /* keep identity of the track, unless only a random one is known yet */
+  if (Traffic_is_stable(prev.addr_type) || !Traffic_is_stable(fop->addr_type)) {
+    t->addr      = prev.addr;
+    t->addr_type = prev.addr_type;
+    t->protocol  = prev.protocol;
+  }
+  f->addr = t->addr;
+
+  /* pressure altitude: ADS-B has priority */
+  if (Traffic_is_ADSB(f->alt_protocol) && !Traffic_is_ADSB(fop->protocol) &&
+      fop->timestamp - f->alt_time <= TRAFFIC_VECTOR_UPDATE_INTERVAL &&
+      prev.pressure_altitude != 0.0) {
+    t->pressure_altitude = prev.pressure_altitude;
+  } else if (fop->pressure_altitude != 0.0) {
+    f->alt_protocol = fop->protocol;
+    f->alt_time     = fop->timestamp;
+  } else {
+    t->pressure_altitude = prev.pressure_altitude;
+  }
+
+  /* climb rate: FLARM-like links have finer resolution than ADS-B */
+  if (!Traffic_is_ADSB(f->vs_protocol) && Traffic_is_ADSB(fop->protocol) &&
+      fop->timestamp - f->vs_time <= TRAFFIC_VECTOR_UPDATE_INTERVAL) {
+    t->vs = prev.vs;
+  } else {
+    f->vs_protocol = fop->protocol;
+    f->vs_time     = fop->timestamp;
+  }
+
+  /* 1090ES does not tell a glider from a jet */
+  if (Traffic_is_ADSB(fop->protocol) && !Traffic_is_ADSB(prev.protocol) &&
+      prev.aircraft_type != AIRCRAFT_TYPE_UNKNOWN) {
+    t->aircraft_type = prev.aircraft_type;
+  }
+
+  if (t->callsign[0] == 0) {
+    memcpy(t->callsign, prev.callsign, sizeof(t->callsign));
+  }
+
+  /* privacy flags of any source are honoured */
+  t->stealth  = t->stealth  || prev.stealth;
+  t->no_track = t->no_track || prev.no_track;
+}
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+
+static void Traffic_Assign(int i, ufo_t *fop)
+{
+  Table[i] = *fop;
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+  Traffic_Fusion[i].addr = 0;
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+}
+
+static bool Traffic_Insert(ufo_t *fop)
 {
   int i;
 
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+  i = Traffic_Fusion_Match(fop);
+  if (i >= 0) {
+    Traffic_Fusion_Merge(i, fop);
+    return true;
+  }
+#else
   for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
-    if (Container[i].addr == fo.addr) {
-      uint8_t alert_bak = Container[i].alert;
-      Container[i] = fo;
-      Container[i].alert = alert_bak;
+    if (Table[i].addr == fop->addr) {
+      uint8_t alert_bak = Table[i].alert;
+      Table[i] = *fop;
+      Table[i].alert = alert_bak;
       return true;
     }
   }
+#endif /* EXCLUDE_TRAFFIC_FUSION */
 
   int max_dist_ndx = 0;
   int min_level_ndx = 0;
 
   for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
-    if (now() - Container[i].timestamp > ENTRY_EXPIRATION_TIME) {
-      Container[i] = fo;
+    if (now() - Table[i].timestamp > ENTRY_EXPIRATION_TIME) {
+      Traffic_Assign(i, fop);
       return true;
     }
 #if !defined(EXCLUDE_TRAFFIC_FILTER_EXTENSION)
-    if  (Container[i].distance > Container[max_dist_ndx].distance)  {
+    if  (Table[i].distance > Table[max_dist_ndx].distance)  {
       max_dist_ndx = i;
     }
-    if  (Container[i].alarm_level < Container[min_level_ndx].alarm_level)  {
+    if  (Table[i].alarm_level < Table[min_level_ndx].alarm_level)  {
       min_level_ndx = i;
     }
 #endif /* EXCLUDE_TRAFFIC_FILTER_EXTENSION */
   }
 
 #if !defined(EXCLUDE_TRAFFIC_FILTER_EXTENSION)
-  if (fo.alarm_level > Container[min_level_ndx].alarm_level) {
-    Container[min_level_ndx] = fo;
+  if (fop->alarm_level > Table[min_level_ndx].alarm_level) {
+    Traffic_Assign(min_level_ndx, fop);
     return true;
   }
 
-  if (fo.distance    <  Container[max_dist_ndx].distance &&
-      fo.alarm_level >= Container[max_dist_ndx].alarm_level) {
-    Container[max_dist_ndx] = fo;
+  if (fop->distance    <  Table[max_dist_ndx].distance &&
+      fop->alarm_level >= Table[max_dist_ndx].alarm_level) {
+    Traffic_Assign(max_dist_ndx, fop);
     return true;
   }
 #endif /* EXCLUDE_TRAFFIC_FILTER_EXTENSION */
@@ -183,22 +565,197 @@ bool Traffic_Add(ufo_t *fop)
   return false;
 }
 
-void ParseData()
+bool Traffic_Add(ufo_t *fop)
+{
+#if defined(ENABLE_RADIO_TASK)
+  /* inputs of UI side reach the table through the radio task */
+  if (!Tasks_isRadio()) {
+    return Tasks_Queue_put(&Tasks_Inject_Queue, fop);
+  }
+#endif /* ENABLE_RADIO_TASK */
+
+  if (!Traffic_Insert(fop)) {
+    return false;
+  }
+
+  Traffic_Touch();
+
+  return true;
+}
+
+/* reject what a damaged frame may decode into */
+static bool Traffic_is_sane(ufo_t *fop)
 {
-    size_t rx_size = RF_Payload_Size(settings->rf_protocol);
-    rx_size = rx_size > sizeof(fo.raw) ? sizeof(fo.raw) : rx_size;
+  return fop->latitude  >=  -90.0 && fop->latitude  <=  90.0 &&
+         fop->longitude >= -180.0 && fop->longitude <= 180.0 &&
+         !isnan(fop->altitude) && !isnan(fop->course) &&
+         !isnan(fop->speed)    && !isnan(fop->vs);
+}
+
+/*
+ * Coarse prefilter, ahead of the full decode (XXTEA of Legacy, ...).
+ *
+ * With all the entries live, Traffic_Add() takes a new aircraft only
+ * when it raises an alarm or is closer than the farthest entry.
+ * Formats that carry the address in clear (Legacy) or also the position
+ * (FANET) are peeked at first:
+ *  - known address or a free entry - always decode;
+ *  - position out of reach of the alarms and beyond the farthest
+ *    entry - reject;
+ *  - address that has been decoded and dropped a moment ago - reject
+ *    for TRAFFIC_PREFILTER_DEFER seconds.
+ */
+typedef struct traffic_deferred_struct {
+  uint32_t  addr;
+  time_t    timestamp;
+} traffic_deferred_t;
+
+static traffic_deferred_t Traffic_Deferred[TRAFFIC_PREFILTER_DEFERRED];
+traffic_prefilter_stats_t Traffic_Prefilter_Stats;
+
+static bool Traffic_Peek(ufo_t *this_aircraft, ufo_t *fop)
+{
+  switch (RF_rx_protocol)
+  {
+  case RF_PROTOCOL_LEGACY:
+    return legacy_peek((void *) RxBuffer, this_aircraft, fop);
+  case RF_PROTOCOL_FANET:
+    return fanet_peek((void *) RxBuffer, this_aircraft, fop);
+  default:
+    return false;
+  }
+}
+
+static bool Traffic_Out_Of_Reach(ufo_t *this_aircraft, ufo_t *fop)
+{
+  float reach = ALARM_ZONE_NONE; /* time based alarms */
+
+  if (Alarm_Level == NULL || Alarm_Level == &Alarm_None) {
+    reach = 0;
+  } else if (Alarm_Level == &Alarm_Distance) {
+    reach = ALARM_ZONE_LOW;
+  }
+
+  return fop->distance > reach + TRAFFIC_PREFILTER_MARGIN_H ||
+         fabs(fop->altitude - this_aircraft->altitude) >
+           VERTICAL_SEPARATION + TRAFFIC_PREFILTER_MARGIN_V;
+}
+
+static bool Traffic_Prefilter(ufo_t *this_aircraft, ufo_t *peek)
+{
+  time_t this_moment = now();
+  int i, far_ndx = 0;
+
+  peek->addr = 0;
+  bool position = Traffic_Peek(this_aircraft, peek);
+
+  if (peek->addr == 0) {
+    return true;
+  }
+  Prefilter_Stats->peeked++;
+
+  for (i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    ufo_t *t = &Table[i];
+
+    if (this_moment - t->timestamp > ENTRY_EXPIRATION_TIME ||
+        t->addr == peek->addr) {
+      return true;
+    }
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+    if (Traffic_Fusion[i].addr == t->addr) {
+      for (int k=0; k < TRAFFIC_FUSION_SOURCES; k++) {
+        if (Traffic_Fusion[i].src[k].addr == peek->addr) {
+          return true;
+        }
+      }
+    }
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+    if (t->distance > Table[far_ndx].distance) {
+      far_ndx = i;
+    }
+  }
+
+#if defined(EXCLUDE_TRAFFIC_FILTER_EXTENSION)
+  Prefilter_Stats->full++;
+  return false;
+#else
+  if (position) {
+    float dLon = peek->longitude - this_aircraft->longitude;
+
+    if (dLon > 180.0) {
+      dLon -= 360.0;
+    } else if (dLon < -180.0) {
+      dLon += 360.0;
+    }
+
+    float dN = (peek->latitude - this_aircraft->latitude) * 111320.0;
+    float dE = dLon * 111320.0 * cosf(radians(this_aircraft->latitude));
+
+    peek->distance = sqrtf(dN * dN + dE * dE);
+
+    if (Traffic_Out_Of_Reach(this_aircraft, peek) &&
+        (peek->distance > Table[far_ndx].distance + TRAFFIC_PREFILTER_MARGIN_H ||
+         Table[far_ndx].alarm_level > ALARM_LEVEL_NONE)) {
+      Prefilter_Stats->range++;
+      return false;
+    }
+
+    return true;
+  }
+
+  for (i=0; i < TRAFFIC_PREFILTER_DEFERRED; i++) {
+    if (Traffic_Deferred[i].addr == peek->addr &&
+        this_moment - Traffic_Deferred[i].timestamp < TRAFFIC_PREFILTER_DEFER) {
+      Prefilter_Stats->deferred++;
+      return false;
+    }
+  }
+
+  return true;
+#endif /* EXCLUDE_TRAFFIC_FILTER_EXTENSION */
+}
+
+/* remember an address that was dropped by Traffic_Add() far from alarms */
+static void Traffic_Defer(ufo_t *this_aircraft, ufo_t *fop)
+{
+  int i, oldest = 0;
+
+  if (!Traffic_Out_Of_Reach(this_aircraft, fop)) {
+    return;
+  }
+
+  for (i=0; i < TRAFFIC_PREFILTER_DEFERRED; i++) {
+    if (Traffic_Deferred[i].addr == fop->addr) {
+      oldest = i;
+      break;
+    }
+    if (Traffic_Deferred[i].timestamp < Traffic_Deferred[oldest].timestamp) {
+      oldest = i;
+    }
+  }
+
+  Traffic_Deferred[oldest].addr      = fop->addr;
+  Traffic_Deferred[oldest].timestamp = now();
+}
+
+void ParseData(ufo_t *this_aircraft)
+{
+    size_t rx_size = RF_rx_size;
+    rx_size = rx_size > UFO_RAW_SIZE ? UFO_RAW_SIZE : rx_size;
 
 #if DEBUG
     Hex2Bin(TxDataTemplate, RxBuffer);
 #endif
 
+#if defined(ENABLE_UFO_RAW)
     memset(fo.raw, 0, sizeof(fo.raw));
     memcpy(fo.raw, RxBuffer, rx_size);
+#endif /* ENABLE_UFO_RAW */
 
     if (settings->nmea_p) {
       StdOut.print(F("$PSRFI,"));
       StdOut.print((unsigned long) now()); StdOut.print(F(","));
-      StdOut.print(Bin2Hex(fo.raw, rx_size)); StdOut.print(F(","));
+      StdOut.print(Bin2Hex(RxBuffer, rx_size)); StdOut.print(F(","));
       StdOut.println(RF_last_rssi);
     }
 
@@ -211,10 +768,27 @@ void ParseData()
       return;
     }
 
-    if (protocol_decode && (*protocol_decode)((void *) RxBuffer, &ThisAircraft, &fo)) {
+    ufo_t peek;
+
+    if (!Traffic_Prefilter(this_aircraft, &peek)) {
+      return;
+    }
+
+    if (protocol_decode && (*protocol_decode)((void *) RxBuffer, this_aircraft, &fo) &&
+        Traffic_is_sane(&fo)) {
+#if defined(ENABLE_MULTI_RX)
+      RF_Rx_Stats[RF_rx_protocol].decoded++;
+#endif /* ENABLE_MULTI_RX */
       fo.rssi = RF_last_rssi;
-      Traffic_Update(&fo);
-      Traffic_Add(&fo);
+      Traffic_Update(this_aircraft, &fo);
+      if (!Traffic_Add(&fo)) {
+        Prefilter_Stats->dropped++;
+        if (peek.addr) {
+          Traffic_Defer(this_aircraft, &fo);
+        }
+      }
+    } else {
+      Prefilter_Stats->undecoded++;
     }
 }
 
@@ -238,37 +812,156 @@ void Traffic_setup()
   }
 }
 
-void Traffic_loop()
+void Traffic_loop(ufo_t *this_aircraft)
 {
   if (isTimeToUpdateTraffic()) {
     for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
 
-      if (Container[i].addr &&
-          (ThisAircraft.timestamp - Container[i].timestamp) <= ENTRY_EXPIRATION_TIME) {
-        if ((ThisAircraft.timestamp - Container[i].timestamp) >= TRAFFIC_VECTOR_UPDATE_INTERVAL) {
-          Traffic_Update(&Container[i]);
+      if (Table[i].addr &&
+          (this_aircraft->timestamp - Table[i].timestamp) <= ENTRY_EXPIRATION_TIME) {
+        if ((this_aircraft->timestamp - Table[i].timestamp) >= TRAFFIC_VECTOR_UPDATE_INTERVAL) {
+          Traffic_Update(this_aircraft, &Table[i]);
         }
-        if ((Container[i].alert & TRAFFIC_ALERT_SOUND) == 0) {
+        if ((Table[i].alert & TRAFFIC_ALERT_SOUND) == 0) {
+#if defined(ENABLE_RADIO_TASK)
+          Tasks_Notify(TASK_EV_SOUND);
+#else
           Sound_Notify();
-          Container[i].alert |= TRAFFIC_ALERT_SOUND;
+#endif /* ENABLE_RADIO_TASK */
+          Table[i].alert |= TRAFFIC_ALERT_SOUND;
         }
       } else {
-        Container[i] = EmptyFO;
+        Traffic_Clear(&Table[i]);
       }
     }
 
     UpdateTrafficTimeMarker = millis();
+    Traffic_Touch();
   }
 }
 
-void ClearExpired()
+void ClearExpired(ufo_t *this_aircraft)
 {
   for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-    if (Container[i].addr && (ThisAircraft.timestamp - Container[i].timestamp) > ENTRY_EXPIRATION_TIME) {
-      Container[i] = EmptyFO;
+    if (Table[i].addr && (this_aircraft->timestamp - Table[i].timestamp) > ENTRY_EXPIRATION_TIME) {
+      Traffic_Clear(&Table[i]);
+      Traffic_Touch();
+    }
+  }
+}
+
+#if defined(ENABLE_RADIO_TASK)
+/* the radio task keeps the entries to itself from now on */
+void Traffic_Detach()
+{
+  memcpy(Radio_Table, Container, sizeof(Radio_Table));
+  Table = Radio_Table;
+
+  Radio_Prefilter_Stats = Traffic_Prefilter_Stats;
+  Prefilter_Stats       = &Radio_Prefilter_Stats;
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+  Radio_Fusion_Merged   = Traffic_Fusion_Stats.merged;
+  Fusion_Merged         = &Radio_Fusion_Merged;
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+}
+
+/*
+ * Radio side, once a pass. Only the entries that have changed
+ * are written, the radio task never waits for a reader.
+ */
+void Traffic_Publish()
+{
+  ufo_t inject;
+
+  while (Tasks_Queue_get(&Tasks_Inject_Queue, &inject)) {
+    Traffic_Add(&inject);
+  }
+
+  if (Stats_Shared.merged != Radio_Fusion_Merged ||
+      memcmp(&Stats_Shared.prefilter, &Radio_Prefilter_Stats,
+             sizeof(traffic_prefilter_stats_t)) != 0) {
+    Tasks_Seq_write_begin(&Stats_Shared.seq);
+    Stats_Shared.prefilter = Radio_Prefilter_Stats;
+    Stats_Shared.merged    = Radio_Fusion_Merged;
+    Tasks_Seq_write_end(&Stats_Shared.seq);
+  }
+
+  if (!Table_dirty) {
+    return;
+  }
+
+  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    traffic_slot_t *slot = &Traffic_Shared[i];
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+    uint8_t duplicates = Traffic_Fusion_Live(i);
+#else
+    uint8_t duplicates = 0;
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+
+    if (slot->duplicates == duplicates &&
+        memcmp(&slot->fo, &Radio_Table[i], sizeof(ufo_t)) == 0) {
+      continue;
+    }
+
+    Tasks_Seq_write_begin(&slot->seq);
+    slot->fo         = Radio_Table[i];
+    slot->duplicates = duplicates;
+    Tasks_Seq_write_end(&slot->seq);
+  }
+
+  Table_dirty = false;
+}
+
+/*
+ * UI side, once a pass: Container[] does not change in between.
+ * An entry caught in the middle of an update keeps its previous
+ * contents until the next pass.
+ */
+void Traffic_Snapshot()
+{
+  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    traffic_slot_t *slot = &Traffic_Shared[i];
+
+    for (int n = 0; n < TASKS_SEQ_TRIES; n++) {
+      uint32_t count = Tasks_Seq_read_begin(&slot->seq);
+
+      if (count == Traffic_View_Seq[i]) {
+        break;
+      }
+
+      ufo_t   copy       = slot->fo;
+      uint8_t duplicates = slot->duplicates;
+
+      if (Tasks_Seq_read_valid(&slot->seq, count)) {
+        Container[i]               = copy;
+        Traffic_View_Duplicates[i] = duplicates;
+        Traffic_View_Seq[i]        = count;
+        break;
+      }
+    }
+  }
+
+  for (int n = 0; n < TASKS_SEQ_TRIES; n++) {
+    uint32_t count = Tasks_Seq_read_begin(&Stats_Shared.seq);
+
+    if (count == Stats_View_Seq) {
+      break;
+    }
+
+    traffic_prefilter_stats_t prefilter = Stats_Shared.prefilter;
+    uint32_t                  merged    = Stats_Shared.merged;
+
+    if (Tasks_Seq_read_valid(&Stats_Shared.seq, count)) {
+      Traffic_Prefilter_Stats     = prefilter;
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+      Traffic_Fusion_Stats.merged = merged;
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+      Stats_View_Seq              = count;
+      break;
     }
   }
 }
+#endif /* ENABLE_RADIO_TASK */
 
 int Traffic_Count()
 {
@@ -50,16 +50,64 @@ enum
 
 #define TRAFFIC_ALERT_SOUND   1
 
-void ParseData(void);
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+#define TRAFFIC_FUSION_SOURCES  3   /* links remembered per track */
+#define TRAFFIC_FUSION_GATE_H   100 /* metres, plus 1 second of motion */
+#define TRAFFIC_FUSION_GATE_V   60  /* metres */
+
+typedef struct traffic_fusion_stats_struct {
+  uint32_t  merged;       /* reports folded into a track of another link */
+  uint32_t  nmea_saved;   /* bytes of PFLAA not sent for duplicates */
+  uint32_t  gdl90_saved;  /* bytes of GDL90 traffic reports, same */
+} traffic_fusion_stats_t;
+
+/* with the radio task, 'merged' is of the last Traffic_Snapshot() */
+extern traffic_fusion_stats_t Traffic_Fusion_Stats;
+
+int  Traffic_Fusion_Duplicates(int);
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+
+#define TRAFFIC_PREFILTER_MARGIN_H  500 /* metres, coarse position and 2 s of closure */
+#define TRAFFIC_PREFILTER_MARGIN_V  100 /* metres */
+#define TRAFFIC_PREFILTER_DEFER     TRAFFIC_VECTOR_UPDATE_INTERVAL /* seconds */
+#define TRAFFIC_PREFILTER_DEFERRED  8   /* addresses remembered */
+
+typedef struct traffic_prefilter_stats_struct {
+  uint32_t  peeked;     /* frames with address known ahead of the decode */
+  uint32_t  full;       /* rejected, table is full and can not evict */
+  uint32_t  range;      /* rejected by coarse position */
+  uint32_t  deferred;   /* rejected, same address was dropped recently */
+  uint32_t  undecoded;  /* failed the decode or sanity check */
+  uint32_t  dropped;    /* decoded, then not taken by the table */
+} traffic_prefilter_stats_t;
+
+/* with the radio task, a copy of the last Traffic_Snapshot() */
+extern traffic_prefilter_stats_t Traffic_Prefilter_Stats;
+
+void ParseData(ufo_t *);
 void Traffic_setup(void);
-void Traffic_loop(void);
-void ClearExpired(void);
-void Traffic_Update(ufo_t *);
+void Traffic_loop(ufo_t *);
+void ClearExpired(ufo_t *);
+void Traffic_Update(ufo_t *, ufo_t *);
 bool Traffic_Add(ufo_t *);
 int  Traffic_Count(void);
 
+#if defined(ENABLE_RADIO_TASK)
+void Traffic_Detach(void);
+void Traffic_Publish(void);
+void Traffic_Snapshot(void);
+#endif /* ENABLE_RADIO_TASK */
+
 int  traffic_cmp_by_distance(const void *, const void *);
 
+#if defined(ENABLE_UFO_RAW)
+/* relay takes a non-empty raw frame for a live entry */
+#define Traffic_Clear(fop)    (*(fop) = EmptyFO)
+#else
+/* expired entry: only the part that loops look at */
+#define Traffic_Clear(fop)    memset((fop), 0, offsetof(ufo_t, rssi))
+#endif /* ENABLE_UFO_RAW */
+
 extern ufo_t fo, Container[MAX_TRACKING_OBJECTS], EmptyFO;
 extern traffic_by_dist_t traffic_by_dist[MAX_TRACKING_OBJECTS];
 
@@ -19,6 +19,76 @@
 #include "../system/SoC.h"
 
 #include "Baro.h"
+#include "GNSS.h"
+#include "EEPROM.h"
+
+/*
+ * Vertical speed estimator.
+ *
+ * Steady state Kalman (alpha-beta) filter of constant vertical speed model
+ * in fixed point arithmetic. Gains are tuned for 3 Hz sampling rate and
+ * ~0.25 m of baro altitude noise: it lags no more than the former mean of
+ * three differences (one sample, 1/3 s) with about 2/3 of its noise.
+ * It does not depend on a sensor driver and is built on every target.
+ */
+#define VARIO_ALPHA_Q16   26214 /* 0.40 */
+#define VARIO_BETA_Q16    16384 /* 0.25 */
+#define VARIO_GNSS_SHIFT  3     /* GNSS vertical velocity blend, 1/8 */
+#define VARIO_MAX_GAP_MS  2000
+
+typedef struct Baro_vario_struct {
+  int32_t       h_mm;     /* altitude, mm */
+  int32_t       v_q8;     /* vertical speed, mm/s Q24.8 */
+  unsigned long gnss_ms;  /* last GNSS velocity taken in */
+} Baro_vario_t;
+
+static Baro_vario_t Baro_vario;
+
+void Baro_vario_reset(float altitude)
+{
+  Baro_vario.h_mm    = (int32_t) (altitude * 1000);
+  Baro_vario.v_q8    = 0;
+  Baro_vario.gnss_ms = 0;
+}
+
+void Baro_vario_step(float altitude, unsigned long dt_ms)
+{
+  int32_t z_mm = (int32_t) (altitude * 1000);
+
+  if (dt_ms == 0) {
+    return;
+  }
+  if (dt_ms > VARIO_MAX_GAP_MS) {
+    Baro_vario_reset(altitude);
+    return;
+  }
+
+  /* predict */
+  Baro_vario.h_mm += (int32_t) (((int64_t) Baro_vario.v_q8 * (int64_t) dt_ms) / (1000L << 8));
+
+  /* correct */
+  int32_t r = z_mm - Baro_vario.h_mm;
+
+  Baro_vario.h_mm += (int32_t) (((int64_t) r * VARIO_ALPHA_Q16) >> 16);
+  Baro_vario.v_q8 += (int32_t) (((int64_t) r * VARIO_BETA_Q16 * 1000) /
+                                ((int64_t) dt_ms << 8));
+
+#if defined(ENABLE_UBX_PVT)
+  /* native GNSS vertical velocity pulls slow baro drift out */
+  if (GNSS_PVT_valid() && GNSS_PVT.time_ms != Baro_vario.gnss_ms) {
+    int32_t vg_q8 = -GNSS_PVT.velD * 256;
+
+    Baro_vario.v_q8   += (vg_q8 - Baro_vario.v_q8) >> VARIO_GNSS_SHIFT;
+    Baro_vario.gnss_ms = GNSS_PVT.time_ms;
+  }
+#endif /* ENABLE_UBX_PVT */
+}
+
+/* vertical speed estimate, feet per minute */
+float Baro_vario_fpm()
+{
+  return Baro_vario.v_q8 * (_GPS_FEET_PER_METER * 60.0 / (1000.0 * 256));
+}
 
 #if defined(EXCLUDE_BMP180) && defined(EXCLUDE_BMP280)    && \
     defined(EXCLUDE_BME680) && defined(EXCLUDE_BME280AUX) && \
@@ -73,10 +143,6 @@ static float Baro_temperature_cache         = 0;
 
 static unsigned long BaroAltitudeTimeMarker = 0;
 static unsigned long BaroPresTempTimeMarker = 0;
-static float prev_pressure_altitude         = 0;
-
-static float Baro_VS[VS_AVERAGING_FACTOR];
-static int avg_ndx = 0;
 
 #if !defined(EXCLUDE_BMP180)
 static bool bmp180_probe()
@@ -419,44 +485,95 @@ barochip_ops_t mpl3115a2_ops = {
 };
 #endif /* EXCLUDE_MPL3115A2 */
 
+#if defined(ENABLE_PROBE_CACHE)
+/* sensor of last boot, that Baro_probe() does not try again */
+static barochip_ops_t *baro_cached = NULL;
+
+#define BARO_PROBE(ops)   (baro_chip = &ops, \
+                           baro_chip != baro_cached && baro_chip->probe())
+#else
+#define BARO_PROBE(ops)   (baro_chip = &ops, baro_chip->probe())
+#endif /* ENABLE_PROBE_CACHE */
+
 bool Baro_probe()
 {
   return (
 #if !defined(EXCLUDE_BMP180)
-           (baro_chip = &bmp180_ops,    baro_chip->probe()) ||
+           BARO_PROBE(bmp180_ops)                           ||
 #else
            false                                            ||
 #endif /* EXCLUDE_BMP180 */
 
 #if !defined(EXCLUDE_BMP280)
-           (baro_chip = &bmp280_ops,    baro_chip->probe()) ||
+           BARO_PROBE(bmp280_ops)                           ||
 #else
            false                                            ||
 #endif /* EXCLUDE_BMP280 */
 
 #if !defined(EXCLUDE_BME680)
-           (baro_chip = &bme680_ops,    baro_chip->probe()) ||
+           BARO_PROBE(bme680_ops)                           ||
 #else
            false                                            ||
 #endif /* EXCLUDE_BME680 */
 
 #if !defined(EXCLUDE_BME280AUX)
-           (baro_chip = &bme280aux_ops, baro_chip->probe()) ||
+           BARO_PROBE(bme280aux_ops)                        ||
 #else
            false                                            ||
 #endif /* EXCLUDE_BME280AUX */
 
 #if !defined(EXCLUDE_MPL3115A2)
-           (baro_chip = &mpl3115a2_ops, baro_chip->probe())
+           BARO_PROBE(mpl3115a2_ops)
 #else
            false
 #endif /* EXCLUDE_MPL3115A2 */
          );
 }
 
+#if defined(ENABLE_PROBE_CACHE)
+/*
+ * The sensor found on last boot gets probed first, and only once:
+ * a stale record costs no probe that Baro_probe() does not run.
+ */
+static bool Baro_probe_cached()
+{
+  switch (probe_cache->baro)
+  {
+#if !defined(EXCLUDE_BMP180)
+  case BARO_MODULE_BMP180:    baro_chip = &bmp180_ops;    break;
+#endif /* EXCLUDE_BMP180 */
+#if !defined(EXCLUDE_BMP280)
+  case BARO_MODULE_BMP280:    baro_chip = &bmp280_ops;    break;
+#endif /* EXCLUDE_BMP280 */
+#if !defined(EXCLUDE_BME680)
+  case BARO_MODULE_BME680:    baro_chip = &bme680_ops;    break;
+#endif /* EXCLUDE_BME680 */
+#if !defined(EXCLUDE_BME280AUX)
+  case BARO_MODULE_BME280AUX: baro_chip = &bme280aux_ops; break;
+#endif /* EXCLUDE_BME280AUX */
+#if !defined(EXCLUDE_MPL3115A2)
+  case BARO_MODULE_MPL3115A2: baro_chip = &mpl3115a2_ops; break;
+#endif /* EXCLUDE_MPL3115A2 */
+  default:                    return Baro_probe();
+  }
+
+  if (baro_chip->probe()) {
+    return true;
+  }
+
+  baro_cached = baro_chip;
+  bool found  = Baro_probe();
+  baro_cached = NULL;
+
+  return found;
+}
+#else
+#define Baro_probe_cached()   Baro_probe()
+#endif /* ENABLE_PROBE_CACHE */
+
 byte Baro_setup()
 {
-  if ( SoC->Baro_setup() && Baro_probe() ) {
+  if ( SoC->Baro_setup() && Baro_probe_cached() ) {
 
     Serial.print(baro_chip->name);
     Serial.println(F(" barometric pressure sensor is detected."));
@@ -468,12 +585,10 @@ byte Baro_setup()
     BaroPresTempTimeMarker = millis();
 
     Baro_altitude_cache    = baro_chip->altitude(1013.25);
-    ThisAircraft.pressure_altitude = prev_pressure_altitude = Baro_altitude_cache;
+    ThisAircraft.pressure_altitude = Baro_altitude_cache;
     BaroAltitudeTimeMarker = millis();
 
-    for (int i=0; i<VS_AVERAGING_FACTOR; i++) {
-      Baro_VS[i] = 0;
-    }
+    Baro_vario_reset(Baro_altitude_cache);
 
     return baro_chip->type;
 
@@ -497,29 +612,15 @@ void Baro_loop()
     }
 #endif /* EXCLUDE_BME280AUX */
 
-    /* Draft of pressure altitude and vertical speed calculation */
     Baro_altitude_cache = baro_chip->altitude(1013.25);
 
     ThisAircraft.pressure_altitude = Baro_altitude_cache;
 
-    Baro_VS[avg_ndx] = (Baro_altitude_cache - prev_pressure_altitude) /
-                       (millis() - BaroAltitudeTimeMarker) * 1000;  /* in m/s */
-
-    ThisAircraft.vs = 0;
-    for (int i=0; i<VS_AVERAGING_FACTOR; i++) {
-      ThisAircraft.vs += Baro_VS[i];
-    }
-    ThisAircraft.vs /= VS_AVERAGING_FACTOR;
-
-    if (ThisAircraft.vs > -0.1 && ThisAircraft.vs < 0.1) {
-      ThisAircraft.vs = 0;
-    }
+    Baro_vario_step(Baro_altitude_cache, millis() - BaroAltitudeTimeMarker);
 
-    ThisAircraft.vs *= (_GPS_FEET_PER_METER * 60.0) ; /* feet per minute */
+    ThisAircraft.vs = Baro_vario_fpm();
 
-    prev_pressure_altitude = Baro_altitude_cache;
     BaroAltitudeTimeMarker = millis();
-    avg_ndx = (avg_ndx + 1) % VS_AVERAGING_FACTOR;
 
 #if 0
     Serial.print(F("P.Alt. = ")); Serial.print(ThisAircraft.pressure_altitude);
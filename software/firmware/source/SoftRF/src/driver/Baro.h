@@ -21,10 +21,10 @@
 
 #define BMP280_ADDRESS_ALT    0x76 /* GY-91, SA0 is NC */
 
-#define VS_AVERAGING_FACTOR   3
+#define BARO_SAMPLE_RATE      3 /* Hz */
 
 /* 3 baro sensor altitude readings per second */
-#define isTimeToBaroAltitude() ((millis() - BaroAltitudeTimeMarker) > (1000 / VS_AVERAGING_FACTOR))
+#define isTimeToBaroAltitude() ((millis() - BaroAltitudeTimeMarker) > (1000 / BARO_SAMPLE_RATE))
 /* read pressure and temperature every 3 seconds */
 #define isTimeToBaroPresTemp() ((millis() - BaroPresTempTimeMarker) > 3000)
 
@@ -59,4 +59,8 @@ float Baro_altitude(void);
 float Baro_pressure(void);
 float Baro_temperature(void);
 
+void  Baro_vario_reset(float);
+void  Baro_vario_step(float, unsigned long);
+float Baro_vario_fpm(void);
+
 #endif /* BAROHELPER_H */
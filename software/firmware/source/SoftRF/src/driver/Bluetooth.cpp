@@ -16,4 +16,48 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
-/* Superseded by files in 'src/platform/bluetooth' folder */
+/* platform code is in 'src/platform/bluetooth' folder */
+
+#include "Bluetooth.h"
+
+#define GDL90_FLAG  0x7E
+
+/*
+ * Length of a notification out of 'size' bytes at the head of the Tx FIFO,
+ * such that it ends on a message boundary. 'full' tells that the FIFO holds
+ * a chunk or more, so that a message with no boundary in the chunk is longer
+ * than the chunk and has to go torn. Otherwise 0 is returned for a tail that
+ * the writer has not finished yet - it is held back for the next pass.
+ *
+ * A GDL90 frame is 0x7E, the stuffed message and the CRC, then 0x7E; stuffing
+ * leaves no 0x7E inside, and no frame is empty, so a 0x7E after another byte
+ * is a closing flag. 0x0A is a plain byte of a GDL90 message.
+ */
+size_t Bluetooth_Chunk_Align(const uint8_t *chunk, size_t size, bool full,
+                             uint8_t framing)
+{
+  size_t i;
+
+  switch (framing)
+  {
+  case BLUETOOTH_FRAMING_TEXT:
+    for (i = size; i > 0; i--) {
+      if (chunk[i - 1] == '\n') {
+        return i;
+      }
+    }
+    break;
+  case BLUETOOTH_FRAMING_GDL90:
+    for (i = size; i > 1; i--) {
+      if (chunk[i - 1] == GDL90_FLAG && chunk[i - 2] != GDL90_FLAG) {
+        return i;
+      }
+    }
+    break;
+  case BLUETOOTH_FRAMING_NONE:
+  default:
+    return size;
+  }
+
+  return full ? size : 0;
+}
@@ -19,6 +19,9 @@
 #ifndef BLUETOOTHHELPER_H
 #define BLUETOOTHHELPER_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 enum
 {
 	BLUETOOTH_NONE,
@@ -27,6 +30,14 @@ enum
 	BLUETOOTH_A2DP_SOURCE,
 };
 
+/* what a notification of the BLE UART service ends on */
+enum
+{
+	BLUETOOTH_FRAMING_NONE,
+	BLUETOOTH_FRAMING_TEXT,   /* NMEA, D1090 - '\n' */
+	BLUETOOTH_FRAMING_GDL90,  /* 0x7E closing flag */
+};
+
 #if defined(ESP32)
 #include "../system/SoC.h"
 #if !defined(EXCLUDE_BLUETOOTH)
@@ -57,4 +68,6 @@ enum
 #include "../platform/bluetooth/ArduinoBLE.h"
 #endif /* ESP32 or NRF52 or RP2040 or RENESAS or SILABS */
 
+extern size_t Bluetooth_Chunk_Align(const uint8_t *, size_t, bool, uint8_t);
+
 #endif /* BLUETOOTHHELPER_H */
@@ -40,6 +40,22 @@ void EEPROM_store()    {}
 eeprom_t eeprom_block;
 settings_t *settings;
 
+#if defined(ENABLE_PROBE_CACHE)
+probe_cache_t *probe_cache;
+
+static uint8_t Probe_Cache_csum(probe_cache_t *pc)
+{
+  uint8_t *raw = (uint8_t *) pc;
+  uint8_t csum = 0x5A;
+
+  for (int i=0; i < offsetof(probe_cache_t, csum); i++) {
+    csum = (csum << 1 | csum >> 7) ^ raw[i];
+  }
+
+  return csum;
+}
+#endif /* ENABLE_PROBE_CACHE */
+
 void EEPROM_setup()
 {
   int cmd = EEPROM_EXT_LOAD;
@@ -75,6 +91,16 @@ void EEPROM_setup()
   }
   settings = &eeprom_block.field.settings;
 
+#if defined(ENABLE_PROBE_CACHE)
+  probe_cache = &eeprom_block.field.probe;
+
+  if (probe_cache->magic != SOFTRF_PROBE_MAGIC ||
+      probe_cache->csum  != Probe_Cache_csum(probe_cache)) {
+    /* all of *_NONE, every device gets the full probe */
+    memset(probe_cache, 0, sizeof(probe_cache_t));
+  }
+#endif /* ENABLE_PROBE_CACHE */
+
   SoC->EEPROM_extension(cmd);
 }
 
@@ -142,6 +168,7 @@ void EEPROM_defaults()
                                            hw_info.model == SOFTRF_MODEL_HAM      ?
                                            POWER_SAVE_NORECEIVE : POWER_SAVE_NONE;
   eeprom_block.field.settings.freq_corr  = 0;
+  eeprom_block.field.settings.rx_protocols = 0;
   eeprom_block.field.settings.igc_key[0] = 0;
   eeprom_block.field.settings.igc_key[1] = 0;
   eeprom_block.field.settings.igc_key[2] = 0;
@@ -159,4 +186,37 @@ void EEPROM_store()
   EEPROM_commit();
 }
 
+#if defined(ENABLE_PROBE_CACHE)
+/* once all the devices are set up, records what was found */
+void Probe_Cache_update()
+{
+  probe_cache_t pc;
+
+  memset(&pc, 0, sizeof(pc));
+
+  pc.magic   = SOFTRF_PROBE_MAGIC;
+  pc.rf      = hw_info.rf;
+  pc.baro    = hw_info.baro;
+  pc.gnss    = hw_info.gnss;
+  pc.display = hw_info.display;
+  pc.csum    = Probe_Cache_csum(&pc);
+
+  if (memcmp(probe_cache, &pc, sizeof(pc)) == 0) {
+    return;
+  }
+
+  *probe_cache = pc;
+
+  size_t base = offsetof(eeprom_struct_t, probe);
+
+  for (int i=0; i<sizeof(probe_cache_t); i++) {
+    EEPROM.write(base + i, eeprom_block.raw[base + i]);
+  }
+
+  EEPROM_commit();
+
+  Serial.println(F("INFO: hardware probe cache is updated."));
+}
+#endif /* ENABLE_PROBE_CACHE */
+
 #endif /* EXCLUDE_EEPROM */
@@ -36,7 +36,7 @@
 #endif /* EXCLUDE_EEPROM */
 
 #define SOFTRF_EEPROM_MAGIC   0xBABADEDA
-#define SOFTRF_EEPROM_VERSION 0x00000061
+#define SOFTRF_EEPROM_VERSION 0x00000062
 
 enum
 {
@@ -74,7 +74,7 @@ typedef struct Settings {
     uint8_t  power_save;
 
     int8_t   freq_corr; /* +/-, kHz */
-    uint8_t  resvd2;
+    uint8_t  rx_protocols; /* bitmap of extra protocols to listen to */
     uint8_t  resvd3;
     uint8_t  resvd4;
 
@@ -83,10 +83,32 @@ typedef struct Settings {
 
 } __attribute__((packed)) settings_t;
 
+#if defined(ENABLE_PROBE_CACHE)
+#define SOFTRF_PROBE_MAGIC    0x5047
+
+/*
+ * Hardware found on last boot. RF_setup(), Baro_setup() and GNSS_setup()
+ * verify the recorded device with its own probe first and walk the full
+ * probe chain only when it is not there anymore.
+ */
+typedef struct Probe_Cache {
+    uint16_t magic;
+    uint8_t  rf;
+    uint8_t  baro;
+    uint8_t  gnss;
+    uint8_t  display;
+    uint8_t  resvd;
+    uint8_t  csum;
+} __attribute__((packed)) probe_cache_t;
+#endif /* ENABLE_PROBE_CACHE */
+
 typedef struct EEPROM_S {
     uint32_t  magic;
     uint32_t  version;
     settings_t settings;
+#if defined(ENABLE_PROBE_CACHE)
+    probe_cache_t probe;
+#endif /* ENABLE_PROBE_CACHE */
 } eeprom_struct_t;
 
 typedef union EEPROM_U {
@@ -99,4 +121,9 @@ void EEPROM_defaults(void);
 void EEPROM_store(void);
 extern settings_t *settings;
 
+#if defined(ENABLE_PROBE_CACHE)
+void Probe_Cache_update(void);
+extern probe_cache_t *probe_cache;
+#endif /* ENABLE_PROBE_CACHE */
+
 #endif /* EEPROMHELPER_H */
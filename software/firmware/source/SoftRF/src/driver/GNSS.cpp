@@ -21,13 +21,15 @@
 #endif
 #include <TimeLib.h>
 
+#include "../system/SoC.h"
+#include "../system/Time.h"
 #include "GNSS.h"
 #include "EEPROM.h"
 #include "../protocol/data/NMEA.h"
-#include "../system/SoC.h"
 #include "WiFi.h"
 #include "RF.h"
 #include "Battery.h"
+#include "Baro.h"
 #include "../protocol/data/D1090.h"
 
 #if !defined(EXCLUDE_EGM96)
@@ -48,6 +50,7 @@
 
 unsigned long GNSSTimeSyncMarker = 0;
 volatile unsigned long PPS_TimeMarker = 0;
+volatile unsigned long PPS_TimeMarker_us = 0;
 
 const gnss_chip_ops_t *gnss_chip = NULL;
 extern const gnss_chip_ops_t goke_ops; /* forward declaration */
@@ -195,6 +198,18 @@ const uint8_t setGLL[] PROGMEM = {0xF0, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01
 const uint8_t setGSV[] PROGMEM = {0xF0, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
 const uint8_t setVTG[] PROGMEM = {0xF0, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
 const uint8_t setGSA[] PROGMEM = {0xF0, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01};
+#if defined(ENABLE_UBX_PVT)
+#define UBX_NMEA_RATE    (1000 / UBX_PVT_RATE_MS)
+const uint8_t setGGA[] PROGMEM = {0xF0, 0x00, UBX_NMEA_RATE, UBX_NMEA_RATE, 0x00,
+                                  UBX_NMEA_RATE, UBX_NMEA_RATE, 0x00};
+const uint8_t setRMC[] PROGMEM = {0xF0, 0x04, UBX_NMEA_RATE, UBX_NMEA_RATE, 0x00,
+                                  UBX_NMEA_RATE, UBX_NMEA_RATE, 0x00};
+const uint8_t setPVT[] PROGMEM = {0x01, 0x07, 0x01, 0x01, 0x00, 0x01, 0x01, 0x00};
+const uint8_t setTGP[] PROGMEM = {0x01, 0x20, 0x01, 0x01, 0x00, 0x01, 0x01, 0x00};
+ /* CFG-RATE */
+const uint8_t setRate[] PROGMEM = {UBX_PVT_RATE_MS & 0xFF, UBX_PVT_RATE_MS >> 8,
+                                   0x01, 0x00, 0x01, 0x00};
+#endif /* ENABLE_UBX_PVT */
  /* CFG-PRT */
 uint8_t setBR[] = {0x01, 0x00, 0x00, 0x00, 0xD0, 0x08, 0x00, 0x00, 0x00, 0x96,
                    0x00, 0x00, 0x07, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00};
@@ -417,6 +432,58 @@ static void setup_UBX()
     }
   }
 
+#if defined(ENABLE_UBX_PVT)
+  /*
+   * A CFG-MSG divider counts navigation epochs from the moment it is set,
+   * so 1 Hz GGA and RMC out of a faster navigation rate would not be
+   * aligned to the top of the second. Slot timing relies on NMEA
+   * arrival time when there is no PPS, so faster rate needs PPS.
+   */
+  bool fast_rate = (SOC_GPIO_PIN_GNSS_PPS != SOC_UNUSED_PIN);
+
+  if (fast_rate) {
+    GNSS_DEBUG_PRINTLN(F("Slowing down NMEA GGA and RMC: "));
+
+    msglen = makeUBXCFG(0x06, 0x01, sizeof(setGGA), setGGA);
+    sendUBX(GNSSbuf, msglen);
+    gnss_set_sucess = getUBX_ACK(0x06, 0x01);
+
+    msglen = makeUBXCFG(0x06, 0x01, sizeof(setRMC), setRMC);
+    sendUBX(GNSSbuf, msglen);
+    gnss_set_sucess = getUBX_ACK(0x06, 0x01) && gnss_set_sucess;
+
+    if (!gnss_set_sucess) {
+      GNSS_DEBUG_PRINTLN(F("WARNING: Unable to change NMEA GGA and RMC rate."));
+    }
+  }
+
+  GNSS_DEBUG_PRINTLN(F("Switching on UBX NAV-PVT and NAV-TIMEGPS: "));
+
+  msglen = makeUBXCFG(0x06, 0x01, sizeof(setPVT), setPVT);
+  sendUBX(GNSSbuf, msglen);
+  gnss_set_sucess = getUBX_ACK(0x06, 0x01);
+
+  msglen = makeUBXCFG(0x06, 0x01, sizeof(setTGP), setTGP);
+  sendUBX(GNSSbuf, msglen);
+  gnss_set_sucess = getUBX_ACK(0x06, 0x01) && gnss_set_sucess;
+
+  if (!gnss_set_sucess) {
+    GNSS_DEBUG_PRINTLN(F("WARNING: Unable to turn on UBX NAV-PVT."));
+  }
+
+  if (fast_rate) {
+    GNSS_DEBUG_PRINTLN(F("Setting navigation rate: "));
+
+    msglen = makeUBXCFG(0x06, 0x08, sizeof(setRate), setRate);
+    sendUBX(GNSSbuf, msglen);
+    gnss_set_sucess = getUBX_ACK(0x06, 0x08);
+
+    if (!gnss_set_sucess) {
+      GNSS_DEBUG_PRINTLN(F("WARNING: Unable to set navigation rate."));
+    }
+  }
+#endif /* ENABLE_UBX_PVT */
+
 #if defined(USE_U10_EXT)
   /* Disable BeiDou B1I. Enable BeiDou B1C and GLONASS L1OF */
   if (_ulox_version_cache == GNSS_MODULE_U10) {
@@ -1217,6 +1284,50 @@ bool isValidGNSSFix()
   return GNSS_fix_cache;
 }
 
+#if defined(ENABLE_PROBE_CACHE)
+/*
+ * Driver of the module of last boot. Its probe goes first among those
+ * of the chain that tell NMEA modules apart and is not repeated there,
+ * so that a stale record costs no probe that the chain does not run.
+ * A plain NMEA module of last boot skips these probes altogether.
+ */
+static const gnss_chip_ops_t *GNSS_cached_chip()
+{
+  switch (probe_cache->gnss)
+  {
+  case GNSS_MODULE_NMEA:  return &generic_nmea_ops;
+#if !defined(EXCLUDE_GNSS_UBLOX)
+  case GNSS_MODULE_U6:
+  case GNSS_MODULE_U7:
+  case GNSS_MODULE_U8:
+  case GNSS_MODULE_U9:
+  case GNSS_MODULE_U10:   return &ublox_ops;
+#endif /* EXCLUDE_GNSS_UBLOX */
+#if !defined(EXCLUDE_GNSS_MTK)
+  case GNSS_MODULE_MT33:  return &mtk_ops;
+#endif /* EXCLUDE_GNSS_MTK */
+#if !defined(EXCLUDE_GNSS_AT65)
+  case GNSS_MODULE_AT65:  return &at65_ops;
+#endif /* EXCLUDE_GNSS_AT65 */
+#if !defined(EXCLUDE_GNSS_UC65)
+  case GNSS_MODULE_UC65:  return &uc65_ops;
+#endif /* EXCLUDE_GNSS_UC65 */
+#if !defined(EXCLUDE_GNSS_AG33)
+  case GNSS_MODULE_AG33:  return &ag33_ops;
+#endif /* EXCLUDE_GNSS_AG33 */
+#if !defined(EXCLUDE_GNSS_GOKE)
+  case GNSS_MODULE_GOKE:  return &goke_ops;
+#endif /* EXCLUDE_GNSS_GOKE */
+  default:                return NULL;
+  }
+}
+
+#define GNSS_PROBE_NEXT(id, ops)  ((id) == GNSS_MODULE_NMEA && (ops) != cached \
+                                   && probe_cache->gnss != GNSS_MODULE_NMEA)
+#else
+#define GNSS_PROBE_NEXT(id, ops)  ((id) == GNSS_MODULE_NMEA)
+#endif /* ENABLE_PROBE_CACHE */
+
 byte GNSS_setup() {
 
   gnss_id_t gnss_id = GNSS_MODULE_NONE;
@@ -1284,28 +1395,43 @@ byte GNSS_setup() {
         return (byte) gnss_id;
   }
 
+#if defined(ENABLE_PROBE_CACHE)
+  const gnss_chip_ops_t *cached = GNSS_cached_chip();
+
+  if (gnss_id == GNSS_MODULE_NMEA && cached) {
+    if (cached != &generic_nmea_ops) {
+      gnss_id = (gnss_chip = cached, gnss_chip->probe());
+    }
+
+    if (gnss_id == probe_cache->gnss) {
+      Serial.print(GNSS_name[gnss_id]);
+      Serial.println(F(" GNSS module is detected (cached)."));
+    }
+  }
+#endif /* ENABLE_PROBE_CACHE */
+
 #if !defined(EXCLUDE_GNSS_UBLOX)
-  gnss_id = gnss_id == GNSS_MODULE_NMEA ?
+  gnss_id = GNSS_PROBE_NEXT(gnss_id, &ublox_ops) ?
             (gnss_chip = &ublox_ops,  gnss_chip->probe()) : gnss_id;
 #endif /* EXCLUDE_GNSS_UBLOX */
 #if !defined(EXCLUDE_GNSS_MTK)
-  gnss_id = gnss_id == GNSS_MODULE_NMEA ?
+  gnss_id = GNSS_PROBE_NEXT(gnss_id, &mtk_ops) ?
             (gnss_chip = &mtk_ops,    gnss_chip->probe()) : gnss_id;
 #endif /* EXCLUDE_GNSS_MTK */
 #if !defined(EXCLUDE_GNSS_AT65)
-  gnss_id = gnss_id == GNSS_MODULE_NMEA ?
+  gnss_id = GNSS_PROBE_NEXT(gnss_id, &at65_ops) ?
             (gnss_chip = &at65_ops,   gnss_chip->probe()) : gnss_id;
 #endif /* EXCLUDE_GNSS_AT65 */
 #if !defined(EXCLUDE_GNSS_UC65)
-  gnss_id = gnss_id == GNSS_MODULE_NMEA ?
+  gnss_id = GNSS_PROBE_NEXT(gnss_id, &uc65_ops) ?
             (gnss_chip = &uc65_ops,   gnss_chip->probe()) : gnss_id;
 #endif /* EXCLUDE_GNSS_UC65 */
 #if !defined(EXCLUDE_GNSS_AG33)
-  gnss_id = gnss_id == GNSS_MODULE_NMEA ?
+  gnss_id = GNSS_PROBE_NEXT(gnss_id, &ag33_ops) ?
             (gnss_chip = &ag33_ops,   gnss_chip->probe()) : gnss_id;
 #endif /* EXCLUDE_GNSS_AG33 */
 #if !defined(EXCLUDE_GNSS_GOKE)
-  gnss_id = gnss_id == GNSS_MODULE_NMEA ?
+  gnss_id = GNSS_PROBE_NEXT(gnss_id, &goke_ops) ?
             (gnss_chip = &goke_ops,   gnss_chip->probe()) : gnss_id;
 #endif /* EXCLUDE_GNSS_GOKE */
 
@@ -1354,6 +1480,11 @@ void GNSS_loop()
                   (gnss.altitude.age() <= NMEA_EXP_TIME) &&
                   (gnss.date.age()     <= NMEA_EXP_TIME);
 
+#if defined(ENABLE_UBX_PVT)
+  /* one NAV-PVT frame is enough, no need to wait for both GGA and RMC */
+  GNSS_fix_cache = GNSS_fix_cache || GNSS_PVT_valid();
+#endif /* ENABLE_UBX_PVT */
+
   GNSSTimeSync();
 
   if (gnss_chip) gnss_chip->loop();
@@ -1402,196 +1533,502 @@ void GNSSTimeSync()
             gnss.date.year());
     GNSSTimeSyncMarker = millis();
   }
+
+#if defined(ENABLE_UBX_PVT)
+  if ((GNSSTimeSyncMarker == 0 || (millis() - GNSSTimeSyncMarker > 60000)) &&
+      (GNSS_PVT.valid & 0x03) == 0x03 /* validDate, validTime */            &&
+       GNSS_PVT.year >= FW_Build_Year                                      &&
+      (millis() - GNSS_PVT.time_ms <= 1000) /* 1s */ ) {
+    setTime(GNSS_PVT.hour,
+            GNSS_PVT.min,
+            GNSS_PVT.sec,
+            GNSS_PVT.day,
+            GNSS_PVT.month,
+            GNSS_PVT.year);
+    GNSSTimeSyncMarker = millis();
+  }
+#endif /* ENABLE_UBX_PVT */
 }
 
-void PickGNSSFix()
+static const char NMEA_hex[] = "0123456789ABCDEF";
+
+/*
+ * Validate NMEA checksum of a sentence that starts with '$'
+ * and ends with "*XX" (XX is last 2 bytes of the buffer)
+ */
+bool GNSS_NMEA_checksum(const uint8_t *s, size_t len)
 {
-  bool isValidSentence = false;
-  int ndx;
-  int c = -1;
+  if (len < 6 || s[len-3] != '*') {
+    return false;
+  }
 
-  /*
-   * Check SW/HW UARTs, USB and BT for data
-   * WARNING! Make use only one input source at a time.
-   */
-  while (true) {
-#if !defined(USE_NMEA_CFG)
-    if (Serial_GNSS_In.available() > 0) {
-      c = Serial_GNSS_In.read();
-    } else if (Serial.available() > 0) {
-      c = Serial.read();
-    } else if (SoC->Bluetooth_ops && SoC->Bluetooth_ops->available() > 0) {
-      c = SoC->Bluetooth_ops->read();
-
-      /*
-       * Don't forget to disable echo:
-       *
-       * stty raw -echo -F /dev/rfcomm0
-       *
-       * GNSS input becomes garbled otherwise
-       */
-
-      // Serial.write((char) c);
-      /* Ignore Bluetooth input for a while */
-      // break;
+  uint8_t cs = 0;
+  for (size_t i = 1; i < len - 3; i++) {
+    cs ^= s[i];
+  }
+
+  return (toupper(s[len-2]) == NMEA_hex[cs >> 4] &&
+          toupper(s[len-1]) == NMEA_hex[cs & 0xF]);
+}
+
+/*
+ * TinyGPS++ makes use of GGA and RMC only (and of $P... custom sentences),
+ * everything else (GSV, GSA, VTG, ...) is not worth to be fed into it.
+ */
+bool GNSS_NMEA_wanted(const uint8_t *s, size_t len)
+{
+  if (len < 6 || s[0] != '$') {
+    return false;
+  }
+  if (s[1] == 'P') {
+    return true;
+  }
+  return ((s[3] == 'G' && s[4] == 'G' && s[5] == 'A') ||
+          (s[3] == 'R' && s[4] == 'M' && s[5] == 'C'));
+}
+
+/*
+ * Bulk read from a Stream. TTYSerial of Linux targets has no readBytes().
+ */
+template<class T>
+static size_t GNSS_Read_Stream(T &port, uint8_t *buf, size_t len)
+{
+#if defined(RASPBERRY_PI)
+  size_t n = 0;
+
+  while (n < len) {
+    int c = port.read();
+    if (c == -1) break;
+    buf[n++] = c;
+  }
+  return n;
 #else
+  return port.readBytes(buf, len);
+#endif
+}
+
+/*
+ * Fill the buffer with whatever is available from current input source.
+ * WARNING! Make use only one input source at a time.
+ */
+static size_t GNSS_Read_Block(uint8_t *buf, size_t size)
+{
+  size_t n = 0;
+  int avail;
+
+#if !defined(USE_NMEA_CFG)
+  if ((avail = Serial_GNSS_In.available()) > 0) {
+    n = GNSS_Read_Stream(Serial_GNSS_In, buf, (size_t) avail < size ? (size_t) avail : size);
+  } else if ((avail = Serial.available()) > 0) {
+    n = GNSS_Read_Stream(Serial, buf, (size_t) avail < size ? (size_t) avail : size);
+  } else if (SoC->Bluetooth_ops &&
+             (avail = SoC->Bluetooth_ops->available()) > 0) {
     /*
-     * Give priority to control channels over default GNSS input source on
-     * 'Dongle', 'Retro', 'Uni', 'Mini', 'Badge', 'Academy' and 'Lego' Editions
+     * Don't forget to disable echo:
+     *
+     * stty raw -echo -F /dev/rfcomm0
+     *
+     * GNSS input becomes garbled otherwise
      */
+    while (n < size && avail-- > 0) {
+      int c = SoC->Bluetooth_ops->read();
+      if (c == -1) break;
+      buf[n++] = c;
+    }
+  }
+#else
+  /*
+   * Give priority to control channels over default GNSS input source on
+   * 'Dongle', 'Retro', 'Uni', 'Mini', 'Badge', 'Academy' and 'Lego' Editions
+   */
 
-    /* Bluetooth input is first */
-    if (SoC->Bluetooth_ops && SoC->Bluetooth_ops->available() > 0) {
-      c = SoC->Bluetooth_ops->read();
+  /* Bluetooth input is first */
+  if (SoC->Bluetooth_ops && (avail = SoC->Bluetooth_ops->available()) > 0) {
+    while (n < size && avail-- > 0) {
+      int c = SoC->Bluetooth_ops->read();
+      if (c == -1) break;
+      buf[n++] = c;
+    }
 
-      C_NMEA_Source = NMEA_BLUETOOTH;
+    C_NMEA_Source = NMEA_BLUETOOTH;
 
-    /* USB input is second */
-    } else if (SoC->USB_ops && SoC->USB_ops->available() > 0) {
-      c = SoC->USB_ops->read();
+  /* USB input is second */
+  } else if (SoC->USB_ops && (avail = SoC->USB_ops->available()) > 0) {
+    while (n < size && avail-- > 0) {
+      int c = SoC->USB_ops->read();
+      if (c == -1) break;
+      buf[n++] = c;
+    }
 
-      C_NMEA_Source = NMEA_USB;
+    C_NMEA_Source = NMEA_USB;
 
 #if defined(ARDUINO_NUCLEO_L073RZ)
-      /* This makes possible to configure S76x's built-in SONY GNSS from aside */
-      if (hw_info.model == SOFTRF_MODEL_DONGLE) {
-        Serial_GNSS_Out.write(c);
-      }
+    /* This makes possible to configure S76x's built-in SONY GNSS from aside */
+    if (hw_info.model == SOFTRF_MODEL_DONGLE) {
+      Serial_GNSS_Out.write(buf, n);
+    }
 #endif
 
-    /* Serial input is third */
-    } else if (SerialOutput.available() > 0) {
-      c = SerialOutput.read();
-
-      C_NMEA_Source = NMEA_UART;
+  /* Serial input is third */
+  } else if ((avail = SerialOutput.available()) > 0) {
+    n = GNSS_Read_Stream(SerialOutput, buf, (size_t) avail < size ? (size_t) avail : size);
 
-#if 0
-      /* This makes possible to configure HTCC-AB02S built-in GOKE GNSS from aside */
-      if (hw_info.model == SOFTRF_MODEL_MINI) {
-        Serial_GNSS_Out.write(c);
-      }
-#endif
+    C_NMEA_Source = NMEA_UART;
 
-    /* Built-in GNSS input */
-    } else if (Serial_GNSS_In.available() > 0) {
-      c = Serial_GNSS_In.read();
+  /* Built-in GNSS input */
+  } else if ((avail = Serial_GNSS_In.available()) > 0) {
+    n = GNSS_Read_Stream(Serial_GNSS_In, buf, (size_t) avail < size ? (size_t) avail : size);
+  }
 #endif /* USE_NMEA_CFG */
-    } else {
-      /* return back if no input data */
-      break;
-    }
 
-    if (c == -1) {
-      /* retry */
-      continue;
-    }
+  return n;
+}
 
-    if (isPrintable(c) || c == '\r' || c == '\n') {
-      GNSSbuf[GNSS_cnt] = c;
-    } else {
-      /* ignore */
-      continue;
+/* one complete line, CR and LF stripped */
+static void GNSS_Process_Line(uint8_t *s, size_t len)
+{
+#if defined(ENABLE_D1090_INPUT)
+  if (s[0] == '*' && s[len-1] == ';' && (len == 16 || len == 30)) {
+    int i;
+
+    for (i=1; i < len-1; i++) {
+      if (!isxdigit(s[i])) break;
+    }
+    if (i == len-1) {
+      D1090_Import(s);
     }
+    return;
+  }
+#endif /* ENABLE_D1090_INPUT */
+
+  if (s[0] != '$' || !GNSS_NMEA_checksum(s, len)) {
+    return;
+  }
 
+  if (GNSS_NMEA_wanted(s, len)) {
 #if defined(ENABLE_GNSS_STATS)
-    if ( (GNSS_cnt >= 5) &&
-         (GNSSbuf[GNSS_cnt-5] == '$') &&
-         (GNSSbuf[GNSS_cnt-4] == 'G') &&
-        ((GNSSbuf[GNSS_cnt-3] == 'P') || (GNSSbuf[GNSS_cnt-3] == 'N'))) {
-      if ( (GNSSbuf[GNSS_cnt-2] == 'G') &&
-           (GNSSbuf[GNSS_cnt-1] == 'G') &&
-           (GNSSbuf[GNSS_cnt-0] == 'A')) {
+    if (s[1] == 'G' && (s[2] == 'P' || s[2] == 'N')) {
+      if (s[3] == 'G') {
         gnss_stats.gga_time_ms = millis();
         gnss_stats.gga_count++;
-      } else if ( (GNSSbuf[GNSS_cnt-2] == 'R') &&
-                  (GNSSbuf[GNSS_cnt-1] == 'M') &&
-                  (GNSSbuf[GNSS_cnt-0] == 'C')) {
+      } else if (s[3] == 'R') {
         gnss_stats.rmc_time_ms = millis();
         gnss_stats.rmc_count++;
       }
     }
 #endif /* ENABLE_GNSS_STATS */
 
-    isValidSentence = gnss.encode(GNSSbuf[GNSS_cnt]);
-    if (GNSSbuf[GNSS_cnt] == '\r' && isValidSentence) {
-      for (ndx = GNSS_cnt - 4; ndx >= 0; ndx--) { // skip CS and *
-        if (settings->nmea_g && (GNSSbuf[ndx] == '$') && (GNSSbuf[ndx+1] == 'G')) {
-
-          size_t write_size = GNSS_cnt - ndx + 1;
-
-#if 0
-          if (!strncmp((char *) &GNSSbuf[ndx+3], "GGA,", strlen("GGA,"))) {
-            GGA_Stop_Time_Marker = millis();
-
-            Serial.print("GGA Start: ");
-            Serial.print(GGA_Start_Time_Marker);
-            Serial.print(" Stop: ");
-            Serial.print(GGA_Stop_Time_Marker);
-            Serial.print(" gnss.time.age: ");
-            Serial.println(gnss.time.age());
+    for (size_t i = 0; i < len; i++) {
+      gnss.encode(s[i]);
+    }
+    gnss.encode('\r');
+  }
 
-          }
-#endif
+  if (settings->nmea_g && s[1] == 'G') {
+    /* CR is still there, in front of the (stripped) LF */
+    size_t write_size = len + 1;
 
-          /*
-           * Work around issue with "always 0.0,M" GGA geoid separation value
-           * given by some Chinese GNSS chipsets
-           */
+    /*
+     * Work around issue with "always 0.0,M" GGA geoid separation value
+     * given by some Chinese GNSS chipsets
+     */
 #if defined(USE_NMEALIB)
-          if (hw_info.model == SOFTRF_MODEL_PRIME_MK2 &&
-              !strncmp((char *) &GNSSbuf[ndx+3], "GGA,", strlen("GGA,")) &&
-              gnss.separation.meters() == 0.0) {
-            NMEA_GGA();
-          }
-          else
+    if (hw_info.model == SOFTRF_MODEL_PRIME_MK2 &&
+        !strncmp((char *) &s[3], "GGA,", strlen("GGA,")) &&
+        gnss.separation.meters() == 0.0) {
+      NMEA_GGA();
+    }
+    else
 #endif
-          {
-            NMEA_Out(settings->nmea_out, &GNSSbuf[ndx], write_size, true);
-          }
-
-          break;
-        }
-      }
+    {
+      NMEA_Out(settings->nmea_out, s, write_size, true);
+    }
+  }
 
 #if defined(USE_NMEA_CFG)
-      NMEA_Process_SRF_SKV_Sentences();
+  NMEA_Process_SRF_SKV_Sentences();
 #endif /* USE_NMEA_CFG */
+}
+
+#if defined(ENABLE_UBX_PVT)
+gnss_pvt_t GNSS_PVT;
+
+#define UBX_NAV_PVT_LEN     92
+#define UBX_NAV_TIMEGPS_LEN 16
+#define UBX_MAX_LEN         512
+
+enum
+{
+  UBX_SYNC1,
+  UBX_SYNC2,
+  UBX_CLASS,
+  UBX_ID,
+  UBX_LEN1,
+  UBX_LEN2,
+  UBX_PAYLOAD,
+  UBX_CK_A,
+  UBX_CK_B
+};
+
+static struct {
+  uint8_t  state;
+  uint8_t  cl;
+  uint8_t  id;
+  uint16_t len;
+  uint16_t cnt;
+  uint8_t  ck_a;
+  uint8_t  ck_b;
+  uint8_t  payload[UBX_NAV_PVT_LEN];
+} UBX_rx;
+
+#define UBX_U1(p, o)  ((uint8_t)  (p)[o])
+#define UBX_U2(p, o)  ((uint16_t) ((p)[o] | ((p)[(o)+1] << 8)))
+#define UBX_U4(p, o)  ((uint32_t) (p)[o]              | \
+                      ((uint32_t) (p)[(o)+1] <<  8)   | \
+                      ((uint32_t) (p)[(o)+2] << 16)   | \
+                      ((uint32_t) (p)[(o)+3] << 24))
+
+static void GNSS_UBX_Process(const uint8_t *p)
+{
+  if (UBX_rx.cl != 0x01) {
+    return;
+  }
+
+  if (UBX_rx.id == 0x07 && UBX_rx.len == UBX_NAV_PVT_LEN) {
+    GNSS_PVT.iTOW    = UBX_U4(p,  0);
+    GNSS_PVT.year    = UBX_U2(p,  4);
+    GNSS_PVT.month   = UBX_U1(p,  6);
+    GNSS_PVT.day     = UBX_U1(p,  7);
+    GNSS_PVT.hour    = UBX_U1(p,  8);
+    GNSS_PVT.min     = UBX_U1(p,  9);
+    GNSS_PVT.sec     = UBX_U1(p, 10);
+    GNSS_PVT.valid   = UBX_U1(p, 11);
+    GNSS_PVT.fixType = UBX_U1(p, 20);
+    GNSS_PVT.flags   = UBX_U1(p, 21);
+    GNSS_PVT.numSV   = UBX_U1(p, 23);
+    GNSS_PVT.lon     = (int32_t) UBX_U4(p, 24);
+    GNSS_PVT.lat     = (int32_t) UBX_U4(p, 28);
+    GNSS_PVT.height  = (int32_t) UBX_U4(p, 32);
+    GNSS_PVT.hMSL    = (int32_t) UBX_U4(p, 36);
+    GNSS_PVT.hAcc    = UBX_U4(p, 40);
+    GNSS_PVT.vAcc    = UBX_U4(p, 44);
+    GNSS_PVT.velD    = (int32_t) UBX_U4(p, 56);
+    GNSS_PVT.gSpeed  = (int32_t) UBX_U4(p, 60);
+    GNSS_PVT.headMot = (int32_t) UBX_U4(p, 64);
+    GNSS_PVT.pDOP    = UBX_U2(p, 76);
+    GNSS_PVT.time_ms = millis();
+  } else if (UBX_rx.id == 0x20 && UBX_rx.len == UBX_NAV_TIMEGPS_LEN) {
+    GNSS_PVT.week       = (int16_t) UBX_U2(p, 8);
+    GNSS_PVT.leapS      = (int8_t)  UBX_U1(p, 10);
+    GNSS_PVT.time_valid = UBX_U1(p, 11);
+  }
+}
+
+/*
+ * UBX frame decoder. Returns true when the byte belongs to a UBX frame
+ * and must not be passed over to NMEA sentence framer.
+ */
+bool GNSS_UBX_input(uint8_t c)
+{
+  if (UBX_rx.state >= UBX_CLASS && UBX_rx.state <= UBX_PAYLOAD) {
+    UBX_rx.ck_a += c;
+    UBX_rx.ck_b += UBX_rx.ck_a;
+  }
+
+  switch (UBX_rx.state)
+  {
+  case UBX_SYNC1:
+    if (c != 0xB5) {
+      return false;
+    }
+    UBX_rx.state = UBX_SYNC2;
+    break;
+  case UBX_SYNC2:
+    if (c != 0x62) {
+      UBX_rx.state = UBX_SYNC1;
+      return GNSS_UBX_input(c);
+    }
+    UBX_rx.ck_a  = UBX_rx.ck_b = 0;
+    UBX_rx.state = UBX_CLASS;
+    break;
+  case UBX_CLASS:
+    UBX_rx.cl    = c;
+    UBX_rx.state = UBX_ID;
+    break;
+  case UBX_ID:
+    UBX_rx.id    = c;
+    UBX_rx.state = UBX_LEN1;
+    break;
+  case UBX_LEN1:
+    UBX_rx.len   = c;
+    UBX_rx.state = UBX_LEN2;
+    break;
+  case UBX_LEN2:
+    UBX_rx.len  |= (uint16_t) c << 8;
+    UBX_rx.cnt   = 0;
+    if (UBX_rx.len > UBX_MAX_LEN) {
+      /* garbage - re-sync */
+      UBX_rx.state = UBX_SYNC1;
+      return true;
+    }
+    UBX_rx.state = UBX_rx.len > 0 ? UBX_PAYLOAD : UBX_CK_A;
+    break;
+  case UBX_PAYLOAD:
+    if (UBX_rx.cnt < sizeof(UBX_rx.payload)) {
+      UBX_rx.payload[UBX_rx.cnt] = c;
+    }
+    if (++UBX_rx.cnt >= UBX_rx.len) {
+      UBX_rx.state = UBX_CK_A;
     }
+    break;
+  case UBX_CK_A:
+    UBX_rx.state = c == UBX_rx.ck_a ? UBX_CK_B : UBX_SYNC1;
+    return true;
+  case UBX_CK_B:
+    if (c == UBX_rx.ck_b && UBX_rx.len <= sizeof(UBX_rx.payload)) {
+      GNSS_UBX_Process(UBX_rx.payload);
+    }
+    UBX_rx.state = UBX_SYNC1;
+    return true;
+  default:
+    UBX_rx.state = UBX_SYNC1;
+    return false;
+  }
 
-#if defined(ENABLE_D1090_INPUT)
-    if (GNSSbuf[GNSS_cnt]   == '\n' &&
-        GNSS_cnt             >  1   &&
-        GNSSbuf[GNSS_cnt-1] == '\r' &&
-        GNSSbuf[GNSS_cnt-2] == ';')
-    {
-      int i=0;
+  return true;
+}
 
-      if (GNSS_cnt > 16 && GNSSbuf[GNSS_cnt-17] == '*') {
-        for (i=0; i<14; i++) {
-          if (!isxdigit(GNSSbuf[GNSS_cnt-16+i])) break;
-        }
-        if (i>=14) {
-          D1090_Import(&GNSSbuf[GNSS_cnt-17]);
-          GNSS_cnt -= 18;
-        }
-      } else if (GNSS_cnt > 30 && GNSSbuf[GNSS_cnt-31] == '*') {
-        for (i=0; i<28; i++) {
-          if (!isxdigit(GNSSbuf[GNSS_cnt-30+i])) break;
+bool GNSS_PVT_valid()
+{
+  return GNSS_PVT.time_ms != 0                              &&
+        (millis() - GNSS_PVT.time_ms <= NMEA_EXP_TIME)      &&
+        (GNSS_PVT.flags & 0x01) /* gnssFixOK */             &&
+        (GNSS_PVT.fixType == 3  || GNSS_PVT.fixType == 4)   &&
+        (GNSS_PVT.valid & 0x01) /* validDate */;
+}
+
+/*
+ * Fill ownship state out of most recent NAV-PVT frame.
+ * Horizontal DOP is not a part of NAV-PVT and is taken over from GGA.
+ */
+bool GNSS_PVT_Ownship(ufo_t *this_aircraft)
+{
+  if (!GNSS_PVT_valid()) {
+    return false;
+  }
+
+  this_aircraft->latitude         = GNSS_PVT.lat * 1e-7;
+  this_aircraft->longitude        = GNSS_PVT.lon * 1e-7;
+  this_aircraft->altitude         = GNSS_PVT.hMSL / 1000.0;
+  this_aircraft->geoid_separation = (GNSS_PVT.height - GNSS_PVT.hMSL) / 1000.0;
+  this_aircraft->course           = GNSS_PVT.headMot * 1e-5;
+  this_aircraft->speed            = GNSS_PVT.gSpeed / (1000.0 * _GPS_MPS_PER_KNOT);
+  this_aircraft->hdop             = (uint16_t) gnss.hdop.value();
+
+  /* barometric vertical speed (when available) is preferred */
+  if (hw_info.baro == BARO_MODULE_NONE) {
+    this_aircraft->vs = -GNSS_PVT.velD * (_GPS_FEET_PER_METER * 60.0 / 1000.0);
+  }
+
+  return true;
+}
+#endif /* ENABLE_UBX_PVT */
+
+/*
+ * Snapshot of ownship for the radio part. RF_SetChannel() takes the
+ * time of the slots out of it rather than out of 'gnss', which the
+ * UI side keeps parsing into while the radio task runs. The time PLL
+ * is run here, on the side of 'gnss', for the same reason.
+ */
+void GNSS_Ownship_View(ownship_view_t *view, ufo_t *this_aircraft, bool valid)
+{
+  tmElements_t  tm;
+  unsigned long ms = millis();
+
+  int yr    = gnss.date.year();
+  if( yr > 99)
+      yr    = yr - 1970;
+  else
+      yr    += 30;
+  tm.Year   = yr;
+  tm.Month  = gnss.date.month();
+  tm.Day    = gnss.date.day();
+  tm.Hour   = gnss.time.hour();
+  tm.Minute = gnss.time.minute();
+  tm.Second = gnss.time.second();
+
+  view->fo       = *this_aircraft;
+  view->valid    = valid;
+  view->fix_time = makeTime(tm);
+  view->time_ms  = ms - gnss.time.age();
+  view->date_ms  = ms - gnss.date.age();
+  view->pps_ms   = SoC->get_PPS_TimeMarker();
+
+#if !defined(EXCLUDE_TIME_PLL)
+  Time_PLL_loop();
+  Time_PLL_view(view);
+#else
+  view->pll_locked = false;
+#endif /* EXCLUDE_TIME_PLL */
+}
+
+/*
+ * Block oriented sentence framer.
+ * Input bytes are gathered into GNSSbuf in bulk, complete lines are
+ * handed over by reference and a partial line is kept for the next call.
+ */
+void PickGNSSFix()
+{
+  size_t n;
+
+  if (GNSS_cnt < 0 || GNSS_cnt >= sizeof(GNSSbuf)) {
+    GNSS_cnt = 0;
+  }
+
+  while ((n = GNSS_Read_Block(&GNSSbuf[GNSS_cnt],
+                              sizeof(GNSSbuf) - GNSS_cnt)) > 0) {
+    size_t r, w = GNSS_cnt;
+    size_t line = 0;
+
+    for (r = GNSS_cnt; r < GNSS_cnt + n; r++) {
+      uint8_t c = GNSSbuf[r];
+
+#if defined(ENABLE_UBX_PVT)
+      /* binary UBX frames are interleaved with NMEA sentences */
+      if (GNSS_UBX_input(c)) {
+        continue;
+      }
+#endif /* ENABLE_UBX_PVT */
+
+      if (c == '\n') {
+        size_t len = w - line;
+
+        /* strip CR */
+        if (len > 0 && GNSSbuf[w-1] == '\r') {
+          len--;
         }
-        if (i>=28) {
-          D1090_Import(&GNSSbuf[GNSS_cnt-31]);
-          GNSS_cnt -= 32;
+        if (len > 0) {
+          GNSSbuf[line + len] = '\r';
+          GNSS_Process_Line(&GNSSbuf[line], len);
         }
+        line = w;
+      } else if (isPrintable(c) || c == '\r') {
+        GNSSbuf[w++] = c;
       }
     }
-#endif /* ENABLE_D1090_INPUT */
 
-    if (GNSSbuf[GNSS_cnt] == '\n' || GNSS_cnt == sizeof(GNSSbuf)-1) {
+    /* move partial sentence to the front */
+    if (line > 0) {
+      memmove(&GNSSbuf[0], &GNSSbuf[line], w - line);
+    }
+    GNSS_cnt = w - line;
+
+    /* no line end within a full buffer - drop it */
+    if (GNSS_cnt >= sizeof(GNSSbuf) - 1) {
       GNSS_cnt = 0;
-    } else {
-      GNSS_cnt++;
-      yield();
     }
+
+    yield();
   }
 }
 
@@ -60,16 +60,66 @@ typedef struct gnss_stat_struct {
 
 #define NMEA_EXP_TIME  3500 /* 3.5 seconds */
 
+#if defined(ENABLE_UBX_PVT)
+/* UBX-NAV-PVT and UBX-NAV-TIMEGPS content, u-blox native units */
+typedef struct gnss_pvt_struct {
+  unsigned long time_ms;    /* millis() at frame reception */
+  uint32_t  iTOW;           /* ms */
+  uint16_t  year;
+  uint8_t   month;
+  uint8_t   day;
+  uint8_t   hour;
+  uint8_t   min;
+  uint8_t   sec;
+  uint8_t   valid;          /* validDate, validTime, fullyResolved */
+  uint8_t   fixType;
+  uint8_t   flags;          /* gnssFixOK, ... */
+  uint8_t   numSV;
+  int32_t   lon;            /* 1e-7 deg */
+  int32_t   lat;            /* 1e-7 deg */
+  int32_t   height;         /* above ellipsoid, mm */
+  int32_t   hMSL;           /* above MSL, mm */
+  uint32_t  hAcc;           /* mm */
+  uint32_t  vAcc;           /* mm */
+  int32_t   velD;           /* mm/s, positive down */
+  int32_t   gSpeed;         /* mm/s */
+  int32_t   headMot;        /* 1e-5 deg */
+  uint16_t  pDOP;           /* 0.01 */
+
+  /* NAV-TIMEGPS */
+  int16_t   week;
+  int8_t    leapS;
+  uint8_t   time_valid;     /* towValid, weekValid, leapSValid */
+} gnss_pvt_t;
+
+#if !defined(UBX_PVT_RATE_MS)
+#define UBX_PVT_RATE_MS  200 /* 5 Hz with PPS, GGA and RMC are kept at 1 Hz */
+#endif
+#endif /* ENABLE_UBX_PVT */
+
 bool isValidGNSSFix  (void);
 byte GNSS_setup      (void);
 void GNSS_loop       (void);
 void GNSS_fini       (void);
 void GNSSTimeSync    (void);
 void PickGNSSFix     (void);
+bool GNSS_NMEA_checksum(const uint8_t *, size_t);
+bool GNSS_NMEA_wanted  (const uint8_t *, size_t);
+#if defined(ENABLE_UBX_PVT)
+bool GNSS_UBX_input    (uint8_t);
+bool GNSS_PVT_valid    (void);
+bool GNSS_PVT_Ownship  (struct UFO *);
+#endif /* ENABLE_UBX_PVT */
+void GNSS_Ownship_View (struct ownship_view_struct *, struct UFO *, bool);
 int LookupSeparation (float, float);
 
 extern TinyGPSPlus gnss;
+extern unsigned long GNSSTimeSyncMarker;
 extern volatile unsigned long PPS_TimeMarker;
+extern volatile unsigned long PPS_TimeMarker_us;
 extern const char *GNSS_name[];
+#if defined(ENABLE_UBX_PVT)
+extern gnss_pvt_t GNSS_PVT;
+#endif /* ENABLE_UBX_PVT */
 
 #endif /* GNSSHELPER_H */
@@ -18,6 +18,7 @@
 
 #include "RF.h"
 #include "EEPROM.h"
+#include "../system/Time.h"
 #if !defined(EXCLUDE_MAVLINK)
 #include "../protocol/data/MAVLink.h"
 #endif /* EXCLUDE_MAVLINK */
@@ -28,9 +29,13 @@ unsigned long TxTimeMarker = 0;
 byte TxBuffer[MAX_PKT_SIZE] __attribute__((aligned(sizeof(uint32_t))));
 
 uint32_t tx_packets_counter = 0;
+uint32_t RF_first_tx_ms = 0;
 uint32_t rx_packets_counter = 0;
 
 int8_t RF_last_rssi = 0;
+uint32_t RF_slot_jitter_us = 0;
+uint8_t RF_rx_protocol = RF_PROTOCOL_LEGACY;
+uint8_t RF_rx_size     = 0; /* payload size of RF_rx_protocol */
 
 FreqPlan RF_FreqPlan;
 
@@ -58,6 +63,165 @@ static uint8_t       RF_timing = RF_TIMING_INTERVAL;
 
 extern const gnss_chip_ops_t *gnss_chip;
 
+#if defined(ENABLE_MULTI_RX)
+/*
+ * Multi-protocol Rx scheduler.
+ *
+ * One transceiver is time-shared between several protocols within each
+ * UTC second. Slotted protocols (Legacy, OGNTP, ADS-L) take turns in
+ * slot 0 and slot 1 windows of their (common) slot plan, interval
+ * protocols (P3I, FANET) are given the gap in between.
+ * Tx always happens with the primary protocol (settings->rf_protocol).
+ */
+typedef struct RF_rx_proto_struct {
+  const rf_proto_desc_t *desc;
+  bool (*decode)(void *, ufo_t *, ufo_t *);
+} RF_rx_proto_t;
+
+static const RF_rx_proto_t RF_Rx_Candidates[] = {
+  { &legacy_proto_desc, legacy_decode },
+  { &ogntp_proto_desc,  ogntp_decode  },
+  { &p3i_proto_desc,    p3i_decode    },
+  { &fanet_proto_desc,  fanet_decode  },
+#if defined(ENABLE_ADSL)
+  { &adsl_proto_desc,   adsl_decode   },
+#endif /* ENABLE_ADSL */
+};
+
+RF_rx_stats_t RF_Rx_Stats[RF_RX_PROTOCOLS_MAX];
+uint8_t RF_Rx_Protocols_Num = 0;
+
+static const RF_rx_proto_t *RF_Rx_Slotted[RF_RX_PROTOCOLS_MAX];
+static const RF_rx_proto_t *RF_Rx_Interval[RF_RX_PROTOCOLS_MAX];
+static uint8_t RF_Rx_Slotted_Num  = 0;
+static uint8_t RF_Rx_Interval_Num = 0;
+
+static const RF_rx_proto_t *RF_Rx_Primary = NULL;
+static const RF_rx_proto_t *RF_Rx_Current = NULL;
+static uint32_t RF_Rx_Window = 0;
+static time_t   RF_Rx_Time   = 0;
+
+static void RF_Rx_setup()
+{
+  RF_Rx_Slotted_Num   = 0;
+  RF_Rx_Interval_Num  = 0;
+  RF_Rx_Protocols_Num = 0;
+  RF_Rx_Primary       = NULL;
+  RF_Rx_Current       = NULL;
+
+  if (rf_chip->protocol == NULL) {
+    return;
+  }
+
+  uint8_t mask = settings->rx_protocols | (1 << settings->rf_protocol);
+
+  for (int i=0; i < sizeof(RF_Rx_Candidates) / sizeof(RF_rx_proto_t); i++) {
+    const RF_rx_proto_t *p = &RF_Rx_Candidates[i];
+
+    if ((mask & (1 << p->desc->type)) == 0) {
+      continue;
+    }
+    if (p->desc->type == settings->rf_protocol) {
+      RF_Rx_Primary = p;
+    }
+    if (p->desc->slot0.end > 0) {
+      RF_Rx_Slotted[RF_Rx_Slotted_Num++]   = p;
+    } else {
+      RF_Rx_Interval[RF_Rx_Interval_Num++] = p;
+    }
+  }
+
+  /* primary protocol is not a candidate (e.g. PRoL) */
+  if (RF_Rx_Primary == NULL) {
+    RF_Rx_Slotted_Num  = 0;
+    RF_Rx_Interval_Num = 0;
+    return;
+  }
+
+  RF_Rx_Protocols_Num = RF_Rx_Slotted_Num + RF_Rx_Interval_Num;
+  RF_Rx_Current       = RF_Rx_Primary;
+
+  memset(RF_Rx_Stats, 0, sizeof(RF_Rx_Stats));
+}
+
+static void RF_Rx_Select(const RF_rx_proto_t *p, time_t Time, uint8_t Slot)
+{
+  if (p != RF_Rx_Current) {
+    rf_chip->protocol(p->desc);
+    RF_FreqPlan.setPlan(settings->band, p->desc->type);
+    protocol_decode = p->decode;
+    RF_rx_protocol  = p->desc->type;
+    RF_rx_size      = RF_Payload_Size(RF_rx_protocol);
+    RF_Rx_Current   = p;
+  }
+
+  uint8_t OGN = (p->desc->type == RF_PROTOCOL_OGNTP ||
+                 p->desc->type == RF_PROTOCOL_ADSL_860 ? 1 : 0);
+
+  rf_chip->channel((int8_t) RF_FreqPlan.getChannel(Time, Slot, OGN));
+}
+
+static void RF_Rx_Schedule(time_t Time, unsigned long ref_time_ms)
+{
+  const RF_rx_proto_t *p;
+  uint32_t ms = (millis() - ref_time_ms) % 1000;
+  uint8_t window = 2; /* gap */
+
+  RF_Rx_Time = Time;
+
+  if (RF_Rx_Slotted_Num > 0) {
+    /*
+     * Every slotted protocol is matched against its own slot plan.
+     * Slot 0 of this second and the tail of slot 1 of previous second
+     * belong to the same protocol of the rotation, slot 1 of this
+     * second - to the next one.
+     */
+    const rf_proto_desc_t *d0 = RF_Rx_Slotted[Time % RF_Rx_Slotted_Num]->desc;
+    const rf_proto_desc_t *d1 = RF_Rx_Slotted[(Time + 1) % RF_Rx_Slotted_Num]->desc;
+
+    if (ms >= d0->slot0.begin && ms < d0->slot0.end) {
+      window = 0;
+    } else if (ms >= d1->slot1.begin && ms < d1->slot1.end) {
+      window = 1;
+    } else if (ms + 1000 < d0->slot1.end) {
+      window = 1;
+      /* tail of slot 1 belongs to previous second */
+      Time--;
+    }
+  }
+
+  if (window == 2) {
+    if (RF_Rx_Interval_Num == 0) {
+      /* nothing to do in the gap, keep listening on slot 1 set up */
+      return;
+    }
+    p = RF_Rx_Interval[Time % RF_Rx_Interval_Num];
+  } else {
+    p = RF_Rx_Slotted[(Time + window) % RF_Rx_Slotted_Num];
+  }
+
+  uint32_t id = (uint32_t) Time * 3 + window;
+  if (id != RF_Rx_Window) {
+    RF_Rx_Window = id;
+    RF_Rx_Stats[p->desc->type].windows++;
+  }
+
+  RF_Rx_Select(p, Time, window == 2 ? 0 : window);
+}
+
+/* Tx is done with primary protocol only */
+static void RF_Rx_Restore()
+{
+  if (RF_Rx_Current == NULL || RF_Rx_Current == RF_Rx_Primary) {
+    return;
+  }
+
+  uint8_t Slot = (RF_timing == RF_TIMING_2SLOTS_PPS_SYNC ? ts->current : 0);
+
+  RF_Rx_Select(RF_Rx_Primary, RF_Rx_Time, Slot);
+}
+#endif /* ENABLE_MULTI_RX */
+
 String Bin2Hex(byte *buffer, size_t size)
 {
   String str = "";
@@ -79,9 +243,74 @@ uint8_t parity(uint32_t x) {
     return (parity % 2);
 }
  
+#if defined(ENABLE_PROBE_CACHE) && !defined(USE_OGN_RF_DRIVER)
+/* the RFIC of last boot, when it still answers its own probe */
+static const rfchip_ops_t *RF_probe_cached()
+{
+  const rfchip_ops_t *p = NULL;
+
+  switch (probe_cache->rf)
+  {
+#if !defined(EXCLUDE_SX12XX)
+#if !defined(EXCLUDE_SX1276)
+  case RF_IC_SX1276:  p = &sx1276_ops;  break;
+#endif /* EXCLUDE_SX1276 */
+#if defined(USE_BASICMAC)
+  case RF_IC_SX1262:  p = &sx1262_ops;  break;
+#endif /* USE_BASICMAC */
+#endif /* EXCLUDE_SX12XX */
+#if !defined(EXCLUDE_NRF905)
+  case RF_IC_NRF905:  p = &nrf905_ops;  break;
+#endif /* EXCLUDE_NRF905 */
+#if !defined(EXCLUDE_UATM)
+  case RF_IC_UATM:    p = &uatm_ops;    break;
+#endif /* EXCLUDE_UATM */
+#if !defined(EXCLUDE_CC13XX)
+  case RF_IC_CC13XX:  p = &cc13xx_ops;  break;
+#endif /* EXCLUDE_CC13XX */
+#if defined(USE_RADIOLIB)
+  case RF_IC_LR1110:  p = &lr1110_ops;  break;
+  case RF_IC_LR1121:  p = &lr1121_ops;  break;
+#endif /* USE_RADIOLIB */
+#if defined(USE_SA8X8)
+  case RF_IC_SA8X8:   p = &sa8x8_ops;   break;
+#endif /* USE_SA8X8 */
+  case RF_IC_NONE:
+  default:
+    break;
+  }
+
+  if (p == NULL || !p->probe()) {
+    return NULL;
+  }
+
+#if !defined(EXCLUDE_SX12XX) && defined(USE_BASICMAC)
+#if !defined(EXCLUDE_SX1276)
+  if (p == &sx1276_ops) {
+    SX12XX_LL = &sx127x_ll_ops;
+  }
+#endif /* EXCLUDE_SX1276 */
+  if (p == &sx1262_ops) {
+    SX12XX_LL = &sx126x_ll_ops;
+  }
+#endif /* EXCLUDE_SX12XX && USE_BASICMAC */
+
+  Serial.print(p->name);
+  Serial.println(F(" RFIC is detected (cached)."));
+
+  return p;
+}
+#endif /* ENABLE_PROBE_CACHE && !USE_OGN_RF_DRIVER */
+
 byte RF_setup(void)
 {
 
+#if defined(ENABLE_PROBE_CACHE) && !defined(USE_OGN_RF_DRIVER)
+  if (rf_chip == NULL) {
+    rf_chip = RF_probe_cached();
+  }
+#endif /* ENABLE_PROBE_CACHE && !USE_OGN_RF_DRIVER */
+
   if (rf_chip == NULL) {
 #if !defined(USE_OGN_RF_DRIVER)
 #if !defined(EXCLUDE_SX12XX)
@@ -185,17 +414,26 @@ byte RF_setup(void)
     uint16_t duration = ts->s0.duration + ts->s1.duration;
     ts->adj = duration > ts->interval_mid ? 0 : (ts->interval_mid - duration) / 2;
 
+    RF_rx_protocol    = settings->rf_protocol;
+    RF_rx_size        = RF_Payload_Size(RF_rx_protocol);
+
+#if defined(ENABLE_MULTI_RX)
+    RF_Rx_setup();
+#endif /* ENABLE_MULTI_RX */
+
     return rf_chip->type;
   } else {
     return RF_IC_NONE;
   }
 }
 
-void RF_SetChannel(void)
+static time_t        RF_ref_Time_prev = 0;
+static unsigned long RF_ref_us_prev   = 0;
+
+void RF_SetChannel(ownship_view_t *own)
 {
-  tmElements_t  tm;
   time_t        Time;
-  unsigned long pps_btime_ms, ref_time_ms;
+  unsigned long pps_btime_ms, ref_time_ms, ref_time_us;
 
   switch (settings->mode)
   {
@@ -213,12 +451,26 @@ void RF_SetChannel(void)
 #endif /* EXCLUDE_MAVLINK */
   case SOFTRF_MODE_NORMAL:
   default:
-    pps_btime_ms = SoC->get_PPS_TimeMarker();
+#if !defined(EXCLUDE_TIME_PLL)
+    /* the PLL runs on the UI side, see GNSS_Ownship_View() */
+    if (own->pll_locked) {
+      unsigned long us     = micros();
+      uint64_t      utc_us = Time_PLL_view_us(own, us);
+      unsigned long frac   = (unsigned long) (utc_us % 1000000ULL);
+
+      Time        = (time_t) (utc_us / 1000000ULL);
+      ref_time_us = us - frac;
+      ref_time_ms = millis() - frac / 1000;
+      break;
+    }
+#endif /* EXCLUDE_TIME_PLL */
+
+    pps_btime_ms = own->pps_ms;
     unsigned long time_corr_neg;
     unsigned long ms_since_boot = millis();
 
     if (pps_btime_ms) {
-      unsigned long last_Commit_Time = ms_since_boot - gnss.time.age();
+      unsigned long last_Commit_Time = own->time_ms;
       if (pps_btime_ms <= last_Commit_Time) {
         time_corr_neg = (last_Commit_Time - pps_btime_ms) % 1000;
       } else {
@@ -228,27 +480,28 @@ void RF_SetChannel(void)
                     pps_btime_ms :
                     ms_since_boot-(ms_since_boot % 1000)+(pps_btime_ms % 1000);
     } else {
-      unsigned long last_RMC_Commit = ms_since_boot - gnss.date.age();
+      unsigned long last_RMC_Commit = own->date_ms;
       time_corr_neg = gnss_chip ? gnss_chip->rmc_ms : 100;
       ref_time_ms = last_RMC_Commit - time_corr_neg;
     }
 
-    int yr    = gnss.date.year();
-    if( yr > 99)
-        yr    = yr - 1970;
-    else
-        yr    += 30;
-    tm.Year   = yr;
-    tm.Month  = gnss.date.month();
-    tm.Day    = gnss.date.day();
-    tm.Hour   = gnss.time.hour();
-    tm.Minute = gnss.time.minute();
-    tm.Second = gnss.time.second();
-
-    Time = makeTime(tm) + (gnss.time.age() - time_corr_neg) / 1000;
+    Time = own->fix_time + (ms_since_boot - own->time_ms - time_corr_neg) / 1000;
+    ref_time_us = micros() - (ms_since_boot - ref_time_ms) * 1000UL;
     break;
   }
 
+  /* how much start of second (and so slots) wanders from one second to next */
+  if (settings->mode == SOFTRF_MODE_NORMAL && Time != RF_ref_Time_prev) {
+    long d = (long) (ref_time_us - RF_ref_us_prev) -
+             (long) (Time - RF_ref_Time_prev) * 1000000L;
+
+    if (Time - RF_ref_Time_prev == 1 && d > -500000L && d < 500000L) {
+      RF_slot_jitter_us += ((d < 0 ? -d : d) - (long) RF_slot_jitter_us) / 8;
+    }
+    RF_ref_Time_prev = Time;
+    RF_ref_us_prev   = ref_time_us;
+  }
+
   uint8_t OGN  = (settings->rf_protocol == RF_PROTOCOL_OGNTP    ? 1 : 0);
   uint8_t ADSL = (settings->rf_protocol == RF_PROTOCOL_ADSL_860 ? 1 : 0);
   int8_t chan  = -1;
@@ -283,14 +536,22 @@ void RF_SetChannel(void)
   Serial.print("Channel: "); Serial.println(chan);
 #endif
 
+#if defined(ENABLE_MULTI_RX)
+  if (rf_chip && RF_Rx_Protocols_Num > 1 &&
+      settings->mode == SOFTRF_MODE_NORMAL) {
+    RF_Rx_Schedule(Time, ref_time_ms);
+    return;
+  }
+#endif /* ENABLE_MULTI_RX */
+
   if (rf_chip) {
     rf_chip->channel(chan);
   }
 }
 
-void RF_loop()
+void RF_loop(ownship_view_t *own)
 {
-  RF_SetChannel();
+  RF_SetChannel(own);
 }
 
 size_t RF_Encode(ufo_t *fop)
@@ -324,6 +585,10 @@ bool RF_Transmit(size_t size, bool wait)
 
       if (memcmp(TxBuffer, RxBuffer, RF_tx_size) != 0) {
 
+#if defined(ENABLE_MULTI_RX)
+        RF_Rx_Restore();
+#endif /* ENABLE_MULTI_RX */
+
         if (rf_chip->transmit()) {
           if (settings->nmea_p) {
             StdOut.print(F("$PSRFO,"));
@@ -332,6 +597,9 @@ bool RF_Transmit(size_t size, bool wait)
             StdOut.println(Bin2Hex((byte *) &TxBuffer[0],
                                    RF_Payload_Size(settings->rf_protocol)));
           }
+          if (tx_packets_counter == 0) {
+            RF_first_tx_ms = millis();
+          }
           tx_packets_counter++;
         }
       } else {
@@ -374,6 +642,12 @@ bool RF_Receive(void)
 
   if (rf_chip) {
     rval = rf_chip->receive();
+
+#if defined(ENABLE_MULTI_RX)
+    if (rval) {
+      RF_Rx_Stats[RF_rx_protocol].packets++;
+    }
+#endif /* ENABLE_MULTI_RX */
   }
   
   return rval;
@@ -99,6 +99,7 @@ typedef struct rfchip_ops_struct {
   bool (*receive)();
   bool (*transmit)();
   void (*shutdown)();
+  void (*protocol)(const rf_proto_desc_t *);
 } rfchip_ops_t;
 
 typedef struct Slot_descr_struct {
@@ -118,12 +119,25 @@ typedef struct Slots_descr_struct {
   uint8_t       current;
 } Slots_descr_t;
 
+#if defined(ENABLE_MULTI_RX)
+#define RF_RX_PROTOCOLS_MAX   (RF_PROTOCOL_ADSL_860 + 1)
+
+typedef struct RF_rx_stats_struct {
+  uint32_t      windows;  /* Rx windows assigned to the protocol */
+  uint32_t      packets;  /* frames received within these windows */
+  uint32_t      decoded;  /* frames that have passed the protocol decoder */
+} RF_rx_stats_t;
+
+extern RF_rx_stats_t RF_Rx_Stats[RF_RX_PROTOCOLS_MAX];
+extern uint8_t RF_Rx_Protocols_Num;
+#endif /* ENABLE_MULTI_RX */
+
 String Bin2Hex(byte *, size_t);
 uint8_t parity(uint32_t);
 
 byte    RF_setup(void);
-void    RF_SetChannel(void);
-void    RF_loop(void);
+void    RF_SetChannel(ownship_view_t *);
+void    RF_loop(ownship_view_t *);
 size_t  RF_Encode(ufo_t *);
 bool    RF_Transmit(size_t, bool);
 bool    RF_Receive(void);
@@ -133,6 +147,7 @@ uint8_t RF_Payload_Size(uint8_t);
 extern byte TxBuffer[MAX_PKT_SIZE], RxBuffer[MAX_PKT_SIZE];
 extern unsigned long TxTimeMarker;
 extern uint32_t tx_packets_counter, rx_packets_counter;
+extern uint32_t RF_first_tx_ms;
 
 extern const rfchip_ops_t *rf_chip;
 extern bool RF_SX12XX_RST_is_connected;
@@ -142,6 +157,9 @@ extern bool (*protocol_decode)(void *, ufo_t *, ufo_t *);
 extern FreqPlan RF_FreqPlan;
 
 extern int8_t RF_last_rssi;
+extern uint32_t RF_slot_jitter_us;
+extern uint8_t RF_rx_protocol;
+extern uint8_t RF_rx_size;
 extern const char *Protocol_ID[];
 
 #if !defined(EXCLUDE_NRF905)
@@ -40,6 +40,7 @@ static bool sx12xx_receive(void);
 static bool sx12xx_transmit(void);
 static void sx1276_shutdown(void);
 static void sx1262_shutdown(void);
+static void sx12xx_protocol(const rf_proto_desc_t *);
 
 const rfchip_ops_t sx1276_ops = {
   RF_IC_SX1276,
@@ -49,7 +50,8 @@ const rfchip_ops_t sx1276_ops = {
   sx12xx_channel,
   sx12xx_receive,
   sx12xx_transmit,
-  sx1276_shutdown
+  sx1276_shutdown,
+  sx12xx_protocol
 };
 
 #if defined(USE_BASICMAC)
@@ -61,7 +63,8 @@ const rfchip_ops_t sx1262_ops = {
   sx12xx_channel,
   sx12xx_receive,
   sx12xx_transmit,
-  sx1262_shutdown
+  sx1262_shutdown,
+  sx12xx_protocol
 };
 #endif /* USE_BASICMAC */
 
@@ -249,6 +252,27 @@ static void sx12xx_channel(int8_t channel)
   }
 }
 
+/*
+ * Switch Rx to another radio protocol on the fly.
+ * Modem settings are picked up by sx12xx_setvars() on next Rx start.
+ */
+static void sx12xx_protocol(const rf_proto_desc_t *desc)
+{
+  if (desc == NULL || desc == LMIC.protocol) {
+    return;
+  }
+
+  if (sx12xx_receive_active) {
+    os_radio(RADIO_RST);
+    sx12xx_receive_active = false;
+  }
+
+  LMIC.protocol = desc;
+
+  /* frequency depends on the protocol, have it re-calculated */
+  sx12xx_channel_prev = (int8_t) -1;
+}
+
 static void sx12xx_setup()
 {
   SoC->SPI_begin();
@@ -576,42 +600,50 @@ static void sx12xx_rx_func (osjob_t* job) {
     break;
   }
 
-  for (i = LMIC.protocol->payload_offset;
-       i < (LMIC.dataLen - LMIC.protocol->crc_size);
-       i++)
-  {
+  u1_t first = LMIC.protocol->payload_offset;
+  int  last  = LMIC.dataLen - LMIC.protocol->crc_size;
 
-    switch (LMIC.protocol->crc_type)
-    {
-    case RF_CHECKSUM_TYPE_GALLAGER:
-    case RF_CHECKSUM_TYPE_CRC_MODES:
-    case RF_CHECKSUM_TYPE_NONE:
-      break;
-    case RF_CHECKSUM_TYPE_CRC8_107:
+  /* checksum and whitening type are selected once per packet, not per byte */
+  switch (LMIC.protocol->crc_type)
+  {
+  case RF_CHECKSUM_TYPE_GALLAGER:
+  case RF_CHECKSUM_TYPE_CRC_MODES:
+  case RF_CHECKSUM_TYPE_NONE:
+    break;
+  case RF_CHECKSUM_TYPE_CRC8_107:
+    for (i = first; i < last; i++) {
       update_crc8(&crc8, (u1_t)(LMIC.frame[i]));
-      break;
-    case RF_CHECKSUM_TYPE_CCITT_FFFF:
-    case RF_CHECKSUM_TYPE_CCITT_0000:
-    default:
+    }
+    break;
+  case RF_CHECKSUM_TYPE_CCITT_FFFF:
+  case RF_CHECKSUM_TYPE_CCITT_0000:
+  default:
+    for (i = first; i < last; i++) {
       crc16 = update_crc_ccitt(crc16, (u1_t)(LMIC.frame[i]));
-      break;
     }
+    break;
+  }
 
-    switch (LMIC.protocol->whitening)
-    {
-    case RF_WHITENING_NICERF:
-      LMIC.frame[i] ^= pgm_read_byte(&whitening_pattern[i - LMIC.protocol->payload_offset]);
-      break;
-    case RF_WHITENING_MANCHESTER:
-    case RF_WHITENING_NONE:
-    default:
-      break;
+  switch (LMIC.protocol->whitening)
+  {
+  case RF_WHITENING_NICERF:
+    for (i = first; i < last; i++) {
+      LMIC.frame[i] ^= pgm_read_byte(&whitening_pattern[i - first]);
     }
+    break;
+  case RF_WHITENING_MANCHESTER:
+  case RF_WHITENING_NONE:
+  default:
+    break;
+  }
 
 #if DEBUG
+  for (i = first; i < last; i++) {
     Serial.printf("%02x", (u1_t)(LMIC.frame[i]));
-#endif
   }
+#endif
+
+  i = last > first ? last : first;
 
   switch (LMIC.protocol->crc_type)
   {
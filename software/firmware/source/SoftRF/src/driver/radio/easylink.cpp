@@ -54,7 +54,8 @@ const rfchip_ops_t cc13xx_ops = {
   cc13xx_channel,
   cc13xx_receive,
   cc13xx_transmit,
-  cc13xx_shutdown
+  cc13xx_shutdown,
+  NULL
 };
 
 const rf_proto_desc_t  *cc13xx_protocol = &uat978_proto_desc;
@@ -157,6 +158,10 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
           (offset > 3 ? (rxPacket_ptr->payload[3] == cc13xx_protocol->syncword[7]) : true)) {
 
         uint8_t i, val1, val2;
+        bool crc16_used = cc13xx_protocol->crc_type != RF_CHECKSUM_TYPE_GALLAGER  &&
+                          cc13xx_protocol->crc_type != RF_CHECKSUM_TYPE_CRC_MODES &&
+                          cc13xx_protocol->crc_type != RF_CHECKSUM_TYPE_NONE;
+
         for (i = 0; i < size; i++) {
           val1 = pgm_read_byte(&ManchesterDecode[rxPacket_ptr->payload[i + offset]]);
           i++;
@@ -164,19 +169,9 @@ void cc13xx_Receive_callback(EasyLink_RxPacket *rxPacket_ptr, EasyLink_Status st
           if ((i>>1) < sizeof(RxBuffer)) {
             RxBuffer[i>>1] = ((val1 & 0x0F) << 4) | (val2 & 0x0F);
 
-            if (i < size - (cc13xx_protocol->crc_size + cc13xx_protocol->crc_size)) {
-              switch (cc13xx_protocol->crc_type)
-              {
-              case RF_CHECKSUM_TYPE_GALLAGER:
-              case RF_CHECKSUM_TYPE_CRC_MODES:
-              case RF_CHECKSUM_TYPE_NONE:
-                break;
-              case RF_CHECKSUM_TYPE_CCITT_FFFF:
-              case RF_CHECKSUM_TYPE_CCITT_0000:
-              default:
-                crc16 = update_crc_ccitt(crc16, (u1_t)(RxBuffer[i>>1]));
-                break;
-              }
+            if (crc16_used &&
+                i < size - (cc13xx_protocol->crc_size + cc13xx_protocol->crc_size)) {
+              crc16 = update_crc_ccitt(crc16, (u1_t)(RxBuffer[i>>1]));
             }
           }
         }
@@ -46,7 +46,8 @@ const rfchip_ops_t sa8x8_ops = {
   sa8x8_channel,
   sa8x8_receive,
   sa8x8_transmit,
-  sa8x8_shutdown
+  sa8x8_shutdown,
+  NULL
 };
 
 SA818 sa868(&SA8X8_Serial);
@@ -46,7 +46,8 @@ const rfchip_ops_t nrf905_ops = {
   nrf905_channel,
   nrf905_receive,
   nrf905_transmit,
-  nrf905_shutdown
+  nrf905_shutdown,
+  NULL
 };
 
 static int8_t nrf905_channel_prev = (int8_t) -1;
@@ -50,7 +50,8 @@ const rfchip_ops_t ognrf_ops = {
   ognrf_channel,
   ognrf_receive,
   ognrf_transmit,
-  ognrf_shutdown
+  ognrf_shutdown,
+  NULL
 };
 
 static RFM_TRX  TRX;
@@ -43,7 +43,8 @@ const rfchip_ops_t lr1110_ops = {
   lr11xx_channel,
   lr11xx_receive,
   lr11xx_transmit,
-  lr11xx_shutdown
+  lr11xx_shutdown,
+  NULL
 };
 
 const rfchip_ops_t lr1121_ops = {
@@ -54,7 +55,8 @@ const rfchip_ops_t lr1121_ops = {
   lr11xx_channel,
   lr11xx_receive,
   lr11xx_transmit,
-  lr11xx_shutdown
+  lr11xx_shutdown,
+  NULL
 };
 
 #define USE_SX1262      1
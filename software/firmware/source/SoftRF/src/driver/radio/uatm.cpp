@@ -47,7 +47,8 @@ const rfchip_ops_t uatm_ops = {
   uatm_channel,
   uatm_receive,
   uatm_transmit,
-  uatm_shutdown
+  uatm_shutdown,
+  NULL
 };
 
 static unsigned char uat_ringbuf[UAT_RINGBUF_SIZE];
@@ -21,7 +21,7 @@
 #define PLATFORM_ASR66_H
 
 /* Maximum of tracked flying objects is now SoC-specific constant */
-#define MAX_TRACKING_OBJECTS    8
+#define MAX_TRACKING_OBJECTS    11
 
 #define DEFAULT_SOFTRF_MODEL    SOFTRF_MODEL_OCTAVE
 
@@ -130,6 +130,7 @@ struct rst_info {
 #define EXCLUDE_TEST_MODE
 #define EXCLUDE_WATCHOUT_MODE
 #define EXCLUDE_TRAFFIC_FILTER_EXTENSION
+#define EXCLUDE_TRAFFIC_FUSION
 #define EXCLUDE_LK8EX1
 
 //#define EXCLUDE_GNSS_UBLOX
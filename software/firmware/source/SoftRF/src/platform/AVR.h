@@ -133,6 +133,7 @@ struct rst_info {
 #define EXCLUDE_TEST_MODE
 #define EXCLUDE_WATCHOUT_MODE
 #define EXCLUDE_TRAFFIC_FILTER_EXTENSION
+#define EXCLUDE_TRAFFIC_FUSION
 //#define EXCLUDE_LK8EX1
 
 #define EXCLUDE_GNSS_UBLOX
@@ -156,6 +157,7 @@ struct rst_info {
 #define EXCLUDE_UATM             //  -    kb
 #define EXCLUDE_MAVLINK          //  -    kb
 #define EXCLUDE_EGM96            //  -    kb
+#define EXCLUDE_TIME_PLL
 #define EXCLUDE_LED_RING         //  -    kb
 //#define EXCLUDE_SOUND
 #define EXCLUDE_IMU
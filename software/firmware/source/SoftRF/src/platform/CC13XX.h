@@ -21,7 +21,7 @@
 #define PLATFORM_CC13XX_H
 
 /* Maximum of tracked flying objects is now SoC-specific constant */
-#define MAX_TRACKING_OBJECTS    8
+#define MAX_TRACKING_OBJECTS    11
 
 #define DEFAULT_SOFTRF_MODEL    SOFTRF_MODEL_UAT
 
@@ -196,6 +196,7 @@ struct rst_info {
 #define EXCLUDE_LK8EX1
 #define EXCLUDE_WATCHOUT_MODE
 #define EXCLUDE_TRAFFIC_FILTER_EXTENSION
+#define EXCLUDE_TRAFFIC_FUSION
 #define EXCLUDE_LOG_GNSS_VERSION
 #define EXCLUDE_IMU
 #define EXCLUDE_AIR6
@@ -47,6 +47,7 @@
 
 #include "../system/SoC.h"
 #include "../system/Time.h"
+#include "../system/Tasks.h"
 #include "../driver/Sound.h"
 #include "../driver/EEPROM.h"
 #include "../driver/RF.h"
@@ -204,6 +205,7 @@ char UDPpacketBuffer[UDP_PACKET_BUFSIZE];
 #include <Adafruit_SPIFlash.h>
 #include "../driver/EPD.h"
 #include "uCDB.hpp"
+#include "../system/ADB.h"
 
 SPIClass uSD_SPI(HSPI);
 #define  SD_CONFIG SdSpiConfig(uSD_SS_pin, SHARED_SPI, SD_SCK_MHZ(16), &uSD_SPI)
@@ -274,6 +276,51 @@ ui_settings_t ui_settings = {
 
 ui_settings_t *ui;
 uCDB<FatVolume, File32> ucdb(fatfs);
+ADB<FatVolume, File32>  adb(fatfs);
+
+static uint32_t ESP32_ADB_records()
+{
+  return adb.isOpen() ? adb.recordsNumber() : ucdb.recordsNumber();
+}
+
+/*
+ * Binary ADB is preferred, legacy '|' separated CDB is a fallback
+ */
+static bool ESP32_ADB_lookup(uint32_t id, adb_record_t *rec)
+{
+  if (adb.isOpen()) {
+    return adb.find(id, rec);
+  }
+
+  char key[8];
+  char out[64];
+  uint8_t tokens[3] = { 0 };
+  int c, i = 0, token_cnt = 0;
+
+  snprintf(key, sizeof(key),"%06X", id);
+
+  if (ucdb.findKey(key, strlen(key)) != KEY_FOUND) {
+    return false;
+  }
+
+  while ((c = ucdb.readValue()) != -1 && i < (sizeof(out) - 1)) {
+    if (c == '|') {
+      if (token_cnt < (sizeof(tokens) - 1)) {
+        token_cnt++;
+        tokens[token_cnt] = i+1;
+      }
+      c = 0;
+    }
+    out[i++] = (char) c;
+  }
+  out[i] = 0;
+
+  strncpy(rec->mam, out + tokens[0], ADB_VALUE_MAX); rec->mam[ADB_VALUE_MAX] = 0;
+  strncpy(rec->reg, out + tokens[1], ADB_VALUE_MAX); rec->reg[ADB_VALUE_MAX] = 0;
+  strncpy(rec->cn,  out + tokens[2], ADB_VALUE_MAX); rec->cn [ADB_VALUE_MAX] = 0;
+
+  return true;
+}
 
 #if CONFIG_TINYUSB_MSC_ENABLED
 #if defined(USE_ADAFRUIT_MSC)
@@ -1903,11 +1950,7 @@ static void ESP32_post_init()
 #if defined(CONFIG_IDF_TARGET_ESP32S3)
     if (hw_info.model == SOFTRF_MODEL_PRIME_MK3)
     {
-      char key[8];
-      char out[64];
-      uint8_t tokens[3] = { 0 };
-      cdbResult rt;
-      int c, i = 0, token_cnt = 0;
+      adb_record_t rec;
 
       int acfts;
       char *reg, *mam, *cn;
@@ -1916,35 +1959,12 @@ static void ESP32_post_init()
       OLED_info2();
 
       if (ADB_is_open) {
-        acfts = ucdb.recordsNumber();
-
-        snprintf(key, sizeof(key),"%06X", ThisAircraft.addr);
-
-        rt = ucdb.findKey(key, strlen(key));
-
-        switch (rt) {
-          case KEY_FOUND:
-            while ((c = ucdb.readValue()) != -1 && i < (sizeof(out) - 1)) {
-              if (c == '|') {
-                if (token_cnt < (sizeof(tokens) - 1)) {
-                  token_cnt++;
-                  tokens[token_cnt] = i+1;
-                }
-                c = 0;
-              }
-              out[i++] = (char) c;
-            }
-            out[i] = 0;
-
-            reg = out + tokens[1];
-            mam = out + tokens[0];
-            cn  = out + tokens[2];
+        acfts = ESP32_ADB_records();
 
-            break;
-
-          case KEY_NOT_FOUND:
-          default:
-            break;
+        if (ESP32_ADB_lookup(ThisAircraft.addr, &rec)) {
+          reg = rec.reg;
+          mam = rec.mam;
+          cn  = rec.cn;
         }
 
         reg = (reg != NULL) && strlen(reg) ? reg : (char *) "REG: N/A";
@@ -1969,46 +1989,19 @@ static void ESP32_post_init()
 
       EPD_info1();
 
-      char key[8];
-      char out[64];
-      uint8_t tokens[3] = { 0 };
-      cdbResult rt;
-      int c, i = 0, token_cnt = 0;
+      adb_record_t rec;
 
       int acfts;
       char *reg, *mam, *cn;
       reg = mam = cn = NULL;
 
       if (ADB_is_open) {
-        acfts = ucdb.recordsNumber();
+        acfts = ESP32_ADB_records();
 
-        snprintf(key, sizeof(key),"%06X", ThisAircraft.addr);
-
-        rt = ucdb.findKey(key, strlen(key));
-
-        switch (rt) {
-          case KEY_FOUND:
-            while ((c = ucdb.readValue()) != -1 && i < (sizeof(out) - 1)) {
-              if (c == '|') {
-                if (token_cnt < (sizeof(tokens) - 1)) {
-                  token_cnt++;
-                  tokens[token_cnt] = i+1;
-                }
-                c = 0;
-              }
-              out[i++] = (char) c;
-            }
-            out[i] = 0;
-
-            reg = out + tokens[1];
-            mam = out + tokens[0];
-            cn  = out + tokens[2];
-
-            break;
-
-          case KEY_NOT_FOUND:
-          default:
-            break;
+        if (ESP32_ADB_lookup(ThisAircraft.addr, &rec)) {
+          reg = rec.reg;
+          mam = rec.mam;
+          cn  = rec.cn;
         }
 
         reg = (reg != NULL) && strlen(reg) ? reg : (char *) "REG: N/A";
@@ -3524,7 +3517,12 @@ static byte ESP32_Display_setup()
       }
 
       xTaskCreateUniversal(EPD_Task, "EPD", EPD_STACK_SZ, NULL, 1,
-                           &EPD_Task_Handle, CONFIG_ARDUINO_RUNNING_CORE);
+                           &EPD_Task_Handle,
+#if defined(ENABLE_RADIO_TASK)
+                           UI_TASK_CORE);
+#else
+                           CONFIG_ARDUINO_RUNNING_CORE);
+#endif /* ENABLE_RADIO_TASK */
 
       TaskInfoTime = millis();
 #endif /* USE_EPD_TASK */
@@ -4251,6 +4249,7 @@ static void IRAM_ATTR ESP32_GNSS_PPS_Interrupt_handler()
 {
   portENTER_CRITICAL_ISR(&GNSS_PPS_mutex);
   PPS_TimeMarker = millis();    /* millis() has IRAM_ATTR */
+  PPS_TimeMarker_us = micros(); /* micros() has IRAM_ATTR */
   portEXIT_CRITICAL_ISR(&GNSS_PPS_mutex);
 }
 
@@ -4988,6 +4987,11 @@ static size_t ESP32SX_USB_write(const uint8_t *buffer, size_t size)
   return rval;
 }
 
+static int ESP32SX_USB_availableForWrite()
+{
+  return USB_TX_FIFO->room();
+}
+
 #elif ARDUINO_USB_CDC_ON_BOOT
 
 #define USE_ASYNC_USB_OUTPUT
@@ -5079,6 +5083,21 @@ static size_t ESP32SX_USB_write(const uint8_t *buffer, size_t size)
 
   return rval;
 }
+
+static int ESP32SX_USB_availableForWrite()
+{
+  int rval = 0;
+
+#if !ARDUINO_USB_MODE && defined(USE_ASYNC_USB_OUTPUT)
+  rval = USB_TX_FIFO->room();
+#else
+  if (USBSerial) {
+    rval = USBSerial.availableForWrite();
+  }
+#endif /* USE_ASYNC_USB_OUTPUT */
+
+  return rval;
+}
 #endif /* USE_USB_HOST || ARDUINO_USB_CDC_ON_BOOT */
 
 #if ARDUINO_USB_CDC_ON_BOOT || defined(USE_USB_HOST)
@@ -5089,7 +5108,8 @@ IODev_ops_t ESP32SX_USBSerial_ops = {
   ESP32SX_USB_fini,
   ESP32SX_USB_available,
   ESP32SX_USB_read,
-  ESP32SX_USB_write
+  ESP32SX_USB_write,
+  ESP32SX_USB_availableForWrite
 };
 #endif /* USE_USB_HOST || ARDUINO_USB_CDC_ON_BOOT */
 #endif /* CONFIG_IDF_TARGET_ESP32S2 */
@@ -5168,6 +5188,17 @@ static size_t ESP32CX_USB_write(const uint8_t *buffer, size_t size)
   return rval;
 }
 
+static int ESP32CX_USB_availableForWrite()
+{
+  int rval = 0;
+
+  if (USBSerial) {
+    rval = USBSerial.availableForWrite();
+  }
+
+  return rval;
+}
+
 IODev_ops_t ESP32CX_USBSerial_ops = {
   "ESP32CX USB",
   ESP32CX_USB_setup,
@@ -5175,7 +5206,8 @@ IODev_ops_t ESP32CX_USBSerial_ops = {
   ESP32CX_USB_fini,
   ESP32CX_USB_available,
   ESP32CX_USB_read,
-  ESP32CX_USB_write
+  ESP32CX_USB_write,
+  ESP32CX_USB_availableForWrite
 };
 #endif /* CONFIG_IDF_TARGET_ESP32C2 || C3 || C6 */
 
@@ -5187,7 +5219,9 @@ static bool ESP32_ADB_setup()
 
     if (ui->adb == DB_OGN) {
       fileName = "/Aircrafts/ogn.cdb";
-      if (ucdb.open(fileName) != CDB_OK) {
+      if (adb.open("/Aircrafts/ogn.adb")) {
+        ADB_is_open = true;
+      } else if (ucdb.open(fileName) != CDB_OK) {
         Serial.print("Invalid OGN CDB: ");
         Serial.println(fileName);
       } else {
@@ -5196,7 +5230,9 @@ static bool ESP32_ADB_setup()
     }
     if (ui->adb == DB_FLN) {
       fileName = "/Aircrafts/fln.cdb";
-      if (ucdb.open(fileName) != CDB_OK) {
+      if (adb.open("/Aircrafts/fln.adb")) {
+        ADB_is_open = true;
+      } else if (ucdb.open(fileName) != CDB_OK) {
         Serial.print("Invalid FLN CDB: ");
         Serial.println(fileName);
       } else {
@@ -5211,6 +5247,7 @@ static bool ESP32_ADB_setup()
 static bool ESP32_ADB_fini()
 {
   if (ADB_is_open) {
+    adb.close();
     ucdb.close();
     ADB_is_open = false;
   }
@@ -5225,58 +5262,29 @@ static bool ESP32_ADB_fini()
  */
 static bool ESP32_ADB_query(uint8_t type, uint32_t id, char *buf, size_t size)
 {
-  char key[8];
-  char out[64];
-  uint8_t tokens[3] = { 0 };
-  cdbResult rt;
-  int c, i = 0, token_cnt = 0;
+  adb_record_t rec;
   bool rval = false;
 
   if (!ADB_is_open) {
     return rval;
   }
 
-  snprintf(key, sizeof(key),"%06X", id);
-
-  rt = ucdb.findKey(key, strlen(key));
-
-  switch (rt) {
-    case KEY_FOUND:
-      while ((c = ucdb.readValue()) != -1 && i < (sizeof(out) - 1)) {
-        if (c == '|') {
-          if (token_cnt < (sizeof(tokens) - 1)) {
-            token_cnt++;
-            tokens[token_cnt] = i+1;
-          }
-          c = 0;
-        }
-        out[i++] = (char) c;
-      }
-      out[i] = 0;
-
-      switch (ui->idpref)
-      {
-      case ID_TAIL:
-        snprintf(buf, size, "CN: %s",
-          strlen(out + tokens[2]) ? out + tokens[2] : "N/A");
-        break;
-      case ID_MAM:
-        snprintf(buf, size, "%s",
-          strlen(out + tokens[0]) ? out + tokens[0] : "Unknown");
-        break;
-      case ID_REG:
-      default:
-        snprintf(buf, size, "%s",
-          strlen(out + tokens[1]) ? out + tokens[1] : "REG: N/A");
-        break;
-      }
-
-      rval = true;
+  if (ESP32_ADB_lookup(id, &rec)) {
+    switch (ui->idpref)
+    {
+    case ID_TAIL:
+      snprintf(buf, size, "CN: %s", strlen(rec.cn) ? rec.cn : "N/A");
       break;
-
-    case KEY_NOT_FOUND:
+    case ID_MAM:
+      snprintf(buf, size, "%s", strlen(rec.mam) ? rec.mam : "Unknown");
+      break;
+    case ID_REG:
     default:
+      snprintf(buf, size, "%s", strlen(rec.reg) ? rec.reg : "REG: N/A");
       break;
+    }
+
+    rval = true;
   }
 
   return rval;
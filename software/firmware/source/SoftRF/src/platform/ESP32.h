@@ -362,6 +362,17 @@ struct rst_info {
 #define USE_OGN_ENCRYPTION
 #define ENABLE_PROL
 #define ENABLE_ADSL
+#define ENABLE_MULTI_RX
+#define ENABLE_UBX_PVT
+#define ENABLE_OUTPUT_QUEUE
+#if !defined(CONFIG_FREERTOS_UNICORE)
+//#define ENABLE_RADIO_TASK     /* radio on one core, UI and exports on other */
+#endif /* CONFIG_FREERTOS_UNICORE */
+#define ENABLE_PROBE_CACHE      /* verify hardware of last boot before probing */
+//#define ENABLE_PROFILER
+#if defined(ENABLE_RADIO_TASK) && !defined(ENABLE_PROFILER)
+#define ENABLE_PROFILER         /* CPU load and longest pass of either task */
+#endif /* ENABLE_RADIO_TASK */
 
 //#define EXCLUDE_GNSS_UBLOX    /* Neo-6/7/8, M10 */
 #define ENABLE_UBLOX_RFS        /* revert factory settings (when necessary)  */
@@ -662,7 +662,7 @@ void main_loop_CPP(void)
     ThisAircraft.hdop             = (uint16_t) gnss.hdop.value();
     ThisAircraft.geoid_separation = gnss.separation.meters();
 
-    Traffic_loop();
+    Traffic_loop(&ThisAircraft);
   }
 
   Sound_loop();
@@ -723,8 +723,7 @@ void once_per_second_task_CPP(void)
     if (a->even_cprtime && a->odd_cprtime &&
         abs((long) (a->even_cprtime - a->odd_cprtime)) <= MODE_S_INTERACTIVE_TTL * 1000 ) {
       if (es1090_decode(a, &ThisAircraft, &fo)) {
-        memset(fo.raw, 0, sizeof(fo.raw));
-        Traffic_Update(&fo);
+        Traffic_Update(&ThisAircraft, &fo);
         Traffic_Add(&fo);
       }
     }
@@ -735,7 +734,7 @@ void once_per_second_task_CPP(void)
 
   /* D1090 data comes directly out of MODE-S low-level frames decoder */
 
-  ClearExpired();
+  ClearExpired(&ThisAircraft);
 }
 
 void shutdown(int reason)
@@ -172,6 +172,7 @@ extern softSerial swSer;
 #define EXCLUDE_TEST_MODE
 #define EXCLUDE_WATCHOUT_MODE
 #define EXCLUDE_TRAFFIC_FILTER_EXTENSION
+#define EXCLUDE_TRAFFIC_FUSION
 #define EXCLUDE_LK8EX1
 
 #if defined(CubeCell_GPS)
@@ -187,7 +187,7 @@ eeprom_t eeprom_block = {
     POWER_SAVE_NONE,
 
     0,
-    0, /* resvd2 */
+    0, /* rx_protocols */
     0, /* resvd3 */
     0, /* resvd4 */
 
@@ -1022,6 +1022,7 @@ static float RP2xxx_Battery_param(uint8_t param)
 
 void RP2xxx_GNSS_PPS_Interrupt_handler() {
   PPS_TimeMarker = millis();
+  PPS_TimeMarker_us = micros();
 }
 
 static unsigned long RP2xxx_get_PPS_TimeMarker() {
@@ -1313,6 +1314,23 @@ static size_t RP2xxx_USB_write(const uint8_t *buffer, size_t size)
 #endif /* USE_TINYUSB */
 }
 
+#if !defined(ARDUINO_ARCH_MBED)
+static int RP2xxx_USB_availableForWrite()
+{
+#if !defined(USE_TINYUSB)
+  return USB_TX_FIFO.availableForStore();
+#else
+  int rval = 0;
+
+  if (USBSerial) {
+    rval = USBSerial.availableForWrite();
+  }
+
+  return rval;
+#endif /* USE_TINYUSB */
+}
+#endif /* ARDUINO_ARCH_MBED */
+
 #if defined(USE_USB_HOST)
 /*********************************************************************
  Adafruit invests time and resources providing this open source code,
@@ -1501,7 +1519,10 @@ IODev_ops_t RP2xxx_USBSerial_ops = {
   RP2xxx_USB_fini,
   RP2xxx_USB_available,
   RP2xxx_USB_read,
-  RP2xxx_USB_write
+  RP2xxx_USB_write,
+#if !defined(ARDUINO_ARCH_MBED)
+  RP2xxx_USB_availableForWrite
+#endif /* ARDUINO_ARCH_MBED */
 };
 
 const SoC_ops_t RP2xxx_ops = {
@@ -23,7 +23,7 @@
 #include <avr/dtostrf.h>
 
 /* Maximum of tracked flying objects is now SoC-specific constant */
-#define MAX_TRACKING_OBJECTS    8
+#define MAX_TRACKING_OBJECTS    9
 
 #define DEFAULT_SOFTRF_MODEL    SOFTRF_MODEL_LEGO
 
@@ -313,6 +313,7 @@ struct rst_info {
 
 #if !defined(ARDUINO_ARCH_MBED)
 #define USE_BOOTSEL_BUTTON
+#define ENABLE_OUTPUT_QUEUE
 #else
 #define EXCLUDE_EEPROM
 
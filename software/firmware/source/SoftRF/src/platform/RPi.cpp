@@ -64,11 +64,26 @@
 #include "../driver/Battery.h"
 #include "../driver/Bluetooth.h"
 #include "../system/Time.h"
+#include "../system/NetOutput.h"
+#include "../system/Profiler.h"
 
 #include "TCPServer.h"
 
 #include <stdio.h>
-#include <sys/select.h>
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+
+#if defined(__has_include)
+#if __has_include(<linux/gpio.h>)
+#include <linux/gpio.h>
+#endif
+#endif
+
+#if defined(GPIO_GET_LINEEVENT_IOCTL)
+#define USE_GPIO_LINE_EVENTS
+#endif /* GPIO_GET_LINEEVENT_IOCTL */
 
 #include <iostream>
 
@@ -117,6 +132,7 @@ void onEvent (ev_t ev) {
 eeprom_t eeprom_block;
 settings_t *settings = &eeprom_block.field.settings;
 ufo_t ThisAircraft;
+static ownship_view_t Ownship;
 
 #if !defined(EXCLUDE_MAVLINK)
 aircraft the_aircraft;
@@ -150,6 +166,9 @@ std::string input_line;
 
 TCPServer Traffic_TCP_Server;
 
+static netout_t NMEA_NetOut;
+static netout_t GDL90_NetOut;
+
 #if defined(USE_EPAPER)
 GxEPD2_BW<GxEPD2_270, GxEPD2_270::HEIGHT> __attribute__ ((common)) epd_waveshare_W3(GxEPD2_270(/*CS=5*/ 8,
                                        /*DC=*/ 25, /*RST=*/ 17, /*BUSY=*/ 24));
@@ -292,6 +311,7 @@ static void RPi_setup()
   eeprom_block.field.settings.no_track      = false;
   eeprom_block.field.settings.power_save    = POWER_SAVE_NONE;
   eeprom_block.field.settings.freq_corr     = 0;
+  eeprom_block.field.settings.rx_protocols  = 0;
   eeprom_block.field.settings.igc_key[0]    = 0;
   eeprom_block.field.settings.igc_key[1]    = 0;
   eeprom_block.field.settings.igc_key[2]    = 0;
@@ -344,6 +364,7 @@ static void RPi_loop()
 
     if (PPS_state == HIGH && prev_PPS_state == LOW) {
       PPS_TimeMarker = millis();
+      PPS_TimeMarker_us = micros();
     }
     prev_PPS_state = PPS_state;
   }
@@ -377,9 +398,65 @@ static long RPi_random(long howsmall, long howBig)
   return howsmall + random() % (howBig - howsmall);
 }
 
+static bool RPi_Loop_watch(int, uint32_t);
+
 static void RPi_WiFi_transmit_UDP(int port, byte *buf, size_t size)
 {
-  /* TBD */
+  switch (port)
+  {
+  case NMEA_UDP_PORT:
+    NetOutput_write(&NMEA_NetOut, buf, size);
+    break;
+  case GDL90_DST_PORT:
+    NetOutput_write(&GDL90_NetOut, buf, size);
+    break;
+  default:
+    break;
+  }
+}
+
+void RPi_TCP_transmit(int port, byte *buf, size_t size)
+{
+  switch (port)
+  {
+  case NMEA_TCP_PORT:
+    NetOutput_write(&NMEA_NetOut, buf, size);
+    break;
+  case GDL90_TCP_PORT:
+    NetOutput_write(&GDL90_NetOut, buf, size);
+    break;
+  default:
+    break;
+  }
+}
+
+/* (re)open network output servers as the settings require */
+static void RPi_NetOut_setup()
+{
+  NetOutput_begin(&NMEA_NetOut,
+                  settings->nmea_out == NMEA_UDP  ? NMEA_UDP_PORT  : 0,
+                  settings->nmea_out == NMEA_TCP  ? NMEA_TCP_PORT  : 0);
+  NetOutput_begin(&GDL90_NetOut,
+                  settings->gdl90    == GDL90_UDP ? GDL90_DST_PORT : 0,
+                  settings->gdl90    == GDL90_TCP ? GDL90_TCP_PORT : 0);
+
+  RPi_Loop_watch(NMEA_NetOut.epfd,  RPI_EV_NETOUT);
+  RPi_Loop_watch(GDL90_NetOut.epfd, RPI_EV_NETOUT);
+}
+
+/* one sendmmsg() per export cycle, TCP clients are served without blocking */
+static void RPi_NetOut_loop()
+{
+  NetOutput_poll(&NMEA_NetOut, 0);
+  NetOutput_flush(&NMEA_NetOut);
+  NetOutput_poll(&GDL90_NetOut, 0);
+  NetOutput_flush(&GDL90_NetOut);
+}
+
+static void RPi_NetOut_fini()
+{
+  NetOutput_end(&NMEA_NetOut);
+  NetOutput_end(&GDL90_NetOut);
 }
 
 static void RPi_SPI_begin()
@@ -484,6 +561,7 @@ static float RPi_Battery_param(uint8_t param)
 
 void RPi_GNSS_PPS_Interrupt_handler() {
   PPS_TimeMarker = millis();
+  PPS_TimeMarker_us = micros();
 }
 
 static unsigned long RPi_get_PPS_TimeMarker() {
@@ -591,23 +669,271 @@ const SoC_ops_t RPi_ops = {
   NULL
 };
 
-static bool inputAvailable()
+/*
+ * The main loop sleeps in epoll_wait() until there is something to do:
+ * input on stdin, a message to the traffic TCP server, a sample buffer
+ * from SDR, Rx done edge on DIO0 of SX1276, a client of network output,
+ * or the nearest deadline - export tick, Tx time or, while a radio IC
+ * is polled over SPI or UART, next RPI_LOOP_TICK_MS.
+ */
+#define RPI_LOOP_TICK_MS      10   /* Rx slot windows are followed this close */
+#define RPI_LOOP_IDLE_MS      1000
+#define RPI_LOOP_MAX_EVENTS   8
+#define RPI_STDIN_BUF_MAX     65536
+
+static int  RPi_Loop_fd       = -1;
+static int  RPi_Traffic_fd    = -1;
+static int  RPi_DIO_fd        = -1;
+static bool RPi_Loop_Tick     = true;
+static bool RPi_Stdin_watched = false;
+static bool RPi_Stdin_file    = false; /* regular file, can not be watched */
+
+static std::string input_pending;
+
+rpi_loop_stats_t RPi_Loop_Stats = { 0, 0, 0, 0 };
+
+static struct {
+  unsigned long window;     /* start of measurement window, ms */
+  uint64_t      cpu_us;     /* process CPU time at start of the window */
+  uint32_t      wakeups;
+  uint64_t      lat_sum_us;
+  uint32_t      lat_num;
+  uint32_t      lat_max_us;
+} RPi_Loop_Acc;
+
+static bool RPi_Loop_watch(int fd, uint32_t tag)
+{
+  struct epoll_event ev;
+
+  if (RPi_Loop_fd < 0 || fd < 0) {
+    return false;
+  }
+
+  ev.events   = EPOLLIN;
+  ev.data.u32 = tag;
+
+  return epoll_ctl(RPi_Loop_fd, EPOLL_CTL_ADD, fd, &ev) == 0 || errno == EEXIST;
+}
+
+#if defined(USE_GPIO_LINE_EVENTS)
+static int RPi_DIO_open(unsigned int line)
+{
+  struct gpioevent_request req;
+  int fd = open("/dev/gpiochip0", O_RDONLY | O_CLOEXEC);
+
+  if (fd < 0) {
+    return -1;
+  }
+
+  memset(&req, 0, sizeof(req));
+  req.lineoffset  = line;
+  req.handleflags = GPIOHANDLE_REQUEST_INPUT;
+  req.eventflags  = GPIOEVENT_REQUEST_RISING_EDGE;
+  strncpy(req.consumer_label, "SoftRF DIO0", sizeof(req.consumer_label) - 1);
+
+  int rval = ioctl(fd, GPIO_GET_LINEEVENT_IOCTL, &req);
+  close(fd);
+
+  return rval < 0 ? -1 : req.fd;
+}
+#endif /* USE_GPIO_LINE_EVENTS */
+
+static uint64_t RPi_CPU_time_us()
+{
+  struct rusage ru;
+
+  getrusage(RUSAGE_SELF, &ru);
+
+  return (uint64_t) (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000 +
+                     ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+static void RPi_Loop_latency(uint32_t us)
+{
+  RPi_Loop_Acc.lat_sum_us += us;
+  RPi_Loop_Acc.lat_num++;
+  if (us > RPi_Loop_Acc.lat_max_us) {
+    RPi_Loop_Acc.lat_max_us = us;
+  }
+}
+
+static void RPi_Loop_setup()
+{
+  RPi_Loop_fd = epoll_create1(EPOLL_CLOEXEC);
+  if (RPi_Loop_fd < 0) {
+    perror("epoll_create1");
+    exit(EXIT_FAILURE);
+  }
+
+  if (RPi_Loop_watch(STDIN_FILENO, RPI_EV_STDIN)) {
+    RPi_Stdin_watched = true;
+  } else if (errno == EPERM) {
+    RPi_Stdin_file    = true;
+  }
+
+  RPi_Traffic_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (RPi_Loop_watch(RPi_Traffic_fd, RPI_EV_TRAFFIC)) {
+    Traffic_TCP_Server.setNotify(RPi_Traffic_fd);
+  }
+
+#if defined(ENABLE_RTLSDR) || defined(ENABLE_HACKRF) || defined(ENABLE_MIRISDR)
+  if (hw_info.rf == RF_IC_R820T   ||
+      hw_info.rf == RF_IC_MAX2837 ||
+      hw_info.rf == RF_IC_MSI001) {
+    RPi_Loop_watch(fifo_notify_fd(), RPI_EV_SDR);
+    /* nothing to poll: Mode S decoder is fed by the FIFO */
+    RPi_Loop_Tick = false;
+  }
+#endif /* ENABLE_RTLSDR || ENABLE_HACKRF || ENABLE_MIRISDR */
+
+#if defined(USE_GPIO_LINE_EVENTS)
+  /* SX1126x shares this pin as BUSY, only SX1276 raises Rx done on it */
+  if (hw_info.rf == RF_IC_SX1276 && SOC_GPIO_PIN_DIO0 != SOC_UNUSED_PIN) {
+    RPi_DIO_fd = RPi_DIO_open(SOC_GPIO_PIN_DIO0);
+    RPi_Loop_watch(RPi_DIO_fd, RPI_EV_DIO);
+  }
+#endif /* USE_GPIO_LINE_EVENTS */
+
+  RPi_Loop_Acc.window = millis();
+  RPi_Loop_Acc.cpu_us = RPi_CPU_time_us();
+}
+
+/* a deadline counts only when it is ahead, late ones are served by this pass */
+static void RPi_Loop_deadline(long *timeout, unsigned long marker)
+{
+  long dt = (long) (marker - millis());
+
+  if (dt > 0 && dt < *timeout) {
+    *timeout = dt;
+  }
+}
+
+static void RPi_Loop_wait()
+{
+  struct epoll_event ev[RPI_LOOP_MAX_EVENTS];
+  long timeout = RPi_Loop_Tick ? RPI_LOOP_TICK_MS : RPI_LOOP_IDLE_MS;
+
+  RPi_Loop_deadline(&timeout, ExportTimeMarker + 1001);
+  if (settings->txpower != RF_TX_POWER_OFF) {
+    RPi_Loop_deadline(&timeout, TxTimeMarker + 1);
+  }
+
+  if (RPi_Stdin_file || input_pending.find('\n') != std::string::npos) {
+    timeout = 0;
+  }
+
+  uint32_t deadline_us = micros() + timeout * 1000;
+  int n = epoll_wait(RPi_Loop_fd, ev, RPI_LOOP_MAX_EVENTS, (int) timeout);
+
+  if (n == 0 && timeout > 0) {
+    int32_t late = (int32_t) (micros() - deadline_us);
+    RPi_Loop_latency(late > 0 ? late : 0);
+  }
+
+  bool stdin_ready = RPi_Stdin_file;
+
+  for (int i = 0; i < n; i++) {
+    switch (ev[i].data.u32)
+    {
+    case RPI_EV_STDIN:
+      stdin_ready = true;
+      break;
+    case RPI_EV_TRAFFIC:
+      {
+        uint64_t count;
+        if (read(RPi_Traffic_fd, &count, sizeof(count)) < 0) { /* spurious */ }
+      }
+      break;
+#if defined(USE_GPIO_LINE_EVENTS)
+    case RPI_EV_DIO:
+      {
+        struct gpioevent_data event;
+        struct timespec ts;
+
+        if (read(RPi_DIO_fd, &event, sizeof(event)) == sizeof(event)) {
+          clock_gettime(CLOCK_MONOTONIC, &ts);
+          int64_t d = (int64_t) ts.tv_sec * 1000000000LL + ts.tv_nsec -
+                      (int64_t) event.timestamp;
+          /* older kernels stamp events with CLOCK_REALTIME */
+          if (d >= 0 && d < 1000000000LL) {
+            RPi_Loop_latency(d / 1000);
+          }
+        }
+      }
+      break;
+#endif /* USE_GPIO_LINE_EVENTS */
+    case RPI_EV_SDR:
+    case RPI_EV_NETOUT:
+    default:
+      /* served by ModeS_demod_loop() and RPi_NetOut_loop() */
+      break;
+    }
+  }
+
+  if (stdin_ready) {
+    char buf[4096];
+    ssize_t len = read(STDIN_FILENO, buf, sizeof(buf));
+
+    if (len > 0) {
+      if (input_pending.length() + len > RPI_STDIN_BUF_MAX) {
+        input_pending.clear(); /* no line end in sight, or nobody reads */
+      }
+      input_pending.append(buf, len);
+    } else if (len == 0 || (errno != EAGAIN && errno != EINTR)) {
+      /* end of input */
+      if (RPi_Stdin_watched) {
+        epoll_ctl(RPi_Loop_fd, EPOLL_CTL_DEL, STDIN_FILENO, NULL);
+        RPi_Stdin_watched = false;
+      }
+      RPi_Stdin_file = false;
+    }
+  }
+
+  RPi_Loop_Acc.wakeups++;
+
+  unsigned long window = millis() - RPi_Loop_Acc.window;
+
+  if (window >= 1000) {
+    uint64_t cpu_us = RPi_CPU_time_us();
+
+    RPi_Loop_Stats.cpu        = (cpu_us - RPi_Loop_Acc.cpu_us) / window;
+    RPi_Loop_Stats.wakeups    = RPi_Loop_Acc.wakeups * 1000 / window;
+    RPi_Loop_Stats.lat_avg_us = RPi_Loop_Acc.lat_num ?
+                                RPi_Loop_Acc.lat_sum_us / RPi_Loop_Acc.lat_num : 0;
+    RPi_Loop_Stats.lat_max_us = RPi_Loop_Acc.lat_max_us;
+
+    memset(&RPi_Loop_Acc, 0, sizeof(RPi_Loop_Acc));
+    RPi_Loop_Acc.window = millis();
+    RPi_Loop_Acc.cpu_us = cpu_us;
+  }
+}
+
+/* next complete line of stdin input, if any */
+static bool RPi_Input_line()
 {
-  struct timeval tv;
-  fd_set fds;
-  tv.tv_sec = 0;
-  tv.tv_usec = 0;
-  FD_ZERO(&fds);
-  FD_SET(STDIN_FILENO, &fds);
-  select(STDIN_FILENO+1, &fds, NULL, NULL, &tv);
-  return (FD_ISSET(0, &fds));
+  size_t nl = input_pending.find('\n');
+
+  if (nl == std::string::npos) {
+    return false;
+  }
+
+  input_line.assign(input_pending, 0, nl);
+  input_pending.erase(0, nl + 1);
+
+  return true;
 }
 
 static void parseNMEA(const char *str, int len)
 {
-  // NMEA input
-  for (int i=0; i < len; i++) {
-    gnss.encode(str[i]);
+  /* strip CR left by std::getline() */
+  int cs_len = (len > 0 && str[len-1] == '\r') ? len - 1 : len;
+
+  // NMEA input, GGA and RMC only
+  if (GNSS_NMEA_wanted((const uint8_t *) str, cs_len)) {
+    for (int i=0; i < cs_len; i++) {
+      gnss.encode(str[i]);
+    }
+    gnss.encode('\r');
   }
   if (settings->nmea_g) {
     NMEA_Out(settings->nmea_out, (byte *) str, len, true);
@@ -640,8 +966,7 @@ static void parseNMEA(const char *str, int len)
 
 static void RPi_PickGNSSFix()
 {
-  if (inputAvailable()) {
-    std::getline(std::cin, input_line);
+  while (RPi_Input_line()) {
     const char *str = input_line.c_str();
     int len = input_line.length();
 
@@ -666,6 +991,7 @@ static void RPi_PickGNSSFix()
 
           RF_setup();
           Traffic_setup();
+          RPi_NetOut_setup();
         }
       }
 
@@ -712,6 +1038,7 @@ static void RPi_ReadTraffic()
 
           RF_setup();
           Traffic_setup();
+          RPi_NetOut_setup();
         }
       }
 
@@ -738,6 +1065,7 @@ static void RPi_ReadTraffic()
     } else if (str[0] == 'q') {
       if (len >= 4 && str[1] == 'u' && str[2] == 'i' && str[3] == 't') {
         Traffic_TCP_Server.detach();
+        RPi_NetOut_fini();
         fprintf( stderr, "Program termination.\n" );
         exit(EXIT_SUCCESS);
       }
@@ -750,47 +1078,54 @@ static void RPi_ReadTraffic()
 void normal_loop()
 {
     /* Read GNSS data from standard input */
-    RPi_PickGNSSFix();
+    PROFILE(PROF_GNSS, RPi_PickGNSSFix());
 
     /* Read NMEA data from GNSS module on GPIO pins */
 //    PickGNSSFix();
 
     RPi_ReadTraffic();
 
-    RF_loop();
-
     ThisAircraft.timestamp = now();
 
-    if (isValidFix()) {
-      RF_Transmit(RF_Encode(&ThisAircraft), true);
+    /* one view of ownship for the whole radio part of the pass */
+    GNSS_Ownship_View(&Ownship, &ThisAircraft, isValidFix());
+
+    PROFILE(PROF_RF, RF_loop(&Ownship));
+
+    if (Ownship.valid) {
+      PROFILE(PROF_TX, RF_Transmit(RF_Encode(&Ownship.fo), true));
     }
 
-    bool success = RF_Receive();
+    bool success;
 
-    if (success && isValidFix()) ParseData();
+    PROFILE(PROF_RX, success = RF_Receive());
 
-    if (isValidFix()) {
-      Traffic_loop();
+    if (success && Ownship.valid) PROFILE(PROF_PARSE, ParseData(&Ownship.fo));
+
+    if (Ownship.valid) {
+      PROFILE(PROF_TRAFFIC, Traffic_loop(&Ownship.fo));
     }
 
     if (isTimeToExport()) {
 
-      NMEA_Export();
-      GDL90_Export();
-      D1090_Export();
+      PROFILE(PROF_EXPORT, {
+        NMEA_Export();
+        GDL90_Export();
+        D1090_Export();
 
-      if (isValidFix()) {
-        JSON_Export();
-      }
+        if (isValidFix()) {
+          JSON_Export();
+        }
+      });
       ExportTimeMarker = millis();
     }
 
     // Handle Air Connect
-    NMEA_loop();
+    PROFILE(PROF_NMEA, NMEA_loop());
 
-    SoC->Display_loop();
+    PROFILE(PROF_DISPLAY, SoC->Display_loop());
 
-    ClearExpired();
+    ClearExpired(&Ownship.fo);
 }
 
 void relay_loop()
@@ -803,7 +1138,8 @@ void relay_loop()
 
     RPi_ReadTraffic();
 
-    RF_loop();
+    GNSS_Ownship_View(&Ownship, &ThisAircraft, isValidFix());
+    RF_loop(&Ownship);
 
     for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
       size_t size = RF_Payload_Size(settings->rf_protocol);
@@ -870,7 +1206,8 @@ void txrx_test_loop()
 
   RPi_ReadTraffic();
 
-  RF_loop();
+  GNSS_Ownship_View(&Ownship, &ThisAircraft, isValidFix());
+  RF_loop(&Ownship);
 
   ThisAircraft.timestamp = now();
 
@@ -904,12 +1241,12 @@ void txrx_test_loop()
 #if DEBUG_TIMING
   parse_start_ms = millis();
 #endif
-  if (success) ParseData();
+  if (success) ParseData(&ThisAircraft);
 #if DEBUG_TIMING
   parse_end_ms = millis();
 #endif
 
-  Traffic_loop();
+  Traffic_loop(&ThisAircraft);
 
 #if DEBUG_TIMING
   export_start_ms = millis();
@@ -956,7 +1293,7 @@ void txrx_test_loop()
   // Handle Air Connect
   NMEA_loop();
 
-  ClearExpired();
+  ClearExpired(&ThisAircraft);
 }
 
 
@@ -1090,6 +1427,12 @@ int main()
   Traffic_setup();
   NMEA_setup();
 
+  RPi_Loop_setup();
+
+  NetOutput_init(&NMEA_NetOut);
+  NetOutput_init(&GDL90_NetOut);
+  RPi_NetOut_setup();
+
   Traffic_TCP_Server.setup(JSON_SRV_TCP_PORT);
 
   pthread_t traffic_tcpserv_thread;
@@ -1102,7 +1445,17 @@ int main()
 
   SoC->WDT_setup();
 
+#if defined(ENABLE_PROFILER)
+  Profiler_setup();
+#endif /* ENABLE_PROFILER */
+
   while (true) {
+    RPi_Loop_wait();
+
+#if defined(ENABLE_PROFILER)
+    Profiler_loop();
+#endif /* ENABLE_PROFILER */
+
     switch (settings->mode)
     {
     case SOFTRF_MODE_TXRX_TEST:
@@ -1123,6 +1476,8 @@ int main()
 
     SoC->loop();
 
+    PROFILE(PROF_IO, RPi_NetOut_loop());
+
 #if defined(TAKE_CARE_OF_MILLIS_ROLLOVER)
     /* take care of millis() rollover on a long term run */
     if (millis() > (47 * 24 * 3600 * 1000UL)) {
@@ -1159,6 +1514,7 @@ void shutdown(int reason)
   }
 
   Traffic_TCP_Server.detach();
+  RPi_NetOut_fini();
   fprintf( stderr, "Program termination. Reason code: %d.\n", reason );
   exit(EXIT_SUCCESS);
 }
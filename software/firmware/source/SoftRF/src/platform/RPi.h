@@ -113,6 +113,9 @@ extern const char *Hardware_Rev[];
 #define EXCLUDE_LK8EX1
 
 #define USE_NMEALIB
+#define USE_NET_OUTPUT
+#define USE_EVENT_LOOP
+#define ENABLE_PROFILER
 //#define USE_EPAPER
 
 #define TAKE_CARE_OF_MILLIS_ROLLOVER
@@ -139,6 +142,7 @@ extern const char *Hardware_Rev[];
 /* Experimental */
 #define ENABLE_ADSL
 //#define ENABLE_PROL
+#define ENABLE_MULTI_RX
 
 //#define USE_OGN_RF_DRIVER
 //#define WITH_RFM95
@@ -150,6 +154,27 @@ extern const char *Hardware_Rev[];
 typedef void* EPD_Task_t;
 #endif /* USE_EPAPER */
 
+extern void RPi_TCP_transmit(int, uint8_t *, size_t);
+
+/* wake-up sources of the main loop */
+enum
+{
+	RPI_EV_STDIN,
+	RPI_EV_TRAFFIC,
+	RPI_EV_SDR,
+	RPI_EV_DIO,
+	RPI_EV_NETOUT
+};
+
+typedef struct rpi_loop_stats_struct {
+  uint16_t  cpu;          /* process CPU load, permille of one core */
+  uint16_t  wakeups;      /* per second */
+  uint32_t  lat_avg_us;   /* wake-up latency: past deadline or DIO0 edge */
+  uint32_t  lat_max_us;
+} rpi_loop_stats_t;
+
+extern rpi_loop_stats_t RPi_Loop_Stats;
+
 #endif /* PLATFORM_RPI_H */
 
 #endif /* RASPBERRY_PI */
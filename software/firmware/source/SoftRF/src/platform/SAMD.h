@@ -23,7 +23,7 @@
 #include <avr/dtostrf.h>
 
 /* Maximum of tracked flying objects is now SoC-specific constant */
-#define MAX_TRACKING_OBJECTS    8
+#define MAX_TRACKING_OBJECTS    9
 
 #define DEFAULT_SOFTRF_MODEL    SOFTRF_MODEL_ACADEMY
 
@@ -1200,6 +1200,11 @@ static size_t STM32_USB_write(const uint8_t *buffer, size_t size)
   return SerialUSB.write(buffer, size);
 }
 
+static int STM32_USB_availableForWrite()
+{
+  return SerialUSB.availableForWrite();
+}
+
 IODev_ops_t STM32_USBSerial_ops = {
   "STM32 USBSerial",
   STM32_USB_setup,
@@ -1207,7 +1212,8 @@ IODev_ops_t STM32_USBSerial_ops = {
   STM32_USB_fini,
   STM32_USB_available,
   STM32_USB_read,
-  STM32_USB_write
+  STM32_USB_write,
+  STM32_USB_availableForWrite
 };
 
 #endif /* USBD_USE_CDC */
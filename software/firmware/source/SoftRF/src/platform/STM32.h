@@ -31,7 +31,7 @@ extern char *dtostrf_workaround(double, signed char, unsigned char, char *);
 #endif /* ARDUINO_ARCH_STM32 */
 
 /* Maximum of tracked flying objects is now SoC-specific constant */
-#define MAX_TRACKING_OBJECTS    8
+#define MAX_TRACKING_OBJECTS    11
 
 #define DEFAULT_SOFTRF_MODEL    SOFTRF_MODEL_RETRO
 
@@ -230,6 +230,7 @@ typedef struct stm32_backup_struct {
 #define EXCLUDE_IMU
 #define EXCLUDE_MAG
 #define EXCLUDE_TRAFFIC_FILTER_EXTENSION
+#define EXCLUDE_TRAFFIC_FUSION
 #define EXCLUDE_AIR7             //  -1.8 kb
 //#define USE_OGN_RF_DRIVER
 //#define WITH_RFM95
@@ -294,6 +295,8 @@ typedef struct stm32_backup_struct {
 /* Experimental */
 #define ENABLE_ADSL
 #define ENABLE_PROL
+#define ENABLE_OUTPUT_QUEUE
+#define OUTPUT_QUEUE_SIZE     1024
 
 #elif defined(ARDUINO_WisDuo_RAK3172_Evaluation_Board)
 
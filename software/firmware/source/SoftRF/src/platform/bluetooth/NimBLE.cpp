@@ -38,6 +38,9 @@
 #include "../../driver/Bluetooth.h"
 #include "../../driver/WiFi.h"
 #include "../../driver/Battery.h"
+#include "../../protocol/data/NMEA.h"
+#include "../../protocol/data/GDL90.h"
+#include "../../protocol/data/D1090.h"
 
 #include <core_version.h>
 
@@ -61,9 +64,13 @@ NimBLECharacteristic* pMIDICharacteristic = NULL;
 
 cbuf *BLE_FIFO_RX, *BLE_FIFO_TX;
 
+/* notification payload, follows negotiated ATT MTU */
+static size_t BLE_Chunk_Size = BLE_MAX_WRITE_CHUNK_SIZE;
+
 String BT_name = HOSTNAME;
 
 static unsigned long BLE_Notify_TimeMarker = 0;
+static unsigned long BLE_Hold_TimeMarker = 0;
 static unsigned long BLE_Advertising_TimeMarker = 0;
 
 // NimBLEDescriptor UserDescriptor(NimBLEUUID((uint16_t)0x2901));
@@ -73,6 +80,18 @@ class MyServerCallbacks: public NimBLEServerCallbacks {
       deviceConnected = true;
     };
 
+    void onConnect(NimBLEServer* pServer, ble_gap_conn_desc* desc) {
+      BLE_Chunk_Size = BLE_MAX_WRITE_CHUNK_SIZE;
+      /* data length extension, when the peer supports it */
+      pServer->setDataLen(desc->conn_handle, BLE_MAX_DATA_LEN);
+    };
+
+    void onMTUChange(uint16_t MTU, ble_gap_conn_desc* desc) {
+      size_t size = MTU - 3; /* ATT header */
+      BLE_Chunk_Size = size < BLE_MAX_WRITE_CHUNK_SIZE ? BLE_MAX_WRITE_CHUNK_SIZE :
+                       size > BLE_MAX_MTU - 3 ? BLE_MAX_MTU - 3 : size;
+    };
+
     void onDisconnect(NimBLEServer* pServer) {
       deviceConnected = false;
       BLE_Advertising_TimeMarker = millis();
@@ -111,10 +130,10 @@ static void ESP32_Bluetooth_setup()
       NimBLEDevice::init((BT_name+"-LE").c_str());
 
       /*
-       * Set the MTU of the packets sent,
-       * maximum is 500, Apple needs 23 apparently.
+       * Preferred MTU of the packets sent. A peer that does not
+       * ask for a larger one (or can not) stays at 23.
        */
-      // NimBLEDevice::setMTU(23);
+      NimBLEDevice::setMTU(BLE_MAX_MTU);
 
       // Create the BLE Server
       pServer = NimBLEDevice::createServer();
@@ -260,6 +279,23 @@ static void ESP32_Bluetooth_setup()
   }
 }
 
+/*
+ * Notifications end on a message boundary, so that a client which parses
+ * every notification on its own never sees a torn NMEA sentence or GDL90
+ * frame. GDL90 is binary, it is aligned on flags only when it is alone.
+ */
+static uint8_t BLE_Framing()
+{
+  bool text = settings->nmea_out == NMEA_BLUETOOTH ||
+              settings->d1090    == D1090_BLUETOOTH;
+
+  if (settings->gdl90 == GDL90_BLUETOOTH) {
+    return text ? BLUETOOTH_FRAMING_NONE : BLUETOOTH_FRAMING_GDL90;
+  }
+
+  return BLUETOOTH_FRAMING_TEXT;
+}
+
 static void ESP32_Bluetooth_loop()
 {
   switch (settings->bluetooth)
@@ -270,9 +306,17 @@ static void ESP32_Bluetooth_loop()
       // bluetooth stack will go into congestion, if too many packets are sent
       if (deviceConnected && (millis() - BLE_Notify_TimeMarker > 10)) { /* < 18000 baud */
 
-          uint8_t chunk[BLE_MAX_WRITE_CHUNK_SIZE];
-          size_t size = BLE_FIFO_TX->available();
-          size = size < BLE_MAX_WRITE_CHUNK_SIZE ? size : BLE_MAX_WRITE_CHUNK_SIZE;
+          uint8_t chunk[BLE_MAX_MTU - 3];
+          size_t avail = BLE_FIFO_TX->peek((char *) chunk, BLE_Chunk_Size);
+          size_t size  = Bluetooth_Chunk_Align(chunk, avail,
+                                               avail == BLE_Chunk_Size,
+                                               BLE_Framing());
+
+          /* a tail that the writer never finished goes out as it is */
+          if (size == 0 && avail > 0 &&
+              millis() - BLE_Hold_TimeMarker > BLE_CHUNK_HOLD_MS) {
+            size = avail;
+          }
 
           if (size > 0) {
             BLE_FIFO_TX->read((char *) chunk, size);
@@ -280,6 +324,9 @@ static void ESP32_Bluetooth_loop()
             pUARTCharacteristic->setValue(chunk, size);
             pUARTCharacteristic->notify();
           }
+          if (size > 0 || avail == 0) {
+            BLE_Hold_TimeMarker = millis();
+          }
 
           BLE_Notify_TimeMarker = millis();
       }
@@ -335,6 +382,25 @@ static int ESP32_Bluetooth_available()
   return rval;
 }
 
+static int ESP32_Bluetooth_availableForWrite()
+{
+  int rval = 0;
+
+  switch (settings->bluetooth)
+  {
+  case BLUETOOTH_LE_HM10_SERIAL:
+    rval = BLE_FIFO_TX->room();
+    break;
+  case BLUETOOTH_NONE:
+  case BLUETOOTH_A2DP_SOURCE:
+  case BLUETOOTH_SPP:
+  default:
+    break;
+  }
+
+  return rval;
+}
+
 static int ESP32_Bluetooth_read()
 {
   int rval = -1;
@@ -361,8 +427,9 @@ static size_t ESP32_Bluetooth_write(const uint8_t *buffer, size_t size)
   switch (settings->bluetooth)
   {
   case BLUETOOTH_LE_HM10_SERIAL:
-    rval = BLE_FIFO_TX->write((char *) buffer,
-                        (BLE_FIFO_TX->room() > size ? size : BLE_FIFO_TX->room()));
+    /* whole message or nothing, a torn sentence is worse than a lost one */
+    rval = BLE_FIFO_TX->room() < size ? 0 :
+           BLE_FIFO_TX->write((char *) buffer, size);
     break;
   case BLUETOOTH_NONE:
   case BLUETOOTH_A2DP_SOURCE:
@@ -381,7 +448,8 @@ IODev_ops_t ESP32_Bluetooth_ops = {
   ESP32_Bluetooth_fini,
   ESP32_Bluetooth_available,
   ESP32_Bluetooth_read,
-  ESP32_Bluetooth_write
+  ESP32_Bluetooth_write,
+  ESP32_Bluetooth_availableForWrite
 };
 
 #endif /* USE_NIMBLE */
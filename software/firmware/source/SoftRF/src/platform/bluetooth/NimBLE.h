@@ -48,7 +48,10 @@
 #define BLE_FIFO_TX_SIZE          1024
 #define BLE_FIFO_RX_SIZE          256
 
-#define BLE_MAX_WRITE_CHUNK_SIZE  20
+#define BLE_MAX_WRITE_CHUNK_SIZE  20  /* default ATT MTU (23) - 3 */
+#define BLE_MAX_MTU               247 /* fits one LL PDU with DLE */
+#define BLE_MAX_DATA_LEN          251
+#define BLE_CHUNK_HOLD_MS         250 /* of an unterminated tail */
 
 extern IODev_ops_t ESP32_Bluetooth_ops;
 
@@ -46,6 +46,7 @@
 #include "../system/Time.h"
 
 #include "uCDB.hpp"
+#include "../system/ADB.h"
 
 #if defined(USE_BLE_MIDI)
 #include <bluefruit.h>
@@ -324,6 +325,51 @@ extern float IMU_g;
 
 #if !defined(ARDUINO_ARCH_MBED)
 uCDB<FatVolume, File32> ucdb(fatfs);
+ADB<FatVolume, File32>  adb(fatfs);
+
+static uint32_t nRF52_ADB_records()
+{
+  return adb.isOpen() ? adb.recordsNumber() : ucdb.recordsNumber();
+}
+
+/*
+ * Binary ADB is preferred, legacy '|' separated CDB is a fallback
+ */
+static bool nRF52_ADB_lookup(uint32_t id, adb_record_t *rec)
+{
+  if (adb.isOpen()) {
+    return adb.find(id, rec);
+  }
+
+  char key[8];
+  char out[64];
+  uint8_t tokens[3] = { 0 };
+  int c, i = 0, token_cnt = 0;
+
+  snprintf(key, sizeof(key),"%06X", id);
+
+  if (ucdb.findKey(key, strlen(key)) != KEY_FOUND) {
+    return false;
+  }
+
+  while ((c = ucdb.readValue()) != -1 && i < (sizeof(out) - 1)) {
+    if (c == '|') {
+      if (token_cnt < (sizeof(tokens) - 1)) {
+        token_cnt++;
+        tokens[token_cnt] = i+1;
+      }
+      c = 0;
+    }
+    out[i++] = (char) c;
+  }
+  out[i] = 0;
+
+  strncpy(rec->mam, out + tokens[0], ADB_VALUE_MAX); rec->mam[ADB_VALUE_MAX] = 0;
+  strncpy(rec->reg, out + tokens[1], ADB_VALUE_MAX); rec->reg[ADB_VALUE_MAX] = 0;
+  strncpy(rec->cn,  out + tokens[2], ADB_VALUE_MAX); rec->cn [ADB_VALUE_MAX] = 0;
+
+  return true;
+}
 
 // Callback invoked when received READ10 command.
 // Copy disk's data to buffer (up to bufsize) and
@@ -1497,46 +1543,19 @@ static void nRF52_post_init()
     /* EPD back light off */
     digitalWrite(SOC_GPIO_PIN_EPD_BLGT, LOW);
 
-    char key[8];
-    char out[64];
-    uint8_t tokens[3] = { 0 };
-    cdbResult rt;
-    int c, i = 0, token_cnt = 0;
+    adb_record_t rec;
 
     int acfts;
     char *reg, *mam, *cn;
     reg = mam = cn = NULL;
 
     if (ADB_is_open) {
-      acfts = ucdb.recordsNumber();
-
-      snprintf(key, sizeof(key),"%06X", ThisAircraft.addr);
+      acfts = nRF52_ADB_records();
 
-      rt = ucdb.findKey(key, strlen(key));
-
-      switch (rt) {
-        case KEY_FOUND:
-          while ((c = ucdb.readValue()) != -1 && i < (sizeof(out) - 1)) {
-            if (c == '|') {
-              if (token_cnt < (sizeof(tokens) - 1)) {
-                token_cnt++;
-                tokens[token_cnt] = i+1;
-              }
-              c = 0;
-            }
-            out[i++] = (char) c;
-          }
-          out[i] = 0;
-
-          reg = out + tokens[1];
-          mam = out + tokens[0];
-          cn  = out + tokens[2];
-
-          break;
-
-        case KEY_NOT_FOUND:
-        default:
-          break;
+      if (nRF52_ADB_lookup(ThisAircraft.addr, &rec)) {
+        reg = rec.reg;
+        mam = rec.mam;
+        cn  = rec.cn;
       }
 
       reg = (reg != NULL) && strlen(reg) ? reg : (char *) "REG: N/A";
@@ -2960,6 +2979,7 @@ static float nRF52_Battery_param(uint8_t param)
 
 void nRF52_GNSS_PPS_Interrupt_handler() {
   PPS_TimeMarker = millis();
+  PPS_TimeMarker_us = micros();
 }
 
 static unsigned long nRF52_get_PPS_TimeMarker() {
@@ -3287,6 +3307,17 @@ static size_t nRF52_USB_write(const uint8_t *buffer, size_t size)
   return rval;
 }
 
+static int nRF52_USB_availableForWrite()
+{
+  int rval = 0;
+
+  if (USBSerial) {
+    rval = USBSerial.availableForWrite();
+  }
+
+  return rval;
+}
+
 IODev_ops_t nRF52_USBSerial_ops = {
   "nRF52 USBSerial",
   nRF52_USB_setup,
@@ -3294,7 +3325,8 @@ IODev_ops_t nRF52_USBSerial_ops = {
   nRF52_USB_fini,
   nRF52_USB_available,
   nRF52_USB_read,
-  nRF52_USB_write
+  nRF52_USB_write,
+  nRF52_USB_availableForWrite
 };
 
 static bool nRF52_ADB_setup()
@@ -3305,7 +3337,9 @@ static bool nRF52_ADB_setup()
 
     if (ui->adb == DB_OGN) {
       fileName = "/Aircrafts/ogn.cdb";
-      if (ucdb.open(fileName) != CDB_OK) {
+      if (adb.open("/Aircrafts/ogn.adb")) {
+        ADB_is_open = true;
+      } else if (ucdb.open(fileName) != CDB_OK) {
         Serial.print("Invalid OGN CDB: ");
         Serial.println(fileName);
       } else {
@@ -3314,7 +3348,9 @@ static bool nRF52_ADB_setup()
     }
     if (ui->adb == DB_FLN) {
       fileName = "/Aircrafts/fln.cdb";
-      if (ucdb.open(fileName) != CDB_OK) {
+      if (adb.open("/Aircrafts/fln.adb")) {
+        ADB_is_open = true;
+      } else if (ucdb.open(fileName) != CDB_OK) {
         Serial.print("Invalid FLN CDB: ");
         Serial.println(fileName);
       } else {
@@ -3331,6 +3367,7 @@ static bool nRF52_ADB_fini()
 {
 #if !defined(ARDUINO_ARCH_MBED)
   if (ADB_is_open) {
+    adb.close();
     ucdb.close();
     ADB_is_open = false;
   }
@@ -3346,11 +3383,7 @@ static bool nRF52_ADB_fini()
  */
 static bool nRF52_ADB_query(uint8_t type, uint32_t id, char *buf, size_t size)
 {
-  char key[8];
-  char out[64];
-  uint8_t tokens[3] = { 0 };
-  cdbResult rt;
-  int c, i = 0, token_cnt = 0;
+  adb_record_t rec;
   bool rval = false;
 
   if (!ADB_is_open) {
@@ -3358,47 +3391,22 @@ static bool nRF52_ADB_query(uint8_t type, uint32_t id, char *buf, size_t size)
   }
 
 #if !defined(ARDUINO_ARCH_MBED)
-  snprintf(key, sizeof(key),"%06X", id);
-
-  rt = ucdb.findKey(key, strlen(key));
-
-  switch (rt) {
-    case KEY_FOUND:
-      while ((c = ucdb.readValue()) != -1 && i < (sizeof(out) - 1)) {
-        if (c == '|') {
-          if (token_cnt < (sizeof(tokens) - 1)) {
-            token_cnt++;
-            tokens[token_cnt] = i+1;
-          }
-          c = 0;
-        }
-        out[i++] = (char) c;
-      }
-      out[i] = 0;
-
-      switch (ui->idpref)
-      {
-      case ID_TAIL:
-        snprintf(buf, size, "CN: %s",
-          strlen(out + tokens[2]) ? out + tokens[2] : "N/A");
-        break;
-      case ID_MAM:
-        snprintf(buf, size, "%s",
-          strlen(out + tokens[0]) ? out + tokens[0] : "Unknown");
-        break;
-      case ID_REG:
-      default:
-        snprintf(buf, size, "%s",
-          strlen(out + tokens[1]) ? out + tokens[1] : "REG: N/A");
-        break;
-      }
-
-      rval = true;
+  if (nRF52_ADB_lookup(id, &rec)) {
+    switch (ui->idpref)
+    {
+    case ID_TAIL:
+      snprintf(buf, size, "CN: %s", strlen(rec.cn) ? rec.cn : "N/A");
       break;
-
-    case KEY_NOT_FOUND:
+    case ID_MAM:
+      snprintf(buf, size, "%s", strlen(rec.mam) ? rec.mam : "Unknown");
+      break;
+    case ID_REG:
     default:
+      snprintf(buf, size, "%s", strlen(rec.reg) ? rec.reg : "REG: N/A");
       break;
+    }
+
+    rval = true;
   }
 #endif /* ARDUINO_ARCH_MBED */
 
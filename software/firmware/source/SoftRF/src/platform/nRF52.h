@@ -27,7 +27,7 @@
 #endif /* ARDUINO_ARCH_MBED */
 
 /* Maximum of tracked flying objects is now SoC-specific constant */
-#define MAX_TRACKING_OBJECTS    8
+#define MAX_TRACKING_OBJECTS    10
 
 #define DEFAULT_SOFTRF_MODEL    SOFTRF_MODEL_BADGE
 
@@ -255,6 +255,8 @@ struct rst_info {
 #define USE_OGN_ENCRYPTION
 #define ENABLE_ADSL
 #define ENABLE_PROL
+#define ENABLE_OUTPUT_QUEUE
+#define EXCLUDE_OUTPUT_QUEUE_UART /* Uart of the core can not tell Tx room */
 #if !defined(ARDUINO_ARCH_MBED)
 #define USE_BLE_MIDI
 #define ENABLE_REMOTE_ID
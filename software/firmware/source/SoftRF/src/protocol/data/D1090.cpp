@@ -20,21 +20,91 @@
 #include <TimeLib.h>
 
 #include "../../system/SoC.h"
+#include "../../system/Output.h"
 #include "D1090.h"
 #include "../../driver/GNSS.h"
 #include "GDL90.h"
 #include "../../driver/EEPROM.h"
 #include "../../TrafficHelper.h"
 
-#define ADDR_TO_HEX_STR(s, c) (s += ((c) < 0x10 ? "0" : "") + String((c), HEX))
+/* "*", frame in hex, ";\r\n" */
+#define D1090_FRAME_HEX_SIZE  (1 + 2 * sizeof(frame_data_t) + 3)
 
-#define DF17_FRAME_TO_HEX_STR(s)                        \
-      ({                                                \
-        for (int i=0; i < sizeof(frame_data_t); i++) {  \
-          byte c = df17.msg[i];                         \
-          s += (c < 0x10 ? "0" : "") + String(c, HEX);  \
-        }                                               \
-      })
+/* even and odd position, identification and velocity */
+static char D1090_Buf[4 * D1090_FRAME_HEX_SIZE];
+
+/*
+ * Identification frame depends on address, protocol and aircraft type only.
+ * It is kept in hex per Container entry and rebuilt when any of them changes.
+ */
+typedef struct d1090_ident_struct {
+  uint32_t  addr;
+  uint8_t   protocol;
+  uint8_t   aircraft_type;
+  char      hex[D1090_FRAME_HEX_SIZE];
+} d1090_ident_t;
+
+static d1090_ident_t D1090_Ident[MAX_TRACKING_OBJECTS];
+
+static const char D1090_Hex[] = "0123456789ABCDEF";
+
+static char *D1090_Frame_Hex(char *p, frame_data_t *df17)
+{
+  *p++ = '*';
+  for (int i=0; i < sizeof(frame_data_t); i++) {
+    byte c = df17->msg[i];
+    *p++ = D1090_Hex[c >> 4];
+    *p++ = D1090_Hex[c & 0xF];
+  }
+  *p++ = ';';
+  *p++ = '\r';
+  *p++ = '\n';
+
+  return p;
+}
+
+static char *D1090_Ident_Hex(char *p, int ndx)
+{
+  d1090_ident_t *ident = &D1090_Ident[ndx];
+  ufo_t *fop = &Container[ndx];
+
+  if (ident->addr          != fop->addr     ||
+      ident->protocol      != fop->protocol ||
+      ident->aircraft_type != fop->aircraft_type) {
+
+    unsigned char callsign[8 + 1];
+    const char *prefix = GDL90_CallSign_Prefix[fop->protocol];
+    size_t len = 0;
+
+    /*
+     * Protocol prefix, then 6 hex digits of address, upper case,
+     * as D1090 output has always named the traffic. 8 symbols at most.
+     */
+    memset(callsign, 0, sizeof(callsign));
+    while (*prefix && len < 8) {
+      callsign[len++] = toupper(*prefix++);
+    }
+    for (int shift = 20; shift >= 0 && len < 8; shift -= 4) {
+      callsign[len++] = D1090_Hex[(fop->addr >> shift) & 0xF];
+    }
+
+    frame_data_t df17 = make_aircraft_identification_frame(fop->addr,
+                          callsign,
+                          Category_Set_D,
+                          AT_TO_GDL90(fop->aircraft_type),
+                          DF17);
+
+    D1090_Frame_Hex(ident->hex, &df17);
+
+    ident->addr          = fop->addr;
+    ident->protocol      = fop->protocol;
+    ident->aircraft_type = fop->aircraft_type;
+  }
+
+  memcpy(p, ident->hex, D1090_FRAME_HEX_SIZE);
+
+  return p + D1090_FRAME_HEX_SIZE;
+}
 
 #if defined(ENABLE_D1090_INPUT)
 #include "../radio/ES1090.h"
@@ -47,24 +117,16 @@ static void D1090_Out(byte *buf, size_t size)
   switch(settings->d1090)
   {
   case D1090_UART:
-    if (SoC->UART_ops) {
-      SoC->UART_ops->write(buf, size);
-    } else {
-      SerialOutput.write(buf, size);
-    }
+    Output_write(Output_UART_ops(), buf, size, false, OUTPUT_PRIO_ROUTINE);
     break;
   case D1090_USB:
     {
-      if (SoC->USB_ops) {
-        SoC->USB_ops->write(buf, size);
-      }
+      Output_write(SoC->USB_ops, buf, size, false, OUTPUT_PRIO_ROUTINE);
     }
     break;
   case D1090_BLUETOOTH:
     {
-      if (SoC->Bluetooth_ops) {
-        SoC->Bluetooth_ops->write(buf, size);
-      }
+      Output_write(SoC->Bluetooth_ops, buf, size, false, OUTPUT_PRIO_ROUTINE);
     }
     break;
   case D1090_UDP:
@@ -79,20 +141,20 @@ void D1090_Export()
 {
   frame_data_t df17;
   float distance;
-  String str;
   time_t this_moment = now();
 
 #if defined(ENABLE_D1090_INPUT) || \
     defined(ENABLE_RTLSDR) || defined(ENABLE_HACKRF) || defined(ENABLE_MIRISDR)
   struct mode_s_aircraft *a;
+  ufo_t es_fo; /* fo belongs to Rx path */
 
   for (a = state.aircrafts; a; a = a->next) {
     if (a->even_cprtime && a->odd_cprtime &&
         abs((long) (a->even_cprtime - a->odd_cprtime)) <= MODE_S_INTERACTIVE_TTL * 1000 ) {
-      if (es1090_decode(a, &ThisAircraft, &fo)) {
-        memset(fo.raw, 0, sizeof(fo.raw));
-        Traffic_Update(&fo);
-        Traffic_Add(&fo);
+      es_fo = EmptyFO;
+      if (es1090_decode(a, &ThisAircraft, &es_fo)) {
+        Traffic_Update(&ThisAircraft, &es_fo);
+        Traffic_Add(&es_fo);
       }
     }
   }
@@ -122,37 +184,21 @@ void D1090_Export()
           }
           altitude *= _GPS_FEET_PER_METER;
 
+          char *p = D1090_Buf;
+
           df17 = make_air_position_frame(11, Container[i].addr,
             Container[i].latitude, Container[i].longitude,
             altitude, CPR_EVEN, DF17);
 
-          str = "*";
-          DF17_FRAME_TO_HEX_STR(str);
-          str += ";\r\n*";
+          p = D1090_Frame_Hex(p, &df17);
 
           df17 = make_air_position_frame(11, Container[i].addr,
             Container[i].latitude, Container[i].longitude,
             altitude, CPR_ODD, DF17);
 
-          DF17_FRAME_TO_HEX_STR(str);
-          str += ";\r\n*";
-
-          String callsign = String(GDL90_CallSign_Prefix[Container[i].protocol]);
-        
-          ADDR_TO_HEX_STR(callsign, (Container[i].addr >> 16) & 0xFF);
-          ADDR_TO_HEX_STR(callsign, (Container[i].addr >>  8) & 0xFF);
-          ADDR_TO_HEX_STR(callsign, (Container[i].addr      ) & 0xFF);
-
-          callsign.toUpperCase();
-
-          df17 = make_aircraft_identification_frame(Container[i].addr,
-            (unsigned char*) callsign.c_str(),
-            Category_Set_D,
-            AT_TO_GDL90(Container[i].aircraft_type),
-            DF17);
+          p = D1090_Frame_Hex(p, &df17);
 
-          DF17_FRAME_TO_HEX_STR(str);
-          str += ";\r\n*";
+          p = D1090_Ident_Hex(p, i);
 
           df17 = make_velocity_frame(Container[i].addr,
             Container[i].speed * cos(Container[i].course * PI / 180),
@@ -160,11 +206,9 @@ void D1090_Export()
             Container[i].vs,
             DF17);
 
-          DF17_FRAME_TO_HEX_STR(str);
-          str.toUpperCase();
-          str += ";\r\n";
+          p = D1090_Frame_Hex(p, &df17);
 
-          D1090_Out((byte *) str.c_str(), str.length());
+          D1090_Out((byte *) D1090_Buf, p - D1090_Buf);
         }
       }
     }
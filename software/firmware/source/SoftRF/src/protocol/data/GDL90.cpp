@@ -20,10 +20,10 @@
  */
 
 #include <TimeLib.h>
-#include <lib_crc.h>
 #include <protocol.h>
 
 #include "../../system/SoC.h"
+#include "../../system/Output.h"
 #include "GDL90.h"
 #include "../../driver/GNSS.h"
 #include "../../driver/EEPROM.h"
@@ -111,6 +111,32 @@ const GDL90_Msg_FF_ID_t msgFFid = {
 };
 #endif /* DO_GDL90_FF_EXT */
 
+#if defined(ENABLE_UBX_PVT)
+/*
+ * Navigation Accuracy Category for Position out of horizontal accuracy (mm).
+ * NACp bounds are 95% radii, u-blox hAcc is a 1-sigma estimate:
+ * 95% of a circular normal distribution lies within 2.45 sigma.
+ */
+static uint8_t makeNACp(uint32_t hAcc)
+{
+  uint64_t epu95 = (uint64_t) hAcc * 245 / 100;
+
+  static const uint32_t epu[] = {
+    /* NACp 11 ... 1 */
+    3000, 10000, 30000, 92600, 185200, 555600, 926000,
+    1852000, 3704000, 7408000, 18520000
+  };
+
+  for (uint8_t i = 0; i < sizeof(epu) / sizeof(epu[0]); i++) {
+    if (epu95 < epu[i]) {
+      return 11 - i;
+    }
+  }
+
+  return 0; /* unknown */
+}
+#endif /* ENABLE_UBX_PVT */
+
 /* convert a signed latitude to 2s complement ready for 24-bit packing */
 static uint32_t makeLatitude(float latitude)
 {
@@ -161,15 +187,60 @@ static uint32_t pack24bit(uint32_t num)
   return( ((num & 0xff0000) >> 16) | (num & 0x00ff00) | ((num & 0xff) << 16) );
 }
 
+/*
+ * CRC-CCITT (0x1021), GDL 90 Data Interface Specification, 2.2.3
+ */
+static const uint16_t gdl90_crc_table[256] PROGMEM = {
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+  0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+  0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+  0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+  0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+  0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+  0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+  0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+  0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+  0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+  0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+  0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+  0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+  0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+  0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+  0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+  0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+  0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+  0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+  0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+  0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+  0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+  0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+  0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+  0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+  0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+  0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+  0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+  0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+  0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+  0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+  0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0
+};
+
+#if !defined(pgm_read_word)
+#define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+#endif
+
+#define GDL90_CRC(crc, c) \
+  (pgm_read_word(&gdl90_crc_table[(crc) >> 8]) ^ ((crc) << 8) ^ (uint8_t) (c))
+
 uint16_t GDL90_calcFCS(uint8_t msg_id, uint8_t *msg, int size)
 {
   uint16_t crc16 = 0x0000;  /* seed value */
 
-  crc16 = update_crc_gdl90(crc16, msg_id);
+  crc16 = GDL90_CRC(crc16, msg_id);
 
   for (int i=0; i < size; i++)
   {
-    crc16 = update_crc_gdl90(crc16, msg[i]);
+    crc16 = GDL90_CRC(crc16, msg[i]);
   }    
 
   return(crc16);
@@ -189,6 +260,44 @@ uint8_t *GDL90_EscapeFilter(uint8_t *buf, uint8_t *p, int size)
   return (buf);
 }
 
+#define GDL90_STUFF(ptr, c)  do {                   \
+    if ((c) != 0x7D && (c) != 0x7E) {               \
+      *(ptr)++ = (c);                               \
+    } else {                                        \
+      *(ptr)++ = 0x7D;                              \
+      *(ptr)++ = (c) ^ 0x20;                        \
+    }                                               \
+  } while (0)
+
+/*
+ * Flags, message ID, message and FCS in one pass.
+ * 'buf' must have room for GDL90_FRAME_MAX(size) bytes.
+ */
+size_t GDL90_Frame(uint8_t *buf, uint8_t msg_id, const uint8_t *msg, int size)
+{
+  uint8_t *ptr = buf;
+  uint16_t crc16 = GDL90_CRC(0x0000, msg_id);
+  uint8_t c;
+
+  *ptr++ = 0x7E; /* Start flag */
+  *ptr++ = msg_id;
+
+  while (size--) {
+    c = *msg++;
+    crc16 = GDL90_CRC(crc16, c);
+    GDL90_STUFF(ptr, c);
+  }
+
+  c = crc16        & 0xFF;
+  GDL90_STUFF(ptr, c);
+  c = (crc16 >> 8) & 0xFF;
+  GDL90_STUFF(ptr, c);
+
+  *ptr++ = 0x7E; /* Stop flag */
+
+  return(ptr-buf);
+}
+
 static void *msgHeartbeat()
 {
   time_t ts = elapsedSecsToday(now());
@@ -276,6 +385,12 @@ static void *msgType10and20(ufo_t *aircraft)
   Traffic.nic           = 8 /* 0xa */;
   Traffic.nacp          = 8 /* 0xb */;
 
+#if defined(ENABLE_UBX_PVT)
+  if (aircraft == &ThisAircraft && GNSS_PVT_valid()) {
+    Traffic.nacp        = makeNACp(GNSS_PVT.hAcc);
+  }
+#endif /* ENABLE_UBX_PVT */
+
   /*
    * workaround against "implementation dependant"
    * XTENSA's GCC bitmap layout in structures
@@ -319,6 +434,17 @@ static void *msgOwnershipGeometricAltitude(ufo_t *aircraft)
 {
   uint16_t vfom = 0x000A;
 
+#if defined(ENABLE_UBX_PVT)
+  /*
+   * Vertical Figure of Merit, 95% bound in metres, 0x7FFE stands
+   * for > 32766 m. vAcc is a 1-sigma estimate, 95% is 1.96 sigma.
+   */
+  if (aircraft == &ThisAircraft && GNSS_PVT_valid()) {
+    uint32_t vacc = (uint32_t) (((uint64_t) GNSS_PVT.vAcc * 196 / 100 + 999) / 1000);
+    vfom = vacc < 0x7FFE ? vacc : 0x7FFE;
+  }
+#endif /* ENABLE_UBX_PVT */
+
 #if !defined(USE_GDL90_MSL)
   /*
    * The Geo Altitude field is a 16-bit signed integer that represents
@@ -345,103 +471,42 @@ static void *msgOwnershipGeometricAltitude(ufo_t *aircraft)
 
 static size_t makeHeartbeat(uint8_t *buf)
 {
-  uint8_t *ptr = buf;
-  uint8_t *msg = (uint8_t *) msgHeartbeat();
-  uint16_t fcs = GDL90_calcFCS(GDL90_HEARTBEAT_MSG_ID, msg,
-                               sizeof(GDL90_Msg_HeartBeat_t));
-  uint8_t fcs_lsb, fcs_msb;
-  
-  fcs_lsb = fcs        & 0xFF;
-  fcs_msb = (fcs >> 8) & 0xFF;
-
-  *ptr++ = 0x7E; /* Start flag */
-  *ptr++ = GDL90_HEARTBEAT_MSG_ID;
-  ptr = GDL90_EscapeFilter(ptr, msg, sizeof(GDL90_Msg_HeartBeat_t));
-  ptr = GDL90_EscapeFilter(ptr, &fcs_lsb, 1);
-  ptr = GDL90_EscapeFilter(ptr, &fcs_msb, 1);
-  *ptr++ = 0x7E; /* Stop flag */
-
-  return(ptr-buf);
+  return GDL90_Frame(buf, GDL90_HEARTBEAT_MSG_ID, (uint8_t *) msgHeartbeat(),
+                     sizeof(GDL90_Msg_HeartBeat_t));
 }
 
 static size_t makeType10and20(uint8_t *buf, uint8_t id, ufo_t *aircraft)
 {
-  uint8_t *ptr = buf;
-  uint8_t *msg = (uint8_t *) msgType10and20(aircraft);
-  uint16_t fcs = GDL90_calcFCS(id, msg, sizeof(GDL90_Msg_Traffic_t));
-  uint8_t fcs_lsb, fcs_msb;
-  
-  fcs_lsb = fcs        & 0xFF;
-  fcs_msb = (fcs >> 8) & 0xFF;
-
-  *ptr++ = 0x7E; /* Start flag */
-  *ptr++ = id;
-  ptr = GDL90_EscapeFilter(ptr, msg, sizeof(GDL90_Msg_Traffic_t));
-  ptr = GDL90_EscapeFilter(ptr, &fcs_lsb, 1);
-  ptr = GDL90_EscapeFilter(ptr, &fcs_msb, 1);
-  *ptr++ = 0x7E; /* Stop flag */
-
-  return(ptr-buf);
+  return GDL90_Frame(buf, id, (uint8_t *) msgType10and20(aircraft),
+                     sizeof(GDL90_Msg_Traffic_t));
 }
 
 static size_t makeGeometricAltitude(uint8_t *buf, ufo_t *aircraft)
 {
-  uint8_t *ptr = buf;
-  uint8_t *msg = (uint8_t *) msgOwnershipGeometricAltitude(aircraft);
-  uint16_t fcs = GDL90_calcFCS(GDL90_OWNGEOMALT_MSG_ID, msg,
-                               sizeof(GDL90_Msg_OwnershipGeometricAltitude_t));
-  uint8_t fcs_lsb, fcs_msb;
-
-  fcs_lsb = fcs        & 0xFF;
-  fcs_msb = (fcs >> 8) & 0xFF;
-
-  *ptr++ = 0x7E; /* Start flag */
-  *ptr++ = GDL90_OWNGEOMALT_MSG_ID;
-  ptr = GDL90_EscapeFilter(ptr, msg, sizeof(GDL90_Msg_OwnershipGeometricAltitude_t));
-  ptr = GDL90_EscapeFilter(ptr, &fcs_lsb, 1);
-  ptr = GDL90_EscapeFilter(ptr, &fcs_msb, 1);
-  *ptr++ = 0x7E; /* Stop flag */
-
-  return(ptr-buf);
+  return GDL90_Frame(buf, GDL90_OWNGEOMALT_MSG_ID,
+                     (uint8_t *) msgOwnershipGeometricAltitude(aircraft),
+                     sizeof(GDL90_Msg_OwnershipGeometricAltitude_t));
 }
 
 #if defined(DO_GDL90_FF_EXT)
 
 static size_t makeFFid(uint8_t *buf)
 {
-  uint8_t *ptr = buf;
-  uint8_t *msg = (uint8_t *) &msgFFid;
-  uint16_t fcs = GDL90_calcFCS(GDL90_FFEXT_MSG_ID, msg, sizeof(GDL90_Msg_FF_ID_t));
-  uint8_t fcs_lsb, fcs_msb;
-
-  fcs_lsb = fcs        & 0xFF;
-  fcs_msb = (fcs >> 8) & 0xFF;
-
-  *ptr++ = 0x7E; /* Start flag */
-  *ptr++ = GDL90_FFEXT_MSG_ID;
-  ptr = GDL90_EscapeFilter(ptr, msg, sizeof(GDL90_Msg_FF_ID_t));
-  ptr = GDL90_EscapeFilter(ptr, &fcs_lsb, 1);
-  ptr = GDL90_EscapeFilter(ptr, &fcs_msb, 1);
-  *ptr++ = 0x7E; /* Stop flag */
-
-  return(ptr-buf);
+  return GDL90_Frame(buf, GDL90_FFEXT_MSG_ID, (uint8_t *) &msgFFid,
+                     sizeof(GDL90_Msg_FF_ID_t));
 }
 #endif
 
 #define makeOwnershipReport(b,a)  makeType10and20(b, GDL90_OWNSHIP_MSG_ID, a)
 #define makeTrafficReport(b,a)    makeType10and20(b, GDL90_TRAFFIC_MSG_ID, a)
 
-static void GDL90_Out(byte *buf, size_t size)
+static void GDL90_Out(byte *buf, size_t size, uint8_t prio)
 {
   if (size > 0) {
     switch(settings->gdl90)
     {
     case GDL90_UART:
-      if (SoC->UART_ops) {
-        SoC->UART_ops->write(buf, size);
-      } else {
-        SerialOutput.write(buf, size);
-      }
+      Output_write(Output_UART_ops(), buf, size, false, prio);
       break;
     case GDL90_UDP:
       {
@@ -450,19 +515,23 @@ static void GDL90_Out(byte *buf, size_t size)
       break;
     case GDL90_USB:
       {
-        if (SoC->USB_ops) {
-          SoC->USB_ops->write(buf, size);
-        }
+        Output_write(SoC->USB_ops, buf, size, false, prio);
       }
       break;
     case GDL90_BLUETOOTH:
       {
-        if (SoC->Bluetooth_ops) {
-          SoC->Bluetooth_ops->write(buf, size);
-        }
+        Output_write(SoC->Bluetooth_ops, buf, size, false, prio);
       }
       break;
+#if defined(USE_NET_OUTPUT)
     case GDL90_TCP:
+      {
+        RPi_TCP_transmit(GDL90_TCP_PORT, buf, size);
+      }
+      break;
+#else
+    case GDL90_TCP:
+#endif /* USE_NET_OUTPUT */
     case GDL90_OFF:
     default:
       break;
@@ -470,50 +539,148 @@ static void GDL90_Out(byte *buf, size_t size)
   }
 }
 
+/*
+ * All frames of one export cycle are packed together, so that a cycle
+ * leaves as few UDP datagrams (or serial writes) as possible.
+ */
+#if GDL90_CYCLE_BUFSIZE > NMEA_BUFFER_SIZE
+static uint8_t GDL90_Cycle_Buf[GDL90_CYCLE_BUFSIZE];
+#else
+#define GDL90_Cycle_Buf ((uint8_t *) NMEABuffer)
+#endif
+
+static size_t  GDL90_Cycle_Len   = 0;
+static size_t  GDL90_Cycle_Limit = GDL90_CYCLE_BUFSIZE;
+static uint8_t GDL90_Cycle_Prio  = OUTPUT_PRIO_ROUTINE;
+static bool    GDL90_Cycle_Split = false; /* alarms in chunks of their own */
+
+gdl90_stats_t GDL90_Stats = { 0, 0, 0 };
+
+static void GDL90_Flush()
+{
+  if (GDL90_Cycle_Len > 0) {
+    GDL90_Out(GDL90_Cycle_Buf, GDL90_Cycle_Len, GDL90_Cycle_Prio);
+
+    GDL90_Stats.datagrams++;
+    GDL90_Stats.bytes += GDL90_Cycle_Len;
+
+    GDL90_Cycle_Len  = 0;
+    GDL90_Cycle_Prio = OUTPUT_PRIO_ROUTINE;
+  }
+}
+
+/* room for a frame of up to 'size' bytes long message */
+static uint8_t *GDL90_Room(size_t size)
+{
+  if (GDL90_Cycle_Len + GDL90_FRAME_MAX(size) > GDL90_Cycle_Limit) {
+    GDL90_Flush();
+  }
+
+  return &GDL90_Cycle_Buf[GDL90_Cycle_Len];
+}
+
+static void GDL90_Commit(size_t size, uint8_t prio)
+{
+  GDL90_Cycle_Len += size;
+  if (prio > GDL90_Cycle_Prio) {
+    GDL90_Cycle_Prio = prio;
+  }
+  GDL90_Stats.frames++;
+}
+
+static void GDL90_Traffic(time_t this_moment, bool alarm)
+{
+  size_t size;
+  uint8_t *buf;
+
+  for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+    if (Container[i].addr &&
+       (this_moment - Container[i].timestamp) <= EXPORT_EXPIRATION_TIME &&
+       (Container[i].alarm_level > ALARM_LEVEL_NONE) == alarm) {
+
+      /*
+       * Disable distance filter when we have no GNSS data source to locate
+       * own position. Assume that we never gonna fly over 'Null Island'.
+       */
+
+      if ((ThisAircraft.latitude == 0 && ThisAircraft.longitude == 0) ||
+          Container[i].distance < ALARM_ZONE_NONE) {
+        buf = GDL90_Room(sizeof(GDL90_Msg_Traffic_t));
+        size = makeTrafficReport(buf, &Container[i]);
+        GDL90_Commit(size, alarm ? OUTPUT_PRIO_ALARM : OUTPUT_PRIO_ROUTINE);
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+        Traffic_Fusion_Stats.gdl90_saved += Traffic_Fusion_Duplicates(i) * size;
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+      }
+    }
+  }
+}
+
 void GDL90_Export()
 {
   size_t size;
   time_t this_moment = now();
-  uint8_t *buf = (uint8_t *) (sizeof(UDPpacketBuffer) < UDP_PACKET_BUFSIZE ?
-                              NMEABuffer : UDPpacketBuffer);
+  uint8_t *buf;
 
   if (settings->gdl90 != GDL90_OFF) {
+
+    GDL90_Stats.frames    = 0;
+    GDL90_Stats.datagrams = 0;
+    GDL90_Stats.bytes     = 0;
+
+#if defined(ENABLE_OUTPUT_QUEUE)
+    /*
+     * Heartbeat, ownship and traffic with an alarm go first, in writes
+     * to serial transport of their own, which are no larger than the
+     * reserved room of the Tx queue. Routine messages never take that
+     * room, so the alarm writes of a cycle are refused only when they
+     * are more than OUTPUT_QUEUE_RESERVE bytes together - some 7
+     * alarmed targets with a 2K queue - or the queue was not drained
+     * since the alarm writes of the last cycle.
+     */
+    GDL90_Cycle_Split = settings->gdl90 != GDL90_UDP &&
+                        settings->gdl90 != GDL90_TCP;
+    GDL90_Cycle_Limit = !GDL90_Cycle_Split ||
+                        OUTPUT_QUEUE_RESERVE > GDL90_CYCLE_BUFSIZE ?
+                        GDL90_CYCLE_BUFSIZE : OUTPUT_QUEUE_RESERVE;
+#endif /* ENABLE_OUTPUT_QUEUE */
+
+    buf = GDL90_Room(sizeof(GDL90_Msg_HeartBeat_t));
     size = makeHeartbeat(buf);
-    GDL90_Out(buf, size);
+    GDL90_Commit(size, OUTPUT_PRIO_ALARM);
+
+    if (isValidFix()) {
+      buf = GDL90_Room(sizeof(GDL90_Msg_Traffic_t));
+      size = makeOwnershipReport(buf, &ThisAircraft);
+      GDL90_Commit(size, OUTPUT_PRIO_ALARM);
+    }
+
+    GDL90_Traffic(this_moment, true);
+
+    if (GDL90_Cycle_Split) {
+      GDL90_Flush();
+    }
 
 #if defined(DO_GDL90_FF_EXT)
+    buf = GDL90_Room(sizeof(GDL90_Msg_FF_ID_t));
     size = makeFFid(buf);
-    GDL90_Out(buf, size);
+    GDL90_Commit(size, OUTPUT_PRIO_ROUTINE);
 #endif /* DO_GDL90_FF_EXT */
 
 #if defined(ENABLE_AHRS)
+    buf = GDL90_Room(GDL90_MSG_MAX_SIZE);
     size = AHRS_GDL90(buf);
-    GDL90_Out(buf, size);
+    GDL90_Commit(size, OUTPUT_PRIO_ROUTINE);
 #endif /* ENABLE_AHRS */
 
     if (isValidFix()) {
-      size = makeOwnershipReport(buf, &ThisAircraft);
-      GDL90_Out(buf, size);
-
+      buf = GDL90_Room(sizeof(GDL90_Msg_OwnershipGeometricAltitude_t));
       size = makeGeometricAltitude(buf, &ThisAircraft);
-      GDL90_Out(buf, size);
+      GDL90_Commit(size, OUTPUT_PRIO_ROUTINE);
     }
 
-    for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
-      if (Container[i].addr &&
-         (this_moment - Container[i].timestamp) <= EXPORT_EXPIRATION_TIME) {
+    GDL90_Traffic(this_moment, false);
 
-        /*
-         * Disable distance filter when we have no GNSS data source to locate
-         * own position. Assume that we never gonna fly over 'Null Island'.
-         */
-
-        if ((ThisAircraft.latitude == 0 && ThisAircraft.longitude == 0) ||
-            Container[i].distance < ALARM_ZONE_NONE) {
-          size = makeTrafficReport(buf, &Container[i]);
-          GDL90_Out(buf, size);
-        }
-      }
-    }
+    GDL90_Flush();
   }
 }
@@ -160,8 +160,29 @@ extern const uint8_t aircraft_type_to_gdl90[] PROGMEM;
 extern const uint8_t gdl90_to_aircraft_type[] PROGMEM;
 extern const char *GDL90_CallSign_Prefix[];
 
+/* flags, message ID and message with FCS, every byte escaped at worst */
+#define GDL90_FRAME_MAX(n)    (2 * ((n) + 2) + 3)
+#define GDL90_MSG_MAX_SIZE    40
+
+#if !defined(GDL90_CYCLE_BUFSIZE)
+#if defined(EXCLUDE_WIFI) && !defined(RASPBERRY_PI)
+#define GDL90_CYCLE_BUFSIZE   128  /* no UDP, shares NMEABuffer */
+#else
+#define GDL90_CYCLE_BUFSIZE   1400 /* one UDP datagram on a 1500 bytes MTU */
+#endif /* EXCLUDE_WIFI */
+#endif
+
+typedef struct gdl90_stats_struct {
+  uint16_t  frames;     /* last export cycle */
+  uint16_t  datagrams;
+  uint32_t  bytes;
+} gdl90_stats_t;
+
+extern gdl90_stats_t GDL90_Stats;
+
 void GDL90_Export(void);
 uint16_t GDL90_calcFCS(uint8_t, uint8_t *, int);
 uint8_t *GDL90_EscapeFilter(uint8_t *, uint8_t *, int);
+size_t GDL90_Frame(uint8_t *, uint8_t, const uint8_t *, int);
 
 #endif /* GDL90HELPER_H */
\ No newline at end of file
@@ -217,42 +217,8 @@ void parsePING(JsonObject& root)
         fo.no_track = false;
         fo.rssi = 0;
 
-        Traffic_Update(&fo);
-
-        int j;
-
-        /* Try to find and update an entry with the same aircraft ID */
-        for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
-          if (Container[j].addr == fo.addr && Container[j].protocol == fo.protocol) {
-            Container[j] = fo;
-            break;
-          }
-        }
-
-        if (j < MAX_TRACKING_OBJECTS) {
-            continue;
-        }
-
-        /* Fill a free entry if able */
-        for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
-          if (Container[j].addr == 0 &&
-             memcmp(Container[j].raw, EmptyFO.raw, sizeof(EmptyFO.raw)) == 0) {
-            Container[j] = fo;
-            break;
-          }
-        }
-
-        if (j < MAX_TRACKING_OBJECTS) {
-            continue;
-        }
-
-        /* Overwrite expired entry */
-        for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
-          if (timestamp - Container[j].timestamp > ENTRY_EXPIRATION_TIME) {
-            Container[j] = fo;
-            break;
-          }
-        }
+        Traffic_Update(&ThisAircraft, &fo);
+        Traffic_Add(&fo);
       }
     }
 
@@ -414,42 +380,8 @@ void parseD1090(JsonObject& root)
         fo.no_track = false;
         fo.rssi = aircraft_array[i].rssi;
 
-        Traffic_Update(&fo);
-
-        int j;
-
-        /* Try to find and update an entry with the same aircraft ID */
-        for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
-          if (Container[j].addr == fo.addr && Container[j].protocol == fo.protocol) {
-            Container[j] = fo;
-            break;
-          }
-        }
-
-        if (j < MAX_TRACKING_OBJECTS) {
-            continue;
-        }
-
-        /* Fill a free entry if able */
-        for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
-          if (Container[j].addr == 0 &&
-             memcmp(Container[j].raw, EmptyFO.raw, sizeof(EmptyFO.raw)) == 0) {
-            Container[j] = fo;
-            break;
-          }
-        }
-
-        if (j < MAX_TRACKING_OBJECTS) {
-            continue;
-        }
-
-        /* Overwrite expired entry */
-        for (j=0; j < MAX_TRACKING_OBJECTS; j++) {
-          if (timestamp - Container[j].timestamp > ENTRY_EXPIRATION_TIME) {
-            Container[j] = fo;
-            break;
-          }
-        }
+        Traffic_Update(&ThisAircraft, &fo);
+        Traffic_Add(&fo);
       }
     }
 
@@ -712,6 +644,31 @@ void parseSettings(JsonObject& root)
     }
   }
 
+  JsonVariant rx_protocols = root["rx_protocols"];
+  if (rx_protocols.success()) {
+    JsonArray& rx_protocols_a = rx_protocols.as<JsonArray&>();
+    int size = rx_protocols_a.size();
+    uint8_t rx_mask = 0;
+
+    for (int i=0; i < size; i++) {
+      const char * rx_protocol_s = rx_protocols_a[i];
+      if (rx_protocol_s == NULL) {
+        continue;
+      } else if (!strcmp(rx_protocol_s,"LEGACY")) {
+        rx_mask |= (1 << RF_PROTOCOL_LEGACY);
+      } else if (!strcmp(rx_protocol_s,"OGNTP")) {
+        rx_mask |= (1 << RF_PROTOCOL_OGNTP);
+      } else if (!strcmp(rx_protocol_s,"P3I")) {
+        rx_mask |= (1 << RF_PROTOCOL_P3I);
+      } else if (!strcmp(rx_protocol_s,"FANET")) {
+        rx_mask |= (1 << RF_PROTOCOL_FANET);
+      } else if (!strcmp(rx_protocol_s,"ADS-L")) {
+        rx_mask |= (1 << RF_PROTOCOL_ADSL_860);
+      }
+    }
+    eeprom_block.field.settings.rx_protocols = rx_mask;
+  }
+
   JsonVariant band = root["band"];
   if (band.success()) {
     const char * band_s = band.as<char*>();
@@ -26,7 +26,11 @@
 #include "../../driver/EEPROM.h"
 #include "../../driver/Battery.h"
 #include "../../driver/Baro.h"
+#include "../../system/Time.h"
+#include "../../system/Output.h"
+#include "../../system/Profiler.h"
 #include "../../TrafficHelper.h"
+#include "GDL90.h"
 
 #define ADDR_TO_HEX_STR(s, c) (s += ((c) < 0x10 ? "0" : "") + String((c), HEX))
 
@@ -334,21 +338,13 @@ void NMEA_fini()
 #endif /* NMEA_TCP_SERVICE */
 }
 
-void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl)
+static void NMEA_Write(uint8_t dest, byte *buf, size_t size, bool nl, uint8_t prio)
 {
   switch (dest)
   {
   case NMEA_UART:
     {
-      if (SoC->UART_ops) {
-        SoC->UART_ops->write(buf, size);
-        if (nl)
-          SoC->UART_ops->write((byte *) "\n", 1);
-      } else {
-        SerialOutput.write(buf, size);
-        if (nl)
-          SerialOutput.write('\n');
-      }
+      Output_write(Output_UART_ops(), buf, size, nl, prio);
     }
     break;
   case NMEA_UDP:
@@ -378,25 +374,21 @@ void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl)
           }
         }
       }
+#elif defined(USE_NET_OUTPUT)
+      RPi_TCP_transmit(NMEA_TCP_PORT, buf, size);
+      if (nl)
+        RPi_TCP_transmit(NMEA_TCP_PORT, (byte *) "\n", 1);
 #endif
     }
     break;
   case NMEA_USB:
     {
-      if (SoC->USB_ops) {
-        SoC->USB_ops->write(buf, size);
-        if (nl)
-          SoC->USB_ops->write((byte *) "\n", 1);
-      }
+      Output_write(SoC->USB_ops, buf, size, nl, prio);
     }
     break;
   case NMEA_BLUETOOTH:
     {
-      if (SoC->Bluetooth_ops) {
-        SoC->Bluetooth_ops->write(buf, size);
-        if (nl)
-          SoC->Bluetooth_ops->write((byte *) "\n", 1);
-      }
+      Output_write(SoC->Bluetooth_ops, buf, size, nl, prio);
     }
     break;
   case NMEA_OFF:
@@ -405,6 +397,11 @@ void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl)
   }
 }
 
+void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl)
+{
+  NMEA_Write(dest, buf, size, nl, OUTPUT_PRIO_ROUTINE);
+}
+
 void NMEA_Export()
 {
     int bearing;
@@ -506,7 +503,14 @@ void NMEA_Export()
 
               NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
 
-              NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+              NMEA_Write(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false,
+                         alarm_level > ALARM_LEVEL_NONE ?
+                         OUTPUT_PRIO_ALARM : OUTPUT_PRIO_ROUTINE);
+
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+              Traffic_Fusion_Stats.nmea_saved +=
+                Traffic_Fusion_Duplicates(i) * strlen(NMEABuffer);
+#endif /* EXCLUDE_TRAFFIC_FUSION */
 
               /* Most close traffic is treated as highest priority target */
               if (distance < HP_distance && abs(alt_diff) < VERTICAL_VISIBILITY_RANGE) {
@@ -554,7 +558,8 @@ void NMEA_Export()
 
       NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
 
-      NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+      NMEA_Write(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false,
+                 OUTPUT_PRIO_ALARM);
 
 #if !defined(EXCLUDE_SOFTRF_HEARTBEAT)
       snprintf_P(NMEABuffer, sizeof(NMEABuffer),
@@ -565,7 +570,187 @@ void NMEA_Export()
       NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
 
       NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+
+#if !defined(EXCLUDE_TIME_PLL)
+      /* time base: PLL state, phase error, jitter, drift, slot start jitter */
+      snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+              PSTR("$PSRFT,%d,%ld,%lu,%ld,%lu*"),
+              Time_PLL.state, (long) Time_PLL.error_us,
+              (unsigned long) Time_PLL.jitter_us, (long) Time_PLL_drift(),
+              (unsigned long) RF_slot_jitter_us);
+
+      NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+      NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+#endif /* EXCLUDE_TIME_PLL */
+
+#if defined(ENABLE_MULTI_RX)
+      /* per-protocol yield of the multi-protocol Rx scheduler */
+      if (RF_Rx_Protocols_Num > 1) {
+        size_t len = snprintf_P(NMEABuffer, sizeof(NMEABuffer), PSTR("$PSRFM"));
+
+        for (int i=0; i < RF_RX_PROTOCOLS_MAX; i++) {
+          if (RF_Rx_Stats[i].windows == 0 ||
+              len >= sizeof(NMEABuffer) - 6) {
+            continue;
+          }
+          len += snprintf_P(NMEABuffer + len, sizeof(NMEABuffer) - 6 - len,
+                            PSTR(",%s,%lu,%lu,%lu"), Protocol_ID[i],
+                            (unsigned long) RF_Rx_Stats[i].windows,
+                            (unsigned long) RF_Rx_Stats[i].packets,
+                            (unsigned long) RF_Rx_Stats[i].decoded);
+        }
+        if (len > sizeof(NMEABuffer) - 6) {
+          len = sizeof(NMEABuffer) - 6;
+        }
+        NMEABuffer[len++] = '*';
+        NMEABuffer[len  ] = 0;
+
+        NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+        NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+      }
+#endif /* ENABLE_MULTI_RX */
+
+#if !defined(EXCLUDE_TRAFFIC_FUSION)
+      /* traffic fusion: slots and output bytes saved on duplicates */
+      if (Traffic_Fusion_Stats.merged > 0) {
+        int slots = 0;
+
+        for (int i=0; i < MAX_TRACKING_OBJECTS; i++) {
+          slots += Traffic_Fusion_Duplicates(i);
+        }
+
+        snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+                PSTR("$PSRFF,%d,%lu,%lu,%lu*"), slots,
+                (unsigned long) Traffic_Fusion_Stats.merged,
+                (unsigned long) Traffic_Fusion_Stats.nmea_saved,
+                (unsigned long) Traffic_Fusion_Stats.gdl90_saved);
+
+        NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+        NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+      }
+#endif /* EXCLUDE_TRAFFIC_FUSION */
+
+#if defined(ENABLE_OUTPUT_QUEUE)
+      /* Tx queues: high-water mark and dropped messages */
+      IODev_ops_t *out_ops[] = { Output_UART_ops(), SoC->USB_ops,
+                                 SoC->Bluetooth_ops };
+
+      for (int i=0; i < 3; i++) {
+        output_queue_t *q = out_ops[i] ? out_ops[i]->queue : NULL;
+
+        if (q && (q->drops > 0 || q->drops_alarm > 0 ||
+                  q->hwm > OUTPUT_QUEUE_SIZE / 2)) {
+          snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+                  PSTR("$PSRFQ,%s,%u,%lu,%lu*"), out_ops[i]->name, q->hwm,
+                  (unsigned long) q->drops, (unsigned long) q->drops_alarm);
+
+          NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+          NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+        }
+      }
+#endif /* ENABLE_OUTPUT_QUEUE */
+
+      /* Rx prefilter: peeked frames and rejects per stage */
+      if (Traffic_Prefilter_Stats.peeked > 0 || Traffic_Prefilter_Stats.dropped > 0) {
+        snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+                PSTR("$PSRFR,%lu,%lu,%lu,%lu,%lu,%lu*"),
+                (unsigned long) Traffic_Prefilter_Stats.peeked,
+                (unsigned long) Traffic_Prefilter_Stats.full,
+                (unsigned long) Traffic_Prefilter_Stats.range,
+                (unsigned long) Traffic_Prefilter_Stats.deferred,
+                (unsigned long) Traffic_Prefilter_Stats.undecoded,
+                (unsigned long) Traffic_Prefilter_Stats.dropped);
+
+        NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+        NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+      }
+
+      /* GDL90 export: frames, datagrams (or writes) and bytes of last cycle */
+      if (settings->gdl90 != GDL90_OFF && GDL90_Stats.frames > 0) {
+        snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+                PSTR("$PSRFG,%u,%u,%lu*"),
+                GDL90_Stats.frames, GDL90_Stats.datagrams,
+                (unsigned long) GDL90_Stats.bytes);
+
+        NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+        NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+      }
+
+#if defined(USE_EVENT_LOOP)
+      /* main loop: CPU load (permille), wake-ups per second, latency (us) */
+      snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+              PSTR("$PSRFW,%u,%u,%lu,%lu*"),
+              RPi_Loop_Stats.cpu, RPi_Loop_Stats.wakeups,
+              (unsigned long) RPi_Loop_Stats.lat_avg_us,
+              (unsigned long) RPi_Loop_Stats.lat_max_us);
+
+      NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+      NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+#endif /* USE_EVENT_LOOP */
 #endif /* EXCLUDE_SOFTRF_HEARTBEAT */
+
+#if defined(ENABLE_PROFILER)
+      /* once per period: subsystem, calls, min, avg, max, p99 (us) */
+      static uint16_t PSRFP_epoch = 0;
+      uint16_t epoch = Profiler_Report_epoch();
+
+      if (epoch != 0 && epoch != PSRFP_epoch) {
+        uint32_t hist[PROFILER_BUCKETS];
+        bool     has_hist = false;
+
+        for (int i=0; i < PROF_COUNT; i++) {
+          prof_stats_t ps;
+
+          if (!Profiler_Stats_get(i, &ps, hist) || ps.epoch != epoch) {
+            continue;
+          }
+          has_hist |= (i == PROF_LOOP);
+
+          snprintf_P(NMEABuffer, sizeof(NMEABuffer),
+                  PSTR("$PSRFP,%s,%lu,%lu,%lu,%lu,%lu*"), Profiler_Name[i],
+                  (unsigned long) ps.count,  (unsigned long) ps.min_us,
+                  (unsigned long) ps.avg_us, (unsigned long) ps.max_us,
+                  (unsigned long) ps.p99_us);
+
+          NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+          NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+        }
+
+        /* loop period histogram, bucket i is [2^i, 2^(i+1)) us */
+        if (has_hist) {
+          size_t len = snprintf_P(NMEABuffer, sizeof(NMEABuffer), PSTR("$PSRFP,HIST"));
+          int last = PROFILER_BUCKETS - 1;
+
+          while (last > 0 && hist[last] == 0) {
+            last--;
+          }
+
+          for (int i=0; i <= last && len < sizeof(NMEABuffer) - 6; i++) {
+            len += snprintf_P(NMEABuffer + len, sizeof(NMEABuffer) - 6 - len,
+                              PSTR(",%lu"), (unsigned long) hist[i]);
+          }
+          if (len > sizeof(NMEABuffer) - 6) {
+            len = sizeof(NMEABuffer) - 6;
+          }
+          NMEABuffer[len++] = '*';
+          NMEABuffer[len  ] = 0;
+
+          NMEA_add_checksum(NMEABuffer, sizeof(NMEABuffer) - strlen(NMEABuffer));
+
+          NMEA_Out(settings->nmea_out, (byte *) NMEABuffer, strlen(NMEABuffer), false);
+        }
+
+        PSRFP_epoch = epoch;
+      }
+#endif /* ENABLE_PROFILER */
     }
 }
 
@@ -163,21 +163,31 @@ int packet2Raw(String &tnc2, AX25Msg &Packet) {
 
 bool aprs_decode(void *pkt, ufo_t *this_aircraft, ufo_t *fop) {
 
-  String tnc2((char *) pkt);
+  memset(&aprs, 0, sizeof(pbuf_t));
+
+  /* a damaged frame is not necessarily NUL terminated */
+  size_t len = strnlen((char *) pkt, sizeof(aprs.data) - 1);
+  memcpy(aprs.data, pkt, len);
+
+  String tnc2(aprs.data);
 
   // Serial.println("APRS RX: " + tnc2);
 
-  int start_val = tnc2.indexOf(">", 0);
-  if (start_val > 3)
+  int start_val  = tnc2.indexOf(">", 0);
+  int start_info = tnc2.indexOf(":", 0);
+
+  if (start_val > 3 && start_info > start_val)
   {
-    String src_call = tnc2.substring(0, start_val);
-    memset(&aprs, 0, sizeof(pbuf_t));
-    aprs.buf_len = 300;
+    aprs.buf_len = sizeof(aprs.data);
     aprs.packet_len = tnc2.length();
-    tnc2.toCharArray(&aprs.data[0], aprs.packet_len);
-    int start_info = tnc2.indexOf(":", 0);
     int end_ssid = tnc2.indexOf(",", 0);
-    int start_dst = tnc2.indexOf(">", 2);
+    int start_dst = start_val;
+
+    /* no digipeater path */
+    if (end_ssid < 0 || end_ssid > start_info) {
+      end_ssid = start_info;
+    }
+
     int start_dstssid = tnc2.indexOf("-", start_dst);
     if ((start_dstssid > start_dst) && (start_dstssid < start_dst + 10))
     {
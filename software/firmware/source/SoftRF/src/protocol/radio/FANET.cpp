@@ -303,6 +303,36 @@ bool fanet_decode(void *fanet_pkt, ufo_t *this_aircraft, ufo_t *fop) {
   return rval;
 }
 
+/* address, position and altitude of Tracking frames, no other fields */
+bool fanet_peek(void *fanet_pkt, ufo_t *this_aircraft, ufo_t *fop) {
+
+  fanet_packet_t *pkt = (fanet_packet_t *) fanet_pkt;
+  unsigned int altitude;
+
+  if (pkt->ext_header != 0 || pkt->type != 1) {  /* not Tracking */
+    return false;
+  }
+
+  fop->addr      = (pkt->vendor << 16) | pkt->address;
+  fop->addr_type = ADDR_TYPE_FANET;
+
+#if defined(FANET_DEPRECATED)
+  fop->latitude  = payload_compressed2coord(pkt->latitude, this_aircraft->latitude);
+  fop->longitude = payload_compressed2coord(pkt->longitude, this_aircraft->longitude);
+#else
+  payload_absolut2coord(&(fop->latitude), &(fop->longitude),
+    ((uint8_t *) pkt) + FANET_HEADER_SIZE);
+#endif
+
+  altitude = ((pkt->altitude_msb << 8) | pkt->altitude_lsb);
+  if (pkt->altitude_scale) {
+    altitude = altitude * 4 /* -2 */;
+  }
+  fop->altitude = (float) altitude;
+
+  return true;
+}
+
 size_t fanet_encode(void *fanet_pkt, ufo_t *this_aircraft) {
 
   uint32_t id = this_aircraft->addr;
@@ -477,9 +477,12 @@ bool legacy_decode(void *legacy_pkt, ufo_t *this_aircraft, ufo_t *fop) {
         return false;
     }
 
-    uint32_t *wpkt     = (uint32_t *) legacy_pkt;
+    /* a copy, not an alias of the bit fields - see legacy_encode() */
+    uint32_t wpkt[6];
     uint32_t timestamp = (uint32_t) this_aircraft->timestamp;
 
+    memcpy(wpkt, legacy_pkt, sizeof(wpkt));
+
     btea(&wpkt[2], -4, xxtea_key);
 
     key_v7[0]          = wpkt[0];
@@ -494,6 +497,8 @@ bool legacy_decode(void *legacy_pkt, ufo_t *this_aircraft, ufo_t *fop) {
     wpkt[4] ^= key_v7[2];
     wpkt[5] ^= key_v7[3];
 
+    memcpy(legacy_pkt, wpkt, sizeof(wpkt));
+
     fop->protocol      = RF_PROTOCOL_LEGACY;
 
     fop->addr          = pkt->addr;
@@ -560,7 +565,13 @@ size_t legacy_encode(void *legacy_pkt, ufo_t *this_aircraft) {
     uint32_t key_v7[4];
 
     legacy_v7_packet_t *pkt = (legacy_v7_packet_t *) legacy_pkt;
-    uint32_t *wpkt     = (uint32_t *) legacy_pkt;
+
+    /*
+     * Words of the packet are ciphered in a copy. Read through an uint32_t
+     * pointer, the bit fields above may be stored after the cipher
+     * has run, once the compiler is let to assume strict aliasing.
+     */
+    uint32_t wpkt[6];
 
     uint32_t id        = this_aircraft->addr;
     uint8_t acft_type  = this_aircraft->aircraft_type > AIRCRAFT_TYPE_STATIC ?
@@ -630,6 +641,8 @@ size_t legacy_encode(void *legacy_pkt, ufo_t *this_aircraft) {
     pkt->_unk9         = 0; /* TBD */
     pkt->_unk10        = 0;
 
+    memcpy(wpkt, legacy_pkt, sizeof(wpkt));
+
     key_v7[0]          = wpkt[0];
     key_v7[1]          = wpkt[1];
     key_v7[2]          = timestamp >> 4;
@@ -644,7 +657,25 @@ size_t legacy_encode(void *legacy_pkt, ufo_t *this_aircraft) {
 
     btea(&wpkt[2], 4, xxtea_key);
 
+    memcpy(legacy_pkt, wpkt, sizeof(wpkt));
+
     return (sizeof(legacy_v7_packet_t));
 }
 
 #endif /* EXCLUDE_AIR7 */
+
+/*
+ * Address is sent in clear, ahead of the XXTEA encrypted part.
+ * Position is not known until the packet is decrypted.
+ */
+bool legacy_peek(void *legacy_pkt, ufo_t *this_aircraft, ufo_t *fop) {
+
+    legacy_v7_packet_t *pkt = (legacy_v7_packet_t *) legacy_pkt;
+
+    if (pkt->type == 0 || pkt->type == 2) { /* Air V6 or V7 position */
+        fop->addr      = pkt->addr;
+        fop->addr_type = pkt->addr_type;
+    }
+
+    return false;
+}
@@ -188,6 +188,7 @@ typedef struct {
 } __attribute__((packed)) legacy_v7_packet_t;
 
 bool   legacy_decode(void *, ufo_t *, ufo_t *);
+bool   legacy_peek(void *, ufo_t *, ufo_t *);
 size_t legacy_encode(void *, ufo_t *);
 
 extern const rf_proto_desc_t legacy_proto_desc;
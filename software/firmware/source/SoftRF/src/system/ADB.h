@@ -0,0 +1,225 @@
+/*
+ * ADB.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ADBHELPER_H
+#define ADBHELPER_H
+
+#include <stdint.h>
+#include <string.h>
+
+/*
+ * Binary aircraft database (*.adb), made by software/utils/python/adb.py
+ *
+ *   +--------+-------------+------------------------------------+
+ *   | header | block index | records, sorted by 24-bit address  |
+ *   +--------+-------------+------------------------------------+
+ *
+ * Integers are little-endian. Every record is a 3 bytes long address
+ * followed by fixed width, zero padded M&M, registration and CN fields.
+ * The block index (address of first record in every block) is kept in RAM.
+ * A lookup is a binary search in the index, one block read and a binary
+ * search within the block.
+ */
+
+#define ADB_MAGIC         0x42444153UL /* "SADB" */
+#define ADB_VERSION       1
+#define ADB_HEADER_SIZE   16
+#define ADB_INDEX_MAX     512
+#define ADB_BLOCK_BYTES   2048
+#define ADB_FIELD_MAX     32
+/* a record also carries a legacy CDB value, that one is up to 63 chars */
+#define ADB_VALUE_MAX     63
+
+typedef struct adb_record_struct {
+  char mam[ADB_VALUE_MAX + 1];
+  char reg[ADB_VALUE_MAX + 1];
+  char cn [ADB_VALUE_MAX + 1];
+} adb_record_t;
+
+template <class TFileSystem, class TFile>
+class ADB
+{
+  public:
+    ADB(TFileSystem& fs) : fs_(fs), is_open_(false), count_(0), blocks_(0) {}
+
+    bool open(const char *fileName);
+    void close();
+    bool find(uint32_t id, adb_record_t *rec);
+
+    bool isOpen() const { return is_open_; }
+    uint32_t recordsNumber() const { return is_open_ ? count_ : 0; }
+
+  private:
+    TFileSystem& fs_;
+    TFile        adb_;
+    bool         is_open_;
+
+    uint32_t     count_;
+    uint16_t     block_;
+    uint16_t     blocks_;
+    uint8_t      mam_len_;
+    uint8_t      reg_len_;
+    uint8_t      cn_len_;
+    uint16_t     rec_size_;
+    uint32_t     data_pos_;
+
+    uint32_t     index_[ADB_INDEX_MAX];
+    uint8_t      buf_[ADB_BLOCK_BYTES];
+
+    static uint32_t get24(const uint8_t *p) {
+      return (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16);
+    }
+    static uint32_t get32(const uint8_t *p) {
+      return get24(p) | ((uint32_t) p[3] << 24);
+    }
+    static void field(char *dst, const uint8_t *src, uint8_t len) {
+      memcpy(dst, src, len);
+      dst[len] = 0;
+    }
+};
+
+template <class TFileSystem, class TFile>
+bool ADB<TFileSystem, TFile>::open(const char *fileName)
+{
+  uint8_t hdr[ADB_HEADER_SIZE];
+
+  close();
+
+  if (!fs_.exists(fileName)) {
+    return false;
+  }
+
+  adb_ = fs_.open(fileName);
+  if (!adb_) {
+    return false;
+  }
+
+  if (adb_.read(hdr, sizeof(hdr)) != (int) sizeof(hdr) ||
+      get32(&hdr[0]) != ADB_MAGIC || hdr[4] != ADB_VERSION) {
+    adb_.close();
+    return false;
+  }
+
+  mam_len_  = hdr[5];
+  reg_len_  = hdr[6];
+  cn_len_   = hdr[7];
+  count_    = get32(&hdr[8]);
+  block_    = hdr[12] | (hdr[13] << 8);
+  rec_size_ = 3 + mam_len_ + reg_len_ + cn_len_;
+
+  if (mam_len_ > ADB_FIELD_MAX || reg_len_ > ADB_FIELD_MAX ||
+      cn_len_  > ADB_FIELD_MAX || block_ == 0 ||
+      (uint32_t) block_ * rec_size_ > ADB_BLOCK_BYTES) {
+    adb_.close();
+    return false;
+  }
+
+  uint32_t blocks = (count_ + block_ - 1) / block_;
+
+  if (blocks > ADB_INDEX_MAX) {
+    adb_.close();
+    return false;
+  }
+  blocks_ = blocks;
+
+  /* block index entries are 24-bit */
+  for (uint16_t i = 0; i < blocks_; i++) {
+    uint8_t b[3];
+
+    if (adb_.read(b, sizeof(b)) != (int) sizeof(b)) {
+      adb_.close();
+      return false;
+    }
+    index_[i] = get24(b);
+  }
+
+  data_pos_ = ADB_HEADER_SIZE + 3 * (uint32_t) blocks_;
+
+  if (adb_.size() < data_pos_ + count_ * rec_size_) {
+    adb_.close();
+    return false;
+  }
+
+  is_open_ = true;
+
+  return true;
+}
+
+template <class TFileSystem, class TFile>
+void ADB<TFileSystem, TFile>::close()
+{
+  if (is_open_) {
+    adb_.close();
+    is_open_ = false;
+  }
+}
+
+template <class TFileSystem, class TFile>
+bool ADB<TFileSystem, TFile>::find(uint32_t id, adb_record_t *rec)
+{
+  if (!is_open_ || blocks_ == 0 || id < index_[0]) {
+    return false;
+  }
+
+  /* last block that starts at or below the id */
+  uint16_t lo = 0, hi = blocks_ - 1;
+
+  while (lo < hi) {
+    uint16_t mid = (lo + hi + 1) / 2;
+
+    if (index_[mid] <= id) {
+      lo = mid;
+    } else {
+      hi = mid - 1;
+    }
+  }
+
+  uint32_t first = (uint32_t) lo * block_;
+  uint16_t num   = (count_ - first) < block_ ? (count_ - first) : block_;
+  int      size  = num * rec_size_;
+
+  if (!adb_.seek(data_pos_ + first * rec_size_) ||
+      adb_.read(buf_, size) != size) {
+    return false;
+  }
+
+  int l = 0, r = num - 1;
+
+  while (l <= r) {
+    int m = (l + r) / 2;
+    const uint8_t *p = &buf_[m * rec_size_];
+    uint32_t addr = get24(p);
+
+    if (addr == id) {
+      p += 3;
+      field(rec->mam, p, mam_len_); p += mam_len_;
+      field(rec->reg, p, reg_len_); p += reg_len_;
+      field(rec->cn,  p, cn_len_);
+      return true;
+    }
+    if (addr < id) {
+      l = m + 1;
+    } else {
+      r = m - 1;
+    }
+  }
+
+  return false;
+}
+
+#endif /* ADBHELPER_H */
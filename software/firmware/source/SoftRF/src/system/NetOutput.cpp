@@ -0,0 +1,424 @@
+/*
+ * NetOutput.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+
+#if defined(USE_NET_OUTPUT)
+
+#include "NetOutput.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#define NETOUT_MAX_EVENTS   (NETOUT_MAX_CLIENTS + 1)
+
+void NetOutput_init(netout_t *s)
+{
+  s->epfd     = -1;
+  s->udp_fd   = -1;
+  s->tcp_fd   = -1;
+  s->udp_port = 0;
+  s->tcp_port = 0;
+  s->dst_addr = htonl(INADDR_BROADCAST);
+  s->pool_len = 0;
+  s->dgrams   = 0;
+  s->clients  = 0;
+
+  for (int i = 0; i < NETOUT_MAX_CLIENTS; i++) {
+    s->client[i].fd  = -1;
+    s->client[i].buf = NULL;
+  }
+
+  memset(&s->stats, 0, sizeof(s->stats));
+}
+
+static int NetOutput_socket(int type)
+{
+  return socket(AF_INET, type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+}
+
+/* either port may be zero, same ports as now is a no-op */
+bool NetOutput_begin(netout_t *s, int udp_port, int tcp_port)
+{
+  if (NetOutput_isOpen(s) &&
+      s->udp_port == udp_port && s->tcp_port == tcp_port) {
+    return true;
+  }
+
+  NetOutput_end(s);
+
+  if (udp_port == 0 && tcp_port == 0) {
+    return true;
+  }
+
+  s->epfd = epoll_create1(EPOLL_CLOEXEC);
+  if (s->epfd < 0) {
+    perror("epoll_create1");
+    return false;
+  }
+
+  if (udp_port) {
+    int on = 1;
+
+    s->udp_fd = NetOutput_socket(SOCK_DGRAM);
+    if (s->udp_fd < 0 ||
+        setsockopt(s->udp_fd, SOL_SOCKET, SO_BROADCAST, &on, sizeof(on)) < 0) {
+      perror("UDP output socket");
+      NetOutput_end(s);
+      return false;
+    }
+    s->udp_port = udp_port;
+  }
+
+  if (tcp_port) {
+    struct sockaddr_in addr;
+    struct epoll_event ev;
+    int on = 1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(tcp_port);
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = NULL; /* listening socket */
+
+    s->tcp_fd = NetOutput_socket(SOCK_STREAM);
+    if (s->tcp_fd < 0 ||
+        setsockopt(s->tcp_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0 ||
+        bind(s->tcp_fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 ||
+        listen(s->tcp_fd, NETOUT_MAX_CLIENTS) < 0 ||
+        epoll_ctl(s->epfd, EPOLL_CTL_ADD, s->tcp_fd, &ev) < 0) {
+      perror("TCP output socket");
+      NetOutput_end(s);
+      return false;
+    }
+    s->tcp_port = tcp_port;
+
+    fprintf(stderr, "TCP output server has started at port: %d\n", tcp_port);
+  }
+
+  return true;
+}
+
+static void NetOutput_drop(netout_t *s, netout_client_t *c)
+{
+  close(c->fd); /* also removes it from the epoll set */
+  free(c->buf);
+
+  c->fd  = -1;
+  c->buf = NULL;
+  s->clients--;
+}
+
+void NetOutput_end(netout_t *s)
+{
+  for (int i = 0; i < NETOUT_MAX_CLIENTS; i++) {
+    if (s->client[i].fd >= 0) {
+      NetOutput_drop(s, &s->client[i]);
+    }
+  }
+
+  if (s->tcp_fd >= 0) { close(s->tcp_fd); s->tcp_fd = -1; }
+  if (s->udp_fd >= 0) { close(s->udp_fd); s->udp_fd = -1; }
+  if (s->epfd   >= 0) { close(s->epfd);   s->epfd   = -1; }
+
+  s->udp_port = 0;
+  s->tcp_port = 0;
+  s->pool_len = 0;
+  s->dgrams   = 0;
+}
+
+static void NetOutput_pollout(netout_t *s, netout_client_t *c, bool on)
+{
+  if (c->pollout != on) {
+    struct epoll_event ev;
+
+    ev.events   = on ? EPOLLIN | EPOLLOUT : EPOLLIN;
+    ev.data.ptr = c;
+    epoll_ctl(s->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->pollout = on;
+  }
+}
+
+/* returns false when the client is gone */
+static bool NetOutput_push(netout_t *s, netout_client_t *c)
+{
+  while (c->len > 0) {
+    ssize_t n = send(c->fd, c->buf + c->head, c->len,
+                     MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n > 0) {
+      c->head += n;
+      c->len  -= n;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else {
+      NetOutput_drop(s, c);
+      return false;
+    }
+  }
+
+  if (c->len == 0) {
+    c->head = 0;
+  }
+  NetOutput_pollout(s, c, c->len > 0);
+
+  return true;
+}
+
+static void NetOutput_send_dgrams(netout_t *s)
+{
+  struct mmsghdr     msg[NETOUT_MAX_DGRAMS];
+  struct iovec       iov[NETOUT_MAX_DGRAMS];
+  struct sockaddr_in dst;
+  unsigned int       sent = 0;
+  size_t             offset = 0;
+
+  if (s->dgrams == 0) {
+    return;
+  }
+
+  memset(&dst, 0, sizeof(dst));
+  dst.sin_family      = AF_INET;
+  dst.sin_addr.s_addr = s->dst_addr;
+  dst.sin_port        = htons(s->udp_port);
+
+  memset(msg, 0, s->dgrams * sizeof(msg[0]));
+  for (int i = 0; i < s->dgrams; i++) {
+    iov[i].iov_base = s->pool + offset;
+    iov[i].iov_len  = s->dgram_len[i];
+    offset += s->dgram_len[i];
+
+    msg[i].msg_hdr.msg_name    = &dst;
+    msg[i].msg_hdr.msg_namelen = sizeof(dst);
+    msg[i].msg_hdr.msg_iov     = &iov[i];
+    msg[i].msg_hdr.msg_iovlen  = 1;
+  }
+
+  while (sent < s->dgrams) {
+    int n = sendmmsg(s->udp_fd, &msg[sent], s->dgrams - sent, MSG_DONTWAIT);
+
+    s->stats.batches++;
+    if (n > 0) {
+      sent += n;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      /* full socket buffer or no route: the rest of the cycle is lost */
+      s->stats.lost += s->dgrams - sent;
+      break;
+    }
+  }
+
+  s->stats.datagrams += sent;
+  s->pool_len = 0;
+  s->dgrams   = 0;
+}
+
+void NetOutput_write(netout_t *s, const uint8_t *buf, size_t size)
+{
+  if (!NetOutput_isOpen(s) || size == 0) {
+    return;
+  }
+
+  if (s->udp_fd >= 0) {
+    size_t udp_size = size > NETOUT_DGRAM_POOL ? NETOUT_DGRAM_POOL : size;
+
+    if (s->dgrams >= NETOUT_MAX_DGRAMS ||
+        s->pool_len + udp_size > NETOUT_DGRAM_POOL) {
+      NetOutput_send_dgrams(s);
+    }
+    memcpy(s->pool + s->pool_len, buf, udp_size);
+    s->pool_len += udp_size;
+    s->dgram_len[s->dgrams++] = udp_size;
+  }
+
+  for (int i = 0; s->clients > 0 && i < NETOUT_MAX_CLIENTS; i++) {
+    netout_client_t *c = &s->client[i];
+
+    if (c->fd < 0) {
+      continue;
+    }
+
+    if (c->len + size > NETOUT_CLIENT_BUFSIZE) {
+      /* it can not keep up with the data rate */
+      NetOutput_drop(s, c);
+      s->stats.dropped++;
+      continue;
+    }
+
+    if (c->head + c->len + size > NETOUT_CLIENT_BUFSIZE) {
+      memmove(c->buf, c->buf + c->head, c->len);
+      c->head = 0;
+    }
+    memcpy(c->buf + c->head + c->len, buf, size);
+    c->len += size;
+  }
+}
+
+void NetOutput_flush(netout_t *s)
+{
+  if (!NetOutput_isOpen(s)) {
+    return;
+  }
+
+  if (s->udp_fd >= 0) {
+    NetOutput_send_dgrams(s);
+  }
+
+  for (int i = 0; s->clients > 0 && i < NETOUT_MAX_CLIENTS; i++) {
+    netout_client_t *c = &s->client[i];
+
+    if (c->fd >= 0 && c->len > 0 && !c->pollout) {
+      NetOutput_push(s, c);
+    }
+  }
+}
+
+static void NetOutput_accept(netout_t *s)
+{
+  while (true) {
+    int fd = accept4(s->tcp_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) {
+        continue;
+      }
+      break;
+    }
+
+    netout_client_t *c = NULL;
+
+    for (int i = 0; i < NETOUT_MAX_CLIENTS; i++) {
+      if (s->client[i].fd < 0) {
+        c = &s->client[i];
+        break;
+      }
+    }
+
+    uint8_t *buf = c ? (uint8_t *) malloc(NETOUT_CLIENT_BUFSIZE) : NULL;
+
+    if (buf == NULL) {
+      close(fd);
+      s->stats.rejected++;
+      continue;
+    }
+
+    struct epoll_event ev;
+    int on = 1;
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+    ev.events   = EPOLLIN;
+    ev.data.ptr = c;
+    if (epoll_ctl(s->epfd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+      close(fd);
+      free(buf);
+      s->stats.rejected++;
+      continue;
+    }
+
+    c->fd      = fd;
+    c->buf     = buf;
+    c->head    = 0;
+    c->len     = 0;
+    c->pollout = false;
+
+    s->clients++;
+    s->stats.accepted++;
+  }
+}
+
+/* input of clients is not used, it is read out to detect a hang up */
+static bool NetOutput_drain(netout_t *s, netout_client_t *c)
+{
+  uint8_t scratch[256];
+
+  while (true) {
+    ssize_t n = recv(c->fd, scratch, sizeof(scratch), MSG_DONTWAIT);
+
+    if (n > 0) {
+      continue;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return true;
+    }
+
+    NetOutput_drop(s, c);
+    return false;
+  }
+}
+
+void NetOutput_poll(netout_t *s, int timeout_ms)
+{
+  struct epoll_event ev[NETOUT_MAX_EVENTS];
+
+  if (!NetOutput_isOpen(s)) {
+    return;
+  }
+
+  int  n = epoll_wait(s->epfd, ev, NETOUT_MAX_EVENTS, timeout_ms);
+  bool pending = false;
+
+  for (int i = 0; i < n; i++) {
+    netout_client_t *c = (netout_client_t *) ev[i].data.ptr;
+
+    /* accept after the batch, so that no slot is reused within it */
+    if (c == NULL) {
+      pending = true;
+      continue;
+    }
+
+    /* an earlier event of this batch may have dropped the client */
+    if (c->fd < 0) {
+      continue;
+    }
+
+    if (ev[i].events & (EPOLLERR | EPOLLHUP)) {
+      NetOutput_drop(s, c);
+      continue;
+    }
+
+    if ((ev[i].events & EPOLLIN) && !NetOutput_drain(s, c)) {
+      continue;
+    }
+
+    if (ev[i].events & EPOLLOUT) {
+      NetOutput_push(s, c);
+    }
+  }
+
+  if (pending) {
+    NetOutput_accept(s);
+  }
+}
+
+#endif /* USE_NET_OUTPUT */
@@ -0,0 +1,89 @@
+/*
+ * NetOutput.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef NETOUTPUTHELPER_H
+#define NETOUTPUTHELPER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Network output server of Linux builds (NMEA or GDL90 over UDP and TCP).
+ *
+ * Exporters never block on a socket. A message written to the server is
+ * queued as one UDP datagram and appended to the Tx buffer of every
+ * TCP client. NetOutput_flush() sends all the datagrams of an export
+ * cycle with a single sendmmsg() call, then pushes TCP buffers as far
+ * as each socket accepts. A client that falls NETOUT_CLIENT_BUFSIZE bytes
+ * behind is disconnected. Listening and client sockets are watched by
+ * the epoll descriptor of the server, NetOutput_poll() serves them.
+ */
+
+#if !defined(NETOUT_MAX_CLIENTS)
+#define NETOUT_MAX_CLIENTS      16
+#endif
+#define NETOUT_CLIENT_BUFSIZE   16384 /* bytes */
+#define NETOUT_MAX_DGRAMS       64    /* per sendmmsg() */
+#define NETOUT_DGRAM_POOL       16384 /* bytes */
+
+typedef struct netout_client_struct {
+  int       fd;
+  uint8_t   *buf;
+  size_t    head;
+  size_t    len;
+  bool      pollout;        /* EPOLLOUT is armed */
+} netout_client_t;
+
+typedef struct netout_stats_struct {
+  uint32_t  accepted;
+  uint32_t  rejected;       /* no free client slot */
+  uint32_t  dropped;        /* slow clients disconnected */
+  uint32_t  datagrams;
+  uint32_t  batches;        /* sendmmsg() calls */
+  uint32_t  lost;           /* datagrams refused by the socket */
+} netout_stats_t;
+
+typedef struct netout_struct {
+  int             epfd;
+  int             udp_fd;
+  int             tcp_fd;
+  int             udp_port;
+  int             tcp_port;
+  uint32_t        dst_addr; /* UDP destination, network order */
+
+  uint8_t         pool[NETOUT_DGRAM_POOL];
+  size_t          pool_len;
+  size_t          dgram_len[NETOUT_MAX_DGRAMS];
+  uint8_t         dgrams;
+
+  netout_client_t client[NETOUT_MAX_CLIENTS];
+  uint8_t         clients;
+
+  netout_stats_t  stats;
+} netout_t;
+
+void NetOutput_init(netout_t *);
+bool NetOutput_begin(netout_t *, int, int);
+void NetOutput_end(netout_t *);
+void NetOutput_write(netout_t *, const uint8_t *, size_t);
+void NetOutput_flush(netout_t *);
+void NetOutput_poll(netout_t *, int);
+
+#define NetOutput_isOpen(s)  ((s)->epfd >= 0)
+
+#endif /* NETOUTPUTHELPER_H */
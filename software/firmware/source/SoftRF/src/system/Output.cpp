@@ -0,0 +1,195 @@
+/*
+ * Output.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Output.h"
+
+static size_t SerialOutput_write(const uint8_t *buffer, size_t size)
+{
+  return SerialOutput.write((uint8_t *) buffer, size);
+}
+
+#if defined(ENABLE_OUTPUT_QUEUE)
+static output_queue_t USB_Queue;
+static output_queue_t BT_Queue;
+
+#if !defined(EXCLUDE_OUTPUT_QUEUE_UART)
+static output_queue_t UART_Queue;
+
+static int SerialOutput_availableForWrite()
+{
+  return SerialOutput.availableForWrite();
+}
+#endif /* EXCLUDE_OUTPUT_QUEUE_UART */
+#endif /* ENABLE_OUTPUT_QUEUE */
+
+IODev_ops_t SerialOutput_ops = {
+  "SerialOutput",
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  NULL,
+  SerialOutput_write,
+#if defined(ENABLE_OUTPUT_QUEUE) && !defined(EXCLUDE_OUTPUT_QUEUE_UART)
+  SerialOutput_availableForWrite,
+#else
+  NULL,
+#endif /* ENABLE_OUTPUT_QUEUE */
+  NULL
+};
+
+#if defined(ENABLE_OUTPUT_QUEUE)
+static bool Output_enqueue(output_queue_t *q, const uint8_t *buf, size_t size,
+                           bool nl, uint8_t prio)
+{
+  uint16_t head  = q->head;
+  size_t   used  = (uint16_t) (head - q->tail);
+  size_t   need  = nl ? size + 1 : size;
+  size_t   limit = prio == OUTPUT_PRIO_ROUTINE ?
+                   OUTPUT_QUEUE_SIZE - OUTPUT_QUEUE_RESERVE : OUTPUT_QUEUE_SIZE;
+
+  /* a message goes in as a whole or not at all */
+  if (used + need > limit) {
+    if (prio == OUTPUT_PRIO_ROUTINE) {
+      q->drops++;
+    } else {
+      q->drops_alarm++;
+    }
+    return false;
+  }
+
+  size_t ndx   = head & (OUTPUT_QUEUE_SIZE - 1);
+  size_t chunk = OUTPUT_QUEUE_SIZE - ndx;
+
+  if (chunk > size) {
+    chunk = size;
+  }
+  memcpy(&q->buf[ndx], buf, chunk);
+  memcpy(&q->buf[0], buf + chunk, size - chunk);
+  if (nl) {
+    q->buf[(head + size) & (OUTPUT_QUEUE_SIZE - 1)] = '\n';
+  }
+
+  /* data must be in place before the consumer sees the new head */
+  __sync_synchronize();
+  q->head = head + need;
+
+  if (used + need > q->hwm) {
+    q->hwm = used + need;
+  }
+
+  return true;
+}
+#endif /* ENABLE_OUTPUT_QUEUE */
+
+void Output_drain(IODev_ops_t *ops)
+{
+#if defined(ENABLE_OUTPUT_QUEUE)
+  output_queue_t *q = ops ? ops->queue : NULL;
+
+  if (q == NULL || ops->availableForWrite == NULL) {
+    return;
+  }
+
+  uint16_t tail = q->tail;
+  size_t   used = (uint16_t) (q->head - tail);
+
+  while (used > 0) {
+    int room = ops->availableForWrite();
+
+    /* some of USB write() methods need size to be less than the room */
+    if (room <= 1) {
+      break;
+    }
+
+    size_t ndx  = tail & (OUTPUT_QUEUE_SIZE - 1);
+    size_t size = OUTPUT_QUEUE_SIZE - ndx;
+
+    if (size > used) {
+      size = used;
+    }
+    if (size > (size_t) room - 1) {
+      size = room - 1;
+    }
+
+    size = ops->write(&q->buf[ndx], size);
+    if (size == 0) {
+      break;
+    }
+
+    tail += size;
+    used -= size;
+  }
+
+  __sync_synchronize();
+  q->tail = tail;
+#endif /* ENABLE_OUTPUT_QUEUE */
+}
+
+size_t Output_write(IODev_ops_t *ops, const uint8_t *buf, size_t size,
+                    bool nl, uint8_t prio)
+{
+  if (ops == NULL) {
+    return 0;
+  }
+
+#if defined(ENABLE_OUTPUT_QUEUE)
+  if (ops->queue && ops->availableForWrite) {
+    bool rval = Output_enqueue(ops->queue, buf, size, nl, prio);
+
+    Output_drain(ops);
+
+    return rval ? size : 0;
+  }
+#endif /* ENABLE_OUTPUT_QUEUE */
+
+  size_t rval = ops->write(buf, size);
+  if (nl) {
+    ops->write((const uint8_t *) "\n", 1);
+  }
+
+  return rval;
+}
+
+void Output_setup()
+{
+#if defined(ENABLE_OUTPUT_QUEUE)
+#if !defined(EXCLUDE_OUTPUT_QUEUE_UART)
+  /* SoC->UART_ops of the platform when it has one, SerialOutput otherwise */
+  IODev_ops_t *uart_ops = Output_UART_ops();
+
+  if (uart_ops->availableForWrite) {
+    uart_ops->queue = &UART_Queue;
+  }
+#endif /* EXCLUDE_OUTPUT_QUEUE_UART */
+  if (SoC->USB_ops && SoC->USB_ops->availableForWrite) {
+    SoC->USB_ops->queue = &USB_Queue;
+  }
+  if (SoC->Bluetooth_ops && SoC->Bluetooth_ops->availableForWrite) {
+    SoC->Bluetooth_ops->queue = &BT_Queue;
+  }
+#endif /* ENABLE_OUTPUT_QUEUE */
+}
+
+void Output_loop()
+{
+  Output_drain(Output_UART_ops());
+  Output_drain(SoC->USB_ops);
+  Output_drain(SoC->Bluetooth_ops);
+}
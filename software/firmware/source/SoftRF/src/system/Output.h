@@ -0,0 +1,67 @@
+/*
+ * Output.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OUTPUTHELPER_H
+#define OUTPUTHELPER_H
+
+#include "SoC.h"
+
+/*
+ * Tx queues of serial transports (UART, USB, Bluetooth).
+ *
+ * NMEA, GDL90 and D1090 exporters put whole messages into the queue of
+ * a transport and never wait for it. The queue is drained into the Tx
+ * buffer of the transport (UART FIFO, interrupt or DMA driven buffer of
+ * the core, USB CDC or BLE FIFO), no more than availableForWrite() at a time.
+ *
+ * Single producer (exporters), single consumer (Output_drain()).
+ * Routine messages are not allowed to fill the last OUTPUT_QUEUE_RESERVE
+ * bytes, that room is kept for PFLAU and alarms.
+ */
+
+#if !defined(OUTPUT_QUEUE_SIZE)
+#define OUTPUT_QUEUE_SIZE     2048 /* bytes, power of 2 */
+#endif
+#define OUTPUT_QUEUE_RESERVE  (OUTPUT_QUEUE_SIZE / 4)
+
+enum
+{
+	OUTPUT_PRIO_ROUTINE,
+	OUTPUT_PRIO_ALARM
+};
+
+typedef struct output_queue_struct {
+  uint8_t           buf[OUTPUT_QUEUE_SIZE];
+  volatile uint16_t head;         /* advanced by producer only */
+  volatile uint16_t tail;         /* advanced by consumer only */
+  uint16_t          hwm;          /* high-water mark, bytes */
+  uint32_t          drops;        /* routine messages not queued */
+  uint32_t          drops_alarm;  /* PFLAU and alarms not queued */
+} output_queue_t;
+
+extern IODev_ops_t SerialOutput_ops;
+
+/* UART transport: platform specific or SerialOutput */
+#define Output_UART_ops()     (SoC->UART_ops ? SoC->UART_ops : &SerialOutput_ops)
+
+void   Output_setup(void);
+void   Output_loop(void);
+size_t Output_write(IODev_ops_t *, const uint8_t *, size_t, bool, uint8_t);
+void   Output_drain(IODev_ops_t *);
+
+#endif /* OUTPUTHELPER_H */
@@ -0,0 +1,209 @@
+/*
+ * Profiler.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Tasks.h"
+#include "Profiler.h"
+
+#if defined(ENABLE_PROFILER)
+
+typedef struct prof_slot_struct {
+  uint32_t  count;
+  uint32_t  sum_us;
+  uint32_t  min_us;
+  uint32_t  max_us;
+  uint32_t  hist[PROFILER_BUCKETS];
+  uint16_t  epoch;
+} prof_slot_t;
+
+typedef struct prof_shared_struct {
+  task_seq_t    seq;
+  prof_stats_t  stats;
+} prof_shared_t;
+
+const char *Profiler_Name[PROF_COUNT] = {
+  [PROF_LOOP]        = "LOOP",
+  [PROF_RF]          = "RF",
+  [PROF_TX]          = "TX",
+  [PROF_RX]          = "RX",
+  [PROF_PARSE]       = "PARSE",
+  [PROF_TRAFFIC]     = "TRAFFIC",
+  [PROF_GNSS]        = "GNSS",
+  [PROF_BARO]        = "BARO",
+  [PROF_EXPORT]      = "EXPORT",
+  [PROF_NMEA]        = "NMEA",
+  [PROF_DISPLAY]     = "DISPLAY",
+  [PROF_WEB]         = "WEB",
+  [PROF_IO]          = "IO",
+  [PROF_BATTERY]     = "BATTERY",
+  [PROF_TASK_RADIO]  = "TASK_RADIO",
+  [PROF_TASK_UI]     = "TASK_UI"
+};
+
+static prof_slot_t   Profiler_Slot[PROF_COUNT];
+static prof_shared_t Profiler_Shared[PROF_COUNT];
+static uint32_t      Profiler_Hist[PROFILER_BUCKETS];  /* under PROF_LOOP seq */
+
+static volatile uint16_t Profiler_Epoch    = 1;
+static unsigned long     Profiler_Epoch_ms = 0;
+static uint32_t          Profiler_tpu      = 1;   /* ticks per us */
+static uint32_t          Loop_ticks        = 0;
+static bool              Loop_started      = false;
+
+/* publish stats of the period that is over, start a new one */
+static void Profiler_close(uint8_t id)
+{
+  prof_slot_t   *s  = &Profiler_Slot[id];
+  prof_shared_t *sh = &Profiler_Shared[id];
+
+  if (s->count > 0) {
+    uint32_t threshold = s->count - s->count / 100;
+    uint32_t cumul     = 0;
+    int      b;
+
+    for (b = 0; b < PROFILER_BUCKETS - 1; b++) {
+      cumul += s->hist[b];
+      if (cumul >= threshold) {
+        break;
+      }
+    }
+
+    Tasks_Seq_write_begin(&sh->seq);
+
+    sh->stats.count  = s->count;
+    sh->stats.min_us = s->min_us;
+    sh->stats.avg_us = s->sum_us / s->count;
+    sh->stats.max_us = s->max_us;
+    sh->stats.p99_us = 2UL << b;
+    sh->stats.cpu    = s->sum_us / (PROFILER_PERIOD * 10);
+    sh->stats.epoch  = s->epoch;
+
+    if (id == PROF_LOOP) {
+      memcpy(Profiler_Hist, s->hist, sizeof(Profiler_Hist));
+    }
+
+    Tasks_Seq_write_end(&sh->seq);
+  }
+
+  memset(s, 0, sizeof(prof_slot_t));
+  s->min_us = 0xFFFFFFFF;
+  s->epoch  = Profiler_Epoch;
+}
+
+void Profiler_setup()
+{
+#if defined(ESP32)
+  Profiler_tpu = ESP.getCpuFreqMHz();
+#elif defined(RASPBERRY_PI)
+  Profiler_tpu = 1000;
+#elif defined(DWT)
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT       = 0;
+  DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+  Profiler_tpu      = SystemCoreClock / 1000000;
+#endif
+
+  for (int i = 0; i < PROF_COUNT; i++) {
+    Profiler_close(i);
+  }
+  memset(Profiler_Shared, 0, sizeof(Profiler_Shared));
+
+  Profiler_Epoch_ms = millis();
+}
+
+void Profiler_account(uint8_t id, uint32_t start)
+{
+  prof_slot_t *s  = &Profiler_Slot[id];
+  uint32_t     us = (Profiler_ticks() - start) / Profiler_tpu;
+
+  if (s->epoch != Profiler_Epoch) {
+    Profiler_close(id);
+  }
+
+  int b = us < 2 ? 0 : 31 - __builtin_clz(us);
+
+  s->hist[b < PROFILER_BUCKETS ? b : PROFILER_BUCKETS - 1]++;
+  s->count++;
+  s->sum_us += us;
+  if (us < s->min_us) {
+    s->min_us = us;
+  }
+  if (us > s->max_us) {
+    s->max_us = us;
+  }
+}
+
+/* once per main loop pass */
+void Profiler_loop()
+{
+  uint32_t ticks = Profiler_ticks();
+
+  if (millis() - Profiler_Epoch_ms >= PROFILER_PERIOD) {
+    Profiler_Epoch++;
+    Profiler_Epoch_ms = millis();
+  }
+
+  if (Loop_started) {
+    Profiler_account(PROF_LOOP, Loop_ticks);
+  }
+
+  Loop_ticks   = ticks;
+  Loop_started = true;
+}
+
+/*
+ * Last stats of subsystem id, and with PROF_LOOP the loop period
+ * histogram of the same period when hist is not NULL. False when no
+ * consistent copy could be taken, the copies are all zero then.
+ */
+bool Profiler_Stats_get(uint8_t id, prof_stats_t *stats, uint32_t *hist)
+{
+  prof_shared_t *sh = &Profiler_Shared[id];
+
+  for (int i = 0; i < TASKS_SEQ_TRIES; i++) {
+    uint32_t count = Tasks_Seq_read_begin(&sh->seq);
+
+    *stats = sh->stats;
+    if (hist != NULL && id == PROF_LOOP) {
+      memcpy(hist, Profiler_Hist, sizeof(Profiler_Hist));
+    }
+
+    if (Tasks_Seq_read_valid(&sh->seq, count)) {
+      return true;
+    }
+  }
+
+  memset(stats, 0, sizeof(prof_stats_t));
+  if (hist != NULL && id == PROF_LOOP) {
+    memset(hist, 0, sizeof(Profiler_Hist));
+  }
+
+  return false;
+}
+
+/* period of the stats that are due for a report, 0 when none is yet */
+uint16_t Profiler_Report_epoch()
+{
+  if (millis() - Profiler_Epoch_ms < PROFILER_PERIOD / 2) {
+    return 0;
+  }
+
+  return Profiler_Epoch - 1;
+}
+
+#endif /* ENABLE_PROFILER */
@@ -0,0 +1,118 @@
+/*
+ * Profiler.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILERHELPER_H
+#define PROFILERHELPER_H
+
+#include "SoC.h"
+
+/*
+ * Main loop profiler.
+ *
+ * PROFILE(id, call) accounts time spent in the call to subsystem id.
+ * Time comes from the CPU cycle counter where there is one (ESP32,
+ * DWT of Cortex-M3 and above), from CLOCK_MONOTONIC on Linux and from
+ * micros() elsewhere. Every subsystem keeps a log2 histogram of its
+ * durations, min/avg/max and the 99th percentile are taken from it
+ * at the end of each PROFILER_PERIOD. Profiler_loop() is called once per
+ * main loop pass and accounts the loop period the same way.
+ *
+ * A subsystem is accounted by one task only (see Tasks.h), which also
+ * closes its period on first call in the next one and publishes its
+ * stats under a sequence lock of their own. Profiler_Stats_get() gives
+ * a consistent copy to any task. Reports are read in the second half
+ * of the period. The passes of the radio and the UI task are accounted
+ * the same way, as PROF_TASK_RADIO and PROF_TASK_UI.
+ *
+ * Without ENABLE_PROFILER, PROFILE() is the bare call.
+ */
+
+enum
+{
+  PROF_LOOP,                   /* loop period, start to start */
+  PROF_RF,                     /* RF_loop() */
+  PROF_TX,                     /* encode and transmit */
+  PROF_RX,                     /* RF_Receive() */
+  PROF_PARSE,                  /* ParseData() */
+  PROF_TRAFFIC,                /* Traffic_loop(), alarms */
+  PROF_GNSS,
+  PROF_BARO,
+  PROF_EXPORT,                 /* NMEA, GDL90, D1090 export */
+  PROF_NMEA,                   /* NMEA_loop() */
+  PROF_DISPLAY,
+  PROF_WEB,
+  PROF_IO,                     /* Output_loop(), output queues */
+  PROF_BATTERY,
+  PROF_TASK_RADIO,             /* pass of the radio task */
+  PROF_TASK_UI,                /* pass of the UI task */
+  PROF_COUNT
+};
+
+#if defined(ENABLE_PROFILER)
+
+#define PROFILER_PERIOD     10000  /* ms */
+#define PROFILER_BUCKETS    16     /* [2^i, 2^(i+1)) us, last one takes the rest */
+#define PROFILER_NAME_MAX   10     /* longest of Profiler_Name[], "TASK_RADIO" */
+
+#if defined(ESP32)
+#define Profiler_ticks()    ((uint32_t) ESP.getCycleCount())
+#elif defined(RASPBERRY_PI)
+#include <time.h>
+static inline uint32_t Profiler_ticks()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t) ts.tv_sec * 1000000000UL + (uint32_t) ts.tv_nsec;
+}
+#elif defined(DWT)
+#define Profiler_ticks()    ((uint32_t) DWT->CYCCNT)
+#else
+#define Profiler_ticks()    ((uint32_t) micros())
+#endif
+
+typedef struct prof_stats_struct {
+  uint32_t  count;
+  uint32_t  min_us;
+  uint32_t  avg_us;
+  uint32_t  max_us;
+  uint32_t  p99_us;            /* upper bound of the bucket */
+  uint16_t  cpu;               /* % of the core, all calls together */
+  uint16_t  epoch;             /* period these are of */
+} prof_stats_t;
+
+extern const char   *Profiler_Name[PROF_COUNT];
+
+void     Profiler_setup(void);
+void     Profiler_loop(void);
+void     Profiler_account(uint8_t, uint32_t);
+bool     Profiler_Stats_get(uint8_t, prof_stats_t *, uint32_t *);
+uint16_t Profiler_Report_epoch(void);
+
+#define PROFILE(id, ...)    do { uint32_t prof_start = Profiler_ticks(); \
+                                 __VA_ARGS__;                           \
+                                 Profiler_account(id, prof_start);      \
+                            } while (0)
+
+#else
+
+#define PROFILE(id, ...)    do { __VA_ARGS__; } while (0)
+
+#endif /* ENABLE_PROFILER */
+
+#endif /* PROFILERHELPER_H */
@@ -0,0 +1,247 @@
+/*
+ * Tasks.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "SoC.h"
+#include "Tasks.h"
+#include "Profiler.h"
+
+#if defined(ENABLE_RADIO_TASK)
+
+#include <esp_task_wdt.h>
+
+#include "../driver/Sound.h"
+
+bool         Tasks_Split = false;
+
+static uint8_t  Event_buf  [TASKS_EVENT_SLOTS];
+static uint32_t Event_stamp[TASKS_EVENT_SLOTS];
+static ufo_t    Inject_buf  [TASKS_INJECT_SLOTS];
+static uint32_t Inject_stamp[TASKS_INJECT_SLOTS];
+
+task_queue_t Tasks_Event_Queue  = {
+  Event_buf,  Event_stamp,  sizeof(uint8_t), TASKS_EVENT_SLOTS,  0, 0, { 0 }
+};
+task_queue_t Tasks_Inject_Queue = {
+  (uint8_t *) Inject_buf, Inject_stamp, sizeof(ufo_t), TASKS_INJECT_SLOTS, 0, 0, { 0 }
+};
+
+static void (*Radio_pass)(void) = NULL;
+static void (*UI_pass)(void)    = NULL;
+
+static TaskHandle_t Radio_Task_Handle = NULL;
+static TaskHandle_t UI_Task_Handle    = NULL;
+
+static volatile bool Radio_Stop   = false;
+static volatile bool Radio_Parked = false;
+
+static task_seq_t     Ownship_seq = 0;
+static ownship_view_t Ownship_shared;
+
+bool Tasks_Queue_put(task_queue_t *q, const void *item)
+{
+  uint8_t head = q->head;
+  uint8_t used = head - q->tail;
+
+  if (used >= q->slots) {
+    q->stats.drops++;
+    return false;
+  }
+
+  uint8_t ndx = head & (q->slots - 1);
+
+  memcpy(q->buf + ndx * q->item_size, item, q->item_size);
+  q->stamp[ndx] = micros();
+
+  /* item must be in place before the consumer sees the new head */
+  __sync_synchronize();
+  q->head = head + 1;
+
+  if (used + 1 > q->stats.hwm) {
+    q->stats.hwm = used + 1;
+  }
+
+  return true;
+}
+
+bool Tasks_Queue_get(task_queue_t *q, void *item)
+{
+  uint8_t tail = q->tail;
+
+  if (q->head == tail) {
+    return false;
+  }
+
+  __sync_synchronize();
+
+  uint8_t  ndx = tail & (q->slots - 1);
+  uint32_t lat = micros() - q->stamp[ndx];
+
+  memcpy(item, q->buf + ndx * q->item_size, q->item_size);
+
+  __sync_synchronize();
+  q->tail = tail + 1;
+
+  /* average over 8 last items */
+  q->stats.lat_avg_us += ((int32_t) (lat - q->stats.lat_avg_us)) / 8;
+  if (lat > q->stats.lat_max_us) {
+    q->stats.lat_max_us = lat;
+  }
+
+  return true;
+}
+
+/* UI side, after every update of ownship */
+void Tasks_Ownship_publish(ownship_view_t *view)
+{
+  Tasks_Seq_write_begin(&Ownship_seq);
+  Ownship_shared = *view;
+  Tasks_Seq_write_end(&Ownship_seq);
+}
+
+/*
+ * Radio side, once a pass. False when no consistent copy is there
+ * (yet), the view is left as it was then.
+ */
+bool Tasks_Ownship_get(ownship_view_t *view)
+{
+  for (int i = 0; i < TASKS_SEQ_TRIES; i++) {
+    uint32_t count = Tasks_Seq_read_begin(&Ownship_seq);
+
+    if (count == 0) {
+      return false;
+    }
+
+    ownship_view_t copy = Ownship_shared;
+
+    if (Tasks_Seq_read_valid(&Ownship_seq, count)) {
+      *view = copy;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void UI_Task(void *parameter)
+{
+  esp_task_wdt_add(NULL);
+
+  for (;;) {
+    /* every task accounts its own passes, on its own core */
+    PROFILE(PROF_TASK_UI, UI_pass());
+
+    esp_task_wdt_reset();
+
+    /* let IDLE task of the core run, its WDT is on */
+    vTaskDelay(1);
+  }
+}
+
+bool Tasks_setup(void (*radio)(void), void (*ui)(void))
+{
+  Radio_pass = radio;
+  UI_pass    = ui;
+
+  Radio_Task_Handle = xTaskGetCurrentTaskHandle();
+
+  /* UI side starts with inputs routed through the queues */
+  Tasks_Split = true;
+
+  if (xTaskCreatePinnedToCore(UI_Task, "UI", UI_TASK_STACK_SZ, NULL,
+                              UI_TASK_PRIO, &UI_Task_Handle,
+                              UI_TASK_CORE) != pdPASS) {
+    UI_Task_Handle = NULL;
+    Tasks_Split = false;
+    return false;
+  }
+
+  /* loop() task carries the radio part from now on */
+  vTaskPrioritySet(NULL, RADIO_TASK_PRIO);
+
+  return true;
+}
+
+void Tasks_Radio_loop()
+{
+  if (Radio_Stop) {
+    Radio_Parked = true;
+    vTaskDelay(100);
+    return;
+  }
+
+  PROFILE(PROF_TASK_RADIO, Radio_pass());
+
+  /* the radio task outranks everything else of the core */
+  vTaskDelay(1);
+}
+
+/* stop the radio side before the UI side shuts the radio down */
+void Tasks_fini()
+{
+  if (!Tasks_Split) {
+    return;
+  }
+
+  Radio_Stop = true;
+  for (int i = 0; i < 100 && !Radio_Parked; i++) {
+    delay(1);
+  }
+
+  if (xTaskGetCurrentTaskHandle() == UI_Task_Handle) {
+    esp_task_wdt_delete(NULL);
+  }
+}
+
+bool Tasks_isRadio()
+{
+  return !Tasks_Split || xTaskGetCurrentTaskHandle() == Radio_Task_Handle;
+}
+
+static void Tasks_Event(uint8_t event)
+{
+  switch (event)
+  {
+  case TASK_EV_SOUND:
+    Sound_Notify();
+    break;
+  default:
+    break;
+  }
+}
+
+/* radio side: hand an event over to the UI side */
+void Tasks_Notify(uint8_t event)
+{
+  if (Tasks_Split) {
+    Tasks_Queue_put(&Tasks_Event_Queue, &event);
+  } else {
+    Tasks_Event(event);
+  }
+}
+
+/* UI side */
+void Tasks_Dispatch()
+{
+  uint8_t event;
+
+  while (Tasks_Queue_get(&Tasks_Event_Queue, &event)) {
+    Tasks_Event(event);
+  }
+}
+
+#endif /* ENABLE_RADIO_TASK */
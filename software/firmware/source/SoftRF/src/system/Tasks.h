@@ -0,0 +1,136 @@
+/*
+ * Tasks.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TASKSHELPER_H
+#define TASKSHELPER_H
+
+#include "SoC.h"
+
+/*
+ * Dual-core task split (ESP32).
+ *
+ * In normal mode Arduino loop() keeps the radio part only: RF Rx/Tx,
+ * ParseData(), alarm evaluation and the traffic table upkeep. Its task
+ * is raised to RADIO_TASK_PRIO on the application core. GNSS, exporters,
+ * web, Bluetooth, display and the rest of the former loop() run by
+ * the UI task pinned to the other core, next to the WiFi and BT stacks.
+ *
+ * The two sides exchange data through single producer, single consumer
+ * queues (alarm events one way, traffic from the UI side inputs the other)
+ * and through sequence locked copies of the traffic table entries
+ * (see Traffic_Publish()) and of ownship. The radio task takes one
+ * copy of ownship per pass, with the time base of the slots that the
+ * time PLL keeps on the UI side, and never reads ThisAircraft or 'gnss'.
+ * Neither side ever waits for the other one.
+ */
+
+#define TASKS_SEQ_TRIES       4    /* reads of a sequence locked record */
+
+/*
+ * Sequence lock of a record with one writer. The count is odd while
+ * the writer updates the record. A reader copies the record out and
+ * keeps the copy only when the count was even and has not moved.
+ */
+typedef volatile uint32_t task_seq_t;
+
+static inline void Tasks_Seq_write_begin(task_seq_t *seq)
+{
+  *seq = *seq + 1;
+  __sync_synchronize();
+}
+
+static inline void Tasks_Seq_write_end(task_seq_t *seq)
+{
+  __sync_synchronize();
+  *seq = *seq + 1;
+}
+
+static inline uint32_t Tasks_Seq_read_begin(task_seq_t *seq)
+{
+  uint32_t count = *seq;
+
+  __sync_synchronize();
+  return count;
+}
+
+static inline bool Tasks_Seq_read_valid(task_seq_t *seq, uint32_t count)
+{
+  __sync_synchronize();
+  return (count & 1) == 0 && *seq == count;
+}
+
+#if defined(ENABLE_RADIO_TASK)
+
+#define RADIO_TASK_PRIO       5
+#define UI_TASK_PRIO          1
+#define UI_TASK_CORE          (CONFIG_ARDUINO_RUNNING_CORE ^ 1)
+#define UI_TASK_STACK_SZ      8192
+
+/* queue sizes are powers of 2 */
+#define TASKS_EVENT_SLOTS     8
+#define TASKS_INJECT_SLOTS    8
+
+enum
+{
+  TASK_RADIO,
+  TASK_UI,
+  TASK_COUNT
+};
+
+enum
+{
+  TASK_EV_SOUND,                   /* new traffic, Sound_Notify() */
+};
+
+typedef struct task_queue_stats_struct {
+  uint32_t          lat_avg_us;    /* put to get, moving average */
+  uint32_t          lat_max_us;
+  uint32_t          drops;
+  uint8_t           hwm;           /* slots */
+} task_queue_stats_t;
+
+typedef struct task_queue_struct {
+  uint8_t           *buf;
+  uint32_t          *stamp;        /* micros() of every put */
+  uint16_t          item_size;
+  uint8_t           slots;         /* power of 2 */
+  volatile uint8_t  head;          /* advanced by producer only */
+  volatile uint8_t  tail;          /* advanced by consumer only */
+  task_queue_stats_t stats;
+} task_queue_t;
+
+extern bool               Tasks_Split;
+extern task_queue_t       Tasks_Event_Queue;
+extern task_queue_t       Tasks_Inject_Queue;
+
+bool Tasks_setup(void (*)(void), void (*)(void));
+void Tasks_Radio_loop(void);
+void Tasks_fini(void);
+bool Tasks_isRadio(void);
+void Tasks_Notify(uint8_t);
+void Tasks_Dispatch(void);
+
+bool Tasks_Queue_put(task_queue_t *, const void *);
+bool Tasks_Queue_get(task_queue_t *, void *);
+
+void Tasks_Ownship_publish(ownship_view_t *);
+bool Tasks_Ownship_get(ownship_view_t *);
+
+#endif /* ENABLE_RADIO_TASK */
+
+#endif /* TASKSHELPER_H */
@@ -18,143 +18,323 @@
 
 #include "SoC.h"
 #include "Time.h"
+#include "../driver/GNSS.h"
+#include <TimeLib.h>
 
 #if defined(EXCLUDE_WIFI) || defined(USE_ARDUINO_WIFI)
 void Time_setup()     {}
+#define NTP_loop()    {}
 #else
 
 #include <TimeLib.h>
+#include <lwip/dns.h>
+#if defined(ESP32)
+#include <lwip/tcpip.h>
+#endif /* ESP32 */
+
+#if !defined(LOCK_TCPIP_CORE)
+#define LOCK_TCPIP_CORE()     {}
+#define UNLOCK_TCPIP_CORE()   {}
+#endif /* LOCK_TCPIP_CORE */
+
+/*
+ * Time acquisition by NTP, in background of the main loop.
+ *
+ * Every pass of Time_loop() starts the name lookup of one pool server,
+ * by lwIP in background, and sends a request to each server whose
+ * name has come back since; replies to the requests sent so far are
+ * taken in meanwhile. No pass waits for the network. First valid reply
+ * sets the clock. A round without any reply within NTP_DEADLINE of the
+ * last lookup or request, once all lookups are back, is repeated every
+ * NTP_RETRY ms until either NTP or GNSSTimeSync() sets the time.
+ */
 
-unsigned int localPort = 2390;      // local port to listen for UDP packets
+#define NTP_PORT            123
+#define NTP_LOCAL_PORT      2390
+#define NTP_SERVERS         4
+#define NTP_DEADLINE        3000          /* ms, after the last request */
+#define NTP_RETRY           60000         /* ms */
+#define NTP_UNIX_OFFSET     2208988800UL  /* s, Jan 1 1900 to Jan 1 1970 */
 
 /* Don't hardwire the IP address or we won't get the benefits of the pool.
  *  Lookup the IP address for the host name instead */
-//IPAddress timeServer(129, 6, 15, 28); // time.nist.gov NTP server
-IPAddress timeServerIP; // time.nist.gov NTP server address
-//const char* ntpServerName = "time.nist.gov";
 const String ntpServerName_suffix = ".pool.ntp.org";
 
 const int NTP_PACKET_SIZE = 48; // NTP time stamp is in the first 48 bytes of the message
 
 byte NTPPacketBuffer[ NTP_PACKET_SIZE]; //buffer to hold incoming and outgoing packets
 
-void Time_setup()
+enum
+{
+  NTP_IDLE,
+  NTP_RESOLVE,
+  NTP_WAIT,
+  NTP_BACKOFF,
+  NTP_DONE
+};
+
+enum
+{
+  NTP_REQ_IDLE,
+  NTP_REQ_RESOLVING,  /* lookup of the name is under way */
+  NTP_REQ_RESOLVED,
+  NTP_REQ_SENT,
+  NTP_REQ_FAILED
+};
+
+typedef struct ntp_request_struct {
+  IPAddress        ip;
+  uint32_t         nonce;    /* echoed back by the server as origin timestamp */
+  unsigned long    sent_ms;  /* 0 - not sent */
+  volatile uint8_t state;    /* of the lookup, set by lwIP too */
+} ntp_request_t;
+
+static WiFiUDP       NTP_udp;
+static ntp_request_t NTP_request[NTP_SERVERS];
+static uint8_t       NTP_state  = NTP_IDLE;
+static uint8_t       NTP_server = 0;
+static unsigned long NTP_marker = 0;
+
+static uint32_t NTP_word32(const byte *p)
+{
+  return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 |
+         (uint32_t) p[2] <<  8 | (uint32_t) p[3];
+}
+
+static void NTP_start()
 {
-  int cb = 0;
-  String ntpServerName;
+  if (WiFi.status() != WL_CONNECTED) {
+    NTP_state  = NTP_BACKOFF;
+    NTP_marker = millis();
+    return;
+  }
 
-  // Do not attempt to timesync in Soft AP mode
-  if (WiFi.getMode() == WIFI_AP) {
+  for (int i = 0; i < NTP_SERVERS; i++) {
+    NTP_request[i].nonce   = 0;
+    NTP_request[i].sent_ms = 0;
+    /* a lookup of the round before is left to come back into this one */
+    if (NTP_request[i].state != NTP_REQ_RESOLVING) {
+      NTP_request[i].state = NTP_REQ_IDLE;
+    }
+  }
+  NTP_server = 0;
+
+  NTP_udp.begin(NTP_LOCAL_PORT);
+  NTP_state  = NTP_RESOLVE;
+}
+
+static void NTP_stop(uint8_t state)
+{
+  NTP_udp.stop();
+  NTP_state  = state;
+  NTP_marker = millis();
+}
+
+/* lwIP context, when the lookup has not been answered from its cache */
+static void NTP_found(const char *name, const ip_addr_t *ipaddr, void *arg)
+{
+  ntp_request_t *req = (ntp_request_t *) arg;
+
+  if (req->state != NTP_REQ_RESOLVING) {
+    return;
+  }
+
+  if (ipaddr) {
+    req->ip    = IPAddress(ip_addr_get_ip4_u32(ipaddr));
+    req->state = NTP_REQ_RESOLVED;
+  } else {
+    req->state = NTP_REQ_FAILED;
+  }
+}
+
+static void NTP_resolve(ntp_request_t *req, uint8_t server)
+{
+  String ntpServerName = String(server) + ntpServerName_suffix;
+  ip_addr_t addr;
+  err_t err;
+
+  if (req->state == NTP_REQ_RESOLVING) {
     return;
   }
 
-  // A UDP instance to let us send and receive packets over UDP
-  WiFiUDP NTP_udp;
-
-  Serial.println(F("Starting NTP UDP"));
-  NTP_udp.begin(localPort);
-  Serial.print(F("Local port: "));
-  Serial.println(localPort);
-
-  for (int attempt = 1; attempt <= 4; attempt++ ) {
-
-    //get a random server from the pool
-    ntpServerName = String(attempt-1) + ntpServerName_suffix;
-    WiFi.hostByName(ntpServerName.c_str(), timeServerIP);
-
-    Serial.print('#');
-    Serial.print(attempt);
-    Serial.print(F(" NTP server's IP address: "));
-    Serial.println(timeServerIP);
-
-    // send an NTP request to the time server at the given address
-    Serial.println(F("sending NTP packet..."));
-    // set all bytes in the buffer to 0
-    memset(NTPPacketBuffer, 0, NTP_PACKET_SIZE);
-    // Initialize values needed to form NTP request
-    // (see URL above for details on the packets)
-    NTPPacketBuffer[0] = 0b11100011;   // LI, Version, Mode
-    NTPPacketBuffer[1] = 0;     // Stratum, or type of clock
-    NTPPacketBuffer[2] = 6;     // Polling Interval
-    NTPPacketBuffer[3] = 0xEC;  // Peer Clock Precision
-    // 8 bytes of zero for Root Delay & Root Dispersion
-    NTPPacketBuffer[12]  = 49;
-    NTPPacketBuffer[13]  = 0x4E;
-    NTPPacketBuffer[14]  = 49;
-    NTPPacketBuffer[15]  = 52;
-
-    // all NTP fields have been given values, now
-    // you can send a packet requesting a timestamp:
-    NTP_udp.beginPacket(timeServerIP, 123); //NTP requests are to port 123
-    NTP_udp.write(NTPPacketBuffer, NTP_PACKET_SIZE);
-    NTP_udp.endPacket();
-
-    // wait to see if a reply is available
-    delay(2000);
-
-    cb = NTP_udp.parsePacket();
-    if (!cb) {
-      Serial.print(F("No response on request #"));
-      Serial.println(attempt);
+  /* before the call: the answer may come back on another core */
+  req->state = NTP_REQ_RESOLVING;
+
+  LOCK_TCPIP_CORE();
+#if defined(LWIP_IPV6) && LWIP_IPV6
+  /* the request goes over IPv4 */
+  err = dns_gethostbyname_addrtype(ntpServerName.c_str(), &addr, NTP_found,
+                                   req, LWIP_DNS_ADDRTYPE_IPV4);
+#else
+  err = dns_gethostbyname(ntpServerName.c_str(), &addr, NTP_found, req);
+#endif /* LWIP_IPV6 */
+  UNLOCK_TCPIP_CORE();
+
+  if (err == ERR_OK) {
+    req->ip    = IPAddress(ip_addr_get_ip4_u32(&addr));
+    req->state = NTP_REQ_RESOLVED;
+  } else if (err != ERR_INPROGRESS) {
+    req->state = NTP_REQ_FAILED;
+  }
+}
+
+/* lwIP gives every lookup an answer or a failure, in its own time */
+static bool NTP_resolving()
+{
+  for (int i = 0; i < NTP_SERVERS; i++) {
+    if (NTP_request[i].state == NTP_REQ_RESOLVING) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+static void NTP_send(ntp_request_t *req)
+{
+  req->state = NTP_REQ_SENT;
+
+  // set all bytes in the buffer to 0
+  memset(NTPPacketBuffer, 0, NTP_PACKET_SIZE);
+  // Initialize values needed to form NTP request
+  NTPPacketBuffer[0] = 0b11100011;   // LI, Version, Mode
+  NTPPacketBuffer[1] = 0;     // Stratum, or type of clock
+  NTPPacketBuffer[2] = 6;     // Polling Interval
+  NTPPacketBuffer[3] = 0xEC;  // Peer Clock Precision
+  // 8 bytes of zero for Root Delay & Root Dispersion
+  NTPPacketBuffer[12]  = 49;
+  NTPPacketBuffer[13]  = 0x4E;
+  NTPPacketBuffer[14]  = 49;
+  NTPPacketBuffer[15]  = 52;
+
+  // fraction of transmit timestamp carries the nonce
+  req->nonce = (uint32_t) SoC->random(1, 0x7FFFFFFF);
+  NTPPacketBuffer[44] = (req->nonce >> 24) & 0xFF;
+  NTPPacketBuffer[45] = (req->nonce >> 16) & 0xFF;
+  NTPPacketBuffer[46] = (req->nonce >>  8) & 0xFF;
+  NTPPacketBuffer[47] = (req->nonce      ) & 0xFF;
+
+  NTP_udp.beginPacket(req->ip, NTP_PORT);
+  NTP_udp.write(NTPPacketBuffer, NTP_PACKET_SIZE);
+  if (NTP_udp.endPacket()) {
+    req->sent_ms = millis();
+  }
+}
+
+/* Unix time of the first valid reply, 0 when none has come in yet */
+static unsigned long NTP_receive()
+{
+  while (NTP_udp.parsePacket() >= NTP_PACKET_SIZE) {
+
+    NTP_udp.read(NTPPacketBuffer, NTP_PACKET_SIZE);
+
+    uint8_t  li       = NTPPacketBuffer[0] >> 6;
+    uint8_t  mode     = NTPPacketBuffer[0] & 0x07;
+    uint8_t  stratum  = NTPPacketBuffer[1];
+    uint32_t origin   = NTP_word32(&NTPPacketBuffer[28]);
+    uint32_t tx_sec   = NTP_word32(&NTPPacketBuffer[40]);
+    uint32_t tx_frac  = NTP_word32(&NTPPacketBuffer[44]);
+
+    /* server mode, synchronized, not a "kiss-o'-death" */
+    if (mode != 4 || li == 3 || stratum == 0 || stratum > 15 || tx_sec == 0) {
       continue;
     }
-    else {
-      Serial.print(F("Reply packet received, length="));
-      Serial.println(cb);
-      // We've received a packet, read the data from it
-      NTP_udp.read(NTPPacketBuffer, NTP_PACKET_SIZE); // read the packet into the buffer
-      break;
+
+    for (int i = 0; i < NTP_SERVERS; i++) {
+      ntp_request_t *req = &NTP_request[i];
+
+      if (req->sent_ms == 0 || req->nonce != origin ||
+          !(req->ip == NTP_udp.remoteIP())) {
+        continue;
+      }
+
+      /* half of the round trip is on the way back */
+      unsigned long ms = (unsigned long) (((uint64_t) tx_frac * 1000) >> 32) +
+                         (millis() - req->sent_ms) / 2;
+
+      Serial.print(F("NTP reply from "));
+      Serial.print(req->ip);
+      Serial.print(F(", round trip "));
+      Serial.print(millis() - req->sent_ms);
+      Serial.println(F(" ms"));
+
+      return tx_sec - NTP_UNIX_OFFSET + ms / 1000;
     }
   }
 
-  NTP_udp.stop();
+  return 0;
+}
 
-  if (!cb) {
-    Serial.println(F("WARNING! Unable to sync time by NTP."));
+void Time_setup()
+{
+  // Do not attempt to timesync in Soft AP mode
+  if (WiFi.getMode() == WIFI_AP) {
     return;
   }
 
-  //the timestamp starts at byte 40 of the received packet and is four bytes,
-  // or two words, long. First, esxtract the two words:
+  NTP_start();
+}
 
-  unsigned long highWord = word(NTPPacketBuffer[40], NTPPacketBuffer[41]);
-  unsigned long lowWord = word(NTPPacketBuffer[42], NTPPacketBuffer[43]);
-  // combine the four bytes (two words) into a long integer
-  // this is NTP time (seconds since Jan 1 1900):
-  unsigned long secsSince1900 = highWord << 16 | lowWord;
-  Serial.print(F("Seconds since Jan 1 1900 = "));
-  Serial.println(secsSince1900);
+static void NTP_loop()
+{
+  if (NTP_state == NTP_IDLE || NTP_state == NTP_DONE) {
+    return;
+  }
 
-  // now convert NTP time into everyday time:
-  Serial.print(F("Unix time = "));
-  // Unix time starts on Jan 1 1970. In seconds, that's 2208988800:
-  const unsigned long seventyYears = 2208988800UL;
-  // subtract seventy years:
-  unsigned long epoch = secsSince1900 - seventyYears;
-  // print Unix time:
-  Serial.println(epoch);
+  /* GNSS time is more accurate and wins */
+  if (Time_source == TIME_SOURCE_GNSS) {
+    NTP_stop(NTP_DONE);
+    return;
+  }
 
-  setTime((time_t) epoch);
+  if (NTP_state == NTP_BACKOFF) {
+    if (millis() - NTP_marker > NTP_RETRY) {
+      NTP_start();
+    }
+    return;
+  }
 
-  // print the hour, minute and second:
-  Serial.print(F("The UTC time is "));       // UTC is the time at Greenwich Meridian (GMT)
-  Serial.print((epoch  % 86400L) / 3600); // print the hour (86400 equals secs per day)
-  Serial.print(':');
-  if ( ((epoch % 3600) / 60) < 10 ) {
-    // In the first 10 minutes of each hour, we'll want a leading '0'
-    Serial.print('0');
+  if (NTP_state == NTP_RESOLVE) {
+    NTP_resolve(&NTP_request[NTP_server], NTP_server);
+    NTP_marker = millis();
+    if (++NTP_server >= NTP_SERVERS) {
+      NTP_state = NTP_WAIT;
+    }
   }
-  Serial.print((epoch  % 3600) / 60); // print the minute (3600 equals secs per minute)
-  Serial.print(':');
-  if ( (epoch % 60) < 10 ) {
-    // In the first 10 seconds of each minute, we'll want a leading '0'
-    Serial.print('0');
+
+  for (int i = 0; i < NTP_SERVERS; i++) {
+    if (NTP_request[i].state == NTP_REQ_RESOLVED) {
+      NTP_send(&NTP_request[i]);
+      NTP_marker = millis();
+    }
+  }
+
+  unsigned long epoch = NTP_receive();
+
+  if (epoch) {
+    setTime((time_t) epoch);
+    NTP_stop(NTP_DONE);
+
+    Time_source   = TIME_SOURCE_NTP;
+    Time_valid_ms = millis();
+
+    Serial.print(F("Unix time = "));
+    Serial.println(epoch);
+    Serial.print(F("INFO: clock is set by NTP in "));
+    Serial.print(Time_valid_ms);
+    Serial.println(F(" ms after start."));
+  } else if (NTP_state == NTP_WAIT && millis() - NTP_marker > NTP_DEADLINE &&
+             !NTP_resolving()) {
+    Serial.println(F("WARNING! Unable to sync time by NTP. Will retry."));
+    NTP_stop(NTP_BACKOFF);
   }
-  Serial.println(epoch % 60); // print the second
 }
 
 #endif /* EXCLUDE_WIFI */
 
+uint8_t  Time_source   = TIME_SOURCE_NONE;
+uint32_t Time_valid_ms = 0;
+
 UpTime_t UpTime = {0, 0, 0, 0};
 static unsigned long UpTime_Marker = 0;
 
@@ -162,6 +342,16 @@ void Time_loop()
 {
   unsigned long ms_since_boot = millis();
 
+  if (Time_source != TIME_SOURCE_GNSS && GNSSTimeSyncMarker != 0) {
+    if (Time_source == TIME_SOURCE_NONE) {
+      Time_valid_ms = GNSSTimeSyncMarker;
+    }
+    Time_source = TIME_SOURCE_GNSS;
+  }
+
+  NTP_loop();
+
+
   if (ms_since_boot - UpTime_Marker > 1000) {
 
     uint32_t sec   = ms_since_boot / 1000;
@@ -183,3 +373,196 @@ void Time_loop()
     UpTime_Marker = ms_since_boot;
   }
 }
+
+#if !defined(EXCLUDE_TIME_PLL)
+
+/*
+ * PPS disciplined time base.
+ *
+ * Second order (phase + frequency) software PLL that keeps track of
+ * the start of UTC second in micros() units. PPS edges are preferred,
+ * arrival of NMEA time is used with lower loop gain when PPS is absent.
+ * At navigation rates above 1 Hz only the first NMEA epoch of every
+ * UTC second is taken in.
+ */
+
+#define TIME_PLL_NOMINAL    1000000L  /* us in a second */
+#define TIME_PLL_MAX_DRIFT  500       /* ppm */
+#define TIME_PLL_CAPTURE    50000     /* us, re-acquire on larger error */
+#define TIME_PLL_HOLDOVER   10        /* s */
+#define TIME_PPS_TIMEOUT    2100000UL /* us */
+
+Time_PLL_t Time_PLL = {
+  TIME_PLL_UNLOCKED, 0, 0, TIME_PLL_NOMINAL << 8, 0, 0, 0, 0
+};
+
+extern const gnss_chip_ops_t *gnss_chip;
+
+static inline unsigned long Time_PLL_period()
+{
+  return (unsigned long) ((Time_PLL.period_q8 + 128) >> 8);
+}
+
+void Time_PLL_input(unsigned long edge_us, uint8_t source)
+{
+  unsigned long period  = Time_PLL_period();
+  unsigned long elapsed = edge_us - Time_PLL.base_us;
+  unsigned long n       = (elapsed + period / 2) / period;
+  int32_t       error   = (int32_t) (elapsed - n * period);
+
+  if (Time_PLL.state == TIME_PLL_UNLOCKED ||
+      n > TIME_PLL_HOLDOVER               ||
+      error > TIME_PLL_CAPTURE || error < -TIME_PLL_CAPTURE) {
+    /* (re-)acquire phase, keep frequency estimate */
+    Time_PLL.base_us   = edge_us;
+    Time_PLL.base_sec  = 0;
+    Time_PLL.error_us  = 0;
+    Time_PLL.jitter_us = 0;
+    Time_PLL.state     = source;
+    return;
+  }
+
+  if (n == 0) {
+    /* edge of the second that is already taken in */
+    return;
+  }
+
+  /* NMEA arrival time is much noisier than PPS, use lower gain */
+  uint8_t kp = (source == TIME_PLL_PPS ? 1 : 4);
+  uint8_t ki = (source == TIME_PLL_PPS ? 4 : 10);
+
+  Time_PLL.base_us   += n * period + (error >> kp);
+  Time_PLL.period_q8 += (int32_t) ((error * 256) / (int32_t) n) >> ki;
+
+  if (Time_PLL.period_q8 > (TIME_PLL_NOMINAL + TIME_PLL_MAX_DRIFT) << 8) {
+    Time_PLL.period_q8 = (TIME_PLL_NOMINAL + TIME_PLL_MAX_DRIFT) << 8;
+  } else if (Time_PLL.period_q8 < (TIME_PLL_NOMINAL - TIME_PLL_MAX_DRIFT) << 8) {
+    Time_PLL.period_q8 = (TIME_PLL_NOMINAL - TIME_PLL_MAX_DRIFT) << 8;
+  }
+
+  if (Time_PLL.base_sec) {
+    Time_PLL.base_sec += n;
+  }
+
+  Time_PLL.error_us   = error;
+  Time_PLL.jitter_us += ((error < 0 ? -error : error) - (int32_t) Time_PLL.jitter_us) / 8;
+  Time_PLL.state      = source;
+}
+
+/* assign UTC second number to the PLL phase with NMEA time */
+static void Time_PLL_label(uint32_t fix_sec, unsigned long commit_us)
+{
+  long period = (long) Time_PLL_period();
+  long d      = (long) (commit_us - Time_PLL.base_us);
+  long k      = d >= 0 ? d / period : -((period - 1 - d) / period);
+
+  Time_PLL.base_sec = fix_sec - k;
+}
+
+void Time_PLL_loop()
+{
+  unsigned long us     = micros();
+  unsigned long pps_ms = SoC->get_PPS_TimeMarker();
+  bool has_PPS = (pps_ms != 0 && (millis() - pps_ms) < TIME_PPS_TIMEOUT / 1000);
+
+  if (has_PPS && pps_ms != Time_PLL.pps_ms) {
+    unsigned long pps_us = PPS_TimeMarker_us;
+
+    if (pps_us == 0) {
+      /* platform reports PPS edges with 1 ms resolution only */
+      pps_us = us - (millis() - pps_ms) * 1000UL;
+    }
+    Time_PLL_input(pps_us, TIME_PLL_PPS);
+    Time_PLL.pps_ms = pps_ms;
+  }
+
+  if (gnss.time.isValid() && gnss.date.isValid() &&
+      gnss.time.value() != Time_PLL.nmea_time && gnss.time.age() < 1000) {
+    tmElements_t tm;
+    unsigned long commit_us = us - gnss.time.age() * 1000UL;
+    /* HHMMSSCC, first epoch of a new UTC second */
+    bool new_sec = (gnss.time.value() / 100 != Time_PLL.nmea_time / 100);
+
+    Time_PLL.nmea_time = gnss.time.value();
+
+    if (!has_PPS && new_sec) {
+      unsigned long rmc_ms = gnss_chip ? gnss_chip->rmc_ms : 100;
+      /* fractional second is non-zero at nav. rates above 1 Hz */
+      rmc_ms += gnss.time.centisecond() * 10UL;
+      Time_PLL_input(commit_us - rmc_ms * 1000UL, TIME_PLL_NMEA);
+    }
+
+    int yr    = gnss.date.year();
+    tm.Year   = yr > 99 ? yr - 1970 : yr + 30;
+    tm.Month  = gnss.date.month();
+    tm.Day    = gnss.date.day();
+    tm.Hour   = gnss.time.hour();
+    tm.Minute = gnss.time.minute();
+    tm.Second = gnss.time.second();
+
+    if (Time_PLL.state != TIME_PLL_UNLOCKED) {
+      Time_PLL_label(makeTime(tm), commit_us);
+    }
+  }
+
+  if (Time_PLL.state != TIME_PLL_UNLOCKED &&
+      (us - Time_PLL.base_us) / TIME_PLL_NOMINAL > TIME_PLL_HOLDOVER) {
+    Time_PLL.state = TIME_PLL_UNLOCKED;
+  }
+}
+
+bool Time_PLL_locked()
+{
+  return Time_PLL.state != TIME_PLL_UNLOCKED && Time_PLL.base_sec != 0;
+}
+
+/* local oscillator offset, ppm */
+int32_t Time_PLL_drift()
+{
+  return (Time_PLL.period_q8 - (TIME_PLL_NOMINAL << 8)) / 256;
+}
+
+/* UTC time at micros() 'us' of a time base, microseconds since Epoch */
+static uint64_t Time_PLL_utc_us(uint32_t base_sec, unsigned long base_us,
+                                int32_t period_q8, unsigned long us)
+{
+  unsigned long period  = (unsigned long) ((period_q8 + 128) >> 8);
+  unsigned long elapsed = us - base_us;
+  unsigned long n       = elapsed / period;
+  unsigned long frac    = elapsed - n * period;
+
+  return (uint64_t) (base_sec + n) * 1000000ULL +
+         (uint64_t) frac * 1000000ULL / period;
+}
+
+/* UTC time, microseconds since Epoch */
+uint64_t now_us()
+{
+  if (!Time_PLL_locked()) {
+    return (uint64_t) now() * 1000000ULL;
+  }
+
+  return Time_PLL_utc_us(Time_PLL.base_sec, Time_PLL.base_us,
+                         Time_PLL.period_q8, micros());
+}
+
+/*
+ * The PLL runs on the side that parses GNSS input. Another task takes
+ * the time base out of the ownship view instead of Time_PLL.
+ */
+void Time_PLL_view(ownship_view_t *view)
+{
+  view->pll_locked    = Time_PLL_locked();
+  view->pll_sec       = Time_PLL.base_sec;
+  view->pll_us        = Time_PLL.base_us;
+  view->pll_period_q8 = Time_PLL.period_q8;
+}
+
+/* UTC time at micros() 'us' by the time base of a view */
+uint64_t Time_PLL_view_us(const ownship_view_t *view, unsigned long us)
+{
+  return Time_PLL_utc_us(view->pll_sec, view->pll_us,
+                         view->pll_period_q8, us);
+}
+
+#endif /* EXCLUDE_TIME_PLL */
@@ -27,6 +27,13 @@ enum
   RTC_PCF8563
 };
 
+enum
+{
+  TIME_SOURCE_NONE,
+  TIME_SOURCE_NTP,
+  TIME_SOURCE_GNSS
+};
+
 typedef struct UpTime_struct {
   uint8_t days;
   uint8_t hours;
@@ -34,10 +41,41 @@ typedef struct UpTime_struct {
   uint8_t seconds;
 } UpTime_t;
 
+enum
+{
+  TIME_PLL_UNLOCKED,
+  TIME_PLL_NMEA,
+  TIME_PLL_PPS
+};
+
+typedef struct Time_PLL_struct {
+  uint8_t       state;
+  uint32_t      base_sec;   /* UTC second that begins at base_us */
+  unsigned long base_us;    /* micros() at start of that second  */
+  int32_t       period_q8;  /* micros() per UTC second, Q24.8    */
+  int32_t       error_us;   /* last phase error                  */
+  uint32_t      jitter_us;  /* averaged abs. phase error         */
+  unsigned long pps_ms;     /* last PPS edge taken in            */
+  uint32_t      nmea_time;  /* last NMEA time value taken in     */
+} Time_PLL_t;
 
 void Time_setup(void);
 void Time_loop(void);
 
+#if !defined(EXCLUDE_TIME_PLL)
+void     Time_PLL_input(unsigned long, uint8_t);
+void     Time_PLL_loop(void);
+bool     Time_PLL_locked(void);
+int32_t  Time_PLL_drift(void);
+uint64_t now_us(void);
+void     Time_PLL_view(struct ownship_view_struct *);
+uint64_t Time_PLL_view_us(const struct ownship_view_struct *, unsigned long);
+
+extern Time_PLL_t Time_PLL;
+#endif /* EXCLUDE_TIME_PLL */
+
 extern UpTime_t UpTime;
+extern uint8_t  Time_source;
+extern uint32_t Time_valid_ms;  /* millis() when the clock got set first */
 
 #endif /* TIMEHELPER_H */
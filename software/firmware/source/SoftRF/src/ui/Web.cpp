@@ -38,6 +38,8 @@ void Web_fini()     {}
 #include "../protocol/data/GDL90.h"
 #include "../protocol/data/D1090.h"
 #include "../system/Time.h"
+#include "../system/Tasks.h"
+#include "../system/Profiler.h"
 
 #if defined(ENABLE_AHRS)
 #include "../driver/AHRS.h"
@@ -734,6 +736,24 @@ void handleSettings() {
   free(Settings_temp);
 }
 
+#if defined(ENABLE_PROFILER)
+static const char Profiler_Head[] PROGMEM = "\
+ <h2 align=center>Main loop profile, us</h2>\
+ <table width=100%%>\
+  <tr><th align=left>Subsystem</th><th align=right>Calls</th>\
+  <th align=right>Avg</th><th align=right>P99</th><th align=right>Max</th>\
+  <th align=right>CPU&nbsp;%%</th></tr>";
+
+static const char Profiler_Row[] PROGMEM = "\
+  <tr><td align=left>%s</td><td align=right>%lu</td><td align=right>%lu</td>\
+  <td align=right>%lu</td><td align=right>%lu</td><td align=right>%u</td></tr>";
+
+static const char Profiler_Tail[] PROGMEM = " </table>";
+
+/* a name, four of %lu and a %u at their longest in place of the format */
+#define PROFILER_ROW_MAX  (sizeof(Profiler_Row) + PROFILER_NAME_MAX + 4 * 10 + 5)
+#endif /* ENABLE_PROFILER */
+
 void handleRoot() {
 
   float vdd = Battery_voltage() ;
@@ -747,16 +767,34 @@ void handleRoot() {
   char str_alt[16];
   char str_Vcc[8];
 
-  size_t size = 2420;
+  size_t size = 2500;
   char *offset;
   size_t len = 0;
 
+#if defined(ENABLE_RADIO_TASK)
+  size += 640;
+#endif /* ENABLE_RADIO_TASK */
+#if defined(ENABLE_PROBE_CACHE)
+  size += 80;
+#endif /* ENABLE_PROBE_CACHE */
+#if defined(ENABLE_PROFILER)
+  size += sizeof(Profiler_Head) + PROF_COUNT * PROFILER_ROW_MAX +
+          sizeof(Profiler_Tail);
+#endif /* ENABLE_PROFILER */
+
   char *Root_temp = (char *) malloc(size);
   if (Root_temp == NULL) {
     return;
   }
   offset = Root_temp;
 
+#if defined(ENABLE_RADIO_TASK)
+  prof_stats_t radio_ps, ui_ps;
+
+  Profiler_Stats_get(PROF_TASK_RADIO, &radio_ps, NULL);
+  Profiler_Stats_get(PROF_TASK_UI,    &ui_ps,    NULL);
+#endif /* ENABLE_RADIO_TASK */
+
   dtostrf(ThisAircraft.latitude,  8, 4, str_lat);
   dtostrf(ThisAircraft.longitude, 8, 4, str_lon);
   dtostrf(ThisAircraft.altitude,  7, 1, str_alt);
@@ -790,6 +828,7 @@ void handleRoot() {
   <td align=right><table><tr><th align=left>AHRS&nbsp;&nbsp;</th><td align=right>%s</td></tr></table></td></tr>"
 #endif /* ENABLE_AHRS */
  "<tr><th align=left>Uptime</th><td align=right>%02d:%02d:%02d</td></tr>\
+  <tr><th align=left>Clock</th><td align=right>%s&nbsp;&nbsp;%lu&nbsp;ms</td></tr>\
   <tr><th align=left>Free memory</th><td align=right>%u</td></tr>\
   <tr><th align=left>Battery voltage</th><td align=right><font color=%s>%s</font></td></tr>"
 #if defined(USE_USB_HOST)
@@ -801,8 +840,24 @@ void handleRoot() {
     <td align=right><table><tr>\
      <th align=left>Tx&nbsp;&nbsp;</th><td align=right>%u</td>\
      <th align=left>&nbsp;&nbsp;&nbsp;&nbsp;Rx&nbsp;&nbsp;</th><td align=right>%u</td>\
+   </tr></table></td></tr>"
+#if defined(ENABLE_RADIO_TASK)
+ "<tr><th align=left>CPU load</th>\
+    <td align=right><table><tr>\
+     <th align=left>Radio&nbsp;&nbsp;</th><td align=right>%u%%</td>\
+     <th align=left>&nbsp;&nbsp;&nbsp;&nbsp;UI&nbsp;&nbsp;</th><td align=right>%u%%</td>\
    </tr></table></td></tr>\
- </table>\
+   <tr><th align=left>Longest pass, us</th>\
+    <td align=right><table><tr>\
+     <th align=left>Radio&nbsp;&nbsp;</th><td align=right>%lu</td>\
+     <th align=left>&nbsp;&nbsp;&nbsp;&nbsp;UI&nbsp;&nbsp;</th><td align=right>%lu</td>\
+   </tr></table></td></tr>\
+   <tr><th align=left>Event latency, us</th><td align=right>%lu&nbsp;/&nbsp;%lu</td></tr>"
+#endif /* ENABLE_RADIO_TASK */
+#if defined(ENABLE_PROBE_CACHE)
+ "<tr><th align=left>First Tx, ms</th><td align=right>%lu</td></tr>"
+#endif /* ENABLE_PROBE_CACHE */
+ "</table>\
  <h2 align=center>Most recent GNSS fix</h2>\
  <table width=100%%>\
   <tr><th align=left>Time</th><td align=right>%u</td></tr>\
@@ -831,13 +886,26 @@ void handleRoot() {
 #if defined(ENABLE_AHRS)
     (ahrs_chip == NULL ? "NONE" : ahrs_chip->name),
 #endif /* ENABLE_AHRS */
-    UpTime.hours, UpTime.minutes, UpTime.seconds, SoC->getFreeHeap(),
+    UpTime.hours, UpTime.minutes, UpTime.seconds,
+    Time_source == TIME_SOURCE_GNSS ? "GNSS" :
+    Time_source == TIME_SOURCE_NTP  ? "NTP"  : "NONE",
+    (unsigned long) Time_valid_ms, SoC->getFreeHeap(),
     low_voltage ? "red" : "green", str_Vcc,
 #if defined(USE_USB_HOST)
     ESP32_USB_Serial.connected ? supported_USB_devices[ESP32_USB_Serial.index].first_name : "",
     ESP32_USB_Serial.connected ? supported_USB_devices[ESP32_USB_Serial.index].last_name  : "N/A",
 #endif /* USE_USB_HOST */
     tx_packets_counter, rx_packets_counter,
+#if defined(ENABLE_RADIO_TASK)
+    radio_ps.cpu, ui_ps.cpu,
+    (unsigned long) radio_ps.max_us,
+    (unsigned long) ui_ps.max_us,
+    (unsigned long) Tasks_Event_Queue.stats.lat_avg_us,
+    (unsigned long) Tasks_Event_Queue.stats.lat_max_us,
+#endif /* ENABLE_RADIO_TASK */
+#if defined(ENABLE_PROBE_CACHE)
+    (unsigned long) RF_first_tx_ms,
+#endif /* ENABLE_PROBE_CACHE */
     timestamp, sats, str_lat, str_lon, str_alt
   );
 
@@ -866,7 +934,40 @@ void handleRoot() {
 
   snprintf_P ( offset, size, PSTR("\
   </tr>\
- </table>\
+ </table>"));
+  len = strlen(offset);
+  offset += len;
+  size -= len;
+
+#if defined(ENABLE_PROFILER)
+  snprintf_P ( offset, size, Profiler_Head);
+  len = strlen(offset);
+  offset += len;
+  size -= len;
+
+  for (int i=0; i < PROF_COUNT; i++) {
+    prof_stats_t ps;
+
+    if (!Profiler_Stats_get(i, &ps, NULL) || ps.count == 0) {
+      continue;
+    }
+
+    snprintf_P ( offset, size, Profiler_Row,
+      Profiler_Name[i], (unsigned long) ps.count,
+      (unsigned long) ps.avg_us, (unsigned long) ps.p99_us,
+      (unsigned long) ps.max_us, ps.cpu);
+    len = strlen(offset);
+    offset += len;
+    size -= len;
+  }
+
+  snprintf_P ( offset, size, Profiler_Tail);
+  len = strlen(offset);
+  offset += len;
+  size -= len;
+#endif /* ENABLE_PROFILER */
+
+  snprintf_P ( offset, size, PSTR("\
 </body>\
 </html>")
   );
@@ -0,0 +1,290 @@
+/*
+ * bench_adb.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Aircraft database lookup, binary ADB (src/system/ADB.h) against uCDB.
+ *
+ * Records of the OGN DDB are taken out of software/data/Aircrafts/ogn.cdb
+ * and written into an .adb the way software/utils/python/adb.py does.
+ * Every address is then looked up in both, hit and miss, and the fields
+ * are compared. File operations are counted as well, since the cost on
+ * an SD card or SPI flash is in seeks and reads rather than in CPU time.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include <raspi/raspi.h>
+#include "../../libraries/uCDB/src/uCDB.hpp"
+#include "../src/system/ADB.h"
+
+#include "host/Host.h"
+
+#define CDB_PATH  "../../../../data/Aircrafts/ogn.cdb"
+#define ADB_PATH  "build/ogn.adb"
+
+typedef struct file_stat_struct {
+  unsigned long seeks;
+  unsigned long reads;
+  unsigned long bytes;
+} file_stat_t;
+
+static file_stat_t fstat_;
+
+/* stdio File of SdFat / Adafruit SPIFlash shape, with I/O counters */
+class HostFile
+{
+  public:
+    HostFile() : f_(NULL) {}
+    explicit operator bool() const { return f_ != NULL; }
+
+    int read() {
+      fstat_.reads++; fstat_.bytes++;
+      return fgetc(f_);
+    }
+    int read(void *buf, size_t n) {
+      fstat_.reads++; fstat_.bytes += n;
+      return fread(buf, 1, n, f_);
+    }
+    bool seek(unsigned long pos) {
+      fstat_.seeks++;
+      return fseek(f_, pos, SEEK_SET) == 0;
+    }
+    unsigned long position() { return ftell(f_); }
+    unsigned long size() {
+      long cur = ftell(f_);
+      fseek(f_, 0, SEEK_END);
+      long end = ftell(f_);
+      fseek(f_, cur, SEEK_SET);
+      return end;
+    }
+    void close() { if (f_) fclose(f_); f_ = NULL; }
+
+    FILE *f_;
+};
+
+class HostFS
+{
+  public:
+    bool exists(const char *name) { struct stat s; return stat(name, &s) == 0; }
+    HostFile open(const char *name) {
+      HostFile h;
+      h.f_ = fopen(name, "rb");
+      return h;
+    }
+};
+
+typedef struct cdb_rec_struct {
+  uint32_t    addr;
+  std::string mam, reg, cn;
+} cdb_rec_t;
+
+static uint32_t le32(const uint8_t *p)
+{
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+/*
+ * CDB records run from the end of the 2 KB header up to the first table.
+ * Of a duplicate address only the first one is kept, as findKey() does.
+ */
+static std::vector<cdb_rec_t> cdb_records(const char *path)
+{
+  std::vector<cdb_rec_t> recs;
+  std::vector<uint8_t> d;
+  FILE *f = fopen(path, "rb");
+
+  if (f == NULL) {
+    return recs;
+  }
+  fseek(f, 0, SEEK_END);
+  d.resize(ftell(f));
+  fseek(f, 0, SEEK_SET);
+  if (fread(d.data(), 1, d.size(), f) != d.size()) {
+    d.clear();
+  }
+  fclose(f);
+  if (d.size() < 2048) {
+    return recs;
+  }
+
+  uint32_t end = le32(&d[0]);
+  for (int i = 1; i < 256; i++) {
+    end = std::min(end, le32(&d[8 * i]));
+  }
+
+  for (uint32_t pos = 2048; pos + 8 <= end; ) {
+    uint32_t klen = le32(&d[pos]);
+    uint32_t vlen = le32(&d[pos + 4]);
+    std::string key((const char *) &d[pos + 8], klen);
+    std::string val((const char *) &d[pos + 8 + klen], vlen);
+    cdb_rec_t r;
+    size_t a = val.find('|');
+    size_t b = a == std::string::npos ? a : val.find('|', a + 1);
+
+    r.addr = strtoul(key.c_str(), NULL, 16);
+    r.mam  = val.substr(0, a);
+    r.reg  = a == std::string::npos ? "" : val.substr(a + 1, b - a - 1);
+    r.cn   = b == std::string::npos ? "" : val.substr(b + 1);
+    pos += 8 + klen + vlen;
+
+    if (std::find_if(recs.begin(), recs.end(),
+          [&r](const cdb_rec_t &x) { return x.addr == r.addr; }) == recs.end()) {
+      recs.push_back(r);
+    }
+  }
+
+  return recs;
+}
+
+/* same layout as adbmake() of adb.py */
+static bool adb_write(const char *path, std::vector<cdb_rec_t> recs)
+{
+  size_t w[3] = { 0, 0, 0 };
+
+  std::stable_sort(recs.begin(), recs.end(),
+            [](const cdb_rec_t &a, const cdb_rec_t &b) { return a.addr < b.addr; });
+  for (const cdb_rec_t &r : recs) {
+    w[0] = std::max(w[0], r.mam.size());
+    w[1] = std::max(w[1], r.reg.size());
+    w[2] = std::max(w[2], r.cn.size());
+  }
+
+  size_t rec_size = 3 + w[0] + w[1] + w[2];
+  size_t block = 16;
+  while ((recs.size() + block - 1) / block > ADB_INDEX_MAX) block++;
+  if (block * rec_size > ADB_BLOCK_BYTES) {
+    return false;
+  }
+
+  FILE *f = fopen(path, "wb");
+  uint8_t hdr[ADB_HEADER_SIZE] = { 'S', 'A', 'D', 'B', ADB_VERSION,
+                                   (uint8_t) w[0], (uint8_t) w[1], (uint8_t) w[2] };
+  uint32_t count = recs.size();
+
+  memcpy(&hdr[8], &count, 4);
+  hdr[12] = block & 0xFF;
+  hdr[13] = block >> 8;
+  fwrite(hdr, 1, sizeof(hdr), f);
+  for (size_t i = 0; i < recs.size(); i += block) {
+    fwrite(&recs[i].addr, 1, 3, f);
+  }
+  for (const cdb_rec_t &r : recs) {
+    fwrite(&r.addr, 1, 3, f);
+    const std::string *s[3] = { &r.mam, &r.reg, &r.cn };
+    for (int i = 0; i < 3; i++) {
+      std::string v = *s[i];
+      v.resize(w[i], '\0');
+      fwrite(v.data(), 1, w[i], f);
+    }
+  }
+  fclose(f);
+
+  return true;
+}
+
+static bool cdb_find(uCDB<HostFS, HostFile> &cdb, uint32_t id, adb_record_t *rec)
+{
+  char key[8];
+  char out[64];
+  uint8_t tokens[3] = { 0 };
+  int c, i = 0, token_cnt = 0;
+
+  snprintf(key, sizeof(key), "%06X", id);
+  if (cdb.findKey(key, strlen(key)) != KEY_FOUND) {
+    return false;
+  }
+  while ((c = cdb.readValue()) != -1 && i < (int) (sizeof(out) - 1)) {
+    if (c == '|') {
+      if (token_cnt < (int) (sizeof(tokens) - 1)) {
+        token_cnt++;
+        tokens[token_cnt] = i + 1;
+      }
+      c = 0;
+    }
+    out[i++] = (char) c;
+  }
+  out[i] = 0;
+
+  strncpy(rec->mam, out + tokens[0], ADB_VALUE_MAX); rec->mam[ADB_VALUE_MAX] = 0;
+  strncpy(rec->reg, out + tokens[1], ADB_VALUE_MAX); rec->reg[ADB_VALUE_MAX] = 0;
+  strncpy(rec->cn,  out + tokens[2], ADB_VALUE_MAX); rec->cn [ADB_VALUE_MAX] = 0;
+
+  return true;
+}
+
+int main()
+{
+  static HostFS fs;
+  static ADB<HostFS, HostFile>  adb(fs);
+  static uCDB<HostFS, HostFile> cdb(fs);
+  std::vector<cdb_rec_t> recs = cdb_records(CDB_PATH);
+  std::vector<uint32_t> ids;
+
+  CHECK(recs.size() > 10000);
+  CHECK(adb_write(ADB_PATH, recs));
+  CHECK(adb.open(ADB_PATH));
+  CHECK(cdb.open(CDB_PATH) == CDB_OK);
+  if (Host_failures) {
+    return Host_report("bench_adb");
+  }
+
+  /* every address, and as many that are not in the DB */
+  for (const cdb_rec_t &r : recs) {
+    ids.push_back(r.addr);
+    ids.push_back(r.addr ^ 0x5A5A5A);
+  }
+
+  printf("%zu records, %zu lookups\n", recs.size(), ids.size());
+
+  for (int pass = 0; pass < 2; pass++) {
+    adb_record_t rec;
+    unsigned found = 0;
+
+    memset(&fstat_, 0, sizeof(fstat_));
+    uint64_t t0 = Host_wall_ns();
+    for (uint32_t id : ids) {
+      found += pass ? cdb_find(cdb, id, &rec) : adb.find(id, &rec);
+    }
+    uint64_t ns = Host_wall_ns() - t0;
+
+    printf("  %s : %6.2f us/lookup, %5.2f seeks, %5.1f reads, %6.1f bytes, %u found\n",
+           pass ? "CDB" : "ADB", ns / 1000.0 / ids.size(),
+           (double) fstat_.seeks / ids.size(), (double) fstat_.reads / ids.size(),
+           (double) fstat_.bytes / ids.size(), found);
+  }
+
+  /* every record carries the same fields in both, in full length */
+  for (const cdb_rec_t &r : recs) {
+    adb_record_t a, c;
+
+    CHECK(adb.find(r.addr, &a));
+    CHECK(cdb_find(cdb, r.addr, &c));
+    CHECK(r.mam == a.mam && r.reg == a.reg && r.cn == a.cn);
+    CHECK(r.mam == c.mam && r.reg == c.reg && r.cn == c.cn);
+  }
+
+  cdb.close();
+  adb.close();
+
+  return Host_report("bench_adb");
+}
@@ -0,0 +1,175 @@
+/*
+ * bench_codecs.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Encodes and decodes per second of every radio protocol codec,
+ * and the heap allocations that each of them makes.
+ *
+ * Codec objects are linked with --wrap=malloc,calloc,realloc,free
+ * (see Makefile) and operator new is replaced below, so that an
+ * allocation of the firmware or of a library it links is counted.
+ * Allocations on the Rx/Tx path are the ones that fragment the heap
+ * of an ESP32 after hours of traffic; the right number is 0.
+ *
+ * legacy_encode() alternates V6 and V7 frames, a Legacy encode rate
+ * is of one V6 and one V7 frame together.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+
+#include "host/Host.h"
+#include "host/Codecs.h"
+
+#define BENCH_NS  200000000ULL  /* per codec and direction */
+
+static unsigned long allocs;
+
+extern "C" {
+
+void *__real_malloc(size_t);
+void *__real_calloc(size_t, size_t);
+void *__real_realloc(void *, size_t);
+void  __real_free(void *);
+
+void *__wrap_malloc(size_t size)
+{
+  allocs++;
+  return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t num, size_t size)
+{
+  allocs++;
+  return __real_calloc(num, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+  allocs++;
+  return __real_realloc(ptr, size);
+}
+
+void __wrap_free(void *ptr)
+{
+  __real_free(ptr);
+}
+
+}
+
+void *operator new(size_t size)
+{
+  allocs++;
+  void *ptr = __real_malloc(size ? size : 1);
+  if (ptr == NULL) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+  __real_free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+  __real_free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+  __real_free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+  __real_free(ptr);
+}
+
+typedef struct result_struct {
+  double        rate;     /* per second */
+  double        allocs;   /* per call */
+} result_t;
+
+static result_t bench_encode(const codec_t *c)
+{
+  uint8_t frame[CODEC_FRAME_MAX];
+  unsigned long n = 0, a = allocs;
+  uint64_t start = Host_wall_ns(), ns;
+
+  do {
+    for (int i = 0; i < 1000; i++, n++) {
+      c->encode(frame, &Codecs_tx);
+    }
+    ns = Host_wall_ns() - start;
+  } while (ns < BENCH_NS);
+
+  return (result_t) { n * 1e9 / ns, (double) (allocs - a) / n };
+}
+
+static result_t bench_decode(const codec_t *c)
+{
+  uint8_t sample[CODEC_FRAME_MAX];
+  uint8_t frame[CODEC_FRAME_MAX];
+  size_t size = Codecs_frame(c, sample);
+  unsigned long n = 0, a = allocs;
+  uint64_t start = Host_wall_ns(), ns;
+  ufo_t fo;
+
+  do {
+    for (int i = 0; i < 1000; i++, n++) {
+      /* some decoders decipher in place */
+      memcpy(frame, sample, size);
+      c->decode(frame, &Codecs_rx, &fo);
+    }
+    ns = Host_wall_ns() - start;
+  } while (ns < BENCH_NS);
+
+  return (result_t) { n * 1e9 / ns, (double) (allocs - a) / n };
+}
+
+int main()
+{
+  Codecs_setup();
+
+  printf("%-10s %12s %8s %12s %8s\n",
+         "codec", "encodes/s", "allocs", "decodes/s", "allocs");
+
+  for (int i = 0; i < Codecs_num; i++) {
+    const codec_t *c = &Codecs[i];
+    result_t dec = bench_decode(c);
+
+    if (c->encode != NULL) {
+      result_t enc = bench_encode(c);
+
+      printf("%-10s %12.0f %8.2f", c->name, enc.rate, enc.allocs);
+    } else {
+      printf("%-10s %12s %8s", c->name, "-", "-");
+    }
+    printf(" %12.0f %8.2f\n", dec.rate, dec.allocs);
+  }
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+/*
+ * bench_cpr.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * CPR encoder of adsb_encoder against the floating point one that
+ * it replaced (cpr_encode_float() below, as it was in the library,
+ * with NL in closed form instead of a table).
+ *
+ * Cycles per encode, and agreement over random airborne positions:
+ * the fixed point encoder may differ by one LSB only where the
+ * position is halfway between two CPR steps. A larger difference,
+ * or a zone number that is not the same, fails the run.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <adsb_encoder.h>
+
+#include "host/Host.h"
+
+#define BENCH_POSITIONS   1000000
+
+typedef struct cpr_pair
+{
+  unsigned int YZ;
+  unsigned int XZ;
+} cpr_pair_t;
+
+/* of adsb_encoder.cpp */
+cpr_pair_t cpr_encode(double lat, double lon, int odd, int surface);
+
+/* number of longitude zones, closed form of DO-260B A.1.7.2 */
+static int CPR_NL_float(double lat)
+{
+  if (fabs(lat) >= 87.0) {
+    return 1;
+  }
+
+  double U = 1 - cos(M_PI / (2 * 15.0));
+  double T = cos(M_PI / 180.0 * fabs(lat));
+
+  return (int) floor(2.0 * M_PI / acos(1 - U / (T * T)));
+}
+
+static double CPR_MOD(double x, double y)
+{
+  return x - y * floor(x / y);
+}
+
+static double CPR_DLON(double rlat, int odd)
+{
+  int nl = CPR_NL_float(rlat) - (odd ? 1 : 0);
+
+  return 360.0 / (nl < 1 ? 1 : nl);
+}
+
+static cpr_pair_t cpr_encode_float(double lat, double lon, int odd)
+{
+  double NbPow = pow(2.0, 17);
+  double Dlat  = 360.0 / (odd ? 59.0 : 60.0);
+  unsigned int YZ = (unsigned int) floor(NbPow * CPR_MOD(lat, Dlat) / Dlat + 0.5);
+  double Rlat  = Dlat * (1.0 * YZ / NbPow + floor(lat / Dlat));
+  double Dlon  = CPR_DLON(Rlat, odd);
+  unsigned int XZ = (unsigned int) floor(NbPow * CPR_MOD(lon, Dlon) / Dlon + 0.5);
+
+  cpr_pair_t v;
+  v.YZ = YZ & 0x1FFFF;
+  v.XZ = XZ & 0x1FFFF;
+  return v;
+}
+
+/* distance of two 17 bit CPR values, modulo the zone */
+static unsigned cpr_diff(unsigned a, unsigned b)
+{
+  unsigned d = (a - b) & 0x1FFFF;
+
+  return d > 0x10000 ? 0x20000 - d : d;
+}
+
+static double lat[BENCH_POSITIONS], lon[BENCH_POSITIONS];
+
+int main()
+{
+  unsigned long differ = 0;
+  unsigned worst = 0;
+  volatile unsigned sink = 0;
+
+  srand(1);
+  for (int i = 0; i < BENCH_POSITIONS; i++) {
+    lat[i] = (rand() / (double) RAND_MAX) * 180.0 - 90.0;
+    lon[i] = (rand() / (double) RAND_MAX) * 360.0 - 180.0;
+  }
+
+  for (int odd = 0; odd <= 1; odd++) {
+    for (int i = 0; i < BENCH_POSITIONS; i++) {
+      cpr_pair_t f = cpr_encode(lat[i], lon[i], odd, AIR_POS);
+      cpr_pair_t r = cpr_encode_float(lat[i], lon[i], odd);
+      unsigned d = cpr_diff(f.YZ, r.YZ);
+
+      d = cpr_diff(f.XZ, r.XZ) > d ? cpr_diff(f.XZ, r.XZ) : d;
+      if (d > 0) {
+        differ++;
+      }
+      worst = d > worst ? d : worst;
+    }
+  }
+
+  uint64_t start = Host_cycles();
+  for (int i = 0; i < BENCH_POSITIONS; i++) {
+    sink += cpr_encode(lat[i], lon[i], i & 1, AIR_POS).XZ;
+  }
+  double fixed = (double) (Host_cycles() - start) / BENCH_POSITIONS;
+
+  start = Host_cycles();
+  for (int i = 0; i < BENCH_POSITIONS; i++) {
+    sink += cpr_encode_float(lat[i], lon[i], i & 1).XZ;
+  }
+  double fp = (double) (Host_cycles() - start) / BENCH_POSITIONS;
+
+  start = Host_cycles();
+  for (int i = 0; i < BENCH_POSITIONS; i++) {
+    frame_data_t df17 = make_air_position_frame(11, 0x3D1234, lat[i], lon[i],
+                                                4100, i & 1, DF17);
+    sink += df17.msg[10];
+  }
+  double frame = (double) (Host_cycles() - start) / BENCH_POSITIONS;
+
+  printf("cpr_encode       %6.0f cycles (fixed point)\n", fixed);
+  printf("cpr_encode_float %6.0f cycles\n", fp);
+  printf("position frame   %6.0f cycles (CPR, altitude and CRC)\n", frame);
+  printf("%lu of %d encodes differ, by %u LSB at most\n",
+         differ, 2 * BENCH_POSITIONS, worst);
+
+  CHECK(worst <= 1);
+
+  return Host_report("bench_cpr");
+}
@@ -0,0 +1,195 @@
+/*
+ * bench_nmea.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * GNSS NMEA input, sentences per second.
+ *
+ * A 10 Hz multi-constellation stream (GGA, RMC, VTG, 4 x GSA, 12 x GSV
+ * per epoch) goes through PickGNSSFix() of driver/GNSS.cpp and, for
+ * reference, through a copy of the former per-character input loop.
+ */
+
+#include "../src/system/SoC.h"
+#include "../src/driver/GNSS.h"
+#include "../src/driver/EEPROM.h"
+#include "../src/protocol/data/NMEA.h"
+
+#include "host/Host.h"
+#include "host/HostSerial.h"
+
+#define BENCH_EPOCHS  20000
+
+/* what GNSS.cpp takes from the rest of the firmware */
+eeprom_t eeprom_block;
+settings_t *settings = &eeprom_block.field.settings;
+hardware_info_t hw_info = { .model = SOFTRF_MODEL_RASPBERRY };
+
+static SoC_ops_t Bench_SoC = { SOC_RPi, "Host" };
+const SoC_ops_t *SoC = &Bench_SoC;
+
+static unsigned long Bench_Out_count = 0;
+static unsigned long Bench_Out_bytes = 0;
+
+void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl)
+{
+  Bench_Out_count++;
+  Bench_Out_bytes += size;
+}
+
+void NMEA_GGA() {}
+
+/* former PickGNSSFix(), one character per pass, RPi branches only */
+static void PickGNSSFix_per_char(TinyGPSPlus &parser)
+{
+  static uint8_t buf[250];
+  static int cnt = 0;
+  bool isValidSentence = false;
+  int ndx;
+  int c;
+
+  while (Serial1.available() > 0) {
+    c = Serial1.read();
+
+    if (c == -1) {
+      continue;
+    }
+    if (isPrintable(c) || c == '\r' || c == '\n') {
+      buf[cnt] = c;
+    } else {
+      continue;
+    }
+
+    isValidSentence = parser.encode(buf[cnt]);
+    if (buf[cnt] == '\r' && isValidSentence) {
+      for (ndx = cnt - 4; ndx >= 0; ndx--) {
+        if (settings->nmea_g && (buf[ndx] == '$') && (buf[ndx+1] == 'G')) {
+          NMEA_Out(settings->nmea_out, &buf[ndx], cnt - ndx + 1, true);
+          break;
+        }
+      }
+    }
+
+    if (buf[cnt] == '\n' || cnt == sizeof(buf)-1) {
+      cnt = 0;
+    } else {
+      cnt++;
+      yield();
+    }
+  }
+}
+
+static int add_sentence(std::string &s, const char *body)
+{
+  unsigned char cs = 0;
+  char tail[8];
+
+  for (const char *p = body; *p; p++) {
+    cs ^= *p;
+  }
+  snprintf(tail, sizeof(tail), "*%02X\r\n", cs);
+  s += '$';
+  s += body;
+  s += tail;
+
+  return 1;
+}
+
+/* one second worth of 10 Hz output */
+static int make_stream(std::string &s, int sec)
+{
+  static const char *talker[] = { "GP", "GL", "GA", "GB" };
+  char body[128];
+  int count = 0;
+
+  for (int e = 0; e < 10; e++) {
+    snprintf(body, sizeof(body),
+             "GNGGA,1213%02d.%02d,5546.0123,N,03737.4567,E,1,24,0.7,"
+             "152.3,M,14.5,M,,", sec % 60, e * 10);
+    count += add_sentence(s, body);
+    snprintf(body, sizeof(body),
+             "GNRMC,1213%02d.%02d,A,5546.0123,N,03737.4567,E,42.1,271.3,"
+             "141123,,,A", sec % 60, e * 10);
+    count += add_sentence(s, body);
+    count += add_sentence(s, "GNVTG,271.3,T,,M,42.1,N,78.0,K,A");
+    for (int t = 0; t < 4; t++) {
+      snprintf(body, sizeof(body),
+               "%sGSA,A,3,01,02,03,04,05,06,07,08,09,10,11,12,1.2,0.7,1.0",
+               talker[t]);
+      count += add_sentence(s, body);
+      for (int m = 1; m <= 3; m++) {
+        snprintf(body, sizeof(body),
+                 "%sGSV,3,%d,12,%02d,45,120,40,%02d,30,200,35,"
+                 "%02d,15,300,28,%02d,60,045,44", talker[t], m,
+                 m * 4 - 3, m * 4 - 2, m * 4 - 1, m * 4);
+        count += add_sentence(s, body);
+      }
+    }
+  }
+
+  return count;
+}
+
+int main()
+{
+  std::string stream;
+  int sentences = 0;
+
+  settings->nmea_g   = true;
+  settings->nmea_out = NMEA_UART;
+
+  for (int sec = 0; sec < BENCH_EPOCHS / 10; sec++) {
+    sentences += make_stream(stream, sec);
+  }
+  /* a damaged sentence is dropped */
+  stream += "$GNRMC,121300.00,A,5546.0123,N,03737.4567,E,42.1,271.3,141123,,,A*00\r\n";
+
+  unsigned long rmc_before = gnss.passedChecksum();
+  uint64_t t0 = Host_wall_ns();
+
+  HostSerial_feed(Serial1, stream.data(), stream.size());
+  PickGNSSFix();
+
+  uint64_t t1 = Host_wall_ns();
+  unsigned long fed = gnss.passedChecksum() - rmc_before;
+
+  CHECK(Bench_Out_count == (unsigned long) sentences);
+  CHECK(fed == (unsigned long) (2 * BENCH_EPOCHS));
+  CHECK(gnss.failedChecksum() == 0);
+  CHECK(gnss.location.isValid());
+
+  TinyGPSPlus ref;
+  unsigned long forwarded = Bench_Out_count;
+  uint64_t t2 = Host_wall_ns();
+
+  HostSerial_feed(Serial1, stream.data(), stream.size());
+  PickGNSSFix_per_char(ref);
+
+  uint64_t t3 = Host_wall_ns();
+
+  /* both paths forward the same sentences */
+  CHECK(Bench_Out_count - forwarded == (unsigned long) sentences);
+
+  printf("NMEA input, %d sentences, %lu bytes\n",
+         sentences, (unsigned long) stream.size());
+  printf("  block framer (PickGNSSFix): %10.0f sentences/s\n",
+         sentences * 1e9 / (t1 - t0));
+  printf("  former per-character loop : %10.0f sentences/s\n",
+         sentences * 1e9 / (t3 - t2));
+
+  return Host_report("bench_nmea");
+}
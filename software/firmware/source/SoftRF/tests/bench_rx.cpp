@@ -0,0 +1,153 @@
+/*
+ * bench_rx.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Cycles of the Rx pipeline, per protocol and alarm method.
+ *
+ * A frame of every codec is put into RxBuffer the way the radio drivers
+ * leave it, and ParseData() of TrafficHelper.cpp takes it through
+ * prefilter, decode, Traffic_Update() with the alarm of settings->alarm
+ * and Traffic_Add(). The decode column is the decoder on its own.
+ * The protocol is selected once, as RF_Rx_Select() does it, so the
+ * numbers are of the code that runs for every packet.
+ *
+ * Cycles are of the TSC on x86 hosts and nanoseconds elsewhere; they
+ * compare protocols and alarm methods, not MCUs.
+ */
+
+#include <string.h>
+
+#include "../src/system/SoC.h"
+#include "../src/driver/RF.h"
+#include "../src/driver/EEPROM.h"
+#include "../src/TrafficHelper.h"
+
+#include "host/Host.h"
+#include "host/Codecs.h"
+
+#define BENCH_RUNS  200000
+
+/* what TrafficHelper.cpp takes from RF.cpp, SoftRF.ino and Sound.cpp */
+ufo_t ThisAircraft;
+byte TxBuffer[MAX_PKT_SIZE], RxBuffer[MAX_PKT_SIZE];
+bool (*protocol_decode)(void *, ufo_t *, ufo_t *);
+uint8_t RF_rx_protocol;
+uint8_t RF_rx_size;
+int8_t RF_last_rssi;
+uint32_t rx_packets_counter;
+RF_rx_stats_t RF_Rx_Stats[RF_RX_PROTOCOLS_MAX];
+
+bool Sound_Notify()
+{
+  return false;
+}
+
+String Bin2Hex(byte *buffer, size_t size)
+{
+  return String("");
+}
+
+static const struct {
+  const char *name;
+  uint8_t     alarm;
+} alarms[] = {
+  { "none",     TRAFFIC_ALARM_NONE     },
+  { "distance", TRAFFIC_ALARM_DISTANCE },
+  { "vector",   TRAFFIC_ALARM_VECTOR   },
+  { "legacy",   TRAFFIC_ALARM_LEGACY   },
+};
+
+#define ALARMS  (sizeof(alarms) / sizeof(alarms[0]))
+
+static double cycles_decode(const codec_t *c, const uint8_t *frame, size_t size)
+{
+  ufo_t fo;
+  uint64_t start = Host_cycles();
+
+  for (int i = 0; i < BENCH_RUNS; i++) {
+    memcpy(RxBuffer, frame, size);
+    c->decode(RxBuffer, &ThisAircraft, &fo);
+  }
+
+  return (double) (Host_cycles() - start) / BENCH_RUNS;
+}
+
+static double cycles_pipeline(const uint8_t *frame, size_t size, bool *tracked)
+{
+  uint64_t start = Host_cycles();
+
+  for (int i = 0; i < BENCH_RUNS; i++) {
+    memcpy(RxBuffer, frame, size);
+    ParseData(&ThisAircraft);
+  }
+
+  double cycles = (double) (Host_cycles() - start) / BENCH_RUNS;
+
+  *tracked = false;
+  for (int i = 0; i < MAX_TRACKING_OBJECTS; i++) {
+    *tracked |= Container[i].addr != 0;
+  }
+
+  return cycles;
+}
+
+int main()
+{
+  Codecs_setup();
+
+  ThisAircraft = Codecs_rx;
+
+  printf("%-10s %8s", "codec", "decode");
+  for (size_t a = 0; a < ALARMS; a++) {
+    printf(" %9s", alarms[a].name);
+  }
+  printf("   (cycles per frame)\n");
+
+  for (int i = 0; i < Codecs_num; i++) {
+    const codec_t *c = &Codecs[i];
+    uint8_t frame[CODEC_FRAME_MAX];
+    size_t size = Codecs_frame(c, frame);
+    bool tracked = true;
+
+    if (size > sizeof(RxBuffer)) {
+      printf("%-10s %8s   (frame is larger than RxBuffer)\n", c->name, "-");
+      continue;
+    }
+
+    /* RF_Rx_Select() */
+    protocol_decode = c->decode;
+    RF_rx_protocol  = c->protocol;
+    RF_rx_size      = c->size;
+
+    printf("%-10s %8.0f", c->name, cycles_decode(c, frame, size));
+
+    for (size_t a = 0; a < ALARMS; a++) {
+      bool ok;
+
+      settings->alarm = alarms[a].alarm;
+      Traffic_setup();
+      memset(Container, 0, sizeof(Container));
+
+      printf(" %9.0f", cycles_pipeline(frame, size, &ok));
+      tracked &= ok;
+    }
+    printf("%s\n", tracked ? "" : "   not tracked");
+  }
+
+  return 0;
+}
@@ -0,0 +1,311 @@
+/*
+ * bench_ufo.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * RAM per target and table scan cycles of ufo_t.
+ *
+ * 'former' is the layout of ufo_t before the hot/cold split, with the
+ * raw frame at the head; 'hot/cold' is that of SoftRF.h without raw,
+ * as MCU builds have it. Both are given with 32-bit time_t of the MCUs
+ * here; the one that this host build of SoftRF.h gives is printed too.
+ *
+ * The scan is what the alarm, display and export loops do every cycle:
+ * live entries, their distance and alarm level. The clear is of every
+ * entry, as ClearExpired() does it: a whole record copy of EmptyFO
+ * before, Traffic_Clear() of the hot part now. Tables of MCU size and
+ * larger ones show what the density of the hot part is worth.
+ *
+ * The budget is of the small MCU targets: every array that is sized by
+ * MAX_TRACKING_OBJECTS there, with the former ufo_t and the hot/cold one.
+ * The limits in src/platform/*.h are what fits in the RAM of the former
+ * 8 targets; the check keeps them there.
+ *
+ * Cycles are of the TSC on x86 hosts and nanoseconds elsewhere.
+ */
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../src/system/SoC.h"
+#include "../src/TrafficHelper.h"
+
+#include "host/Host.h"
+
+#define BENCH_PASSES    (1 << 22) /* entries scanned per table size */
+
+/* ufo_t before the hot/cold split */
+template <typename time_type> struct ufo_former {
+    uint8_t   raw[34];
+    time_type timestamp;
+
+    uint8_t   protocol;
+
+    uint32_t  addr;
+    uint8_t   addr_type;
+    float     latitude;
+    float     longitude;
+    float     altitude;
+    float     pressure_altitude;
+    float     course;
+    float     speed;
+    uint8_t   aircraft_type;
+
+    float     vs;
+
+    bool      stealth;
+    bool      no_track;
+
+    int8_t    ns[4];
+    int8_t    ew[4];
+
+    float     geoid_separation;
+    uint16_t  hdop;
+    int8_t    rssi;
+
+    float     distance;
+    float     bearing;
+    int8_t    alarm_level;
+
+    uint8_t   alert;
+
+    uint8_t   callsign[8];
+};
+
+/* ufo_t of SoftRF.h, without ENABLE_UFO_RAW */
+template <typename time_type> struct ufo_split {
+    time_type timestamp;
+    uint32_t  addr;
+
+    float     latitude;
+    float     longitude;
+    float     altitude;
+    float     pressure_altitude;
+    float     course;
+    float     speed;
+    float     vs;
+
+    float     distance;
+    float     bearing;
+    int8_t    alarm_level;
+
+    uint8_t   alert;
+
+    uint8_t   protocol;
+    uint8_t   addr_type;
+    uint8_t   aircraft_type;
+    bool      stealth;
+    bool      no_track;
+
+    int8_t    rssi;
+    float     geoid_separation;
+    uint16_t  hdop;
+
+    int8_t    ns[4];
+    int8_t    ew[4];
+
+    uint8_t   callsign[8];
+};
+
+typedef ufo_former<uint32_t> former_t;
+typedef ufo_split<uint32_t>  split_t;
+
+/* traffic_fusion_t of TrafficHelper.cpp */
+struct fusion_source {
+    uint32_t  addr;
+    uint8_t   addr_type;
+    uint8_t   protocol;
+    uint32_t  timestamp;
+};
+
+struct fusion {
+    uint32_t             addr;
+    struct fusion_source src[3];
+    uint8_t              alt_protocol;
+    uint32_t             alt_time;
+    uint8_t              vs_protocol;
+    uint32_t             vs_time;
+};
+
+/* d1090_ident_t of D1090.cpp */
+struct d1090_ident {
+    uint32_t  addr;
+    uint8_t   protocol;
+    uint8_t   aircraft_type;
+    char      hex[1 + 2 * 14 + 3];
+};
+
+#define FORMER_TARGETS  8   /* limit of every MCU before the split */
+#define BY_DIST_ENTRY   8   /* traffic_by_dist_t, with 32-bit pointer */
+#define USB_FIFO_ENTRY  65  /* USB_TX_FIFO_SIZE bytes per target */
+
+static const struct {
+  const char *name;
+  bool        fusion;
+  bool        usb_fifo;
+  size_t      targets;      /* MAX_TRACKING_OBJECTS of the platform */
+} platforms[] = {
+  { "STM32",  false, false, 11 },
+  { "ASR66",  false, false, 11 },
+  { "CC13XX", false, false, 11 },
+  { "nRF52",  true,  false, 10 },
+  { "SAMD",   true,  true,  9  },
+  { "RP2XXX", true,  true,  9  },
+};
+
+#define PLATFORMS (sizeof(platforms) / sizeof(platforms[0]))
+
+static const size_t sizes[] = { MAX_TRACKING_OBJECTS, 64, 4096 };
+
+#define SIZES   (sizeof(sizes) / sizeof(sizes[0]))
+#define ENTRIES 4096
+
+static former_t  Former[ENTRIES], Former_Empty;
+static split_t   Split[ENTRIES];
+
+static volatile float  Sink_distance;
+static volatile int8_t Sink_level;
+
+template <typename T> static void table_fill(T *table, size_t n)
+{
+  memset(table, 0, n * sizeof(T));
+
+  /* 3 entries of 4 live, as a busy airfield keeps the table */
+  for (size_t i = 0; i < n; i++) {
+    table[i].addr        = (i % 4) ? 0x100000 + i : 0;
+    table[i].timestamp   = 1000 - (i % 16);
+    table[i].distance    = (float) (i * 37 % 5000);
+    table[i].alarm_level = (int8_t) (i % 3);
+  }
+}
+
+template <typename T> __attribute__((noinline))
+static void table_scan(T *table, size_t n, uint32_t this_moment)
+{
+  float   nearest = 1e9;
+  int8_t  level   = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    T *t = &table[i];
+
+    if (t->addr && this_moment - t->timestamp <= ENTRY_EXPIRATION_TIME) {
+      if (t->distance < nearest) {
+        nearest = t->distance;
+      }
+      if (t->alarm_level > level) {
+        level = t->alarm_level;
+      }
+    }
+  }
+
+  Sink_distance = nearest;
+  Sink_level    = level;
+}
+
+__attribute__((noinline))
+static void clear_former(former_t *table, size_t n)
+{
+  for (size_t i = 0; i < n; i++) {
+    table[i] = Former_Empty;
+  }
+}
+
+__attribute__((noinline))
+static void clear_split(split_t *table, size_t n)
+{
+  for (size_t i = 0; i < n; i++) {
+    memset(&table[i], 0, offsetof(split_t, rssi));
+  }
+}
+
+template <typename T> static double cycles_scan(T *table, size_t n)
+{
+  size_t runs = BENCH_PASSES / n;
+
+  table_fill(table, n);
+
+  uint64_t start = Host_cycles();
+  for (size_t r = 0; r < runs; r++) {
+    table_scan(table, n, 1000);
+  }
+
+  return (double) (Host_cycles() - start) / (runs * n);
+}
+
+template <typename T> static double cycles_clear(T *table, size_t n,
+                                                 void (*clear)(T *, size_t))
+{
+  size_t runs = BENCH_PASSES / n;
+
+  uint64_t start = Host_cycles();
+  for (size_t r = 0; r < runs; r++) {
+    clear(table, n);
+  }
+
+  return (double) (Host_cycles() - start) / (runs * n);
+}
+
+int main()
+{
+  /* the copy above must stay the layout of SoftRF.h */
+  CHECK(offsetof(ufo_t, rssi)     == offsetof(ufo_split<time_t>, rssi));
+  CHECK(offsetof(ufo_t, hdop)     == offsetof(ufo_split<time_t>, hdop));
+  CHECK(offsetof(ufo_t, callsign) == offsetof(ufo_split<time_t>, callsign));
+
+  printf("%-10s %8s %8s %10s   (bytes, 32-bit time_t)\n",
+         "layout", "entry", "hot", "table");
+  printf("%-10s %8zu %8s %10zu\n", "former", sizeof(former_t), "-",
+         sizeof(former_t) * MAX_TRACKING_OBJECTS);
+  printf("%-10s %8zu %8zu %10zu\n", "hot/cold", sizeof(split_t),
+         offsetof(split_t, rssi), sizeof(split_t) * MAX_TRACKING_OBJECTS);
+  printf("%-10s %8zu %8zu %10zu   (this host build of SoftRF.h)\n", "ufo_t",
+         sizeof(ufo_t), offsetof(ufo_t, rssi),
+         sizeof(ufo_t) * MAX_TRACKING_OBJECTS);
+
+  printf("\n%-10s %8s %8s %8s %8s   (bytes, per target and of all)\n",
+         "platform", "former", "now", "fits", "limit");
+
+  for (size_t p = 0; p < PLATFORMS; p++) {
+    size_t other = BY_DIST_ENTRY + sizeof(struct d1090_ident) +
+                   (platforms[p].fusion   ? sizeof(struct fusion) : 0) +
+                   (platforms[p].usb_fifo ? USB_FIFO_ENTRY        : 0);
+    size_t former = (sizeof(former_t) + other) * FORMER_TARGETS;
+    size_t entry  =  sizeof(split_t)  + other;
+
+    printf("%-10s %8zu %8zu %8zu %8zu   %zu of %zu\n", platforms[p].name,
+           sizeof(former_t) + other, entry, former / entry,
+           platforms[p].targets, entry * platforms[p].targets, former);
+
+    CHECK(entry * platforms[p].targets <= former);
+  }
+
+  printf("\n%-10s %9s %9s %9s %9s   (cycles per entry)\n", "entries",
+         "scan", "", "clear", "");
+  printf("%-10s %9s %9s %9s %9s\n", "", "former", "hot/cold",
+         "former", "hot/cold");
+
+  for (size_t s = 0; s < SIZES; s++) {
+    size_t n = sizes[s];
+
+    printf("%-10zu %9.2f %9.2f %9.2f %9.2f\n", n,
+           cycles_scan(Former, n), cycles_scan(Split, n),
+           cycles_clear(Former, n, clear_former),
+           cycles_clear(Split, n, clear_split));
+  }
+
+  return Host_report("bench_ufo");
+}
@@ -0,0 +1,70 @@
+/*
+ * fuzz_codecs.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Fuzz harness of the radio protocol decoders.
+ *
+ * First byte of the input picks the codec of host/Codecs.cpp, the rest
+ * is the frame as the radio hands it over: cut or zero padded to the
+ * payload size of the protocol. APRS text is always NUL terminated,
+ * as the AX.25 layer leaves it.
+ *
+ * Built with clang -fsanitize=fuzzer it is a libFuzzer target, with gcc
+ * host/FuzzMain.cpp drives it instead. Seeds are the golden frames
+ * (test_codecs --corpus <dir>).
+ */
+
+#include <string.h>
+
+#include "host/Codecs.h"
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv)
+{
+  Codecs_setup();
+
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  uint8_t frame[CODEC_FRAME_MAX + 1];
+  ufo_t   rx, fo;
+
+  if (size < 1) {
+    return 0;
+  }
+
+  const codec_t *c = &Codecs[data[0] % Codecs_num];
+
+  data++;
+  size--;
+  if (size > c->size) {
+    size = c->size;
+  }
+
+  memset(frame, 0, sizeof(frame));
+  memcpy(frame, data, size);
+
+  /* decoders may touch the receiver, every input starts from the same one */
+  rx = Codecs_rx;
+  memset(&fo, 0, sizeof(fo));
+
+  c->decode(frame, &rx, &fo);
+
+  return 0;
+}
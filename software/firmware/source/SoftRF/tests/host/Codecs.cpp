@@ -0,0 +1,251 @@
+/*
+ * Codecs.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <TimeLib.h>
+#include <mode-s.h>
+#include <LibAPRSesp.h>
+
+#include "../../src/system/SoC.h"
+#include "../../src/driver/RF.h"
+#include "../../src/driver/EEPROM.h"
+#include "../../src/driver/GNSS.h"
+#include "../../src/protocol/radio/Legacy.h"
+#include "../../src/protocol/radio/OGNTP.h"
+#include "../../src/protocol/radio/P3I.h"
+#include "../../src/protocol/radio/FANET.h"
+#include "../../src/protocol/radio/ADSL.h"
+#include "../../src/protocol/radio/UAT978.h"
+#include "../../src/protocol/radio/ES1090.h"
+#include "../../src/protocol/radio/APRS.h"
+#include "../../src/protocol/data/GDL90.h"
+
+#include "Codecs.h"
+
+/* what the codecs take from the rest of the firmware */
+eeprom_t eeprom_block;
+settings_t *settings = &eeprom_block.field.settings;
+hardware_info_t hw_info = { .model = SOFTRF_MODEL_RASPBERRY };
+/* of GNSS.cpp, when a test links it as well */
+TinyGPSPlus gnss __attribute__((weak));
+
+/*
+ * RF.cpp and GDL90.cpp carry every radio driver and data port,
+ * these are the few things of theirs that the codecs use.
+ */
+AX25Msg Incoming_APRS_Packet;
+
+uint8_t parity(uint32_t x) {
+  uint8_t parity = 0;
+
+  while (x > 0) {
+    if (x & 0x1) {
+      parity++;
+    }
+    x >>= 1;
+  }
+  return (parity % 2);
+}
+
+const uint8_t gdl90_to_aircraft_type[] PROGMEM = {
+  AIRCRAFT_TYPE_UNKNOWN,
+  AIRCRAFT_TYPE_POWERED,
+  AIRCRAFT_TYPE_POWERED,
+  AIRCRAFT_TYPE_JET,
+  AIRCRAFT_TYPE_JET,
+  AIRCRAFT_TYPE_JET,
+  AIRCRAFT_TYPE_POWERED,
+  AIRCRAFT_TYPE_HELICOPTER,
+  AIRCRAFT_TYPE_RESERVED,
+  AIRCRAFT_TYPE_GLIDER,
+  AIRCRAFT_TYPE_BALLOON,
+  AIRCRAFT_TYPE_PARACHUTE,
+  AIRCRAFT_TYPE_HANGGLIDER,
+  AIRCRAFT_TYPE_RESERVED,
+  AIRCRAFT_TYPE_UAV,
+  AIRCRAFT_TYPE_RESERVED
+};
+
+void ogntp_init();
+void adsl_init();
+
+ufo_t Codecs_tx;
+ufo_t Codecs_rx;
+
+static mode_s_t modes;
+
+/* the Tx side alternates V6 and V7 frames, take the one asked for */
+static size_t legacy_encode_type(void *pkt, ufo_t *this_aircraft, unsigned type)
+{
+  size_t size = legacy_encode(pkt, this_aircraft);
+
+  if (((legacy_v7_packet_t *) pkt)->type != type) {
+    size = legacy_encode(pkt, this_aircraft);
+  }
+
+  return size;
+}
+
+static size_t legacy_v6_encode(void *pkt, ufo_t *this_aircraft)
+{
+  return legacy_encode_type(pkt, this_aircraft, 0);
+}
+
+static size_t legacy_v7_encode(void *pkt, ufo_t *this_aircraft)
+{
+  return legacy_encode_type(pkt, this_aircraft, 2);
+}
+
+/* ES1090 payload is one 112-bit DF17 frame, libmodes turns it into a track */
+static bool es1090_frame_decode(void *pkt, ufo_t *this_aircraft, ufo_t *fop)
+{
+  struct mode_s_msg mm;
+  struct mode_s_aircraft *a;
+
+  mode_s_decode(&modes, &mm, (unsigned char *) pkt);
+  if (!mm.crcok) {
+    return false;
+  }
+
+  a = interactiveReceiveData(&modes, &mm);
+
+  return a != NULL && es1090_decode(a, this_aircraft, fop);
+}
+
+const codec_t Codecs[] = {
+  { "Legacy V6", RF_PROTOCOL_LEGACY,    LEGACY_PAYLOAD_SIZE, legacy_v6_encode, legacy_decode },
+  { "Legacy V7", RF_PROTOCOL_LEGACY,    LEGACY_PAYLOAD_SIZE, legacy_v7_encode, legacy_decode },
+  { "OGNTP",     RF_PROTOCOL_OGNTP,     OGNTP_PAYLOAD_SIZE,  ogntp_encode,     ogntp_decode  },
+  { "P3I",       RF_PROTOCOL_P3I,       P3I_PAYLOAD_SIZE,    p3i_encode,       p3i_decode    },
+  { "FANET",     RF_PROTOCOL_FANET,     FANET_PAYLOAD_SIZE,  fanet_encode,     fanet_decode  },
+  { "ADS-L",     RF_PROTOCOL_ADSL_860,  ADSL_PAYLOAD_SIZE,   adsl_encode,     adsl_decode   },
+  { "APRS",      RF_PROTOCOL_APRS,      APRS_PAYLOAD_SIZE,   aprs_encode,      aprs_decode   },
+  { "UAT978",    RF_PROTOCOL_ADSB_UAT,  UAT978_PAYLOAD_SIZE, NULL,             uat978_decode },
+  { "ES1090",    RF_PROTOCOL_ADSB_1090, ES1090_PAYLOAD_SIZE, NULL,             es1090_frame_decode },
+};
+
+const int Codecs_num = sizeof(Codecs) / sizeof(Codecs[0]);
+
+bool Codecs_es1090(const uint8_t *frames, int num, ufo_t *fop)
+{
+  bool rval = false;
+
+  for (int i = 0; i < num; i++) {
+    uint8_t frame[ES1090_PAYLOAD_SIZE];
+
+    memcpy(frame, frames + i * ES1090_PAYLOAD_SIZE, sizeof(frame));
+    rval = es1090_frame_decode(frame, &Codecs_rx, fop);
+  }
+
+  return rval;
+}
+
+/* MSB first bit field of a UAT frame */
+static void uat_put(uint8_t *frame, int pos, int len, uint32_t value)
+{
+  for (int i = 0; i < len; i++) {
+    if (value & (1UL << (len - 1 - i))) {
+      frame[(pos + i) / 8] |= 0x80 >> ((pos + i) % 8);
+    }
+  }
+}
+
+/* DO-282 basic ADS-B message: header and state vector */
+void Codecs_uat978(uint8_t *frame)
+{
+  memset(frame, 0, UAT978_PAYLOAD_SIZE);
+  uat_put(frame,   0,  5, 0);             /* payload type code 0 */
+  uat_put(frame,   5,  3, 0);             /* ICAO address via ADS-B */
+  uat_put(frame,   8, 24, 0xA1B2C3);
+  uat_put(frame,  32, 23, 1864135);       /* 40.0 N */
+  uat_put(frame,  55, 24, 11883861);      /* 105.0 W */
+  uat_put(frame,  79,  1, 0);             /* barometric */
+  uat_put(frame,  80, 12, 261);           /* 5500 ft */
+  uat_put(frame,  92,  4, 8);             /* NIC */
+  uat_put(frame,  96,  2, 0);             /* airborne, subsonic */
+  uat_put(frame,  99, 11, 101);           /* 100 kt north */
+  uat_put(frame, 110, 11, 51);            /*  50 kt east */
+  uat_put(frame, 121, 11, 0x400 | 11);    /* +640 fpm, barometric */
+}
+
+/* "The 1090 MHz Riddle" (J. Sun) */
+const uint8_t Codecs_es1090_frames[CODECS_ES1090_FRAMES][ES1090_PAYLOAD_SIZE] = {
+  /* KLM1023 identification */
+  { 0x8D, 0x48, 0x40, 0xD6, 0x20, 0x2C, 0xC3, 0x71, 0xC3, 0x2C, 0xE0, 0x57, 0x60, 0x98 },
+  /* airborne position, even then odd */
+  { 0x8D, 0x40, 0x62, 0x1D, 0x58, 0xC3, 0x82, 0xD6, 0x90, 0xC8, 0xAC, 0x28, 0x63, 0xA7 },
+  { 0x8D, 0x40, 0x62, 0x1D, 0x58, 0xC3, 0x86, 0x43, 0x5C, 0xC4, 0x12, 0x69, 0x2A, 0xD6 },
+  /* airborne velocity */
+  { 0x8D, 0x48, 0x50, 0x20, 0x99, 0x44, 0x09, 0x94, 0x08, 0x38, 0x17, 0x5B, 0x28, 0x4F },
+};
+
+size_t Codecs_frame(const codec_t *c, uint8_t *frame)
+{
+  memset(frame, 0, CODEC_FRAME_MAX);
+
+  if (c->encode != NULL) {
+    return c->encode(frame, &Codecs_tx);
+  }
+
+  switch (c->protocol)
+  {
+  case RF_PROTOCOL_ADSB_UAT:
+    Codecs_uat978(frame);
+    return UAT978_PAYLOAD_SIZE;
+  case RF_PROTOCOL_ADSB_1090:
+    memcpy(frame, Codecs_es1090_frames[3], ES1090_PAYLOAD_SIZE);
+    return ES1090_PAYLOAD_SIZE;
+  default:
+    return 0;
+  }
+}
+
+void Codecs_setup()
+{
+  /* 2025-10-09 08:53:20 UTC */
+  const time_t timestamp = 1760000000;
+
+  setTime(timestamp);
+  mode_s_init(&modes);
+  ogntp_init();
+  adsl_init();
+
+  memset(&Codecs_tx, 0, sizeof(Codecs_tx));
+  Codecs_tx.timestamp         = timestamp;
+  Codecs_tx.addr              = 0x3D1234;
+  Codecs_tx.latitude          = 47.3823;
+  Codecs_tx.longitude         = 8.5432;
+  Codecs_tx.altitude          = 1250;
+  Codecs_tx.pressure_altitude = 1230;
+  Codecs_tx.geoid_separation  = 48;
+  Codecs_tx.course            = 123.5;
+  Codecs_tx.speed             = 54;             /* knots */
+  Codecs_tx.vs                = 394;            /* 2 m/s */
+  Codecs_tx.hdop              = 100;
+  Codecs_tx.aircraft_type     = AIRCRAFT_TYPE_GLIDER;
+
+  memset(&Codecs_rx, 0, sizeof(Codecs_rx));
+  Codecs_rx.timestamp         = timestamp;
+  Codecs_rx.addr              = 0x3D5678;
+  Codecs_rx.latitude          = 47.4000;
+  Codecs_rx.longitude         = 8.5800;
+  Codecs_rx.altitude          = 900;
+  Codecs_rx.geoid_separation  = 48;
+  Codecs_rx.aircraft_type     = AIRCRAFT_TYPE_GLIDER;
+}
@@ -0,0 +1,65 @@
+/*
+ * Codecs.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Radio protocol codecs of src/protocol/radio, as the codec tests,
+ * fuzz harnesses and benchmarks see them, and the ownship they share.
+ */
+
+#ifndef CODECS_H
+#define CODECS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "../../SoftRF.h"
+#include "../../src/protocol/radio/UAT978.h"
+#include "../../src/protocol/radio/ES1090.h"
+
+#define CODEC_FRAME_MAX   128 /* APRS_PAYLOAD_SIZE and the rest */
+
+typedef struct codec_struct {
+  const char *name;
+  uint8_t     protocol;
+  size_t      size;                             /* frame bytes */
+  size_t      (*encode)(void *, ufo_t *);       /* NULL if Rx only */
+  bool        (*decode)(void *, ufo_t *, ufo_t *);
+} codec_t;
+
+extern const codec_t Codecs[];
+extern const int     Codecs_num;
+
+extern ufo_t         Codecs_tx;     /* transmitting aircraft */
+extern ufo_t         Codecs_rx;     /* receiving aircraft, 3 km away */
+
+void Codecs_setup(void);
+
+/* a frame of the codec: of its encoder, or a sample one if Rx only */
+size_t Codecs_frame(const codec_t *, uint8_t *frame);
+
+/* DO-282 state vector of A1B2C3, 40N 105W, 5500 ft, 100 kt N, 50 kt E */
+void Codecs_uat978(uint8_t *frame);
+
+/* ident, even and odd position, velocity */
+#define CODECS_ES1090_FRAMES  4
+extern const uint8_t Codecs_es1090_frames[CODECS_ES1090_FRAMES][ES1090_PAYLOAD_SIZE];
+
+/* DF17 frames of ES1090 go through libmodes into a mode_s_aircraft */
+bool Codecs_es1090(const uint8_t *frames, int num, ufo_t *fop);
+
+#endif /* CODECS_H */
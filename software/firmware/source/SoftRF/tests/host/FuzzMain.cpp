@@ -0,0 +1,197 @@
+/*
+ * FuzzMain.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Stand-in of libFuzzer for toolchains without it (gcc).
+ *
+ *   fuzz_xxx [-runs=N] [-seed=N] [file or directory ...]
+ *
+ * Every input of the corpus is run once, then N inputs are made out of
+ * them by random bit flips, byte writes, inserts, erases and cuts.
+ * No coverage feedback - that is what clang -fsanitize=fuzzer is for;
+ * with -fsanitize=address,undefined this still finds the overruns of
+ * a decoder that trusts a length or an offset of the frame.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+#include "Host.h"
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv);
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+/* of the sanitizer runtime, when linked */
+extern "C" void __sanitizer_set_death_callback(void (*)(void)) __attribute__((weak));
+
+#define FUZZ_INPUT_MAX  256
+
+typedef std::vector<uint8_t> input_t;
+
+static input_t current;
+
+/* input that the sanitizer stopped on, to be replayed as a corpus file */
+static void save_crash()
+{
+  FILE *f = fopen("crash-input", "wb");
+
+  if (f != NULL) {
+    fwrite(current.data(), 1, current.size(), f);
+    fclose(f);
+    fprintf(stderr, "input written to crash-input\n");
+  }
+}
+
+static void load_file(const char *path, std::vector<input_t> &corpus)
+{
+  FILE *f = fopen(path, "rb");
+  input_t in;
+  int c;
+
+  if (f == NULL) {
+    return;
+  }
+  while ((c = fgetc(f)) != EOF && in.size() < FUZZ_INPUT_MAX) {
+    in.push_back((uint8_t) c);
+  }
+  fclose(f);
+
+  corpus.push_back(in);
+}
+
+static void load(const char *path, std::vector<input_t> &corpus)
+{
+  struct stat st;
+
+  if (stat(path, &st) != 0) {
+    fprintf(stderr, "%s: not found\n", path);
+    return;
+  }
+
+  if (!S_ISDIR(st.st_mode)) {
+    load_file(path, corpus);
+    return;
+  }
+
+  DIR *dir = opendir(path);
+  struct dirent *de;
+
+  while (dir != NULL && (de = readdir(dir)) != NULL) {
+    if (de->d_name[0] != '.') {
+      load_file((std::string(path) + "/" + de->d_name).c_str(), corpus);
+    }
+  }
+  if (dir != NULL) {
+    closedir(dir);
+  }
+}
+
+static void mutate(input_t &in)
+{
+  int n = 1 + rand() % 4;
+
+  while (n--) {
+    size_t pos = in.empty() ? 0 : rand() % in.size();
+
+    switch (rand() % 5) {
+    case 0:
+      if (!in.empty()) {
+        in[pos] ^= 1 << (rand() % 8);
+      }
+      break;
+    case 1:
+      if (!in.empty()) {
+        in[pos] = rand();
+      }
+      break;
+    case 2:
+      if (in.size() < FUZZ_INPUT_MAX) {
+        in.insert(in.begin() + pos, (uint8_t) rand());
+      }
+      break;
+    case 3:
+      if (!in.empty()) {
+        in.erase(in.begin() + pos);
+      }
+      break;
+    default:
+      in.resize(pos);
+      break;
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  std::vector<input_t> corpus;
+  unsigned long runs = 100000;
+  unsigned seed = 1;
+
+  LLVMFuzzerInitialize(&argc, &argv);
+
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-runs=", 6) == 0) {
+      runs = strtoul(argv[i] + 6, NULL, 10);
+    } else if (strncmp(argv[i], "-seed=", 6) == 0) {
+      seed = strtoul(argv[i] + 6, NULL, 10);
+    } else if (argv[i][0] != '-') {
+      load(argv[i], corpus);
+    }
+  }
+
+  srand(seed);
+
+  if (__sanitizer_set_death_callback) {
+    __sanitizer_set_death_callback(save_crash);
+  }
+
+  for (size_t i = 0; i < corpus.size(); i++) {
+    current = corpus[i];
+    LLVMFuzzerTestOneInput(current.data(), current.size());
+  }
+
+  uint64_t start = Host_wall_ns();
+
+  for (unsigned long i = 0; i < runs; i++) {
+    input_t &in = current;
+
+    if (corpus.empty() || rand() % 8 == 0) {
+      in.resize(rand() % FUZZ_INPUT_MAX);
+      for (size_t k = 0; k < in.size(); k++) {
+        in[k] = rand();
+      }
+    } else {
+      in = corpus[rand() % corpus.size()];
+    }
+    mutate(in);
+
+    LLVMFuzzerTestOneInput(in.data(), in.size());
+  }
+
+  double secs = (Host_wall_ns() - start) / 1e9;
+
+  printf("%s: %zu seeds, %lu runs in %.1f s, seed %u\n",
+         argv[0], corpus.size(), runs, secs, seed);
+
+  return 0;
+}
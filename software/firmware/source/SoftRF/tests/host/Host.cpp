@@ -0,0 +1,87 @@
+/*
+ * Host.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <bcm2835.h>
+
+#include "Host.h"
+
+uint64_t Host_time_us  = 0;
+int      Host_failures = 0;
+
+extern "C" {
+
+unsigned int millis()
+{
+  return (unsigned int) (Host_time_us / 1000);
+}
+
+unsigned int micros()
+{
+  return (unsigned int) Host_time_us;
+}
+
+void bcm2835_delay(unsigned int ms)
+{
+  Host_advance_ms(ms);
+}
+
+void bcm2835_delayMicroseconds(uint64_t us)
+{
+  Host_advance_us(us);
+}
+
+}
+
+void Host_advance_us(uint64_t us)
+{
+  Host_time_us += us;
+}
+
+void Host_advance_ms(uint32_t ms)
+{
+  Host_time_us += (uint64_t) ms * 1000;
+}
+
+uint64_t Host_wall_ns()
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+
+  return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+uint64_t Host_cycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return Host_wall_ns();
+#endif
+}
+
+int Host_report(const char *name)
+{
+  printf("%s: %s\n", name, Host_failures ? "FAILED" : "passed");
+
+  return Host_failures ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * Host.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Host (Linux) test support.
+ *
+ * Firmware sources are built as for RASPBERRY_PI, but millis(), micros()
+ * and delay() run on a fake clock that only moves when a test (or a
+ * delay() of the code under test) advances it.
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+extern uint64_t Host_time_us;
+extern int      Host_failures;
+
+void     Host_advance_us(uint64_t);
+void     Host_advance_ms(uint32_t);
+uint64_t Host_wall_ns(void);
+uint64_t Host_cycles(void);       /* TSC on x86, Host_wall_ns() elsewhere */
+int      Host_report(const char *);
+
+#define CHECK(c)                                                             \
+  do {                                                                       \
+    if (!(c)) {                                                              \
+      fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #c);  \
+      Host_failures++;                                                       \
+    }                                                                        \
+  } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                \
+  do {                                                                       \
+    double _a = (a), _b = (b);                                               \
+    if (_a - _b > (tol) || _b - _a > (tol)) {                                \
+      fprintf(stderr, "%s:%d: %s = %g, expected %g +/- %g\n",                \
+              __FILE__, __LINE__, #a, _a, _b, (double) (tol));               \
+      Host_failures++;                                                       \
+    }                                                                        \
+  } while (0)
+
+#endif /* HOST_H */
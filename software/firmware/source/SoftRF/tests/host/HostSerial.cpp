@@ -0,0 +1,193 @@
+/*
+ * HostSerial.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Host.h"
+#include "HostSerial.h"
+
+#define HOST_PORTS  4
+
+typedef struct HostPort_struct {
+  const TTYSerial *tty;
+  std::string      in;
+  size_t           pos;
+  std::string      out;
+  int              baud;
+  bool             wire;
+  size_t           ready;   /* end of the bytes that came in so far */
+  uint64_t         next_us; /* when the byte at 'ready' comes in */
+} HostPort_t;
+
+static HostPort_t  HostPorts[HOST_PORTS];
+static std::string HostConsole;
+
+static HostPort_t &HostSerial_port(const TTYSerial *tty)
+{
+  int i;
+
+  for (i = 0; i < HOST_PORTS - 1 && HostPorts[i].tty != NULL; i++) {
+    if (HostPorts[i].tty == tty) {
+      return HostPorts[i];
+    }
+  }
+  HostPorts[i].tty = tty;
+
+  return HostPorts[i];
+}
+
+/* 8N1 */
+static uint64_t HostSerial_char_us(const HostPort_t &p)
+{
+  return 10000000ULL / (p.baud > 0 ? p.baud : 9600);
+}
+
+/* end of the bytes that can be read now; a poll of an empty port waits */
+static size_t HostSerial_ready(HostPort_t &p, bool poll)
+{
+  if (!p.wire) {
+    return p.in.size();
+  }
+
+  while (p.ready < p.in.size() && p.next_us <= Host_time_us) {
+    p.ready++;
+    p.next_us += HostSerial_char_us(p);
+  }
+
+  if (poll && p.pos == p.ready) {
+    Host_advance_us(HostSerial_char_us(p));
+  }
+
+  return p.ready;
+}
+
+SerialSimulator Serial;
+TTYSerial Serial1("host1");
+TTYSerial Serial2("host2");
+
+void HostSerial_feed(TTYSerial &port, const void *buf, size_t len)
+{
+  HostPort_t &p = HostSerial_port(&port);
+
+  if (p.pos == p.in.size()) {
+    p.in.clear();
+    p.pos   = 0;
+    p.ready = 0;
+  }
+  if (p.wire && p.ready == p.in.size()) {
+    p.next_us = Host_time_us + HostSerial_char_us(p);
+  }
+  p.in.append((const char *) buf, len);
+}
+
+void HostSerial_wire(TTYSerial &port, bool on)
+{
+  HostPort_t &p = HostSerial_port(&port);
+
+  p.wire    = on;
+  p.ready   = p.pos;
+  p.next_us = Host_time_us + HostSerial_char_us(p);
+}
+
+std::string &HostSerial_output(TTYSerial &port)
+{
+  return HostSerial_port(&port).out;
+}
+
+std::string &HostSerial_console()
+{
+  return HostConsole;
+}
+
+TTYSerial::TTYSerial(const char *deviceName) : _deviceName(deviceName),
+                                               _device(-1), _baud(0) {}
+
+void TTYSerial::begin(int baud)
+{
+  _baud = baud;
+  HostSerial_port(this).baud = baud;
+}
+
+void TTYSerial::end()             {}
+void TTYSerial::flush()           {}
+bool TTYSerial::rts(bool value)   { return true; }
+bool TTYSerial::dtr(bool value)   { return true; }
+
+int TTYSerial::available()
+{
+  HostPort_t &p = HostSerial_port(this);
+
+  return (int) (HostSerial_ready(p, true) - p.pos);
+}
+
+int TTYSerial::peek()
+{
+  HostPort_t &p = HostSerial_port(this);
+
+  return p.pos < HostSerial_ready(p, true) ? (uint8_t) p.in[p.pos] : -1;
+}
+
+int TTYSerial::read()
+{
+  HostPort_t &p = HostSerial_port(this);
+
+  return p.pos < HostSerial_ready(p, true) ? (uint8_t) p.in[p.pos++] : -1;
+}
+
+size_t TTYSerial::write(uint8_t ch)
+{
+  HostSerial_port(this).out += (char) ch;
+  return 1;
+}
+
+size_t TTYSerial::write(unsigned char *s, size_t len)
+{
+  HostSerial_port(this).out.append((const char *) s, len);
+  return len;
+}
+
+size_t TTYSerial::write(const char *s)
+{
+  return write((unsigned char *) s, strlen(s));
+}
+
+void TTYSerial::waitAvailable()                   {}
+bool TTYSerial::waitAvailableTimeout(uint16_t ms) { return available() > 0; }
+
+/* console output is kept, not printed */
+void   SerialSimulator::begin(int baud)            {}
+size_t SerialSimulator::println(void)              { HostConsole += '\n'; return 1; }
+size_t SerialSimulator::println(const char *s)     { print(s); return println() + strlen(s); }
+size_t SerialSimulator::print(String s)            { return print(s.c_str()); }
+size_t SerialSimulator::println(String s)          { return println(s.c_str()); }
+size_t SerialSimulator::print(const char *s)       { HostConsole += s; return strlen(s); }
+size_t SerialSimulator::println(short signed int n)   { return println(String(n)); }
+size_t SerialSimulator::println(short unsigned int n) { return println(String(n)); }
+size_t SerialSimulator::print(ostime_t n)          { return print(String((long) n)); }
+size_t SerialSimulator::print(unsigned long n)     { return print(String(n)); }
+size_t SerialSimulator::println(unsigned long n)   { return println(String(n)); }
+size_t SerialSimulator::print(unsigned int n, int base) { return print(String(n, (unsigned char) base)); }
+size_t SerialSimulator::print(char ch)             { HostConsole += ch; return 1; }
+size_t SerialSimulator::println(char ch)           { print(ch); return println() + 1; }
+size_t SerialSimulator::println(int8_t n)          { return println(String((int) n)); }
+size_t SerialSimulator::print(unsigned char ch, int base)   { return print((unsigned int) ch, base); }
+size_t SerialSimulator::println(unsigned char ch, int base) { print(ch, base); return println(); }
+size_t SerialSimulator::write(char ch)             { return print(ch); }
+size_t SerialSimulator::write(unsigned char *s, size_t len) { HostConsole.append((const char *) s, len); return len; }
+size_t SerialSimulator::write(const char *s)       { return print(s); }
+size_t SerialSimulator::available(void)            { return 0; }
+size_t SerialSimulator::read(void)                 { return -1; }
+void   SerialSimulator::flush(void)                {}
@@ -0,0 +1,45 @@
+/*
+ * HostSerial.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * In-memory Serial (console) and Serial1/Serial2 (TTYSerial) ports.
+ * Bytes fed into a port are read back by the firmware, whatever the
+ * firmware writes is kept for the test to look at.
+ *
+ * A port put on the wire takes its time: fed bytes come in one per
+ * character time at the baud rate of begin(), and every poll of the
+ * port with nothing in it moves the clock of Host.h by a character
+ * time, as the firmware would wait on a real port.
+ */
+
+#ifndef HOSTSERIAL_H
+#define HOSTSERIAL_H
+
+#include <string>
+#include <raspi/raspi.h>
+#include <raspi/TTYSerial.h>
+
+extern TTYSerial Serial1;
+extern TTYSerial Serial2;
+
+void         HostSerial_feed(TTYSerial &, const void *, size_t);
+void         HostSerial_wire(TTYSerial &, bool);
+std::string &HostSerial_output(TTYSerial &);
+std::string &HostSerial_console(void);
+
+#endif /* HOSTSERIAL_H */
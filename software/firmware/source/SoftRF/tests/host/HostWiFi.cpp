@@ -0,0 +1,240 @@
+/*
+ * HostWiFi.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "Host.h"
+#include "HostWiFi.h"
+
+#define HOSTWIFI_HOSTS    8
+#define HOSTWIFI_LOOKUPS  4   /* DNS_TABLE_SIZE of lwIP */
+
+typedef struct HostWiFi_host_struct {
+  char      name[64];
+  IPAddress ip;
+} HostWiFi_host_t;
+
+static HostWiFi_host_t HostWiFi_hosts[HOSTWIFI_HOSTS];
+
+typedef struct HostWiFi_lookup_struct {
+  dns_found_callback found;   /* NULL - free */
+  void               *arg;
+  char               name[64];
+  ip_addr_t          ip;      /* 0 - no such name */
+  uint64_t           due_us;
+} HostWiFi_lookup_t;
+
+static HostWiFi_lookup_t HostWiFi_lookups[HOSTWIFI_LOOKUPS];
+
+WiFiClass WiFi;
+
+int      HostWiFi_status    = WL_CONNECTED;
+uint32_t HostWiFi_lookup_ms = 0;
+uint16_t HostWiFi_port_from = 0;
+uint16_t HostWiFi_port_to   = 0;
+
+void HostWiFi_host(const char *name, IPAddress ip)
+{
+  for (int i = 0; i < HOSTWIFI_HOSTS; i++) {
+    HostWiFi_host_t *h = &HostWiFi_hosts[i];
+
+    if (h->name[0] == 0 || strcmp(h->name, name) == 0) {
+      snprintf(h->name, sizeof(h->name), "%s", name);
+      h->ip = ip;
+      return;
+    }
+  }
+}
+
+void HostWiFi_hosts_clear()
+{
+  memset(HostWiFi_hosts, 0, sizeof(HostWiFi_hosts));
+  memset(HostWiFi_lookups, 0, sizeof(HostWiFi_lookups));
+}
+
+int WiFiClass::status()
+{
+  return HostWiFi_status;
+}
+
+int WiFiClass::getMode()
+{
+  return WIFI_STA;
+}
+
+static IPAddress HostWiFi_find(const char *name)
+{
+  for (int i = 0; i < HOSTWIFI_HOSTS; i++) {
+    HostWiFi_host_t *h = &HostWiFi_hosts[i];
+
+    if (strcmp(h->name, name) == 0) {
+      return h->ip;
+    }
+  }
+
+  return 0;
+}
+
+err_t dns_gethostbyname(const char *name, ip_addr_t *addr,
+                        dns_found_callback found, void *arg)
+{
+  if (HostWiFi_lookup_ms == 0) {
+    addr->addr = HostWiFi_find(name);
+    return addr->addr ? ERR_OK : ERR_ARG;
+  }
+
+  for (int i = 0; i < HOSTWIFI_LOOKUPS; i++) {
+    HostWiFi_lookup_t *l = &HostWiFi_lookups[i];
+
+    if (l->found == NULL) {
+      l->found   = found;
+      l->arg     = arg;
+      l->ip.addr = HostWiFi_find(name);
+      l->due_us  = Host_time_us + HostWiFi_lookup_ms * 1000ULL;
+      snprintf(l->name, sizeof(l->name), "%s", name);
+      return ERR_INPROGRESS;
+    }
+  }
+
+  return ERR_MEM;
+}
+
+void HostWiFi_poll()
+{
+  for (int i = 0; i < HOSTWIFI_LOOKUPS; i++) {
+    HostWiFi_lookup_t *l = &HostWiFi_lookups[i];
+
+    if (l->found && Host_time_us >= l->due_us) {
+      dns_found_callback found = l->found;
+
+      l->found = NULL;
+      found(l->name, l->ip.addr ? &l->ip : NULL, l->arg);
+    }
+  }
+}
+
+/* the local port is left to the host, the firmware ones may be taken */
+uint8_t WiFiUDP::begin(uint16_t port)
+{
+  struct sockaddr_in sa;
+
+  stop();
+
+  _fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (_fd < 0) {
+    return 0;
+  }
+  fcntl(_fd, F_SETFL, O_NONBLOCK);
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family      = AF_INET;
+  sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  if (bind(_fd, (struct sockaddr *) &sa, sizeof(sa)) < 0) {
+    stop();
+    return 0;
+  }
+
+  return 1;
+}
+
+void WiFiUDP::stop()
+{
+  if (_fd >= 0) {
+    close(_fd);
+  }
+  _fd  = -1;
+  _len = _pos = 0;
+}
+
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port)
+{
+  _dest      = ip;
+  _dest_port = (port == HostWiFi_port_from ? HostWiFi_port_to : port);
+  _out_len   = 0;
+
+  return _fd >= 0;
+}
+
+size_t WiFiUDP::write(const uint8_t *buf, size_t size)
+{
+  if (size > sizeof(_out) - _out_len) {
+    size = sizeof(_out) - _out_len;
+  }
+  memcpy(_out + _out_len, buf, size);
+  _out_len += size;
+
+  return size;
+}
+
+int WiFiUDP::endPacket()
+{
+  struct sockaddr_in sa;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family      = AF_INET;
+  sa.sin_addr.s_addr = htonl(_dest);
+  sa.sin_port        = htons(_dest_port);
+
+  return sendto(_fd, _out, _out_len, 0,
+                (struct sockaddr *) &sa, sizeof(sa)) == (ssize_t) _out_len;
+}
+
+int WiFiUDP::parsePacket()
+{
+  struct sockaddr_in sa;
+  socklen_t sa_len = sizeof(sa);
+
+  _len = _pos = 0;
+  if (_fd < 0) {
+    return 0;
+  }
+
+  ssize_t len = recvfrom(_fd, _in, sizeof(_in), 0,
+                         (struct sockaddr *) &sa, &sa_len);
+  if (len <= 0) {
+    return 0;
+  }
+
+  _remote = ntohl(sa.sin_addr.s_addr);
+  _len = (size_t) len;
+
+  return (int) _len;
+}
+
+int WiFiUDP::read(unsigned char *buf, size_t len)
+{
+  if (len > _len - _pos) {
+    len = _len - _pos;
+  }
+  memcpy(buf, _in + _pos, len);
+  _pos += len;
+
+  return (int) len;
+}
+
+IPAddress WiFiUDP::remoteIP()
+{
+  return _remote;
+}
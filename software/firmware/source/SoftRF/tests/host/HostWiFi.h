@@ -0,0 +1,118 @@
+/*
+ * HostWiFi.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * WiFi and WiFiUDP of the Arduino cores and the name lookup of lwIP,
+ * as far as system/Time.cpp takes them, over UDP sockets of the host.
+ *
+ * Names resolve by a table of the test only. dns_gethostbyname() answers
+ * right away when HostWiFi_lookup_ms is 0, otherwise the callback comes
+ * by HostWiFi_poll() once HostWiFi_lookup_ms of the fake clock have
+ * passed, as lwIP calls it in a context of its own; HostWiFi_hosts_clear()
+ * drops the lookups under way. Datagrams to HostWiFi_port_from go to
+ * HostWiFi_port_to instead, so that a stand-in of a server on
+ * a well known port needs no privileges. IPAddress is the in_addr_t of
+ * raspi.h, in host byte order here.
+ */
+
+#ifndef HOSTWIFI_H
+#define HOSTWIFI_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <raspi/raspi.h>
+
+enum
+{
+  WL_IDLE_STATUS,
+  WL_CONNECTED,
+  WL_DISCONNECTED
+};
+
+enum
+{
+  WIFI_OFF,
+  WIFI_STA,
+  WIFI_AP,
+  WIFI_AP_STA
+};
+
+class WiFiClass
+{
+public:
+  int     status();
+  int     getMode();
+};
+
+class WiFiUDP
+{
+public:
+  WiFiUDP() : _fd(-1), _remote(0), _dest(0), _dest_port(0), _out_len(0),
+              _len(0), _pos(0) {}
+
+  uint8_t   begin(uint16_t);
+  void      stop();
+  int       beginPacket(IPAddress, uint16_t);
+  size_t    write(const uint8_t *, size_t);
+  int       endPacket();
+  int       parsePacket();
+  int       read(unsigned char *, size_t);
+  IPAddress remoteIP();
+
+private:
+  int       _fd;
+  IPAddress _remote;
+  IPAddress _dest;
+  uint16_t  _dest_port;
+  uint8_t   _out[512];
+  size_t    _out_len;
+  uint8_t   _in[512];
+  size_t    _len;
+  size_t    _pos;
+};
+
+extern WiFiClass WiFi;
+
+extern int      HostWiFi_status;
+extern uint32_t HostWiFi_lookup_ms;
+extern uint16_t HostWiFi_port_from;
+extern uint16_t HostWiFi_port_to;
+
+void HostWiFi_host(const char *, IPAddress);  /* 0 - no such name */
+void HostWiFi_hosts_clear(void);
+void HostWiFi_poll(void);                     /* callbacks that are due */
+
+/* lwip/dns.h */
+typedef int8_t err_t;
+
+#define ERR_OK          0
+#define ERR_INPROGRESS  -5
+#define ERR_MEM         -1
+#define ERR_ARG         -16
+
+typedef struct ip_addr_struct {
+  uint32_t addr;
+} ip_addr_t;
+
+#define ip_addr_get_ip4_u32(ipaddr)   ((ipaddr)->addr)
+
+typedef void (*dns_found_callback)(const char *, const ip_addr_t *, void *);
+
+err_t dns_gethostbyname(const char *, ip_addr_t *, dns_found_callback, void *);
+
+#endif /* HOSTWIFI_H */
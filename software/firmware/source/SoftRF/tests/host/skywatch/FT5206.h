@@ -0,0 +1,33 @@
+/*
+ * FT5206.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Touch point of the FT5206 library, as TFTHelper.h of SkyWatch takes it.
+ */
+
+#ifndef FT5206_H
+#define FT5206_H
+
+#include <stdint.h>
+
+typedef struct {
+  int16_t x;
+  int16_t y;
+} TP_Point;
+
+#endif /* FT5206_H */
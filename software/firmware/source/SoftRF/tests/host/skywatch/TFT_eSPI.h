@@ -0,0 +1,106 @@
+/*
+ * TFT_eSPI.h
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * TFT_eSPI and TFT_eSprite of the SkyWatch views, as far as they take
+ * them. Nothing is drawn: what goes to the screen is counted in
+ * HostTFT_bytes as the SPI bus carries it, 16 bits a pixel, whatever
+ * the colour depth of the sprite is. Text is of a fixed cell size.
+ */
+
+#ifndef TFT_ESPI_H
+#define TFT_ESPI_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define TFT_BLACK       0x0000
+#define TFT_NAVY        0x000F
+#define TFT_RED         0xF800
+#define TFT_GREEN       0x07E0
+#define TFT_YELLOW      0xFFE0
+#define TFT_WHITE       0xFFFF
+
+#define HOSTTFT_CHAR_W  14
+#define HOSTTFT_CHAR_H  26
+
+extern uint32_t HostTFT_bytes;    /* to the screen, since start */
+
+class TFT_eSPI
+{
+public:
+  TFT_eSPI(int16_t w, int16_t h) : _w(w), _h(h) {}
+
+  int16_t width()  { return _w; }
+  int16_t height() { return _h; }
+
+  void    setBitmapColor(uint16_t, uint16_t) {}
+  void    fillScreen(uint32_t) { HostTFT_bytes += (uint32_t) _w * _h * 2; }
+  void    fillCircle(int32_t, int32_t, int32_t, uint32_t) {}
+  void    fillTriangle(int32_t, int32_t, int32_t, int32_t,
+                       int32_t, int32_t, uint32_t) {}
+
+private:
+  int16_t _w;
+  int16_t _h;
+};
+
+class TFT_eSprite
+{
+public:
+  TFT_eSprite(TFT_eSPI *tft) : _tft(tft), _w(0), _h(0) {}
+
+  void   *createSprite(int16_t w, int16_t h) { _w = w; _h = h; return this; }
+  void    deleteSprite() { _w = _h = 0; }
+  bool    created() { return _w > 0; }
+  void    setColorDepth(int8_t) {}
+
+  int16_t width()  { return _w; }
+  int16_t height() { return _h; }
+
+  void    pushSprite(int32_t, int32_t) {
+    HostTFT_bytes += (uint32_t) _w * _h * 2;
+  }
+  void    pushSprite(int32_t, int32_t, int32_t, int32_t, int32_t w, int32_t h) {
+    HostTFT_bytes += (uint32_t) w * h * 2;
+  }
+
+  void    fillSprite(uint32_t) {}
+  void    drawCircle(int32_t, int32_t, int32_t, uint32_t) {}
+  void    drawFastVLine(int32_t, int32_t, int32_t, uint32_t) {}
+  void    drawFastHLine(int32_t, int32_t, int32_t, uint32_t) {}
+  void    drawRoundRect(int32_t, int32_t, int32_t, int32_t, int32_t, uint32_t) {}
+  void    fillTriangle(int32_t, int32_t, int32_t, int32_t,
+                       int32_t, int32_t, uint32_t) {}
+
+  void    setTextColor(uint16_t) {}
+  void    setTextColor(uint16_t, uint16_t) {}
+  void    setTextFont(uint8_t) {}
+  void    setTextSize(uint8_t) {}
+  void    setCursor(int16_t, int16_t) {}
+  int16_t textWidth(const char *s) { return strlen(s) * HOSTTFT_CHAR_W; }
+  int16_t fontHeight() { return HOSTTFT_CHAR_H; }
+  size_t  print(const char *s) { return strlen(s); }
+
+private:
+  TFT_eSPI *_tft;
+  int16_t   _w;
+  int16_t   _h;
+};
+
+#endif /* TFT_ESPI_H */
@@ -0,0 +1,432 @@
+/*
+ * test_afsk.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Block Rx path of the 1200 bps AFSK modem (LibAPRS_ESP32, AFSK_adc_block).
+ *
+ *   test_afsk             - self check: APRS frames with noise, tone
+ *                           twist and sample clock error are written to
+ *                           a WAV file, which is then decoded
+ *   test_afsk <file.wav>  - decode a recording (16 bit PCM, any rate;
+ *                           first channel), print the frames
+ *
+ * Audio is fed in blocks of the I2S DMA buffer, as AFSK_Poll() does it,
+ * and rxFifo is drained after every block, as APRS_poll() does it.
+ * Every frame must come out once, whatever number of demodulators has
+ * decoded it, and a frame that finds no room in rxFifo is dropped whole.
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "AFSK.h"
+#include "CRC-CCIT.h"
+
+#include "host/Host.h"
+
+#define AFSK_BLOCK        384       /* ADC_SAMPLES_COUNT / 2 */
+#define AFSK_LEVEL        1000      /* of the 12 bit ADC */
+#define AFSK_FRAMES       20
+
+typedef std::vector<uint8_t> frame_t;
+typedef std::vector<int16_t> audio_t;
+
+/* what AFSK.cpp takes from LibAPRS.cpp and the rest of the firmware */
+unsigned long custom_preamble = 350;
+unsigned long custom_tail = 50;
+int mVrms;
+float dBV;
+bool afskSync;
+
+void APRS_poll()
+{
+}
+
+/* PTT and LEDs */
+void pinMode(uint8_t pin, uint8_t mode)
+{
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+}
+
+static Afsk modem;
+
+/* --- modulator ---------------------------------------------------------- */
+
+typedef struct tx_struct {
+  audio_t  audio;
+  double   phase;
+  double   rate;        /* samples per second, with the clock error */
+  double   due;         /* samples of the bits so far */
+  double   mark, space; /* amplitude of tones */
+  bool     tone;        /* true - space */
+  int      ones;
+} tx_t;
+
+static void tx_bit(tx_t &tx, bool bit)
+{
+  /* NRZI: 0 changes the tone */
+  if (!bit) {
+    tx.tone = !tx.tone;
+  }
+
+  tx.due += tx.rate / BITRATE;
+  while (tx.audio.size() < (size_t) tx.due) {
+    double f = tx.tone ? SPACE_FREQ : MARK_FREQ;
+    double a = tx.tone ? tx.space : tx.mark;
+    double noise = (rand() / (double) RAND_MAX - 0.5) * 0.6 * AFSK_LEVEL;
+
+    tx.phase += 2 * M_PI * f / tx.rate;
+    tx.audio.push_back((int16_t) lrint(a * AFSK_LEVEL * sin(tx.phase) + noise));
+  }
+}
+
+static void tx_byte(tx_t &tx, uint8_t b, bool stuff)
+{
+  for (int i = 0; i < 8; i++, b >>= 1) {
+    bool bit = b & 1;
+
+    tx_bit(tx, bit);
+    if (!stuff) {
+      tx.ones = 0;
+    } else if (bit && ++tx.ones == BIT_STUFF_LEN) {
+      tx_bit(tx, false);
+      tx.ones = 0;
+    } else if (!bit) {
+      tx.ones = 0;
+    }
+  }
+}
+
+static void tx_frame(tx_t &tx, const frame_t &f)
+{
+  for (int i = 0; i < 30; i++) {
+    tx_byte(tx, HDLC_FLAG, false);
+  }
+  tx.ones = 0;
+  for (size_t i = 0; i < f.size(); i++) {
+    tx_byte(tx, f[i], true);
+  }
+  for (int i = 0; i < 3; i++) {
+    tx_byte(tx, HDLC_FLAG, false);
+  }
+  /* some silence */
+  for (int i = 0; i < 60; i++) {
+    tx.mark = tx.space = 0;
+    tx_bit(tx, true);
+  }
+}
+
+static void ax25_call(frame_t &f, const char *call, int ssid, bool last)
+{
+  for (int i = 0; i < 6; i++) {
+    f.push_back((*call ? *call++ : ' ') << 1);
+  }
+  f.push_back(0x60 | (ssid << 1) | (last ? 1 : 0));
+}
+
+/* UI frame with FCS */
+static frame_t ax25_frame(int n)
+{
+  frame_t f;
+  char info[256];
+  uint16_t crc = CRC_CCIT_INIT_VAL;
+
+  ax25_call(f, "APRS", 0, false);
+  ax25_call(f, "SOFTRF", n % 16, true);
+  f.push_back(AX25_CTRL_UI);
+  f.push_back(AX25_PID_NOLAYER3);
+
+  int len = snprintf(info, sizeof(info),
+                     "!4722.94N/00832.59E'%03d/%03d frame %d ", n * 17 % 360, n, n);
+  /* up to ~200 bytes, with bytes that HDLC and rxFifo escape */
+  for (int i = len; i < 20 + (n * 37) % 180; i++) {
+    info[i] = i % 29 == 0 ? HDLC_FLAG : i % 31 == 0 ? AX25_ESC : 'a' + i % 26;
+    len = i + 1;
+  }
+  f.insert(f.end(), info, info + len);
+
+  for (size_t i = 0; i < f.size(); i++) {
+    crc = update_crc_ccit(f[i], crc);
+  }
+  crc = ~crc;
+  f.push_back(crc & 0xFF);
+  f.push_back(crc >> 8);
+
+  return f;
+}
+
+/* --- WAV ---------------------------------------------------------------- */
+
+static void put_le(FILE *f, uint32_t v, int bytes)
+{
+  while (bytes--) {
+    fputc(v & 0xFF, f);
+    v >>= 8;
+  }
+}
+
+static bool wav_write(const char *path, const audio_t &a, uint32_t rate)
+{
+  FILE *f = fopen(path, "wb");
+
+  if (f == NULL) {
+    return false;
+  }
+  fwrite("RIFF", 1, 4, f);  put_le(f, 36 + 2 * a.size(), 4);
+  fwrite("WAVEfmt ", 1, 8, f);
+  put_le(f, 16, 4);  put_le(f, 1, 2);  put_le(f, 1, 2);
+  put_le(f, rate, 4);  put_le(f, 2 * rate, 4);  put_le(f, 2, 2);  put_le(f, 16, 2);
+  fwrite("data", 1, 4, f);  put_le(f, 2 * a.size(), 4);
+  for (size_t i = 0; i < a.size(); i++) {
+    put_le(f, (uint16_t) (a[i] << 4), 2);  /* 12 bit ADC to 16 bit PCM */
+  }
+  fclose(f);
+
+  return true;
+}
+
+static uint32_t get_le(const uint8_t *p, int bytes)
+{
+  uint32_t v = 0;
+
+  while (bytes--) {
+    v = (v << 8) | p[bytes];
+  }
+  return v;
+}
+
+/* 16 bit PCM, first channel, resampled to the modem rate, 12 bit */
+static bool wav_read(const char *path, audio_t &a)
+{
+  FILE *f = fopen(path, "rb");
+  uint8_t hdr[8];
+  uint32_t rate = 0, channels = 0, bits = 0;
+
+  if (f == NULL || fread(hdr, 1, 4, f) != 4 || memcmp(hdr, "RIFF", 4) ||
+      fseek(f, 12, SEEK_SET) != 0) {
+    fprintf(stderr, "%s: not a WAV file\n", path);
+    if (f) fclose(f);
+    return false;
+  }
+
+  while (fread(hdr, 1, 8, f) == 8) {
+    uint32_t size = get_le(hdr + 4, 4);
+    std::vector<uint8_t> chunk(size + (size & 1));
+
+    if (fread(chunk.data(), 1, chunk.size(), f) < size) {
+      break;
+    }
+    if (memcmp(hdr, "fmt ", 4) == 0 && size >= 16) {
+      channels = get_le(&chunk[2], 2);
+      rate     = get_le(&chunk[4], 4);
+      bits     = get_le(&chunk[14], 2);
+    } else if (memcmp(hdr, "data", 4) == 0 && bits == 16 && channels > 0) {
+      size_t frames = size / (2 * channels);
+      double step = (double) rate / AFSK_RX_SAMPLERATE;
+
+      for (double t = 0; t + 1 < frames; t += step) {
+        size_t i = (size_t) t;
+        int16_t s0 = get_le(&chunk[2 * channels * i], 2);
+        int16_t s1 = get_le(&chunk[2 * channels * (i + 1)], 2);
+
+        a.push_back((int16_t) lrint((s0 + (s1 - s0) * (t - i)) / 16));
+      }
+      fclose(f);
+      return true;
+    }
+  }
+  fclose(f);
+  fprintf(stderr, "%s: no 16 bit PCM data\n", path);
+
+  return false;
+}
+
+/* --- receiver ----------------------------------------------------------- */
+
+/* frames of rxFifo, as ax25_poll() takes them */
+static void rx_drain(std::vector<frame_t> &frames, frame_t &cur, bool &esc)
+{
+  while (!fifo_isempty(&modem.rxFifo)) {
+    uint8_t c = fifo_pop(&modem.rxFifo);
+
+    if (esc) {
+      cur.push_back(c);
+      esc = false;
+    } else if (c == AX25_ESC) {
+      esc = true;
+    } else if (c == HDLC_FLAG) {
+      if (!cur.empty()) {
+        frames.push_back(cur);
+      }
+      cur.clear();
+    } else {
+      cur.push_back(c);
+    }
+  }
+}
+
+static std::vector<frame_t> rx(const audio_t &a, bool drain)
+{
+  std::vector<frame_t> frames;
+  frame_t cur;
+  bool esc = false;
+
+  memset(&modem, 0, sizeof(modem));
+  fifo_init(&modem.rxFifo, modem.rxBuf, sizeof(modem.rxBuf));
+
+  for (size_t i = 0; i < a.size(); i += AFSK_BLOCK) {
+    size_t n = a.size() - i < AFSK_BLOCK ? a.size() - i : AFSK_BLOCK;
+
+    AFSK_adc_block(&modem, &a[i], n);
+    if (drain) {
+      rx_drain(frames, cur, esc);
+    }
+  }
+  rx_drain(frames, cur, esc);
+
+  /* a torn frame would show up as a merged one or as a tail */
+  CHECK(cur.empty());
+
+  return frames;
+}
+
+static bool fcs_good(const frame_t &f)
+{
+  uint16_t crc = CRC_CCIT_INIT_VAL;
+
+  for (size_t i = 0; i < f.size(); i++) {
+    crc = update_crc_ccit(f[i], crc);
+  }
+  return f.size() >= AX25_MIN_FRAME_LEN && crc == AX25_CRC_CORRECT;
+}
+
+static void print_frame(const frame_t &f)
+{
+  /* source>destination:info */
+  for (int i = 7; i < 13 && f[i] != (' ' << 1); i++) putchar(f[i] >> 1);
+  printf("-%d>", (f[13] >> 1) & 0xF);
+  for (int i = 0; i < 6 && f[i] != (' ' << 1); i++) putchar(f[i] >> 1);
+
+  size_t i = 14;
+  while (i < f.size() && !(f[i - 1] & 1)) i += 7;   /* digipeaters */
+  printf(":");
+  for (i += 2; i + 2 < f.size(); i++) {
+    putchar(f[i] >= ' ' && f[i] < 0x7F ? f[i] : '.');
+  }
+  printf("\n");
+}
+
+static unsigned demod_frames()
+{
+  unsigned n = 0;
+
+  for (int d = 0; d < AFSK_DEMODS; d++) {
+    n += modem.demod[d].frames;
+  }
+  return n;
+}
+
+static void self_check()
+{
+  std::vector<frame_t> sent;
+  tx_t tx;
+
+  memset(&tx, 0, sizeof(tx));
+  srand(1);
+  for (int n = 0; n < AFSK_FRAMES; n++) {
+    /* flat, de-emphasised and pre-emphasised audio, +/-0.5% clock */
+    static const double mark[]  = { 1.0, 1.0, 0.5 };
+    static const double space[] = { 1.0, 0.5, 1.0 };
+
+    tx.rate  = AFSK_RX_SAMPLERATE * (1 + ((n % 5) - 2) * 0.0025);
+    tx.mark  = mark[n % 3];
+    tx.space = space[n % 3];
+    tx.due   = tx.audio.size() * tx.rate / AFSK_RX_SAMPLERATE;
+
+    frame_t f = ax25_frame(n);
+    tx_frame(tx, f);
+    sent.push_back(f);
+  }
+
+  std::string path = "build/test_afsk.wav";
+  audio_t audio;
+
+  CHECK(wav_write(path.c_str(), tx.audio, AFSK_RX_SAMPLERATE));
+  CHECK(wav_read(path.c_str(), audio));
+  CHECK(audio.size() + 1 >= tx.audio.size());
+
+  /* drained after every block: every frame, once */
+  std::vector<frame_t> got = rx(audio, true);
+
+  printf("%zu of %d frames, %u duplicates dropped, first by demodulator:",
+         got.size(), AFSK_FRAMES, modem.corr.dups);
+  for (int d = 0; d < AFSK_DEMODS; d++) {
+    printf(" %u", modem.demod[d].frames);
+  }
+  printf("\n");
+
+  CHECK(got.size() == sent.size());
+  for (size_t i = 0; i < got.size() && i < sent.size(); i++) {
+    CHECK(got[i] == sent[i]);
+  }
+  CHECK(modem.corr.drops == 0);
+
+  /* never drained: whole frames up to the room of rxFifo, then drops */
+  got = rx(audio, false);
+
+  /* drops are of every demodulator that decoded a frame */
+  printf("undrained: %zu frames in rxFifo, %u dropped\n", got.size(), modem.corr.drops);
+
+  CHECK(got.size() > 0 && got.size() < sent.size());
+  CHECK(modem.corr.drops > 0);
+  CHECK(demod_frames() == got.size());
+  for (size_t i = 0; i < got.size(); i++) {
+    CHECK(fcs_good(got[i]));
+    CHECK(got[i] == sent[i]);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc > 1) {
+    audio_t audio;
+
+    if (!wav_read(argv[1], audio)) {
+      return 1;
+    }
+
+    std::vector<frame_t> got = rx(audio, true);
+
+    for (size_t i = 0; i < got.size(); i++) {
+      print_frame(got[i]);
+    }
+    printf("%zu frames, %u duplicates dropped\n", got.size(), modem.corr.dups);
+
+    return 0;
+  }
+
+  self_check();
+
+  return Host_report("test_afsk");
+}
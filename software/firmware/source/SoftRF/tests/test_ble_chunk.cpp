@@ -0,0 +1,253 @@
+/*
+ * test_ble_chunk.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Notifications of the BLE UART service against message boundaries.
+ *
+ * The link below is the Tx path of platform/bluetooth/NimBLE.cpp: write()
+ * takes a whole message or nothing, and every 10 ms one notification of
+ * up to a chunk goes out of the FIFO as Bluetooth_Chunk_Align() cuts it.
+ * NMEA and GDL90 streams are sent over a 20 byte (default ATT MTU) and
+ * a 244 byte chunk; a notification may end inside a message only when
+ * the message is longer than the chunk, and the stream that a client
+ * puts back together is the stream that was written.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <deque>
+#include <string>
+
+#include "../src/system/SoC.h"
+#include "../src/driver/Bluetooth.h"
+
+#include "host/Host.h"
+
+#define LINK_FIFO_SIZE    1024      /* BLE_FIFO_TX_SIZE */
+#define LINK_HOLD_MS      250       /* BLE_CHUNK_HOLD_MS */
+#define LINK_NOTIFY_MS    10
+
+typedef struct link_struct {
+  std::deque<uint8_t> fifo;
+  std::string         received;
+  size_t              chunk;
+  uint8_t             framing;
+  unsigned long       hold;
+  unsigned            notifications;
+  unsigned            torn;        /* notifications that end in a message */
+  unsigned            torn_short;  /* ... of less than a chunk */
+} link_t;
+
+static bool link_write(link_t &l, const std::string &msg)
+{
+  if (LINK_FIFO_SIZE - l.fifo.size() < msg.size()) {
+    return false;
+  }
+  l.fifo.insert(l.fifo.end(), msg.begin(), msg.end());
+  return true;
+}
+
+/* ESP32_Bluetooth_loop(), BLUETOOTH_LE_HM10_SERIAL */
+static void link_notify(link_t &l, bool (*boundary)(const std::string &))
+{
+  uint8_t chunk[256];
+  size_t avail = l.fifo.size() < l.chunk ? l.fifo.size() : l.chunk;
+
+  std::copy(l.fifo.begin(), l.fifo.begin() + avail, chunk);
+
+  size_t size = Bluetooth_Chunk_Align(chunk, avail, avail == l.chunk, l.framing);
+
+  if (size == 0 && avail > 0 && millis() - l.hold > LINK_HOLD_MS) {
+    size = avail;
+  }
+
+  if (size > 0) {
+    std::string n((const char *) chunk, size);
+
+    l.fifo.erase(l.fifo.begin(), l.fifo.begin() + size);
+    l.received += n;
+    l.notifications++;
+    if (!boundary(n)) {
+      l.torn++;
+      if (size < l.chunk) {
+        l.torn_short++;
+      }
+    }
+  }
+  if (size > 0 || avail == 0) {
+    l.hold = millis();
+  }
+
+  Host_advance_ms(LINK_NOTIFY_MS);
+}
+
+static bool nmea_boundary(const std::string &n)
+{
+  return n[n.size() - 1] == '\n';
+}
+
+static bool gdl90_boundary(const std::string &n)
+{
+  return n.size() > 1 && (uint8_t) n[n.size() - 1] == 0x7E &&
+         (uint8_t) n[n.size() - 2] != 0x7E;
+}
+
+static std::string nmea_sentence()
+{
+  static const char *talkers[] = { "GPGGA", "GPRMC", "PFLAU", "PFLAA" };
+  std::string s = "$";
+  char cs[8];
+
+  s += talkers[rand() % 4];
+  for (int len = 10 + rand() % 60; len > 0; len--) {
+    s += (char) (rand() % 3 ? '0' + rand() % 10 : ',');
+  }
+  snprintf(cs, sizeof(cs), "*%02X\r\n", rand() & 0xFF);
+
+  return s + cs;
+}
+
+/* random message with the bytes that need stuffing, and 0x0A */
+static std::string gdl90_frame()
+{
+  std::string f(1, (char) 0x7E);
+
+  for (int len = 3 + rand() % 40; len > 0; len--) {
+    uint8_t c;
+
+    switch (rand() % 8) {
+    case 0:  c = 0x0A; break;
+    case 1:  c = 0x7E; break;
+    case 2:  c = 0x7D; break;
+    default: c = rand(); break;
+    }
+    if (c == 0x7D || c == 0x7E) {
+      f += (char) 0x7D;
+      c ^= 0x20;
+    }
+    f += (char) c;
+  }
+
+  return f + (char) 0x7E;
+}
+
+static void check_stream(const char *name, uint8_t framing, size_t chunk,
+                         std::string (*message)(),
+                         bool (*boundary)(const std::string &))
+{
+  link_t l;
+  std::string sent;
+  size_t longest = 0;
+
+  l.chunk = chunk;
+  l.framing = framing;
+  l.hold = millis();
+  l.notifications = l.torn = l.torn_short = 0;
+
+  srand(1);
+  for (int i = 0; i < 2000; i++) {
+    /* a burst of messages, as NMEA_Export() or GDL90_Export() writes it */
+    for (int k = rand() % 6; k > 0; k--) {
+      std::string m = message();
+
+      if (link_write(l, m)) {
+        sent += m;
+        longest = m.size() > longest ? m.size() : longest;
+      }
+    }
+    link_notify(l, boundary);
+  }
+  while (!l.fifo.empty()) {
+    link_notify(l, boundary);
+  }
+
+  printf("%-6s chunk %3zu: %5u notifications, %4u end inside a message\n",
+         name, chunk, l.notifications, l.torn);
+
+  CHECK(l.received == sent);
+  CHECK(l.torn_short == 0);
+  if (longest <= chunk) {
+    CHECK(l.torn == 0);
+  }
+}
+
+/* a tail that the writer has not finished is held, for a while */
+static void check_hold()
+{
+  link_t l;
+  std::string s = nmea_sentence();
+
+  l.chunk = 244;
+  l.framing = BLUETOOTH_FRAMING_TEXT;
+  l.hold = millis();
+  l.notifications = l.torn = l.torn_short = 0;
+
+  link_write(l, s.substr(0, 20));
+  for (int i = 0; i < 5; i++) {
+    link_notify(l, nmea_boundary);
+  }
+  CHECK(l.notifications == 0);
+
+  link_write(l, s.substr(20));
+  link_notify(l, nmea_boundary);
+  CHECK(l.notifications == 1);
+  CHECK(l.received == s);
+  CHECK(l.torn == 0);
+
+  /* never finished */
+  l.received.clear();
+  link_write(l, s + s.substr(0, 20));
+  link_notify(l, nmea_boundary);
+  CHECK(l.received == s);
+  for (int i = 0; i < LINK_HOLD_MS / LINK_NOTIFY_MS + 1; i++) {
+    link_notify(l, nmea_boundary);
+  }
+  CHECK(l.received == s + s.substr(0, 20));
+  CHECK(l.fifo.empty());
+}
+
+static void check_align()
+{
+  const uint8_t text[] = "$GPGGA,1*00\r\n$GP";
+  const uint8_t gdl90[] = { 0x7E, 0x0A, 0x0A, 0x7E, 0x7E, 0x14, 0x0A };
+
+  CHECK(Bluetooth_Chunk_Align(text, 16, false, BLUETOOTH_FRAMING_TEXT) == 13);
+  CHECK(Bluetooth_Chunk_Align(text + 13, 3, false, BLUETOOTH_FRAMING_TEXT) == 0);
+  CHECK(Bluetooth_Chunk_Align(text + 13, 3, true, BLUETOOTH_FRAMING_TEXT) == 3);
+  CHECK(Bluetooth_Chunk_Align(text + 13, 3, false, BLUETOOTH_FRAMING_NONE) == 3);
+
+  /* 0x0A is data, the opening flag of the next frame is not a boundary */
+  CHECK(Bluetooth_Chunk_Align(gdl90, 7, false, BLUETOOTH_FRAMING_GDL90) == 4);
+  CHECK(Bluetooth_Chunk_Align(gdl90, 5, false, BLUETOOTH_FRAMING_GDL90) == 4);
+  CHECK(Bluetooth_Chunk_Align(gdl90, 3, false, BLUETOOTH_FRAMING_GDL90) == 0);
+  CHECK(Bluetooth_Chunk_Align(gdl90 + 4, 3, true, BLUETOOTH_FRAMING_GDL90) == 3);
+}
+
+int main()
+{
+  check_align();
+
+  check_stream("NMEA",  BLUETOOTH_FRAMING_TEXT,  20,  nmea_sentence, nmea_boundary);
+  check_stream("NMEA",  BLUETOOTH_FRAMING_TEXT,  244, nmea_sentence, nmea_boundary);
+  check_stream("GDL90", BLUETOOTH_FRAMING_GDL90, 20,  gdl90_frame,   gdl90_boundary);
+  check_stream("GDL90", BLUETOOTH_FRAMING_GDL90, 244, gdl90_frame,   gdl90_boundary);
+
+  check_hold();
+
+  return Host_report("test_ble_chunk");
+}
@@ -0,0 +1,308 @@
+/*
+ * test_codecs.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Golden vectors of the radio protocol codecs.
+ *
+ *   test_codecs                 - check
+ *   test_codecs --dump          - print the frames that the encoders make now
+ *   test_codecs --corpus <dir>  - write the frames as seeds of fuzz_codecs
+ *
+ * Every encoder must make the very frame below out of Codecs_tx,
+ * and the decoder must give back Codecs_tx within the resolution
+ * of the protocol. UAT978 and ES1090 have no encoder; their frames
+ * (host/Codecs.cpp) are checked against the values that DO-282 and
+ * "The 1090 MHz Riddle" (J. Sun) give.
+ */
+
+#include <math.h>
+#include <string.h>
+#include <string>
+
+#include "../src/system/SoC.h"
+#include "../src/driver/RF.h"
+#include "../src/driver/GNSS.h"
+
+#include "host/Host.h"
+#include "host/Codecs.h"
+
+typedef struct golden_struct {
+  const char *codec;
+  const char *hex;      /* frame, or text for APRS */
+  /* tolerances of the round trip */
+  float       pos;      /* degrees */
+  float       alt;      /* metres */
+  float       course;   /* degrees */
+  float       speed;    /* knots */
+  float       vs;       /* feet per minute, < 0 - not carried */
+} golden_t;
+
+static const golden_t golden[] = {
+  { "Legacy V6", "34123D20F87A415972F7A414A1C72AB2924BEB5FDFB22B98",
+    2e-5, 1, 2, 1.5, -1 },
+  { "Legacy V7", "34123D22000000331D69BCE76F2F4F9DBCAEC5A683C0C376",
+    2e-5, 1, 0.5, 0.5, 25 },
+  { "OGNTP",     "34123D0379BB4D3D5BDA7786368C8E94DC0976A38A11925F9A47",
+    2e-5, 1, 0.5, 0.5, 25 },
+  { "P3I",       "2434123DF2B008417A873D42E2047B000F05000036000116",
+    1e-6, 1, 1, 1, -1 },
+  { "FANET",     "410734123B63433B1306E2C4A8145700",
+    2e-5, 1, 1.5, 0.5, 25 },
+  { "ADS-L",     "0093F4897636014CE533F83C63FFEDA05713F16CAB9A790A",
+    1e-5, 1, 1, 0.5, 25 },
+  { "APRS",      "3D1234>OGFLR:/000000h4722.94N/00832.59E'123/054/A=004101 !W81! id073D1234 +394fpm +0.0rot",
+    2e-4, 1, 1, 1, -1 },
+};
+
+static const codec_t *codec_find(const char *name)
+{
+  for (int i = 0; i < Codecs_num; i++) {
+    if (strcmp(Codecs[i].name, name) == 0) {
+      return &Codecs[i];
+    }
+  }
+  return NULL;
+}
+
+static size_t unhex(const char *s, uint8_t *buf, size_t size)
+{
+  size_t n = 0;
+
+  while (s[0] && s[1] && n < size) {
+    unsigned v;
+
+    sscanf(s, "%2x", &v);
+    buf[n++] = v;
+    s += 2;
+  }
+
+  return n;
+}
+
+static void dump()
+{
+  for (int i = 0; i < Codecs_num; i++) {
+    const codec_t *c = &Codecs[i];
+    uint8_t frame[CODEC_FRAME_MAX];
+
+    if (c->encode == NULL) {
+      continue;
+    }
+
+    memset(frame, 0, sizeof(frame));
+    size_t size = c->encode(frame, &Codecs_tx);
+
+    printf("%-10s ", c->name);
+    if (c->protocol == RF_PROTOCOL_APRS) {
+      printf("\"%s\"\n", (char *) frame);
+      continue;
+    }
+    for (size_t k = 0; k < size; k++) {
+      printf("%02X", frame[k]);
+    }
+    printf("\n");
+  }
+}
+
+static int codec_index(const codec_t *c)
+{
+  return (int) (c - Codecs);
+}
+
+static size_t golden_frame(const golden_t *g, const codec_t *c, uint8_t *buf)
+{
+  if (c->protocol == RF_PROTOCOL_APRS) {
+    size_t size = strlen(g->hex) + 1;
+
+    memcpy(buf, g->hex, size);
+    return size;
+  }
+
+  return unhex(g->hex, buf, CODEC_FRAME_MAX);
+}
+
+static void check_golden(const golden_t *g)
+{
+  const codec_t *c = codec_find(g->codec);
+  uint8_t frame[CODEC_FRAME_MAX];
+  uint8_t gold[CODEC_FRAME_MAX];
+  size_t  gold_size;
+  ufo_t   fo;
+
+  CHECK(c != NULL);
+  if (c == NULL) {
+    return;
+  }
+
+  gold_size = golden_frame(g, c, gold);
+
+  /* encoder: bit exact */
+  memset(frame, 0, sizeof(frame));
+  size_t size = c->encode(frame, &Codecs_tx);
+
+  if (size != gold_size || memcmp(frame, gold, size) != 0) {
+    fprintf(stderr, "%s: encoder output differs from the golden frame\n", c->name);
+    Host_failures++;
+  }
+
+  /* decoder: the golden frame gives Codecs_tx back */
+  memset(&fo, 0, sizeof(fo));
+  memcpy(frame, gold, gold_size);
+  CHECK(c->decode(frame, &Codecs_rx, &fo));
+
+  printf("%-10s %06X %9.5f %9.5f %6.0f m %5.1f deg %5.1f kt %5.0f fpm\n",
+         c->name, fo.addr, fo.latitude, fo.longitude, fo.altitude,
+         fo.course, fo.speed, fo.vs);
+
+  CHECK(fo.protocol == c->protocol);
+  CHECK((fo.addr & 0xFFFF) == (Codecs_tx.addr & 0xFFFF));
+  CHECK_NEAR(fo.latitude,  Codecs_tx.latitude,  g->pos);
+  CHECK_NEAR(fo.longitude, Codecs_tx.longitude, g->pos);
+  CHECK_NEAR(fo.altitude,  Codecs_tx.altitude,  g->alt);
+  CHECK_NEAR(fo.course,    Codecs_tx.course,    g->course);
+  CHECK_NEAR(fo.speed,     Codecs_tx.speed,     g->speed);
+  if (g->vs >= 0) {
+    CHECK_NEAR(fo.vs,      Codecs_tx.vs,        g->vs);
+  }
+  CHECK(fo.aircraft_type == Codecs_tx.aircraft_type);
+}
+
+static void check_uat978()
+{
+  const codec_t *c = codec_find("UAT978");
+  uint8_t frame[UAT978_PAYLOAD_SIZE];
+  ufo_t fo;
+
+  Codecs_uat978(frame);
+
+  memset(&fo, 0, sizeof(fo));
+  Codecs_rx.pressure_altitude = 0;
+  CHECK(c->decode(frame, &Codecs_rx, &fo));
+
+  printf("%-10s %06X %9.5f %9.5f %6.0f m %5.1f deg %5.1f kt %5.0f fpm\n",
+         c->name, fo.addr, fo.latitude, fo.longitude, fo.pressure_altitude,
+         fo.course, fo.speed, fo.vs);
+
+  CHECK(fo.addr == 0xA1B2C3);
+  CHECK(fo.addr_type == ADDR_TYPE_ICAO);
+  CHECK_NEAR(fo.latitude,  40.0,   1e-4);
+  CHECK_NEAR(fo.longitude, -105.0, 1e-4);
+  CHECK_NEAR(fo.pressure_altitude, 5500 / _GPS_FEET_PER_METER, 0.1);
+  CHECK_NEAR(fo.course, 26, 0.1);         /* atan2(100, 50) */
+  CHECK_NEAR(fo.speed, 111, 0.1);         /* |(100, 50)|, truncated */
+  CHECK_NEAR(fo.vs, 640, 0.1);
+}
+
+static void check_es1090()
+{
+  const uint8_t (*frames)[ES1090_PAYLOAD_SIZE] = Codecs_es1090_frames;
+  ufo_t fo;
+
+  memset(&fo, 0, sizeof(fo));
+  CHECK(Codecs_es1090(frames[0], 1, &fo));
+  CHECK(fo.addr == 0x4840D6);
+  CHECK(memcmp(fo.callsign, "KLM1023 ", 8) == 0);
+
+  /* odd frame is the newer one */
+  memset(&fo, 0, sizeof(fo));
+  CHECK(Codecs_es1090(frames[1], 2, &fo));
+  printf("%-10s %06X %9.5f %9.5f %6.0f m\n", "ES1090",
+         fo.addr, fo.latitude, fo.longitude, fo.pressure_altitude);
+  CHECK(fo.addr == 0x40621D);
+  CHECK_NEAR(fo.latitude,  52.26578, 1e-4);
+  CHECK_NEAR(fo.longitude,  3.93891, 1e-4);
+  CHECK_NEAR(fo.pressure_altitude, 38000 / _GPS_FEET_PER_METER, 0.5);
+
+  memset(&fo, 0, sizeof(fo));
+  CHECK(Codecs_es1090(frames[3], 1, &fo));
+  printf("%-10s %06X %5.1f deg %5.1f kt\n", "ES1090", fo.addr, fo.course, fo.speed);
+  CHECK(fo.addr == 0x485020);
+  /* libmodes works in whole knots and degrees */
+  CHECK_NEAR(fo.course, 182.88, 1.5);
+  CHECK_NEAR(fo.speed, 159.20, 1.5);
+
+  /* damaged frame fails the CRC, beyond what libmodes can repair */
+  uint8_t bad[ES1090_PAYLOAD_SIZE];
+
+  memcpy(bad, frames[3], sizeof(bad));
+  bad[5] ^= 0x21;
+  bad[7] ^= 0x10;
+  bad[9] ^= 0x04;
+  CHECK(!Codecs_es1090(bad, 1, &fo));
+}
+
+/* seed: index of the codec in Codecs[], then the frame */
+static void seed(const char *dir, const codec_t *c, int n,
+                 const uint8_t *frame, size_t size)
+{
+  char name[64];
+
+  snprintf(name, sizeof(name), "/%02d-%d", codec_index(c), n);
+
+  FILE *f = fopen((std::string(dir) + name).c_str(), "wb");
+
+  if (f == NULL) {
+    perror(dir);
+    Host_failures++;
+    return;
+  }
+  fputc(codec_index(c), f);
+  fwrite(frame, 1, size, f);
+  fclose(f);
+}
+
+static void corpus(const char *dir)
+{
+  uint8_t frame[CODEC_FRAME_MAX];
+
+  for (size_t i = 0; i < sizeof(golden) / sizeof(golden[0]); i++) {
+    const codec_t *c = codec_find(golden[i].codec);
+
+    seed(dir, c, 0, frame, golden_frame(&golden[i], c, frame));
+  }
+
+  Codecs_uat978(frame);
+  seed(dir, codec_find("UAT978"), 0, frame, UAT978_PAYLOAD_SIZE);
+
+  for (int i = 0; i < CODECS_ES1090_FRAMES; i++) {
+    seed(dir, codec_find("ES1090"), i, Codecs_es1090_frames[i], ES1090_PAYLOAD_SIZE);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Codecs_setup();
+
+  if (argc > 1 && strcmp(argv[1], "--dump") == 0) {
+    dump();
+    return 0;
+  }
+
+  if (argc > 2 && strcmp(argv[1], "--corpus") == 0) {
+    corpus(argv[2]);
+    return Host_failures ? 1 : 0;
+  }
+
+  for (size_t i = 0; i < sizeof(golden) / sizeof(golden[0]); i++) {
+    check_golden(&golden[i]);
+  }
+  check_uat978();
+  check_es1090();
+
+  return Host_report("test_codecs");
+}
@@ -0,0 +1,281 @@
+/*
+ * test_netout.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Load test of the network output server (system/NetOutput), on loopback.
+ *
+ * More TCP clients connect than there are slots; most of them read all
+ * the time, a few never read. Every export cycle writes a burst of NMEA
+ * sentences, and the main loop pass of RPi.cpp (NetOutput_poll(), then
+ * NetOutput_flush()) follows. Checked are:
+ *
+ *  - clients beyond NETOUT_MAX_CLIENTS are refused,
+ *  - a reader gets the very byte stream that was written,
+ *  - a client that does not read is disconnected, and a slot that
+ *    frees up is taken by the next client,
+ *  - a cycle leaves in one sendmmsg() call per NETOUT_MAX_DGRAMS
+ *    datagrams, and no cycle blocks on a socket.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "../src/system/SoC.h"
+#include "../src/system/NetOutput.h"
+
+#include "host/Host.h"
+
+#define LOAD_CYCLES       3000
+#define LOAD_SENTENCES    40        /* per cycle */
+#define LOAD_READERS      12
+#define LOAD_STALLED      4
+#define LOAD_EXTRA        8         /* beyond NETOUT_MAX_CLIENTS */
+
+typedef struct client_struct {
+  int         fd;
+  bool        reads;
+  size_t      from;       /* offset into the stream when it was accepted */
+  std::string got;
+  bool        closed;     /* by the server */
+} client_t;
+
+static netout_t    server;
+static std::string stream;  /* all that was written */
+
+static int client_connect(int port, bool reads)
+{
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+
+  if (!reads) {
+    int size = 4096;
+
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port        = htons(port);
+
+  fcntl(fd, F_SETFL, O_NONBLOCK);
+  connect(fd, (struct sockaddr *) &addr, sizeof(addr));
+
+  return fd;
+}
+
+static void client_read(client_t &c)
+{
+  char buf[65536];
+
+  while (!c.closed) {
+    ssize_t n = recv(c.fd, buf, sizeof(buf), MSG_DONTWAIT);
+
+    if (n > 0) {
+      c.got.append(buf, n);
+    } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      break;
+    } else if (n < 0 && errno == EINTR) {
+      continue;
+    } else {
+      c.closed = true;
+    }
+  }
+}
+
+static int udp_receiver(int port)
+{
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  int size = 4 << 20;
+  struct sockaddr_in addr;
+
+  setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family      = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port        = htons(port);
+
+  if (bind(fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+    perror("UDP receiver");
+    close(fd);
+    return -1;
+  }
+
+  return fd;
+}
+
+static unsigned udp_read(int fd)
+{
+  char buf[2048];
+  unsigned n = 0;
+
+  while (fd >= 0 && recv(fd, buf, sizeof(buf), MSG_DONTWAIT) > 0) {
+    n++;
+  }
+  return n;
+}
+
+/* main loop pass of RPi.cpp */
+static void loop_pass()
+{
+  NetOutput_poll(&server, 0);
+  NetOutput_flush(&server);
+}
+
+static void export_cycle(unsigned cycle)
+{
+  for (int i = 0; i < LOAD_SENTENCES; i++) {
+    char s[96];
+    int len = snprintf(s, sizeof(s),
+                       "$PFLAA,0,%d,%d,%u,2,3D1234,123,,54,0.0,1*%02X\r\n",
+                       i * 37 - 700, 1200 - i * 29, cycle, (cycle + i) & 0xFF);
+
+    NetOutput_write(&server, (const uint8_t *) s, len);
+    stream.append(s, len);
+  }
+}
+
+int main()
+{
+  int port = 30000 + getpid() % 20000;
+  std::vector<client_t> clients;
+
+  NetOutput_init(&server);
+  CHECK(NetOutput_begin(&server, port, port));
+  server.dst_addr = htonl(INADDR_LOOPBACK);
+
+  int udp = udp_receiver(port);
+  CHECK(udp >= 0);
+
+  /* readers, then clients that never read, then more than there are slots */
+  for (int i = 0; i < NETOUT_MAX_CLIENTS + LOAD_EXTRA; i++) {
+    client_t c;
+
+    c.reads  = i < LOAD_READERS || i >= LOAD_READERS + LOAD_STALLED;
+    c.fd     = client_connect(port, c.reads);
+    c.from   = 0;
+    c.closed = false;
+    clients.push_back(c);
+
+    NetOutput_poll(&server, 100);
+  }
+
+  printf("%d clients: %u accepted, %u refused\n", (int) clients.size(),
+         server.stats.accepted, server.stats.rejected);
+  CHECK(server.stats.accepted == NETOUT_MAX_CLIENTS);
+  CHECK(server.stats.rejected == LOAD_EXTRA);
+
+  uint64_t worst = 0;
+  unsigned udp_got = 0;
+  client_t late;
+
+  late.fd = -1;
+
+  for (unsigned cycle = 0; cycle < LOAD_CYCLES; cycle++) {
+    uint64_t start = Host_wall_ns();
+
+    export_cycle(cycle);
+    loop_pass();
+
+    uint64_t ns = Host_wall_ns() - start;
+    worst = ns > worst ? ns : worst;
+
+    for (size_t i = 0; i < clients.size(); i++) {
+      if (clients[i].reads) {
+        client_read(clients[i]);
+      }
+    }
+    udp_got += udp_read(udp);
+
+    /* once the stalled clients are gone, their slots take new clients */
+    if (late.fd < 0 && server.stats.dropped == LOAD_STALLED) {
+      late.fd     = client_connect(port, true);
+      late.reads  = true;
+      late.closed = false;
+      late.from   = stream.size();
+      NetOutput_poll(&server, 100);
+    }
+    if (late.fd >= 0) {
+      client_read(late);
+    }
+  }
+
+  /* the rest of TCP backlogs */
+  for (int i = 0; i < 100; i++) {
+    NetOutput_poll(&server, 10);
+    for (size_t k = 0; k < clients.size(); k++) {
+      if (clients[k].reads) {
+        client_read(clients[k]);
+      }
+    }
+    client_read(late);
+  }
+  udp_got += udp_read(udp);
+
+  unsigned complete = 0, refused = 0;
+
+  for (size_t i = 0; i < clients.size(); i++) {
+    client_t &c = clients[i];
+
+    if (i < LOAD_READERS) {
+      complete += c.got == stream && !c.closed;
+    } else if (c.reads) {
+      refused += c.closed && c.got.empty();
+    }
+  }
+
+  printf("%u readers got all %zu bytes, %u slow clients dropped, "
+         "%u refused clients closed\n",
+         complete, stream.size(), server.stats.dropped, refused);
+  printf("%u datagrams in %u sendmmsg() calls, %u lost, %u received; "
+         "worst cycle %.2f ms\n",
+         server.stats.datagrams, server.stats.batches, server.stats.lost,
+         udp_got, worst / 1e6);
+
+  CHECK(complete == LOAD_READERS);
+  CHECK(refused == LOAD_EXTRA);
+  CHECK(server.stats.dropped == LOAD_STALLED);
+  CHECK(server.clients == LOAD_READERS + 1);
+
+  /* the late client joins on a message boundary, and gets all from there */
+  CHECK(late.fd >= 0);
+  CHECK(late.got.size() > 0 && late.got == stream.substr(late.from));
+
+  /* every cycle of 40 datagrams is one batch */
+  CHECK(server.stats.datagrams + server.stats.lost == LOAD_CYCLES * LOAD_SENTENCES);
+  CHECK(server.stats.batches == LOAD_CYCLES);
+  CHECK(udp_got == server.stats.datagrams);
+
+  /* no socket call blocks: a cycle is far below the export period */
+  CHECK(worst < 100000000ULL);
+
+  NetOutput_end(&server);
+  CHECK(server.clients == 0);
+
+  return Host_report("test_netout");
+}
@@ -0,0 +1,334 @@
+/*
+ * test_ntp.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * NTP time acquisition of system/Time.cpp against a local UDP stand-in
+ * of the four pool servers, on 127.0.0.1 to 127.0.0.4.
+ *
+ * The NTP part of Time.cpp is for the Wi-Fi platforms and RPi.h takes
+ * it out, so Time.cpp is built into this test with WiFi and WiFiUDP
+ * of host/HostWiFi.h instead. The main loop is a Time_loop() pass
+ * every 10 ms of the fake clock; a name lookup comes back by lwIP
+ * after HostWiFi_lookup_ms of it, between passes. No pass may take
+ * more than TEST_PASS_MAX_MS, of either clock. Every server of the stand-in has a clock of
+ * its own (TEST_EPOCH + 1000 s * server number), so the time that is
+ * set tells which reply was taken.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "../src/system/SoC.h"
+
+#include "host/Host.h"
+#include "host/HostWiFi.h"
+
+#undef EXCLUDE_WIFI
+#include "../src/system/Time.cpp"
+
+#define TEST_EPOCH      1774269319UL  /* 2026-03-23 12:35:19 UTC */
+#define TEST_PASS_MS    10
+#define TEST_PASS_MAX_MS 2
+#define TEST_DNS_TIMEOUT 5000          /* ms, lwIP without an upstream */
+
+/* what Time.cpp takes from the rest of the firmware */
+TinyGPSPlus gnss;
+const gnss_chip_ops_t *gnss_chip = NULL;
+unsigned long GNSSTimeSyncMarker = 0;
+volatile unsigned long PPS_TimeMarker_us = 0;
+
+static long Test_random(long howsmall, long howbig)
+{
+  return howsmall + rand() % (howbig - howsmall);
+}
+
+static SoC_ops_t Test_SoC = { SOC_RPi, "Host" };
+const SoC_ops_t *SoC = &Test_SoC;
+
+enum
+{
+  SERVER_SILENT,
+  SERVER_ANSWER,
+  SERVER_FORGED,      /* origin timestamp is not the one of the request */
+  SERVER_UNSYNC,      /* leap indicator 3, stratum 0 */
+  SERVER_ELSEWHERE,   /* right reply, but from the address of another one */
+  SERVER_NO_NAME      /* name lookup fails */
+};
+
+static int      Standin_fd[NTP_SERVERS];
+static uint8_t  Standin_mode[NTP_SERVERS];
+static unsigned Standin_requests;
+
+static void standin_setup()
+{
+  struct sockaddr_in sa;
+  socklen_t sa_len = sizeof(sa);
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sin_family = AF_INET;
+
+  for (int i = 0; i < NTP_SERVERS; i++) {
+    Standin_fd[i] = socket(AF_INET, SOCK_DGRAM, 0);
+    fcntl(Standin_fd[i], F_SETFL, O_NONBLOCK);
+
+    /* one port for all, as the firmware has one */
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK + i);
+    CHECK(bind(Standin_fd[i], (struct sockaddr *) &sa, sizeof(sa)) == 0);
+    if (i == 0) {
+      getsockname(Standin_fd[i], (struct sockaddr *) &sa, &sa_len);
+    }
+  }
+
+  HostWiFi_port_from = NTP_PORT;
+  HostWiFi_port_to   = ntohs(sa.sin_port);
+}
+
+static void standin_reply(int i, uint8_t *pkt, struct sockaddr_in *client)
+{
+  uint32_t tx_sec = TEST_EPOCH + NTP_UNIX_OFFSET + i * 1000;
+  int fd = Standin_fd[i];
+
+  /* origin is the transmit timestamp of the request */
+  memcpy(&pkt[24], &pkt[40], 8);
+  memset(&pkt[40], 0, 8);
+  pkt[0]  = 0 << 6 | 4 << 3 | 4;  /* no leap, version 4, server */
+  pkt[1]  = 2;
+  pkt[40] = tx_sec >> 24;
+  pkt[41] = tx_sec >> 16;
+  pkt[42] = tx_sec >>  8;
+  pkt[43] = tx_sec;
+
+  switch (Standin_mode[i])
+  {
+  case SERVER_FORGED:
+    pkt[31] ^= 1;
+    break;
+  case SERVER_UNSYNC:
+    pkt[0] |= 3 << 6;
+    pkt[1]  = 0;
+    break;
+  case SERVER_ELSEWHERE:
+    fd = Standin_fd[(i + 1) % NTP_SERVERS];
+    break;
+  default:
+    break;
+  }
+
+  sendto(fd, pkt, NTP_PACKET_SIZE, 0, (struct sockaddr *) client,
+         sizeof(*client));
+}
+
+static void standin_poll()
+{
+  for (int i = 0; i < NTP_SERVERS; i++) {
+    struct sockaddr_in client;
+    socklen_t client_len = sizeof(client);
+    uint8_t pkt[NTP_PACKET_SIZE];
+
+    while (recvfrom(Standin_fd[i], pkt, sizeof(pkt), 0,
+                    (struct sockaddr *) &client, &client_len) == sizeof(pkt)) {
+      Standin_requests++;
+      if (Standin_mode[i] != SERVER_SILENT) {
+        standin_reply(i, pkt, &client);
+      }
+    }
+  }
+}
+
+static void standin_modes(uint8_t m0, uint8_t m1, uint8_t m2, uint8_t m3)
+{
+  uint8_t modes[NTP_SERVERS] = { m0, m1, m2, m3 };
+
+  HostWiFi_hosts_clear();
+
+  for (int i = 0; i < NTP_SERVERS; i++) {
+    String name = String(i) + ntpServerName_suffix;
+
+    Standin_mode[i] = modes[i];
+    HostWiFi_host(name.c_str(), modes[i] == SERVER_NO_NAME ?
+                                0 : INADDR_LOOPBACK + i);
+  }
+}
+
+typedef struct result_struct {
+  unsigned long longest_ms;   /* of a Time_loop() pass */
+} result_t;
+
+/* power up, with Wi-Fi up */
+static void boot()
+{
+  NTP_udp.stop();
+  memset(NTP_request, 0, sizeof(NTP_request));
+  NTP_state          = NTP_IDLE;
+  Time_source        = TIME_SOURCE_NONE;
+  Time_valid_ms      = 0;
+  GNSSTimeSyncMarker = 0;
+  Standin_requests   = 0;
+
+  Host_time_us = 0;
+  setTime(0);
+
+  Time_setup();
+}
+
+/* the main loop, until NTP is done or for 'ms' */
+static void run(unsigned long ms, unsigned long gnss_ms, result_t *r)
+{
+  unsigned long start = millis();
+
+  while (millis() - start < ms && NTP_state != NTP_DONE) {
+    uint64_t pass = Host_time_us;
+    uint64_t wall = Host_wall_ns();
+
+    Time_loop();
+
+    unsigned long pass_ms = (Host_time_us - pass) / 1000;
+    unsigned long wall_ms = (Host_wall_ns() - wall) / 1000000;
+
+    if (pass_ms > r->longest_ms) {
+      r->longest_ms = pass_ms;
+    }
+    if (wall_ms > r->longest_ms) {
+      r->longest_ms = wall_ms;
+    }
+
+    HostWiFi_poll();
+    standin_poll();
+
+    if (gnss_ms && GNSSTimeSyncMarker == 0 && millis() >= gnss_ms) {
+      GNSSTimeSyncMarker = millis();
+    }
+
+    Host_advance_ms(TEST_PASS_MS);
+  }
+}
+
+static void report(const char *name, const result_t *r)
+{
+  static const char *source[] = { "none", "NTP", "GNSS" };
+
+  printf("%-26s %6s %10lu %10lu %9u\n", name, source[Time_source],
+         (unsigned long) Time_valid_ms, r->longest_ms, Standin_requests);
+}
+
+/* every server answers, the first reply sets the clock */
+static void check_all()
+{
+  result_t r = { 0 };
+
+  HostWiFi_lookup_ms = 20;
+  standin_modes(SERVER_ANSWER, SERVER_ANSWER, SERVER_ANSWER, SERVER_ANSWER);
+  boot();
+  run(10000, 0, &r);
+  report("all answer", &r);
+
+  CHECK(r.longest_ms <= TEST_PASS_MAX_MS);
+  CHECK(Time_source == TIME_SOURCE_NTP);
+  CHECK(Time_valid_ms < 100);
+  CHECK_NEAR(now(), TEST_EPOCH, 1);
+}
+
+/*
+ * replies that must not be taken, in front of the one that is right;
+ * the names are in the cache of lwIP
+ */
+static void check_bad_replies()
+{
+  result_t r = { 0 };
+
+  HostWiFi_lookup_ms = 0;
+  standin_modes(SERVER_FORGED, SERVER_UNSYNC, SERVER_ELSEWHERE, SERVER_ANSWER);
+  boot();
+  run(10000, 0, &r);
+  report("bad replies, last answers", &r);
+
+  CHECK(r.longest_ms <= TEST_PASS_MAX_MS);
+  CHECK(Time_source == TIME_SOURCE_NTP);
+  CHECK(Standin_requests == NTP_SERVERS);
+  CHECK_NEAR(now(), TEST_EPOCH + 3000, 1);
+}
+
+/* the airfield: Wi-Fi up, no internet, then it comes up */
+static void check_no_internet()
+{
+  result_t r = { 0 };
+
+  HostWiFi_lookup_ms = TEST_DNS_TIMEOUT;
+  standin_modes(SERVER_NO_NAME, SERVER_NO_NAME, SERVER_NO_NAME, SERVER_NO_NAME);
+  boot();
+  run(10000, 0, &r);
+  report("no internet", &r);
+
+  /* the main loop goes on while the names time out */
+  CHECK(r.longest_ms <= TEST_PASS_MAX_MS);
+  CHECK(Time_source == TIME_SOURCE_NONE);
+  CHECK(NTP_state == NTP_BACKOFF);
+  CHECK(Standin_requests == 0);
+
+  standin_modes(SERVER_SILENT, SERVER_ANSWER, SERVER_NO_NAME, SERVER_SILENT);
+  run(NTP_RETRY + 10000, 0, &r);
+  report("  internet after 10 s", &r);
+
+  CHECK(r.longest_ms <= TEST_PASS_MAX_MS);
+  CHECK(Time_source == TIME_SOURCE_NTP);
+  /* by the round after NTP_RETRY, not before */
+  CHECK(Time_valid_ms > NTP_RETRY);
+  CHECK(Time_valid_ms < NTP_RETRY + 10000 + TEST_DNS_TIMEOUT);
+  CHECK_NEAR(now(), TEST_EPOCH + 1000, 1);
+}
+
+/* GNSS time comes in before any reply does, NTP gives way */
+static void check_gnss_first()
+{
+  result_t r = { 0 };
+
+  HostWiFi_lookup_ms = 1000;
+  standin_modes(SERVER_SILENT, SERVER_SILENT, SERVER_SILENT, SERVER_ANSWER);
+  boot();
+  run(10000, 500, &r);
+  report("GNSS first", &r);
+
+  CHECK(r.longest_ms <= TEST_PASS_MAX_MS);
+  CHECK(Time_source == TIME_SOURCE_GNSS);
+  CHECK(Time_valid_ms == GNSSTimeSyncMarker);
+  CHECK(NTP_state == NTP_DONE);
+  /* NTP has not touched the clock */
+  CHECK(now() < 1000);
+}
+
+int main()
+{
+  Test_SoC.random = Test_random;
+
+  standin_setup();
+
+  printf("%-26s %6s %10s %10s %9s\n", "case", "source", "valid ms",
+         "pass ms", "requests");
+
+  check_all();
+  check_bad_replies();
+  check_no_internet();
+  check_gnss_first();
+
+  return Host_report("test_ntp");
+}
@@ -0,0 +1,222 @@
+/*
+ * test_ownship.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Radio part of a pass against one view of ownship.
+ *
+ * GNSS_Ownship_View() must carry the time base of the slots along with
+ * the position, that of the time PLL too, which runs on the side of
+ * 'gnss'. ParseData(), Traffic_loop() and ClearExpired() must
+ * work from the view they are handed. ThisAircraft is put far away,
+ * 10 km high and a day ahead here, as the UI side may leave it in
+ * the middle of an update: nothing of it may show in the results.
+ */
+
+#include <string.h>
+
+#include "../src/system/SoC.h"
+#include "../src/system/Time.h"
+#include "../src/driver/RF.h"
+#include "../src/driver/GNSS.h"
+#include "../src/driver/EEPROM.h"
+#include "../src/TrafficHelper.h"
+
+#include "host/Host.h"
+#include "host/Codecs.h"
+
+/* what TrafficHelper.cpp and GNSS.cpp take from the rest of the firmware */
+ufo_t ThisAircraft;
+byte TxBuffer[MAX_PKT_SIZE], RxBuffer[MAX_PKT_SIZE];
+bool (*protocol_decode)(void *, ufo_t *, ufo_t *);
+uint8_t RF_rx_protocol;
+uint8_t RF_rx_size;
+int8_t RF_last_rssi;
+uint32_t rx_packets_counter;
+RF_rx_stats_t RF_Rx_Stats[RF_RX_PROTOCOLS_MAX];
+
+static SoC_ops_t Test_SoC = { SOC_RPi, "Host" };
+const SoC_ops_t *SoC = &Test_SoC;
+
+static unsigned long Test_get_PPS_TimeMarker()
+{
+  return 0;
+}
+
+void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl) {}
+void NMEA_GGA() {}
+
+bool Sound_Notify()
+{
+  return false;
+}
+
+String Bin2Hex(byte *buffer, size_t size)
+{
+  return String("");
+}
+
+static const char rmc[] =
+  "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230326,003.1,W*63\r\n";
+
+static void check_view()
+{
+  ownship_view_t view;
+
+  Host_advance_ms(5000);
+  unsigned long fix_ms = millis();
+
+  for (const char *c = rmc; *c; c++) {
+    gnss.encode(*c);
+  }
+
+  /* the radio task takes the view a while after the sentence */
+  Host_advance_ms(340);
+
+  ThisAircraft          = Codecs_rx;
+  ThisAircraft.altitude = 1234;
+  GNSS_Ownship_View(&view, &ThisAircraft, true);
+
+  CHECK(view.valid);
+  CHECK(view.fix_time == 1774269319); /* 2026-03-23 12:35:19 UTC */
+  CHECK(view.time_ms  == fix_ms);
+  CHECK(view.date_ms  == fix_ms);
+  CHECK(memcmp(&view.fo, &ThisAircraft, sizeof(ufo_t)) == 0);
+
+  /* a later update of ThisAircraft does not reach a view taken before */
+  ThisAircraft.altitude = 5678;
+  CHECK(view.fo.altitude == 1234);
+
+  /* RMC second began 100 ms before the sentence, 340 ms ago */
+  CHECK(view.pll_locked);
+  CHECK_NEAR(Time_PLL_view_us(&view, micros()) / 1000,
+             1774269319000ULL + 100 + 340, 1);
+
+  /* nor does a later change of the PLL */
+  Time_PLL.state = TIME_PLL_UNLOCKED;
+  CHECK(view.pll_locked);
+
+  GNSS_Ownship_View(&view, &ThisAircraft, false);
+  CHECK(!view.valid);
+}
+
+/* what the UI side may leave in ThisAircraft at any moment */
+static void scramble()
+{
+  ThisAircraft.latitude  = -33.0;
+  ThisAircraft.longitude = 151.0;
+  ThisAircraft.altitude  = 10000;
+  ThisAircraft.timestamp = Codecs_rx.timestamp + 86400;
+}
+
+static const codec_t *codec_find(const char *name)
+{
+  for (int i = 0; i < Codecs_num; i++) {
+    if (strcmp(Codecs[i].name, name) == 0) {
+      return &Codecs[i];
+    }
+  }
+  return NULL;
+}
+
+static ufo_t *entry()
+{
+  for (int i = 0; i < MAX_TRACKING_OBJECTS; i++) {
+    if (Container[i].addr) {
+      return &Container[i];
+    }
+  }
+  return NULL;
+}
+
+static void check_traffic()
+{
+  const codec_t *c = codec_find("Legacy V6");
+  ownship_view_t view;
+  uint8_t frame[CODEC_FRAME_MAX];
+  size_t size = Codecs_frame(c, frame);
+
+  view.fo    = Codecs_rx;
+  view.valid = true;
+
+  memset(Container, 0, sizeof(Container));
+  settings->alarm = TRAFFIC_ALARM_DISTANCE;
+  Traffic_setup();
+
+  /* RF_Rx_Select() */
+  protocol_decode = c->decode;
+  RF_rx_protocol  = c->protocol;
+  RF_rx_size      = c->size;
+
+  scramble();
+  memcpy(RxBuffer, frame, size);
+  ParseData(&view.fo);
+
+  /* Legacy V6 is keyed by the time of the receiver, and so of the view */
+  ufo_t *fop = entry();
+  CHECK(fop != NULL);
+  if (fop == NULL) {
+    return;
+  }
+
+  float distance = gnss.distanceBetween(Codecs_rx.latitude, Codecs_rx.longitude,
+                                        Codecs_tx.latitude, Codecs_tx.longitude);
+
+  CHECK((fop->addr & 0xFFFF) == (Codecs_tx.addr & 0xFFFF));
+  CHECK_NEAR(fop->distance, distance, 50);
+  CHECK_NEAR(fop->altitude, Codecs_tx.altitude, 1);
+  /* 350 m below, 2 km away */
+  CHECK(fop->alarm_level == ALARM_LEVEL_NONE);
+
+  time_t seen = fop->timestamp;
+
+  /* ownship moves next to the traffic, the alarm follows the view */
+  view.fo.latitude  = Codecs_tx.latitude + 0.001;
+  view.fo.longitude = Codecs_tx.longitude;
+  view.fo.altitude  = Codecs_tx.altitude;
+  view.fo.timestamp = seen + TRAFFIC_VECTOR_UPDATE_INTERVAL;
+
+  Host_advance_ms(TRAFFIC_UPDATE_INTERVAL_MS + 1);
+  scramble();
+  Traffic_loop(&view.fo);
+
+  CHECK_NEAR(fop->distance, 111, 5);
+  CHECK(fop->alarm_level == ALARM_LEVEL_URGENT);
+
+  /* expiry goes by the time of the view */
+  view.fo.timestamp = seen + ENTRY_EXPIRATION_TIME;
+  scramble();
+  ClearExpired(&view.fo);
+  CHECK(entry() != NULL);
+
+  view.fo.timestamp = seen + ENTRY_EXPIRATION_TIME + 1;
+  ThisAircraft.timestamp = seen;
+  ClearExpired(&view.fo);
+  CHECK(entry() == NULL);
+}
+
+int main()
+{
+  Test_SoC.get_PPS_TimeMarker = Test_get_PPS_TimeMarker;
+
+  Codecs_setup();
+
+  check_view();
+  check_traffic();
+
+  return Host_report("test_ownship");
+}
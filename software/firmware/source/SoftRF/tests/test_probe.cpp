@@ -0,0 +1,129 @@
+/*
+ * test_probe.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * GNSS_setup() of driver/GNSS.cpp with the hardware probe cache of
+ * EEPROM.h (ENABLE_PROBE_CACHE), and the time that it takes.
+ *
+ * Serial1 is on the wire (see host/HostSerial.h): the probes wait for
+ * their answers as long as they would on a real port, by the fake clock.
+ * The module is a plain NMEA talker at SERIAL_IN_BR that keeps the wire
+ * busy, or no module at all. The chain of the Raspberry Pi build is
+ * generic NMEA, then u-blox and MTK. With a plain NMEA module of last
+ * boot in the cache only the first runs; a chip of last boot is probed
+ * right after it and not again later in the chain.
+ */
+
+#include "../src/system/SoC.h"
+#include "../src/driver/GNSS.h"
+#include "../src/driver/EEPROM.h"
+
+#include "host/Host.h"
+#include "host/HostSerial.h"
+
+/* what GNSS.cpp takes from the rest of the firmware */
+eeprom_t eeprom_block;
+settings_t *settings = &eeprom_block.field.settings;
+probe_cache_t *probe_cache = &eeprom_block.field.probe;
+hardware_info_t hw_info = { .model = SOFTRF_MODEL_RASPBERRY };
+
+static SoC_ops_t Test_SoC = { SOC_RPi, "Host" };
+const SoC_ops_t *SoC = &Test_SoC;
+
+void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl) {}
+void NMEA_GGA() {}
+
+static void Test_swSer_begin(unsigned long baud)
+{
+  Serial1.begin(baud);
+}
+
+static const char burst[] =
+  "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+  "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230326,003.1,W*63\r\n";
+
+#define TALKER_SECONDS  30
+
+static void talker_on()
+{
+  /* a byte per character time, more than every case below takes */
+  for (int i = 0; i < TALKER_SECONDS * SERIAL_IN_BR / 10; i += sizeof(burst) - 1) {
+    HostSerial_feed(Serial1, burst, sizeof(burst) - 1);
+  }
+}
+
+static const struct {
+  const char *name;
+  bool        talker;   /* NMEA on the port */
+  uint8_t     cached;   /* probe_cache->gnss of last boot */
+  uint8_t     found;
+} cases[] = {
+  { "no module, empty cache",   false, GNSS_MODULE_NONE, GNSS_MODULE_NONE },
+  { "no module, NMEA cached",   false, GNSS_MODULE_NMEA, GNSS_MODULE_NONE },
+  { "NMEA, empty cache",        true,  GNSS_MODULE_NONE, GNSS_MODULE_NMEA },
+  { "NMEA, NMEA cached",        true,  GNSS_MODULE_NMEA, GNSS_MODULE_NMEA },
+  { "NMEA, u-blox M8 cached",   true,  GNSS_MODULE_U8,   GNSS_MODULE_NMEA },
+  { "NMEA, Sony cached",        true,  GNSS_MODULE_SONY, GNSS_MODULE_NMEA },
+};
+
+#define CASES (sizeof(cases) / sizeof(cases[0]))
+
+static uint32_t probe_ms(size_t c, byte *found)
+{
+  uint64_t start = Host_time_us;
+
+  probe_cache->gnss = cases[c].cached;
+  *found = GNSS_setup();
+
+  return (uint32_t) ((Host_time_us - start) / 1000);
+}
+
+int main()
+{
+  uint32_t ms[CASES];
+
+  Test_SoC.swSer_begin = Test_swSer_begin;
+  HostSerial_wire(Serial1, true);
+
+  printf("%-26s %6s %8s\n", "case", "found", "ms");
+
+  for (size_t c = 0; c < CASES; c++) {
+    byte found;
+
+    if (cases[c].talker && (c == 0 || !cases[c - 1].talker)) {
+      talker_on();
+    }
+
+    ms[c] = probe_ms(c, &found);
+    printf("%-26s %6d %8u\n", cases[c].name, found, ms[c]);
+
+    CHECK(found == cases[c].found);
+  }
+
+  /* the module of last boot answers its own probe within two sentences */
+  CHECK(ms[3] < 250);
+  /* u-blox and MTK wait 2 s each for an answer of a plain NMEA module */
+  CHECK(ms[2] >= 4000);
+  /* a stale record boots no slower than an empty cache */
+  CHECK(ms[1] <= ms[0]);
+  CHECK(ms[4] <= ms[2]);
+  /* and so does one of a module that this build has no driver for */
+  CHECK(ms[5] <= ms[2]);
+
+  return Host_report("test_probe");
+}
@@ -0,0 +1,183 @@
+/*
+ * test_radar.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Bytes that the radar view of SkyWatch (View_Radar_TFT.cpp) pushes to
+ * the screen per frame, incremental against full redraws.
+ *
+ * The view is built into this test with TFT_eSPI of host/skywatch, which
+ * counts what goes over the bus, and checks the radar_stats of the view
+ * against that count. Targets of the traffic table move every frame;
+ * the full redraws are forced by invalidating the layer before each one,
+ * as every frame was drawn before the layer was kept.
+ */
+
+#include <raspi/raspi.h>
+
+#include "host/Host.h"
+
+#define MAX_TRACKING_OBJECTS  9   /* of the SkyWatch platforms */
+
+#include "../../SkyWatch/View_Radar_TFT.cpp"
+
+#define TEST_W          240
+#define TEST_H          240
+#define TEST_FRAMES     60
+#define TEST_TARGETS    4
+#define TEST_HEAP       100000
+
+/* what the view takes from the rest of SkyWatch */
+static settings_t Test_settings;
+settings_t *settings = &Test_settings;
+traffic_t ThisAircraft, Container[MAX_TRACKING_OBJECTS];
+TinyGPSPlus nmea;
+bool TFT_vmode_updated = false;
+TFT_eSPI *tft = NULL;
+TFT_eSprite *sprite = NULL;
+uint32_t HostTFT_bytes = 0;
+
+bool NMEA_isConnected()  { return true; }
+bool GDL90_isConnected() { return false; }
+bool GDL90_hasOwnShip()  { return false; }
+void TFT_Clear_Screen()  { tft->fillScreen(TFT_NAVY); }
+void TFT_Message(const char *, const char *) {}
+
+bool TFT_Layer_ready()
+{
+  if (!sprite->created()) {
+    sprite->createSprite(tft->width(), tft->height());
+  }
+  return true;
+}
+
+static uint32_t Test_getFreeHeap()
+{
+  return TEST_HEAP;
+}
+
+static SoC_ops_t Test_SoC = { SOC_RPi, "Host" };
+const SoC_ops_t *SoC = &Test_SoC;
+
+typedef struct result_struct {
+  uint32_t bytes;     /* per frame, average */
+  uint32_t max;       /* of a frame */
+  uint32_t full;      /* full redraws */
+} result_t;
+
+/* targets circle the ownship, each at a radius and pace of its own */
+static void traffic_move(int frame)
+{
+  for (int i = 0; i < TEST_TARGETS; i++) {
+    float a = (frame * (i + 1) * 3.0f + i * 90.0f) * PI / 180;
+    int   r = 400 + i * 350;
+
+    Container[i].ID            = 0x100000 + i;
+    Container[i].timestamp     = now();
+    Container[i].RelativeNorth = (int16_t) (r * cosf(a));
+    Container[i].RelativeEast  = (int16_t) (r * sinf(a));
+    Container[i].RelativeVertical = (i - 1) * 100;
+    Container[i].AlarmLevel    = ALARM_LEVEL_NONE;
+  }
+}
+
+static void frames(bool full, int track, int turn, result_t *r)
+{
+  uint32_t full_before = radar_stats.full;
+  uint64_t sum = 0;
+
+  memset(r, 0, sizeof(*r));
+
+  for (int f = 0; f < TEST_FRAMES; f++) {
+    uint32_t bytes = HostTFT_bytes;
+
+    traffic_move(f);
+    /* a track that wanders by 2 degrees, or one in a turn */
+    ThisAircraft.Track = (360 + track + (turn ? turn * f : (f % 5) - 2)) % 360;
+
+    if (full) {
+      TFT_Radar_Invalidate();
+    }
+    TFT_Draw_Radar();
+
+    bytes = HostTFT_bytes - bytes;
+    CHECK(bytes == radar_stats.bytes);
+    CHECK(radar_stats.heap == 0);
+
+    sum += bytes;
+    if (bytes > r->max) {
+      r->max = bytes;
+    }
+  }
+
+  r->bytes = sum / TEST_FRAMES;
+  r->full  = radar_stats.full - full_before;
+}
+
+static void report(const char *name, const result_t *r)
+{
+  printf("%-24s %10u %10u %6u\n", name, r->bytes, r->max, r->full);
+}
+
+int main()
+{
+  const uint32_t screen = TEST_W * TEST_H * 2;
+  result_t inc, full, wander, turn;
+
+  Test_SoC.getFreeHeap = Test_getFreeHeap;
+
+  tft    = new TFT_eSPI(TEST_W, TEST_H);
+  sprite = new TFT_eSprite(tft);
+
+  settings->m.units       = UNITS_METRIC;
+  settings->m.zoom        = ZOOM_MEDIUM;
+  settings->m.orientation = DIRECTION_NORTH_UP;
+  setTime(1000);
+
+  TFT_radar_setup();
+
+  printf("%-24s %10s %10s %6s   (bytes to the screen)\n", "frames",
+         "per frame", "max", "full");
+
+  frames(false, 0, 0, &inc);
+  report("north up, incremental", &inc);
+  frames(true, 0, 0, &full);
+  report("north up, full redraw", &full);
+
+  settings->m.orientation = DIRECTION_TRACK_UP;
+  frames(false, 90, 0, &wander);
+  report("track up, wandering", &wander);
+  frames(false, 90, 3, &turn);
+  report("track up, 3 deg a frame", &turn);
+
+  /* one full frame to start with, bands of the targets after that */
+  CHECK(inc.full == 1);
+  CHECK(inc.max == screen);
+  CHECK(full.bytes == screen);
+  CHECK(inc.bytes < full.bytes / 2);
+
+  /*
+   * COG label of 5 degrees: one redraw for the new orientation and
+   * at most one more as the track wanders over a 5 degree boundary
+   */
+  CHECK(wander.full <= 2);
+  CHECK(wander.bytes < full.bytes / 2);
+  /* in a turn the label moves every 5 degrees, not every frame */
+  CHECK(turn.full <= TEST_FRAMES * 3 / RADAR_TRACK_STEP + 1);
+
+  return Host_report("test_radar");
+}
@@ -0,0 +1,397 @@
+/*
+ * test_seqlock.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Stress of the sequence locks of Tasks.h, with a writer and a reader
+ * thread on two cores.
+ *
+ *   test_seqlock [seconds]
+ *
+ * First the bare Tasks_Seq_*() helpers on a record of 64 words, all of
+ * a value: a reader that trusts its copy without the sequence check
+ * is counted for comparison, the checked reader must never see a mix.
+ * Then Traffic_Publish() and Traffic_Snapshot() of TrafficHelper.cpp,
+ * built with ENABLE_RADIO_TASK: the writer updates every entry of the
+ * table through Traffic_Add(), every field from one counter, and the
+ * reader checks that each entry of Container[] is of one update and
+ * that no entry goes back in time. Last, the stats of system/Profiler.cpp:
+ * the writer closes a period of the loop profile every round, with as
+ * many passes as the number of the period says, and the reader checks
+ * every copy of Profiler_Stats_get() for that count and the histogram
+ * of the same period.
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "../src/system/SoC.h"
+#include "../src/system/Tasks.h"
+#include "../src/system/Profiler.h"
+#include "../src/driver/RF.h"
+#include "../src/driver/EEPROM.h"
+#include "../src/TrafficHelper.h"
+
+#include "host/Host.h"
+
+#define SEQ_WORDS       64
+#define TEST_SECONDS    1
+
+/* what TrafficHelper.cpp takes from the rest of the firmware */
+eeprom_t eeprom_block;
+settings_t *settings = &eeprom_block.field.settings;
+ufo_t ThisAircraft;
+byte TxBuffer[MAX_PKT_SIZE], RxBuffer[MAX_PKT_SIZE];
+bool (*protocol_decode)(void *, ufo_t *, ufo_t *);
+uint8_t RF_rx_protocol;
+uint8_t RF_rx_size;
+int8_t RF_last_rssi;
+uint32_t rx_packets_counter;
+RF_rx_stats_t RF_Rx_Stats[RF_RX_PROTOCOLS_MAX];
+TinyGPSPlus gnss;
+
+bool legacy_peek(void *pkt, ufo_t *this_aircraft, ufo_t *fop) { return false; }
+bool fanet_peek (void *pkt, ufo_t *this_aircraft, ufo_t *fop) { return false; }
+
+String Bin2Hex(byte *buffer, size_t size)
+{
+  return String("");
+}
+
+/* of Tasks.cpp, which is for FreeRTOS only */
+task_queue_t Tasks_Inject_Queue;
+
+static __thread bool Test_is_radio;
+
+bool Tasks_isRadio()                               { return Test_is_radio; }
+bool Tasks_Queue_put(task_queue_t *q, const void *item) { return false; }
+bool Tasks_Queue_get(task_queue_t *q, void *item)  { return false; }
+void Tasks_Notify(uint8_t event)                   {}
+
+static volatile bool Test_stop;
+static uint64_t      Test_ns = TEST_SECONDS * 1000000000ULL;
+
+typedef struct seq_record_struct {
+  task_seq_t  seq;
+  uint32_t    word[SEQ_WORDS];
+} seq_record_t;
+
+static seq_record_t Record;
+
+typedef struct reader_stats_struct {
+  unsigned long reads;
+  unsigned long retries;    /* copies thrown away by the sequence check */
+  unsigned long updates;    /* changes seen */
+  unsigned long torn;
+} reader_stats_t;
+
+static void *seq_writer(void *arg)
+{
+  for (uint32_t k = 1; !Test_stop; k++) {
+    Tasks_Seq_write_begin(&Record.seq);
+    for (int i = 0; i < SEQ_WORDS; i++) {
+      Record.word[i] = k;
+    }
+    Tasks_Seq_write_end(&Record.seq);
+
+    /*
+     * an update at a time, as the radio task makes them: on one core,
+     * a writer that spins is mostly preempted with the count odd
+     */
+    sched_yield();
+  }
+
+  return NULL;
+}
+
+static bool seq_mixed(const uint32_t *word)
+{
+  for (int i = 1; i < SEQ_WORDS; i++) {
+    if (word[i] != word[0]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* trusts every copy, to show what the check is there for */
+static void *seq_reader_unchecked(void *arg)
+{
+  reader_stats_t *stats = (reader_stats_t *) arg;
+  uint32_t copy[SEQ_WORDS];
+
+  while (!Test_stop) {
+    memcpy(copy, (const void *) Record.word, sizeof(copy));
+
+    stats->reads++;
+    if (seq_mixed(copy)) {
+      stats->torn++;
+    }
+  }
+
+  return NULL;
+}
+
+static void *seq_reader(void *arg)
+{
+  reader_stats_t *stats = (reader_stats_t *) arg;
+  uint32_t copy[SEQ_WORDS];
+
+  while (!Test_stop) {
+    uint32_t count = Tasks_Seq_read_begin(&Record.seq);
+
+    memcpy(copy, (const void *) Record.word, sizeof(copy));
+
+    if (!Tasks_Seq_read_valid(&Record.seq, count)) {
+      stats->retries++;
+      continue;
+    }
+    stats->reads++;
+    if (seq_mixed(copy)) {
+      stats->torn++;
+    }
+  }
+
+  return NULL;
+}
+
+/* writer and reader run side by side for half of the test time */
+static void run(void *(*writer)(void *), void *(*reader)(void *), void *arg)
+{
+  pthread_t w, r;
+
+  Test_stop = false;
+  pthread_create(&w, NULL, writer, NULL);
+  pthread_create(&r, NULL, reader, arg);
+
+  uint64_t start = Host_wall_ns();
+  while (Host_wall_ns() - start < Test_ns / 2) {
+    sched_yield();
+  }
+
+  Test_stop = true;
+  pthread_join(w, NULL);
+  pthread_join(r, NULL);
+}
+
+static void check_helpers()
+{
+  reader_stats_t checked = { 0 }, unchecked = { 0 };
+
+  run(seq_writer, seq_reader_unchecked, &unchecked);
+  run(seq_writer, seq_reader, &checked);
+
+  printf("Tasks_Seq:  %lu reads, %lu retried, %lu torn; "
+         "without the check %lu of %lu torn\n",
+         checked.reads, checked.retries, checked.torn,
+         unchecked.torn, unchecked.reads);
+
+  CHECK(checked.reads > 0);
+  CHECK(checked.torn == 0);
+}
+
+/* every field of an update from one counter */
+static void traffic_fill(ufo_t *fop, int i, uint32_t k)
+{
+  memset(fop, 0, sizeof(ufo_t));
+
+  fop->timestamp     = now();
+  fop->addr          = 0x100000 + i;
+  fop->addr_type     = ADDR_TYPE_ICAO;
+  fop->protocol      = RF_PROTOCOL_ADSB_1090;
+  fop->aircraft_type = AIRCRAFT_TYPE_JET;
+  fop->latitude      = (float) (k & 0xFFFF);
+  fop->longitude     = -fop->latitude;
+  fop->altitude      = (float) k;
+  fop->course        = (float) (k % 360);
+  fop->speed         = (float) (k & 0xFF);
+  fop->vs            = fop->latitude;
+  fop->distance      = fop->altitude;
+  memset(fop->callsign, 'A' + k % 26, sizeof(fop->callsign));
+#if defined(ENABLE_UFO_RAW)
+  memset(fop->raw, k, sizeof(fop->raw));
+#endif /* ENABLE_UFO_RAW */
+}
+
+static bool traffic_whole(ufo_t *fop, uint32_t *k)
+{
+  ufo_t ref;
+
+  *k = (uint32_t) fop->altitude;
+  traffic_fill(&ref, fop->addr - 0x100000, *k);
+  ref.timestamp = fop->timestamp;
+  ref.alert     = fop->alert;
+
+  return memcmp(&ref, fop, sizeof(ufo_t)) == 0;
+}
+
+static void *traffic_writer(void *arg)
+{
+  Test_is_radio = true;
+
+  for (uint32_t k = 1; !Test_stop; k++) {
+    for (int i = 0; i < MAX_TRACKING_OBJECTS; i++) {
+      ufo_t fo;
+
+      traffic_fill(&fo, i, k);
+      Traffic_Add(&fo);
+    }
+    Traffic_Publish();
+  }
+
+  return NULL;
+}
+
+static void *traffic_reader(void *arg)
+{
+  reader_stats_t *stats = (reader_stats_t *) arg;
+  uint32_t last[MAX_TRACKING_OBJECTS] = { 0 };
+
+  Test_is_radio = false;
+
+  while (!Test_stop) {
+    Traffic_Snapshot();
+
+    for (int i = 0; i < MAX_TRACKING_OBJECTS; i++) {
+      uint32_t k;
+
+      if (Container[i].addr == 0) {
+        continue;
+      }
+      stats->reads++;
+      if (!traffic_whole(&Container[i], &k) || k < last[i]) {
+        stats->torn++;
+      }
+      if (k != last[i]) {
+        stats->updates++;
+      }
+      last[i] = k;
+    }
+  }
+
+  return NULL;
+}
+
+static void check_traffic()
+{
+  reader_stats_t stats = { 0 };
+
+  /* as setup() leaves it: empty table, then the radio task takes it over */
+  memset(Container, 0, sizeof(Container));
+  Traffic_Detach();
+
+  run(traffic_writer, traffic_reader, &stats);
+
+  printf("Traffic:    %lu entries read, %lu updates seen, %lu torn or stale\n",
+         stats.reads, stats.updates, stats.torn);
+
+  CHECK(stats.reads > 0);
+  CHECK(stats.updates > MAX_TRACKING_OBJECTS);
+  CHECK(stats.torn == 0);
+}
+
+/* passes of the loop in profiler period 'epoch' */
+static int profiler_passes(uint16_t epoch)
+{
+  return 1 + epoch % 8;
+}
+
+static void *profiler_writer(void *arg)
+{
+  uint16_t epoch = 1;   /* the first one, of Profiler_setup() */
+
+  while (!Test_stop) {
+    Host_advance_ms(PROFILER_PERIOD);
+    epoch++;
+
+    for (int i = 0; i < profiler_passes(epoch); i++) {
+      Profiler_loop();
+    }
+    sched_yield();
+  }
+
+  return NULL;
+}
+
+static void *profiler_reader(void *arg)
+{
+  reader_stats_t *stats = (reader_stats_t *) arg;
+  uint32_t hist[PROFILER_BUCKETS];
+  uint16_t last = 0;
+
+  while (!Test_stop) {
+    prof_stats_t ps;
+    uint32_t sum = 0;
+
+    if (!Profiler_Stats_get(PROF_LOOP, &ps, hist)) {
+      stats->retries++;
+      continue;
+    }
+    if (ps.count == 0) {
+      continue;
+    }
+
+    for (int b = 0; b < PROFILER_BUCKETS; b++) {
+      sum += hist[b];
+    }
+
+    stats->reads++;
+    if (ps.count != (uint32_t) profiler_passes(ps.epoch) || sum != ps.count) {
+      stats->torn++;
+    }
+    if (ps.epoch != last) {
+      stats->updates++;
+    }
+    last = ps.epoch;
+  }
+
+  return NULL;
+}
+
+static void check_profiler()
+{
+  reader_stats_t stats = { 0 };
+
+  Profiler_setup();
+  /* start of the first pass */
+  Profiler_loop();
+
+  run(profiler_writer, profiler_reader, &stats);
+
+  printf("Profiler:   %lu reads, %lu failed, %lu periods seen, %lu torn\n",
+         stats.reads, stats.retries, stats.updates, stats.torn);
+
+  CHECK(stats.reads > 0);
+  CHECK(stats.updates > 1);
+  CHECK(stats.torn == 0);
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc > 1) {
+    Test_ns = (uint64_t) (atof(argv[1]) * 1e9);
+  }
+
+  setTime(1760000000);
+
+  check_helpers();
+  check_traffic();
+  check_profiler();
+
+  return Host_report("test_seqlock");
+}
@@ -0,0 +1,198 @@
+/*
+ * test_time_pll.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * PPS disciplined time base (system/Time.cpp) against synthetic PPS
+ * edges and NMEA RMC sentences. Local oscillator runs TEST_PPM fast,
+ * PPS and NMEA arrival times have some jitter.
+ */
+
+#include <stdlib.h>
+
+#include "../src/system/SoC.h"
+#include "../src/system/Time.h"
+#include "../src/driver/GNSS.h"
+#include <TimeLib.h>
+
+#include "host/Host.h"
+
+#define TEST_PPM        100
+#define TEST_EPOCH      1700000000UL  /* 2023-11-14 22:13:20 UTC */
+#define TEST_RMC_DELAY  100           /* ms, NMEA after the epoch */
+
+/* what Time.cpp takes from the rest of the firmware */
+TinyGPSPlus gnss;
+const gnss_chip_ops_t *gnss_chip = NULL;
+unsigned long GNSSTimeSyncMarker = 0;
+volatile unsigned long PPS_TimeMarker = 0;
+volatile unsigned long PPS_TimeMarker_us = 0;
+
+static unsigned long Test_get_PPS_TimeMarker()
+{
+  return PPS_TimeMarker;
+}
+
+static SoC_ops_t Test_SoC = { SOC_RPi, "Host" };
+const SoC_ops_t *SoC = &Test_SoC;
+
+/* micros() of local oscillator at UTC time t (us since TEST_EPOCH) */
+static uint64_t local_us(uint64_t t)
+{
+  return 5000000ULL + t + t * TEST_PPM / 1000000;
+}
+
+/* advance the fake clock to local time of UTC t, running the PLL loop */
+static void run_until(uint64_t t)
+{
+  uint64_t target = local_us(t);
+
+  while (Host_time_us + 10000 < target) {
+    Host_advance_us(10000);
+    Time_PLL_loop();
+  }
+  Host_time_us = target;
+}
+
+static int jitter(int max_us)
+{
+  return (rand() % (2 * max_us + 1)) - max_us;
+}
+
+static void send_rmc(time_t sec, unsigned cs)
+{
+  tmElements_t tm;
+  char buf[96];
+  unsigned char csum = 0;
+
+  breakTime(sec, tm);
+  int len = snprintf(buf, sizeof(buf),
+           "$GPRMC,%02u%02u%02u.%02u,A,5546.000,N,03737.000,E,0.0,0.0,"
+           "%02u%02u%02u,,,A", tm.Hour, tm.Minute, tm.Second, cs,
+           tm.Day, tm.Month, (tm.Year + 1970) % 100);
+  for (int i = 1; i < len; i++) {
+    csum ^= buf[i];
+  }
+  snprintf(buf + len, sizeof(buf) - len, "*%02X\r\n", csum);
+  for (char *p = buf; *p; p++) {
+    gnss.encode(*p);
+  }
+}
+
+static void reset_pll()
+{
+  Time_PLL.state     = TIME_PLL_UNLOCKED;
+  Time_PLL.period_q8 = 1000000L << 8;
+  Time_PLL.base_sec  = 0;
+  Time_PLL.nmea_time = 0;
+  Time_PLL.pps_ms    = 0;
+  PPS_TimeMarker     = 0;
+}
+
+/* UTC now_us() error against the true time t, us */
+static long utc_error(uint64_t t)
+{
+  return (long) ((int64_t) now_us() -
+                 (int64_t) (TEST_EPOCH * 1000000ULL + t));
+}
+
+static void test_pps()
+{
+  reset_pll();
+
+  for (int s = 1; s <= 120; s++) {
+    uint64_t edge = (uint64_t) s * 1000000;
+
+    run_until(edge + jitter(2));
+    PPS_TimeMarker    = millis();
+    PPS_TimeMarker_us = micros();
+    run_until(edge + TEST_RMC_DELAY * 1000);
+    send_rmc(TEST_EPOCH + s, 0);
+  }
+  run_until(120 * 1000000ULL + 500000);
+
+  CHECK(Time_PLL.state == TIME_PLL_PPS);
+  CHECK(Time_PLL_locked());
+  CHECK_NEAR(Time_PLL_drift(), TEST_PPM, 2);
+  CHECK(Time_PLL.jitter_us < 20);
+  CHECK_NEAR(utc_error(120 * 1000000ULL + 500000), 0, 50);
+  printf("PPS:         drift %ld ppm, jitter %lu us, UTC error %ld us\n",
+         (long) Time_PLL_drift(), (unsigned long) Time_PLL.jitter_us,
+         utc_error(120 * 1000000ULL + 500000));
+}
+
+/* NMEA only, 'rate' epochs per second, each one reported in RMC */
+static void test_nmea(int rate, int seconds)
+{
+  reset_pll();
+
+  for (int s = 1; s <= seconds; s++) {
+    for (int e = 0; e < rate; e++) {
+      uint64_t epoch = (uint64_t) s * 1000000 + e * (1000000 / rate);
+
+      run_until(epoch + TEST_RMC_DELAY * 1000 + jitter(3000));
+      send_rmc(TEST_EPOCH + s, e * (100 / rate));
+    }
+  }
+
+  uint64_t t = (uint64_t) seconds * 1000000 + 900000;
+  run_until(t);
+
+  CHECK(Time_PLL.state == TIME_PLL_NMEA);
+  CHECK(Time_PLL_locked());
+  /* frequency loop has to pull in at any rate */
+  CHECK_NEAR(Time_PLL_drift(), TEST_PPM, 30);
+  CHECK(Time_PLL.jitter_us < 5000);
+  CHECK_NEAR(utc_error(t), 0, 5000);
+  printf("NMEA %2d Hz:  drift %ld ppm, jitter %lu us, UTC error %ld us\n",
+         rate, (long) Time_PLL_drift(), (unsigned long) Time_PLL.jitter_us,
+         utc_error(t));
+}
+
+/* phase step beyond capture range re-acquires and re-labels */
+static void test_step()
+{
+  reset_pll();
+
+  for (int s = 1; s <= 30; s++) {
+    uint64_t edge = (uint64_t) s * 1000000 + (s > 20 ? 200000 : 0);
+
+    run_until(edge);
+    PPS_TimeMarker    = millis();
+    PPS_TimeMarker_us = micros();
+    run_until(edge + TEST_RMC_DELAY * 1000);
+    send_rmc(TEST_EPOCH + s, 0);
+  }
+  run_until(30 * 1000000ULL + 500000);
+
+  CHECK(Time_PLL_locked());
+  CHECK_NEAR(utc_error(30 * 1000000ULL + 500000), -200000, 100);
+}
+
+int main()
+{
+  srand(1);
+  Test_SoC.get_PPS_TimeMarker = Test_get_PPS_TimeMarker;
+
+  test_pps();
+  test_nmea(1, 600);
+  test_nmea(5, 600);
+  test_nmea(10, 600);
+  test_step();
+
+  return Host_report("test_time_pll");
+}
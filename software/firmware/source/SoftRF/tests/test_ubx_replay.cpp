@@ -0,0 +1,284 @@
+/*
+ * test_ubx_replay.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * UBX-NAV-PVT ownship path (ENABLE_UBX_PVT) of driver/GNSS.cpp.
+ *
+ *   test_ubx_replay             - self check with a synthetic 5 Hz log
+ *   test_ubx_replay <file.ubx>  - replay a receiver capture (u-center
+ *                                 .ubx or raw UART dump) and print
+ *                                 ownship state of every NAV-PVT epoch
+ */
+
+#include <stdlib.h>
+#include <string>
+
+#include "../src/system/SoC.h"
+#include "../src/driver/GNSS.h"
+#include "../src/driver/EEPROM.h"
+#include "../src/driver/Baro.h"
+
+#include "host/Host.h"
+#include "host/HostSerial.h"
+
+/* what GNSS.cpp takes from the rest of the firmware */
+eeprom_t eeprom_block;
+settings_t *settings = &eeprom_block.field.settings;
+hardware_info_t hw_info = { .model = SOFTRF_MODEL_RASPBERRY };
+
+static SoC_ops_t Test_SoC = { SOC_RPi, "Host" };
+const SoC_ops_t *SoC = &Test_SoC;
+
+void NMEA_Out(uint8_t dest, byte *buf, size_t size, bool nl) {}
+void NMEA_GGA() {}
+
+static void put_u1(std::string &s, size_t o, uint32_t v) { s[o] = v & 0xFF; }
+static void put_u2(std::string &s, size_t o, uint32_t v) { put_u1(s, o, v); put_u1(s, o + 1, v >> 8); }
+static void put_u4(std::string &s, size_t o, uint32_t v) { put_u2(s, o, v); put_u2(s, o + 2, v >> 16); }
+
+static std::string ubx_frame(uint8_t cl, uint8_t id, const std::string &payload)
+{
+  std::string f("\xB5\x62", 2);
+  uint8_t ck_a = 0, ck_b = 0;
+
+  f += (char) cl;
+  f += (char) id;
+  f += (char) (payload.size() & 0xFF);
+  f += (char) (payload.size() >> 8);
+  f += payload;
+  for (size_t i = 2; i < f.size(); i++) {
+    ck_a += (uint8_t) f[i];
+    ck_b += ck_a;
+  }
+  f += (char) ck_a;
+  f += (char) ck_b;
+
+  return f;
+}
+
+typedef struct epoch_struct {
+  uint32_t iTOW;
+  int32_t  lat, lon, hMSL, height, velD, gSpeed, headMot;
+  uint32_t hAcc, vAcc;
+} epoch_t;
+
+static std::string nav_pvt(const epoch_t &e)
+{
+  std::string p(92, '\0');
+  uint32_t ms = e.iTOW % 86400000;
+
+  put_u4(p,  0, e.iTOW);
+  put_u2(p,  4, 2023);
+  put_u1(p,  6, 11);
+  put_u1(p,  7, 14);
+  put_u1(p,  8, ms / 3600000);
+  put_u1(p,  9, ms / 60000 % 60);
+  put_u1(p, 10, ms / 1000 % 60);
+  put_u1(p, 11, 0x07);            /* validDate, validTime, fullyResolved */
+  put_u1(p, 20, 3);               /* 3D fix */
+  put_u1(p, 21, 0x01);            /* gnssFixOK */
+  put_u1(p, 23, 14);
+  put_u4(p, 24, e.lon);
+  put_u4(p, 28, e.lat);
+  put_u4(p, 32, e.height);
+  put_u4(p, 36, e.hMSL);
+  put_u4(p, 40, e.hAcc);
+  put_u4(p, 44, e.vAcc);
+  put_u4(p, 56, e.velD);
+  put_u4(p, 60, e.gSpeed);
+  put_u4(p, 64, e.headMot);
+  put_u2(p, 76, 120);
+
+  return ubx_frame(0x01, 0x07, p);
+}
+
+static std::string nav_timegps(uint32_t iTOW)
+{
+  std::string p(16, '\0');
+
+  put_u4(p,  0, iTOW);
+  put_u2(p,  8, 2288);
+  put_u1(p, 10, 18);
+  put_u1(p, 11, 0x07);
+
+  return ubx_frame(0x01, 0x20, p);
+}
+
+static std::string nmea(const char *body)
+{
+  char tail[8];
+  unsigned char cs = 0;
+
+  for (const char *p = body; *p; p++) {
+    cs ^= *p;
+  }
+  snprintf(tail, sizeof(tail), "*%02X\r\n", cs);
+
+  return std::string("$") + body + tail;
+}
+
+/* feed a log in random sized pieces, as a UART would deliver it */
+static void feed(const std::string &log, void (*epoch_cb)(void))
+{
+  uint32_t last_iTOW = 0;
+
+  for (size_t i = 0; i < log.size(); ) {
+    size_t n = 1 + rand() % 96;
+
+    if (n > log.size() - i) {
+      n = log.size() - i;
+    }
+    HostSerial_feed(Serial1, log.data() + i, n);
+    i += n;
+    Host_advance_ms(5);
+    PickGNSSFix();
+
+    if (GNSS_PVT.iTOW != last_iTOW) {
+      last_iTOW = GNSS_PVT.iTOW;
+      if (epoch_cb) {
+        epoch_cb();
+      }
+    }
+  }
+}
+
+static unsigned int epochs = 0;
+static bool         bogus  = false;
+
+static void check_epoch()
+{
+  epochs++;
+  if (GNSS_PVT.lat > 900000000) {
+    bogus = true;
+  }
+}
+
+static void print_epoch()
+{
+  ufo_t fo = { 0 };
+
+  if (GNSS_PVT_Ownship(&fo)) {
+    printf("%lu,%.7f,%.7f,%.1f,%.1f,%.1f,%.1f,%lu,%lu\n",
+           (unsigned long) GNSS_PVT.iTOW, fo.latitude, fo.longitude,
+           fo.altitude, fo.course, fo.speed, fo.vs,
+           (unsigned long) GNSS_PVT.hAcc, (unsigned long) GNSS_PVT.vAcc);
+  } else {
+    printf("%lu,no fix\n", (unsigned long) GNSS_PVT.iTOW);
+  }
+}
+
+static int replay(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  std::string log;
+  char buf[4096];
+  size_t n;
+
+  if (f == NULL) {
+    perror(path);
+    return 1;
+  }
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+    log.append(buf, n);
+  }
+  fclose(f);
+
+  printf("iTOW,lat,lon,alt_msl,course,speed_kt,vs_fpm,hAcc_mm,vAcc_mm\n");
+  feed(log, print_epoch);
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  srand(1);
+  Host_time_us = 1000000;
+  hw_info.baro = BARO_MODULE_NONE;
+
+  if (argc > 1) {
+    return replay(argv[1]);
+  }
+
+  /* 60 s of a thermalling glider, 5 Hz, 2 m/s climb, 1 Hz NMEA */
+  std::string log;
+  epoch_t e;
+
+  for (int i = 0; i < 300; i++) {
+    e.iTOW    = 252000000 + i * 200;
+    e.lat     = 557666667 + i * 10;
+    e.lon     = 376222222 - i * 7;
+    e.hMSL    = 1500000 + i * 400;
+    e.height  = e.hMSL + 14500;
+    e.velD    = -2000;
+    e.gSpeed  = 22000;
+    e.headMot = (i * 600000) % 36000000;
+    e.hAcc    = 1500;
+    e.vAcc    = 2500;
+
+    log += nav_pvt(e);
+    log += nav_timegps(e.iTOW);
+
+    if (i % 5 == 0) {
+      char body[96];
+
+      snprintf(body, sizeof(body), "GNGGA,%02u%02u%02u.00,5546.0000,N,"
+               "03737.3333,E,1,14,0.6,1500.0,M,14.5,M,,",
+               (e.iTOW / 3600000) % 24, (e.iTOW / 60000) % 60,
+               (e.iTOW / 1000) % 60);
+      log += nmea(body);
+    }
+    if (i == 150) {
+      /* damaged frame: must not reach GNSS_PVT */
+      epoch_t b = e;
+      b.iTOW = 1;
+      b.lat  = 950000000;
+      std::string f = nav_pvt(b);
+      f[20] ^= 0x55;
+      log += f;
+      /* truncated frame: its length is taken from the next frame header */
+      log += std::string("\xB5\x62\x01", 3);
+    }
+  }
+
+  feed(log, check_epoch);
+
+  ufo_t fo = { 0 };
+
+  /* the truncated frame eats up to UBX_MAX_LEN bytes, then decoder recovers */
+  CHECK(epochs >= 300 - 4 && epochs < 300);
+  CHECK(!bogus);
+  CHECK(GNSS_PVT_valid());
+  CHECK(GNSS_PVT_Ownship(&fo));
+  CHECK(GNSS_PVT.week == 2288 && GNSS_PVT.leapS == 18);
+  CHECK_NEAR(fo.latitude,  e.lat * 1e-7, 1e-5);
+  CHECK_NEAR(fo.longitude, e.lon * 1e-7, 1e-5);
+  CHECK_NEAR(fo.altitude,  e.hMSL / 1000.0, 0.01);
+  CHECK_NEAR(fo.geoid_separation, 14.5, 0.01);
+  CHECK_NEAR(fo.course, e.headMot * 1e-5, 1e-3);
+  CHECK_NEAR(fo.speed, 22.0 / _GPS_MPS_PER_KNOT, 0.01);
+  CHECK_NEAR(fo.vs, 2.0 * _GPS_FEET_PER_METER * 60, 0.5);
+  /* NMEA in between of UBX frames still gets through */
+  CHECK(gnss.location.isValid());
+  CHECK(gnss.failedChecksum() == 0);
+
+  /* no fix when NAV-PVT stream stops */
+  Host_advance_ms(NMEA_EXP_TIME + 1);
+  CHECK(!GNSS_PVT_valid());
+
+  return Host_report("test_ubx_replay");
+}
@@ -0,0 +1,252 @@
+/*
+ * test_vario.cpp
+ * Copyright (C) 2026 SoftRF contributors
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Vertical speed estimator of driver/Baro.cpp against the former
+ * 3 sample boxcar average, lag and noise.
+ *
+ *   test_vario             - self check on a synthetic thermalling flight
+ *                            with known vertical speed and baro noise
+ *   test_vario <file.igc>  - pressure altitude of a recorded flight log,
+ *                            resampled to the baro rate; the reference
+ *                            is a centered (non-causal) difference
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+#include "../src/system/SoC.h"
+#include "../src/driver/Baro.h"
+#include "../src/driver/EEPROM.h"
+#include "../src/driver/GNSS.h"
+
+#include "host/Host.h"
+
+#define VARIO_DT_MS     (1000 / BARO_SAMPLE_RATE)
+#define VARIO_MAX_LAG   (3 * BARO_SAMPLE_RATE)  /* samples */
+
+/* what Baro.cpp takes from the rest of the firmware */
+eeprom_t eeprom_block;
+settings_t *settings = &eeprom_block.field.settings;
+hardware_info_t hw_info = { .model = SOFTRF_MODEL_RASPBERRY };
+ufo_t ThisAircraft;
+
+/* former estimator: mean of 3 successive differences, +/-0.1 m/s dead band */
+typedef struct boxcar_struct {
+  float prev;
+  float vs[3];
+  int   ndx;
+} boxcar_t;
+
+static float boxcar_step(boxcar_t &b, float alt, unsigned long dt_ms)
+{
+  float vs = 0;
+
+  b.vs[b.ndx] = (alt - b.prev) / dt_ms * 1000;
+  for (int i = 0; i < 3; i++) {
+    vs += b.vs[i];
+  }
+  vs /= 3;
+  if (vs > -0.1 && vs < 0.1) {
+    vs = 0;
+  }
+  b.prev = alt;
+  b.ndx  = (b.ndx + 1) % 3;
+
+  return vs;
+}
+
+typedef struct score_struct {
+  double rms;   /* m/s, at best lag */
+  int    lag;   /* samples */
+} score_t;
+
+/* lag of best fit against the reference, and RMS error at that lag */
+static score_t score(const std::vector<float> &est, const std::vector<float> &ref)
+{
+  score_t s = { 1e9, 0 };
+  size_t skip = 10 * BARO_SAMPLE_RATE;  /* settling */
+
+  for (int lag = 0; lag <= VARIO_MAX_LAG; lag++) {
+    double sum = 0;
+    size_t n = 0;
+
+    for (size_t i = skip; i + lag < est.size(); i++) {
+      double e = est[i + lag] - ref[i];
+      sum += e * e;
+      n++;
+    }
+    if (n > 0 && sqrt(sum / n) < s.rms) {
+      s.rms = sqrt(sum / n);
+      s.lag = lag;
+    }
+  }
+
+  return s;
+}
+
+/* run both estimators over altitude samples */
+static void run(const std::vector<float> &alt, const std::vector<unsigned long> &dt,
+                std::vector<float> &kf, std::vector<float> &bc)
+{
+  boxcar_t b;
+
+  memset(&b, 0, sizeof(b));
+  b.prev = alt[0];
+  Baro_vario_reset(alt[0]);
+
+  for (size_t i = 0; i < alt.size(); i++) {
+    Baro_vario_step(alt[i], dt[i]);
+    kf.push_back(Baro_vario_fpm() / (_GPS_FEET_PER_METER * 60.0));
+    bc.push_back(boxcar_step(b, alt[i], dt[i]));
+  }
+}
+
+static double gauss()
+{
+  double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+  double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+
+  return sqrt(-2 * log(u1)) * cos(2 * M_PI * u2);
+}
+
+static int self_check()
+{
+  std::vector<float> alt, ref, kf, bc;
+  std::vector<unsigned long> dt;
+  double h = 1000;
+
+  /* 20 min: circling in thermals, 30 s cycle of lift and sink, glides */
+  for (int i = 0; i < 20 * 60 * BARO_SAMPLE_RATE; i++) {
+    double t  = i / (double) BARO_SAMPLE_RATE;
+    double vs = (fmod(t, 300) < 200) ? 1.5 + 1.5 * sin(2 * M_PI * t / 30) : -1.0;
+    unsigned long d = VARIO_DT_MS + rand() % 8;   /* loop jitter */
+
+    h += vs * d / 1000.0;
+    alt.push_back(h + 0.25 * gauss());
+    ref.push_back(vs);
+    dt.push_back(d);
+  }
+
+  run(alt, dt, kf, bc);
+
+  score_t k = score(kf, ref);
+  score_t b = score(bc, ref);
+
+  printf("synthetic flight, 0.25 m baro noise:\n");
+  printf("  alpha-beta : RMS %.3f m/s, lag %4d ms\n", k.rms, k.lag * VARIO_DT_MS);
+  printf("  boxcar     : RMS %.3f m/s, lag %4d ms\n", b.rms, b.lag * VARIO_DT_MS);
+
+  /* less noise than the boxcar, and no more lag */
+  CHECK(k.rms < b.rms);
+  CHECK(k.lag <= b.lag);
+  CHECK(k.rms < 0.3);
+
+  /* steady 2 m/s climb, no noise: no bias, settles in 10 s */
+  Baro_vario_reset(500);
+  h = 500;
+  for (int i = 0; i < 10 * BARO_SAMPLE_RATE; i++) {
+    h += 2.0 * VARIO_DT_MS / 1000.0;
+    Baro_vario_step(h, VARIO_DT_MS);
+  }
+  CHECK_NEAR(Baro_vario_fpm() / (_GPS_FEET_PER_METER * 60.0), 2.0, 0.02);
+
+  /* long gap in samples restarts the filter */
+  Baro_vario_step(h + 100, 5000);
+  CHECK(Baro_vario_fpm() == 0);
+
+  return Host_report("test_vario");
+}
+
+/* IGC B record: BHHMMSSDDMMmmmNDDDMMmmmEVPPPPPGGGGG */
+static int igc(const char *path)
+{
+  FILE *f = fopen(path, "r");
+  std::vector<double> t_s, p_alt;
+  char line[128];
+
+  if (f == NULL) {
+    perror(path);
+    return 1;
+  }
+  while (fgets(line, sizeof(line), f)) {
+    if (line[0] != 'B' || strlen(line) < 35) {
+      continue;
+    }
+    int hh = (line[1] - '0') * 10 + line[2] - '0';
+    int mm = (line[3] - '0') * 10 + line[4] - '0';
+    int ss = (line[5] - '0') * 10 + line[6] - '0';
+    char pa[6];
+
+    memcpy(pa, &line[25], 5);
+    pa[5] = 0;
+    double t = hh * 3600 + mm * 60 + ss;
+    if (!t_s.empty() && t <= t_s.back()) {
+      t += 86400 * (t < t_s.back() - 43200);  /* past midnight */
+      if (t <= t_s.back()) continue;
+    }
+    t_s.push_back(t);
+    p_alt.push_back(atof(pa));
+  }
+  fclose(f);
+
+  if (t_s.size() < 60) {
+    fprintf(stderr, "%s: too few B records\n", path);
+    return 1;
+  }
+
+  /* resample to the baro rate */
+  std::vector<float> alt, ref, kf, bc;
+  std::vector<unsigned long> dt;
+  size_t j = 0;
+
+  for (double t = t_s.front(); t <= t_s.back(); t += VARIO_DT_MS / 1000.0) {
+    while (j + 1 < t_s.size() && t_s[j + 1] < t) j++;
+    double w = (t - t_s[j]) / (t_s[j + 1] - t_s[j]);
+    alt.push_back(p_alt[j] + w * (p_alt[j + 1] - p_alt[j]));
+    dt.push_back(VARIO_DT_MS);
+  }
+
+  /* reference: centered difference over +/-2 s */
+  int k = 2 * BARO_SAMPLE_RATE;
+  for (size_t i = 0; i < alt.size(); i++) {
+    size_t a = i >= (size_t) k ? i - k : 0;
+    size_t b = i + k < alt.size() ? i + k : alt.size() - 1;
+    ref.push_back(b > a ? (alt[b] - alt[a]) * 1000.0 / ((b - a) * VARIO_DT_MS) : 0);
+  }
+
+  run(alt, dt, kf, bc);
+
+  score_t ks = score(kf, ref);
+  score_t bs = score(bc, ref);
+
+  printf("%s, %zu B records, %.0f s:\n", path, t_s.size(), t_s.back() - t_s.front());
+  printf("  alpha-beta : RMS %.3f m/s, lag %4d ms\n", ks.rms, ks.lag * VARIO_DT_MS);
+  printf("  boxcar     : RMS %.3f m/s, lag %4d ms\n", bs.rms, bs.lag * VARIO_DT_MS);
+
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  srand(1);
+
+  return argc > 1 ? igc(argv[1]) : self_check();
+}
@@ -8,6 +8,7 @@
 #endif /* ARDUINO */
 
 #include "fir_filter.h"
+#include "CRC-CCIT.h"
 
 #ifdef I2S_INTERNAL
 #include <driver/adc.h>
@@ -996,6 +997,234 @@ void AFSK_adc_isr(Afsk *afsk, int16_t currentSample)
   }
 }
 
+#if AFSK_DEMODS > 0
+/*
+ * Block Rx path.
+ *
+ * Every sample is correlated with mark and space tones over a window of
+ * one bit (I/Q products of a sliding window, integer only). The energies
+ * of both tones are shared by AFSK_DEMODS demodulators that differ in
+ * the weight of the tones (flat, de-emphasised or pre-emphasised audio)
+ * and in the sampling point of the bit clock. Each demodulator has its
+ * own HDLC deframer and checks the FCS, a good frame is put into rxFifo
+ * unless another demodulator has already delivered it.
+ */
+#define AFSK_NCO_INC(f) ((uint32_t)(((uint64_t)(f) << 32) / AFSK_RX_SAMPLERATE))
+#define AFSK_NCO_QUARTER (1UL << 30)
+
+typedef struct AfskDemodCfg
+{
+  uint8_t markShift;  // Tone energy weights, log2
+  uint8_t spaceShift;
+  int16_t threshold;  // Target transition point of the bit clock
+  int16_t phaseInc;   // Bit clock nudge per transition
+} AfskDemodCfg;
+
+static const AfskDemodCfg afsk_demod_cfg[] = {
+    {0, 0, PHASE_THRESHOLD, PHASE_INC},      // Flat audio
+    {0, 2, PHASE_THRESHOLD, PHASE_INC},      // De-emphasised audio, space +6 dB
+    {2, 0, PHASE_THRESHOLD, PHASE_INC},      // Pre-emphasised audio, mark +6 dB
+    {0, 0, PHASE_THRESHOLD, PHASE_MAX / 32}, // Flat audio, fast bit clock recovery
+};
+
+inline static int afsk_osc(uint32_t phase)
+{
+  return (int)sinSample(phase >> 23) - 128;
+}
+
+static void afsk_deliver(Afsk *afsk, AfskDemod *dm)
+{
+  AfskCorr *c = &afsk->corr;
+  uint16_t len = dm->frameLen;
+  uint16_t fcs = dm->frame[len - 2] | (dm->frame[len - 1] << 8);
+
+  for (int i = 0; i < AFSK_DEDUP_LEN; i++)
+  {
+    if ((c->fcsValid & (1 << i)) && c->fcs[i] == fcs &&
+        c->sampleCount - c->fcsTime[i] < AFSK_RX_SAMPLERATE)
+    {
+      c->dups++;
+      return;
+    }
+  }
+
+  // Same framing as hdlcParse() produces, for ax25_poll()
+  FIFOBuffer *fifo = &afsk->rxFifo;
+  size_t need = len + 2;
+
+  for (uint16_t i = 0; i < len; i++)
+  {
+    uint8_t b = dm->frame[i];
+
+    if (b == HDLC_FLAG || b == HDLC_RESET || b == AX25_ESC)
+      need++;
+  }
+
+  // A frame goes in whole or not at all, a torn one would merge with the next
+  if (fifo_room(fifo) < need)
+  {
+    c->drops++;
+    return;
+  }
+
+  c->fcs[c->fcsIdx] = fcs;
+  c->fcsTime[c->fcsIdx] = c->sampleCount;
+  c->fcsValid |= 1 << c->fcsIdx;
+  c->fcsIdx = (c->fcsIdx + 1) % AFSK_DEDUP_LEN;
+  dm->frames++;
+
+  fifo_push(fifo, HDLC_FLAG);
+
+  for (uint16_t i = 0; i < len; i++)
+  {
+    uint8_t b = dm->frame[i];
+
+    if (b == HDLC_FLAG || b == HDLC_RESET || b == AX25_ESC)
+      fifo_push(fifo, AX25_ESC);
+    fifo_push(fifo, b);
+  }
+
+  fifo_push(fifo, HDLC_FLAG);
+}
+
+static void afsk_demod_hdlc(Afsk *afsk, AfskDemod *dm, bool bit, bool primary)
+{
+  Hdlc *hdlc = &dm->hdlc;
+
+  hdlc->demodulatedBits <<= 1;
+  hdlc->demodulatedBits |= bit ? 1 : 0;
+
+  if (hdlc->demodulatedBits == HDLC_FLAG)
+  {
+    if (hdlc->receiving && dm->frameLen >= AX25_MIN_FRAME_LEN &&
+        dm->crc == AX25_CRC_CORRECT)
+    {
+      afsk_deliver(afsk, dm);
+    }
+
+    hdlc->receiving = true;
+    hdlc->currentByte = 0;
+    hdlc->bitIndex = 0;
+    dm->frameLen = 0;
+    dm->crc = CRC_CCIT_INIT_VAL;
+
+    if (primary && ++hdlc_flag_count >= 3)
+    {
+      LED_RX_ON();
+    }
+    return;
+  }
+
+  if ((hdlc->demodulatedBits & HDLC_RESET) == HDLC_RESET)
+  {
+    hdlc->receiving = false;
+    if (primary)
+    {
+      LED_RX_OFF();
+      hdlc_flag_count = 0;
+      hdlc_flage_end = false;
+    }
+    return;
+  }
+
+  if (!hdlc->receiving)
+    return;
+
+  if (primary)
+    hdlc_flage_end = true;
+
+  // Stuffed bit
+  if ((hdlc->demodulatedBits & 0x3f) == 0x3e)
+    return;
+
+  if (hdlc->demodulatedBits & 0x01)
+    hdlc->currentByte |= 0x80;
+
+  if (++hdlc->bitIndex >= 8)
+  {
+    if (dm->frameLen < sizeof(dm->frame))
+    {
+      dm->frame[dm->frameLen++] = hdlc->currentByte;
+      dm->crc = update_crc_ccit(hdlc->currentByte, dm->crc);
+    }
+    else
+    {
+      hdlc->receiving = false;
+    }
+    hdlc->currentByte = 0;
+    hdlc->bitIndex = 0;
+  }
+  else
+  {
+    hdlc->currentByte >>= 1;
+  }
+}
+
+void AFSK_adc_block(Afsk *afsk, const int16_t *samples, size_t count)
+{
+  AfskCorr *c = &afsk->corr;
+
+  for (size_t n = 0; n < count; n++)
+  {
+    int32_t x = samples[n];
+    int32_t p[4];
+    uint8_t i = c->idx;
+
+    p[0] = x * afsk_osc(c->markPhase);
+    p[1] = x * afsk_osc(c->markPhase + AFSK_NCO_QUARTER);
+    p[2] = x * afsk_osc(c->spacePhase);
+    p[3] = x * afsk_osc(c->spacePhase + AFSK_NCO_QUARTER);
+    c->markPhase += AFSK_NCO_INC(MARK_FREQ);
+    c->spacePhase += AFSK_NCO_INC(SPACE_FREQ);
+
+    for (int k = 0; k < 4; k++)
+    {
+      c->sum[k] += p[k] - c->prod[k][i];
+      c->prod[k][i] = p[k];
+    }
+    if (++c->idx >= AFSK_RX_SPB)
+      c->idx = 0;
+
+    int64_t mark = (int64_t)c->sum[0] * c->sum[0] + (int64_t)c->sum[1] * c->sum[1];
+    int64_t space = (int64_t)c->sum[2] * c->sum[2] + (int64_t)c->sum[3] * c->sum[3];
+
+    c->sampleCount++;
+
+    for (int d = 0; d < AFSK_DEMODS; d++)
+    {
+      const AfskDemodCfg *cfg = &afsk_demod_cfg[d % (sizeof(afsk_demod_cfg) / sizeof(afsk_demod_cfg[0]))];
+      AfskDemod *dm = &afsk->demod[d];
+      bool bit = (mark << cfg->markShift) > (space << cfg->spaceShift);
+
+      dm->sampledBits <<= 1;
+      dm->sampledBits |= bit ? 1 : 0;
+
+      // Bit clock recovery, same as in AFSK_adc_isr()
+      if (SIGNAL_TRANSITIONED(dm->sampledBits))
+      {
+        if (dm->currentPhase < cfg->threshold)
+          dm->currentPhase += cfg->phaseInc;
+        else
+          dm->currentPhase -= cfg->phaseInc;
+      }
+
+      dm->currentPhase += PHASE_BITS;
+
+      if (dm->currentPhase >= PHASE_MAX)
+      {
+        dm->currentPhase %= PHASE_MAX;
+
+        // Correlator is a matched filter, its last decision is the bit
+        dm->actualBits <<= 1;
+        dm->actualBits |= bit ? 1 : 0;
+
+        afsk_demod_hdlc(afsk, dm, !TRANSITION_FOUND(dm->actualBits), d == 0);
+      }
+    }
+  }
+}
+#endif /* AFSK_DEMODS */
+
 #define ADC_SAMPLES_COUNT 768
 #if defined(I2S_INTERNAL) && !defined(CONFIG_IDF_TARGET_ESP32S3)
 #define ADC_SAMPLES_COUNT_IN ADC_SAMPLES_COUNT
@@ -1112,6 +1341,10 @@ void AFSK_Poll(bool SA818, bool RFPower, uint8_t powerPin)
 #if !defined(I2S_INTERNAL) || defined(CONFIG_IDF_TARGET_ESP32S3)
   int8_t adc;
 #endif
+#if AFSK_DEMODS > 0
+  static int16_t rx_block[ADC_SAMPLES_COUNT / 2]; // Every other I2S sample or ADC_SAMPLES_COUNT_IN
+  size_t rx_count = 0;
+#endif /* AFSK_DEMODS */
 
   if (hw_afsk_dac_isr)
   {
@@ -1274,10 +1507,18 @@ void AFSK_Poll(bool SA818, bool RFPower, uint8_t powerPin)
 
           int16_t adcR = (int16_t)(adcVal);
 
+#if AFSK_DEMODS > 0
+          rx_block[rx_count++] = adcR;
+#else
           AFSK_adc_isr(AFSK_modem, adcR); // Process signal IIR
           if (i % 32 == 0)
             APRS_poll(); // Poll check every 1 bit
+#endif /* AFSK_DEMODS */
         }
+#if AFSK_DEMODS > 0
+        AFSK_adc_block(AFSK_modem, rx_block, rx_count);
+        APRS_poll();
+#endif /* AFSK_DEMODS */
         // Get mVrms on Sync flage 0x7E
         if (afskSync == false)
         {
@@ -1316,10 +1557,17 @@ void AFSK_Poll(bool SA818, bool RFPower, uint8_t powerPin)
           break;
         // audiof[x] = (float)adc;
         //  Serial.printf("%02x ", (unsigned char)adc);
+#if AFSK_DEMODS > 0
+        rx_block[rx_count++] = adc;
+#else
         AFSK_adc_isr(AFSK_modem, adc); // Process signal IIR
         if (x % 4 == 0)
           APRS_poll(); // Poll check every 1 byte
+#endif /* AFSK_DEMODS */
       }
+#if AFSK_DEMODS > 0
+      AFSK_adc_block(AFSK_modem, rx_block, rx_count);
+#endif /* AFSK_DEMODS */
       APRS_poll();
     }
 #endif
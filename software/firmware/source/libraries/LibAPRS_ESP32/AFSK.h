@@ -27,6 +27,7 @@
 
 #include "FIFO.h"
 #include "HDLC.h"
+#include "AX25.h"
 
 #define SIN_LEN 512
 static const uint8_t sin_table[] =
@@ -177,7 +178,16 @@ inline static uint8_t sinSample(uint16_t i)
 
 #define CPU_FREQ F_CPU
 
+// Parallel demodulators of the block Rx path, 0 for the single sample-by-sample one
+#if !defined(AFSK_DEMODS)
+#define AFSK_DEMODS 4
+#endif
+
+#if AFSK_DEMODS > 0
+#define CONFIG_AFSK_RX_BUFLEN (2 * AX25_MAX_FRAME_LEN + 2) // Whole frames, escaped
+#else
 #define CONFIG_AFSK_RX_BUFLEN 50
+#endif
 #if defined(CONFIG_IDF_TARGET_ESP32)
 #define CONFIG_AFSK_TX_BUFLEN 50
 #else
@@ -207,6 +217,14 @@ inline static uint8_t sinSample(uint16_t i)
 
 #define PHASE_THRESHOLD (PHASE_MAX / 2)        // Target transition point of our phase window
 
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define AFSK_RX_SAMPLERATE 9600
+#else
+#define AFSK_RX_SAMPLERATE SAMPLERATE
+#endif
+#define AFSK_RX_SPB (AFSK_RX_SAMPLERATE / BITRATE) // Correlator window, one bit long
+#define AFSK_DEDUP_LEN 8                            // Frames remembered for deduplication, up to 8
+
 //#define SQL
 
 #if defined(ESP32)
@@ -245,6 +263,40 @@ typedef struct Hdlc
     bool receiving;
 } Hdlc;
 
+#if AFSK_DEMODS > 0
+// Mark and space tone correlators, shared by all demodulators
+typedef struct AfskCorr
+{
+    uint32_t markPhase;              // Oscillator phases, full turn is 2^32
+    uint32_t spacePhase;
+    int32_t prod[4][AFSK_RX_SPB];    // Products within the window: mark I/Q, space I/Q
+    int32_t sum[4];                  // Their running sums
+    uint8_t idx;                     // Oldest product in the window
+
+    uint32_t sampleCount;            // Samples processed
+    uint16_t fcs[AFSK_DEDUP_LEN];    // FCS of recently delivered frames
+    uint32_t fcsTime[AFSK_DEDUP_LEN];
+    uint8_t fcsIdx;
+    uint8_t fcsValid;                // Bit per used entry
+    uint16_t dups;                   // Frames dropped as duplicates
+    uint16_t drops;                  // Frames dropped, no room in rxFifo
+} AfskCorr;
+
+typedef struct AfskDemod
+{
+    Hdlc hdlc;
+    uint16_t sampledBits;   // Mark/space decisions (at ADC speed)
+    int16_t currentPhase;   // Phase of the bit clock
+    uint8_t actualBits;     // Bits at the bitrate
+
+    uint16_t crc;           // FCS of the frame being received
+    uint16_t frameLen;
+    uint8_t frame[AX25_MAX_FRAME_LEN];
+
+    uint16_t frames;        // Frames this demodulator delivered first
+} AfskDemod;
+#endif /* AFSK_DEMODS */
+
 typedef struct Afsk
 {
     // Stream access to modem
@@ -287,6 +339,11 @@ typedef struct Afsk
     int16_t currentPhase;  // Current phase of the demodulator
     uint8_t actualBits;   // Actual found bits at correct bitrate
 
+#if AFSK_DEMODS > 0
+    AfskCorr corr;
+    AfskDemod demod[AFSK_DEMODS];
+#endif /* AFSK_DEMODS */
+
     volatile int status; // Status of the modem, 0 means OK
 
 } Afsk;
@@ -343,6 +400,7 @@ void AFSK_poll(Afsk *afsk);
 void afsk_putchar(char c);
 int afsk_getchar(void);
 void AFSK_Poll(bool SA818, bool RFPower, uint8_t powerPin);
+void AFSK_adc_block(Afsk *afsk, const int16_t *samples, size_t count);
 void AFSK_TimerEnable(bool sts);
 
 #endif
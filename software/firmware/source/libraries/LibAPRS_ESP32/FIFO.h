@@ -104,6 +104,13 @@ inline void fifo_init(FIFOBuffer *f, unsigned char *buffer, size_t size) {
   f->end = buffer + size -1;
 }
 
+inline size_t fifo_room(const FIFOBuffer *f) {
+  size_t size = f->end - f->begin + 1;
+  size_t used = f->tail >= f->head ? f->tail - f->head :
+                                     size - (f->head - f->tail);
+  return size - 1 - used;
+}
+
 inline size_t fifo_len(FIFOBuffer *f) {
   //return f->end - f->begin;
   if(f->tail>f->head){
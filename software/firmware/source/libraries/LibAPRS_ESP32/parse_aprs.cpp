@@ -1467,7 +1467,7 @@ int ParseAPRS::parse_aprs(struct pbuf_t* pb)
 	case 0x27: /* ' */
 	case 0x60: /* ` */
 		/* could be mic-e, minimum body length 9 chars */
-		if (paclen >= 9) {
+		if (body_end - body >= 9) {
 			pb->packettype |= T_POSITION;
 			rc = parse_aprs_mice(pb,(const unsigned char*)body,(const unsigned char*)body_end);
 			parse_aprs_comment(pb, body + 9, (unsigned int)(body_end - body - 9));
@@ -1786,19 +1786,18 @@ char* ParseAPRS::parse_remove_part(char const* input, unsigned int const input_l
 	char* result;
 
 
-	/* Check params. */
+	/*
+	 * Check params. No caller tests for NULL, an input without the part
+	 * comes back as it is and one that is all part comes back empty.
+	 */
 	if (!input || !input_len || part_so >= input_len || part_eo > input_len || part_so >= part_eo)
 	{
-		*result_len = 0;
-		return NULL;
+		*result_len = input ? input_len : 0;
+		return (char*)input;
 	}
 
 	/* Calculate size of result. */
 	*result_len = input_len - (part_eo - part_so);
-	if (*result_len == 0)
-	{
-		return NULL;
-	}
 
 	/* Copy input into result. */
 	result = (char*)input;
@@ -2241,7 +2240,7 @@ void ParseAPRS::parse_aprs_comment(struct pbuf_t* pb, char const* input, unsigne
 	}
 
 	/* If there's something left, save it as a comment. */
-	rest_len=strlen(rest);
+	rest_len = rest ? strlen(rest) : 0;
 	if (rest_len > 0)
 	{
 		pb->comment = rest;
@@ -1,6 +1,7 @@
 #include "TCPServer.h" 
 
 string TCPServer::Message;
+int TCPServer::NotifyFd = -1;
 
 void* TCPServer::Task(void *arg)
 {
@@ -19,6 +20,11 @@ void* TCPServer::Task(void *arg)
 		msg[n]=0;
 		//send(newsockfd,msg,n,0);
 		Message = string(msg);
+		if(NotifyFd >= 0)
+		{
+			uint64_t one = 1;
+			if(write(NotifyFd,&one,sizeof(one)) < 0) { /* already pending */ }
+		}
 	}
 	return 0;
 }
@@ -63,6 +69,12 @@ void TCPServer::clean()
 //	memset(msg, 0, MAXPACKETSIZE);
 }
 
+// eventfd to signal on every received message
+void TCPServer::setNotify(int fd)
+{
+	NotifyFd = fd;
+}
+
 void TCPServer::detach()
 {
 	close(sockfd);
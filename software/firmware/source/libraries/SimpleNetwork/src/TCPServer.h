@@ -5,6 +5,7 @@
 #include <vector>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 #include <sys/types.h> 
@@ -27,6 +28,7 @@ class TCPServer
 	pthread_t serverThread;
 //	char msg[ MAXPACKETSIZE ];
 	static string Message;
+	static int NotifyFd;
 
 	void setup(int port);
 	string receive();
@@ -34,6 +36,7 @@ class TCPServer
 	void Send(string msg);
 	void detach();
 	void clean();
+	void setNotify(int fd);
 
 	private:
 	static void * Task(void * argv);
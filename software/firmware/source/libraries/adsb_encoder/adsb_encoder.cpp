@@ -1,6 +1,7 @@
 
 #include <math.h>
 #include <string.h>
+#include <stdint.h>
 #include "adsb_encoder.h"
 
 
@@ -11,13 +12,11 @@
 
 #define MODES_GENERATOR_POLY 0xfff409U
 
-#if !defined(ESP8266) && !defined(ESP32) && \
-    !defined(ENERGIA_ARCH_CC13XX) && !defined(ENERGIA_ARCH_CC13X2) && \
-    !defined(__ASR6501__) && !defined(ARDUINO_ARCH_STM32) && \
-    !defined(ARDUINO_ARCH_ASR650X) && !defined(ARDUINO_ARCH_RENESAS) && \
-    !defined(ARDUINO_ARCH_SILABS)
-static unsigned int crc_table[256];
-#else
+#if defined(ESP8266) || defined(ESP32) || \
+    defined(ENERGIA_ARCH_CC13XX) || defined(ENERGIA_ARCH_CC13X2) || \
+    defined(__ASR6501__) || defined(ARDUINO_ARCH_STM32) || \
+    defined(ARDUINO_ARCH_ASR650X) || defined(ARDUINO_ARCH_RENESAS) || \
+    defined(ARDUINO_ARCH_SILABS)
 #if defined(ESP8266) || defined(ESP32) || defined(__ASR6501__) || \
     defined(ARDUINO_ARCH_ASR650X)
 #include <pgmspace.h>
@@ -29,7 +28,14 @@ static unsigned int crc_table[256];
 #include <avr/pgmspace.h>
 #endif
 
-static const unsigned int crc_table[256] PROGMEM = 
+#define ADSB_PGM		PROGMEM
+#define ADSB_READ(x)	pgm_read_dword(&(x))
+#else
+#define ADSB_PGM
+#define ADSB_READ(x)	(x)
+#endif
+
+static const unsigned int crc_table[256] ADSB_PGM = 
 {
  0x000000, 0xFFF409, 0x001C1B, 0xFFE812, 0x003836, 0xFFCC3F, 0x00242D, 0xFFD024,
  0x00706C, 0xFF8465, 0x006C77, 0xFF987E, 0x00485A, 0xFFBC53, 0x005441, 0xFFA048,
@@ -64,7 +70,6 @@ static const unsigned int crc_table[256] PROGMEM =
  0x05A4C8, 0xFA50C1, 0x05B8D3, 0xFA4CDA, 0x059CFE, 0xFA68F7, 0x0580E5, 0xFA74EC,
  0x05D4A4, 0xFA20AD, 0x05C8BF, 0xFA3CB6, 0x05EC92, 0xFA189B, 0x05F089, 0xFA0480
 };
-#endif
 
 typedef struct cpr_pair
 {
@@ -77,154 +82,76 @@ unsigned int modes_crc(unsigned char *buf, size_t  len)
 	unsigned int rem = 0;
 	size_t  i;
 	for (rem = 0, i = len; i > 0; --i) {
-#if !defined(ESP8266) && !defined(ESP32) && \
-    !defined(ENERGIA_ARCH_CC13XX) && !defined(ENERGIA_ARCH_CC13X2) && \
-    !defined(__ASR6501__) && !defined(ARDUINO_ARCH_STM32) && \
-    !defined(ARDUINO_ARCH_ASR650X) && !defined(ARDUINO_ARCH_RENESAS) && \
-    !defined(ARDUINO_ARCH_SILABS)
-		rem = ((rem & 0x00ffff) << 8) ^ crc_table[*buf++ ^ ((rem & 0xff0000) >> 16)];
-#else
-		rem = ((rem & 0x00ffff) << 8) ^ pgm_read_dword(&crc_table[*buf++ ^ ((rem & 0xff0000) >> 16)]);
-#endif
+		rem = ((rem & 0x00ffff) << 8) ^ ADSB_READ(crc_table[*buf++ ^ ((rem & 0xff0000) >> 16)]);
 	}
 
 	return rem;
 }
 
 
-int    CPR_NL(double lat)
-{
-#if 0 
-	if (lat < 0)
-		lat =  -lat;
+/*
+ * Latitudes are fixed point "binary angles", 2^32 units per full turn.
+ * Then a CPR zone number and position within the zone are the integer and
+ * the fractional part of angle * NZ / 2^32, no floating point is involved.
+ */
+#define CPR_ANGLE_PER_DEG	(4294967296.0 / 360.0)
 
-	if (fabs(lat) >= 87.0)
-		return 1;
+/* |lat| where NL drops by one, from 59 at the equator to 1 beyond 87 deg */
+static const uint32_t cpr_nl_table[58] ADSB_PGM =
+{
+	0x07721755, 0x0A8B6304, 0x0CEEB550, 0x0EF448D7, 0x10BE3E9F, 0x125E1229,
+	0x13DE232C, 0x15453244, 0x1697EF0C, 0x17D9C23C, 0x190D3E36, 0x1A34622D,
+	0x1B50C479, 0x1C63AE77, 0x1D6E2F8D, 0x1E712A88, 0x1F6D5F4A, 0x206371E6,
+	0x2153F001, 0x223F54E9, 0x23260CC7, 0x24087723, 0x24E6E8E1, 0x25C1ADDF,
+	0x26990A49, 0x276D3BA2, 0x283E79B4, 0x290CF742, 0x29D8E2B2, 0x2AA2668A,
+	0x2B69A9E5, 0x2C2ED0D5, 0x2CF1FCB2, 0x2DB34C61, 0x2E72DC8C, 0x2F30C7D9,
+	0x2FED270D, 0x30A8112F, 0x31619BA1, 0x3219DA2F, 0x32D0DF13, 0x3386BAF3,
+	0x343B7CCB, 0x34EF31C6, 0x35A1E4F9, 0x36539EFB, 0x37046539, 0x37B438EB,
+	0x38631565, 0x3910ED49, 0x39BDA5B3, 0x3A690D68, 0x3B12CB8B, 0x3BBA3A96,
+	0x3C5E0E31, 0x3CFB4C0F, 0x3D89488A, 0x3DDDDDDE
+};
 
-	double U = 1 - cos(M_PI / (2 * latz));
-	double T = cos(M_PI / 180.0 * fabs(lat));
-	return static_cast<int>(floor(2.0*M_PI* 1.0 / (acos(1 - U / (T*T)))));
-#endif
+int CPR_NL_angle(uint32_t lat)
+{
+	int lo = 0, hi = sizeof(cpr_nl_table) / sizeof(cpr_nl_table[0]);
 
-	if (lat < 0) lat = -lat;
-	if (lat < 10.47047130) return 59;
-	if (lat < 14.82817437) return 58;
-	if (lat < 18.18626357) return 57;
-	if (lat < 21.02939493) return 56;
-	if (lat < 23.54504487) return 55;
-	if (lat < 25.82924707) return 54;
-	if (lat < 27.93898710) return 53;
-	if (lat < 29.91135686) return 52;
-	if (lat < 31.77209708) return 51;
-	if (lat < 33.53993436) return 50;
-	if (lat < 35.22899598) return 49;
-	if (lat < 36.85025108) return 48;
-	if (lat < 38.41241892) return 47;
-	if (lat < 39.92256684) return 46;
-	if (lat < 41.38651832) return 45;
-	if (lat < 42.80914012) return 44;
-	if (lat < 44.19454951) return 43;
-	if (lat < 45.54626723) return 42;
-	if (lat < 46.86733252) return 41;
-	if (lat < 48.16039128) return 40;
-	if (lat < 49.42776439) return 39;
-	if (lat < 50.67150166) return 38;
-	if (lat < 51.89342469) return 37;
-	if (lat < 53.09516153) return 36;
-	if (lat < 54.27817472) return 35;
-	if (lat < 55.44378444) return 34;
-	if (lat < 56.59318756) return 33;
-	if (lat < 57.72747354) return 32;
-	if (lat < 58.84763776) return 31;
-	if (lat < 59.95459277) return 30;
-	if (lat < 61.04917774) return 29;
-	if (lat < 62.13216659) return 28;
-	if (lat < 63.20427479) return 27;
-	if (lat < 64.26616523) return 26;
-	if (lat < 65.31845310) return 25;
-	if (lat < 66.36171008) return 24;
-	if (lat < 67.39646774) return 23;
-	if (lat < 68.42322022) return 22;
-	if (lat < 69.44242631) return 21;
-	if (lat < 70.45451075) return 20;
-	if (lat < 71.45986473) return 19;
-	if (lat < 72.45884545) return 18;
-	if (lat < 73.45177442) return 17;
-	if (lat < 74.43893416) return 16;
-	if (lat < 75.42056257) return 15;
-	if (lat < 76.39684391) return 14;
-	if (lat < 77.36789461) return 13;
-	if (lat < 78.33374083) return 12;
-	if (lat < 79.29428225) return 11;
-	if (lat < 80.24923213) return 10;
-	if (lat < 81.19801349) return 9;
-	if (lat < 82.13956981) return 8;
-	if (lat < 83.07199445) return 7;
-	if (lat < 83.99173563) return 6;
-	if (lat < 84.89166191) return 5;
-	if (lat < 85.75541621) return 4;
-	if (lat < 86.53536998) return 3;
-	if (lat < 87.00000000) return 2;
-	else return 1;
-	
-}
+	while (lo < hi) {
+		int mid = (lo + hi) / 2;
 
-int CPR_N(double lat, int odd)
-{
-	int nl = CPR_NL(lat) - (odd ? 1 : 0);
-	if (nl < 1)
-		nl = 1;
-	return nl;
+		if (lat >= ADSB_READ(cpr_nl_table[mid]))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
 
-}
-double CPR_MOD(double x, double y)
-{
-	return x - y*floor(x / y);
+	return 59 - lo;
 }
 
-double  CPR_DLAT(int odd, int surface)
+int    CPR_NL(double lat)
 {
-	double tmp = 0;
+	if (lat < 0) lat = -lat;
 
-	if (surface == 1)
-		tmp = 90.0;
-	else
-		tmp = 360.0;
-	double  nzcalc = (odd ? 59.0 : 60.0);
-	if (nzcalc == 0)
-		return tmp;
-	else
-		return tmp / nzcalc;
+	return CPR_NL_angle(static_cast<uint32_t>(lat * CPR_ANGLE_PER_DEG));
 }
-double  CPR_DLON(double rlat, int odd, int surface)
+
+cpr_pair_t cpr_encode_angle(int32_t lat, uint32_t lon, int odd, int surface)
 {
-	double tmp = 0;
+	int      bits  = surface ? 19 : 17;
+	uint64_t round = 1ULL << (31 - bits);
+	int      nz    = odd ? 59 : 60;
 
-	if (surface == 1)
-		tmp = 90.0;
-	else
-		tmp = 360.0;
-	double  nzcalc = CPR_N(rlat, odd);
-	if (nzcalc == 0)
-		return tmp;
-	else
-		return tmp / nzcalc;
-}
+	int64_t  y     = (int64_t) lat * nz;
+	uint32_t YZ    = static_cast<uint32_t>(((uint64_t) (uint32_t) y + round) >> (32 - bits));
 
+	/* latitude of the encoded position selects number of longitude zones */
+	int64_t  rlat  = (((y >> 32) * (1LL << bits) + YZ) * (1LL << 32)) / ((int64_t) nz << bits);
+	int      ni    = CPR_NL_angle(static_cast<uint32_t>(rlat < 0 ? -rlat : rlat)) - (odd ? 1 : 0);
 
+	if (ni < 1)
+		ni = 1;
 
-cpr_pair_t cpr_encode(double lat, double lon, int odd, int surface)
-{
-	double NbPow = 0;
-	if (surface)
-		NbPow = pow(2.0, 19);
-	else
-		NbPow = pow(2.0, 17); 
-	double Dlat = CPR_DLAT(odd, 0);
-	unsigned int YZ = static_cast<unsigned int>(floor(NbPow*CPR_MOD(lat, Dlat) / Dlat + 0.5));
-	double Rlat = Dlat*(1.0*YZ / NbPow + floor(lat / Dlat));
-	double Dlon = CPR_DLON(Rlat, odd, 0);
-	unsigned int XZ = static_cast<unsigned int>(floor(NbPow*CPR_MOD(lon, Dlon) / Dlon + 0.5));
+	uint32_t x     = lon * (uint32_t) ni;
+	uint32_t XZ    = static_cast<uint32_t>(((uint64_t) x + round) >> (32 - bits));
 
 	cpr_pair_t v;
 	v.YZ = YZ & 0x1FFFF;
@@ -232,6 +159,14 @@ cpr_pair_t cpr_encode(double lat, double lon, int odd, int surface)
 	return v;
 }
 
+cpr_pair_t cpr_encode(double lat, double lon, int odd, int surface)
+{
+	int32_t  a = static_cast<int32_t>(floor(lat * CPR_ANGLE_PER_DEG + 0.5));
+	uint32_t b = static_cast<uint32_t>(static_cast<int64_t>(floor(lon * CPR_ANGLE_PER_DEG + 0.5)));
+
+	return cpr_encode_angle(a, b, odd, surface);
+}
+
 unsigned int encode_altitude(double ft)
 {
 	unsigned int i = static_cast<unsigned int>((ft + 1012.5) / 25);
@@ -637,26 +572,7 @@ frame_data_t make_velocity_frame(unsigned int addr,
 
 int modescrc_module_init()
 {
-#if !defined(ESP8266) && !defined(ESP32) && \
-    !defined(ENERGIA_ARCH_CC13XX) && !defined(ENERGIA_ARCH_CC13X2) && \
-    !defined(__ASR6501__) && !defined(ARDUINO_ARCH_STM32) && \
-    !defined(ARDUINO_ARCH_ASR650X) && !defined(ARDUINO_ARCH_RENESAS) && \
-    !defined(ARDUINO_ARCH_SILABS)
-	int i;
-
-	for (i = 0; i < 256; ++i) {
-		unsigned int  c = i << 16;
-		int j;
-		for (j = 0; j < 8; ++j) {
-			if (c & 0x800000)
-				c = (c << 1) ^ MODES_GENERATOR_POLY;
-			else
-				c = (c << 1);
-		}
-
-		crc_table[i] = c & 0x00ffffff;
-	}
-#endif
+	/* CRC table is a constant now */
 	return 0;
 }
 
@@ -340,6 +340,14 @@ static struct {
 #endif
 } state;
 
+// Shadow copy of the FSK packet engine registers (0x00 - 0x3F).
+// Rx/Tx setup only talks SPI for the values that actually differ,
+// which keeps a protocol switch between two receive windows short.
+// The shadow is dropped on reset and whenever the LoRa modem gets configured
+// because the same addresses then map onto the LoRa register page.
+static u1_t fskRegShadow[0x40];
+static uint64_t fskRegValid;
+
 // ----------------------------------------
 static void writeReg (u1_t addr, u1_t data) {
     hal_spi_select(1);
@@ -348,6 +356,17 @@ static void writeReg (u1_t addr, u1_t data) {
     hal_spi_select(0);
 }
 
+static void writeRegFSK (u1_t addr, u1_t data) {
+    uint64_t bit = (uint64_t) 1 << addr;
+
+    if ((fskRegValid & bit) && fskRegShadow[addr] == data) {
+        return;
+    }
+    writeReg(addr, data);
+    fskRegShadow[addr] = data;
+    fskRegValid |= bit;
+}
+
 #define FIFO_Push_Inv(x)      writeReg(RegFifo, (u1_t)~(x))
 
 static u1_t readReg (u1_t addr) {
@@ -565,8 +584,8 @@ static void txcw (void) {
     writeReg(RegOpMode, OPMODE_FSK_STANDBY);
 
     // set frequency deviation
-    writeReg(FSKRegFdevMsb, 0x00);
-    writeReg(FSKRegFdevLsb, 0x00);
+    writeRegFSK(FSKRegFdevMsb, 0x00);
+    writeRegFSK(FSKRegFdevLsb, 0x00);
 
     // configure frequency
     configChannel();
@@ -578,7 +597,7 @@ static void txcw (void) {
     writeReg(LORARegModemConfig2, readReg(LORARegModemConfig2) | 0x08);
 
     // initialize the payload size and address pointers
-    writeReg(FSKRegPayloadLength, 1);
+    writeRegFSK(FSKRegPayloadLength, 1);
     writeReg(RegFifo, 0);
 
     // enable antenna switch for TX
@@ -607,14 +626,14 @@ static void txfsk (void) {
     switch (LMIC.protocol->bitrate)
     {
     case RF_BITRATE_38400:
-      writeReg(FSKRegBitrateMsb, 0x03); // 38400 bps
-      writeReg(FSKRegBitrateLsb, 0x41);
+      writeRegFSK(FSKRegBitrateMsb, 0x03); // 38400 bps
+      writeRegFSK(FSKRegBitrateLsb, 0x41);
       writeReg(RegBitRateFrac,   0x05);
       break;
     case RF_BITRATE_100KBPS:
     default:
-      writeReg(FSKRegBitrateMsb, 0x01); // 100 kbps
-      writeReg(FSKRegBitrateLsb, 0x40);
+      writeRegFSK(FSKRegBitrateMsb, 0x01); // 100 kbps
+      writeRegFSK(FSKRegBitrateLsb, 0x40);
       writeReg(RegBitRateFrac,   0x00);
       break;
     }
@@ -623,28 +642,28 @@ static void txfsk (void) {
     switch (LMIC.protocol->deviation)
     {
     case RF_FREQUENCY_DEVIATION_9_6KHZ:
-      writeReg(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
-      writeReg(FSKRegFdevLsb, 0x9d);
+      writeRegFSK(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9d);
       break;
     case RF_FREQUENCY_DEVIATION_19_2KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
-      writeReg(FSKRegFdevLsb, 0x3b);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
+      writeRegFSK(FSKRegFdevLsb, 0x3b);
       break;
     case RF_FREQUENCY_DEVIATION_25KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 25kHz
-      writeReg(FSKRegFdevLsb, 0x9a);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 25kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9a);
       break;
     case RF_FREQUENCY_DEVIATION_50KHZ:
     default:
-      writeReg(FSKRegFdevMsb, 0x03); // +/- 50kHz
-      writeReg(FSKRegFdevLsb, 0x33);
+      writeRegFSK(FSKRegFdevMsb, 0x03); // +/- 50kHz
+      writeRegFSK(FSKRegFdevLsb, 0x33);
       break;
     }
 
     // frame and packet handler settings
-    writeReg(FSKRegPreambleMsb, 0x00);
+    writeRegFSK(FSKRegPreambleMsb, 0x00);
     /* add extra preamble symbol at Tx to ease reception on partner's side */
-    writeReg(FSKRegPreambleLsb, LMIC.protocol->preamble_size > 2 ?
+    writeRegFSK(FSKRegPreambleLsb, LMIC.protocol->preamble_size > 2 ?
       LMIC.protocol->preamble_size : LMIC.protocol->preamble_size + 1);
 
     // set preamble
@@ -652,11 +671,11 @@ static void txfsk (void) {
     switch (LMIC.protocol->preamble_type)
     {
     case RF_PREAMBLE_TYPE_AA:
-      writeReg(FSKRegSyncConfig, (0x10 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x10 | SyncConfig));
       break;
     case RF_PREAMBLE_TYPE_55:
     default:
-      writeReg(FSKRegSyncConfig, (0x30 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x30 | SyncConfig));
       break;
     }
 
@@ -664,20 +683,20 @@ static void txfsk (void) {
     switch (LMIC.protocol->whitening)
     {
     case RF_WHITENING_MANCHESTER:
-      writeReg(FSKRegPacketConfig1, 0x20);
+      writeRegFSK(FSKRegPacketConfig1, 0x20);
       break;
     case RF_WHITENING_NONE:
     case RF_WHITENING_NICERF:
     default:
-      writeReg(FSKRegPacketConfig1, 0x00);
+      writeRegFSK(FSKRegPacketConfig1, 0x00);
       break;
     }
-    writeReg(FSKRegPacketConfig2, 0x40);
+    writeRegFSK(FSKRegPacketConfig2, 0x40);
 
     // set syncword
     int i=0;
     for (i=0; i < LMIC.protocol->syncword_size; i++) {
-      writeReg((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
+      writeRegFSK((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
     }
 
     // configure frequency
@@ -690,10 +709,10 @@ static void txfsk (void) {
     writeReg(RegDioMapping1, MAP1_FSK_DIO0_TXDONE | MAP1_FSK_DIO1_NOP | MAP1_FSK_DIO2_TXNOP);
 
     // setup FIFO
-    writeReg(FSKRegFifoThresh, RF_FIFOTHRESH_TXSTARTCONDITION_FIFONOTEMPTY );
+    writeRegFSK(FSKRegFifoThresh, RF_FIFOTHRESH_TXSTARTCONDITION_FIFONOTEMPTY );
 
     // initialize the payload size and address pointers
-    writeReg(FSKRegPayloadLength, LMIC.dataLen); // (insert length byte into payload))
+    writeRegFSK(FSKRegPayloadLength, LMIC.dataLen); // (insert length byte into payload))
 
     switch (LMIC.protocol->payload_type)
     {
@@ -720,6 +739,7 @@ static void txlora (void) {
     // select LoRa modem (from sleep mode)
     writeReg(RegOpMode, OPMODE_LORA_SLEEP);
     ASSERT(readReg(RegOpMode) == OPMODE_LORA_SLEEP);
+    fskRegValid = 0;
 
     // power-up tcxo
     power_tcxo();
@@ -790,6 +810,7 @@ static void rxlora (bool rxcontinuous) {
     // select LoRa modem (from sleep mode)
     writeReg(RegOpMode, OPMODE_LORA_SLEEP);
     ASSERT(readReg(RegOpMode) == OPMODE_LORA_SLEEP);
+    fskRegValid = 0;
 
     // power-up tcxo
     power_tcxo();
@@ -896,13 +917,13 @@ static void rxfsk (bool rxcontinuous) {
     switch (LMIC.protocol->bitrate)
     {
     case RF_BITRATE_38400:
-      writeReg(FSKRegBitrateMsb, 0x03); // 38400 bps
-      writeReg(FSKRegBitrateLsb, 0x41);
+      writeRegFSK(FSKRegBitrateMsb, 0x03); // 38400 bps
+      writeRegFSK(FSKRegBitrateLsb, 0x41);
       break;
     case RF_BITRATE_100KBPS:
     default:
-      writeReg(FSKRegBitrateMsb, 0x01); // 100kbps
-      writeReg(FSKRegBitrateLsb, 0x40);
+      writeRegFSK(FSKRegBitrateMsb, 0x01); // 100kbps
+      writeRegFSK(FSKRegBitrateLsb, 0x40);
       break;
     }
 
@@ -916,37 +937,37 @@ static void rxfsk (bool rxcontinuous) {
 
     // configure receiver
     //writeReg(FSKRegRxConfig, 0x1E); // AFC auto, AGC, trigger on preamble?!?
-    writeReg(FSKRegRxConfig, 0x0E); // AFC off, AGC on, trigger on preamble?!?
+    writeRegFSK(FSKRegRxConfig, 0x0E); // AFC off, AGC on, trigger on preamble?!?
     //writeReg(FSKRegRxConfig, 0x06); // AFC off, AGC off, trigger on preamble?!?
 
     // set receiver bandwidth
     switch (LMIC.protocol->bandwidth)
     {
     case RF_RX_BANDWIDTH_SS_50KHZ:
-      writeReg(FSKRegRxBw, 0x0B); // 50kHz SSb
+      writeRegFSK(FSKRegRxBw, 0x0B); // 50kHz SSb
       break;
     case RF_RX_BANDWIDTH_SS_100KHZ:
-      writeReg(FSKRegRxBw, 0x0A); // 100kHz SSb
+      writeRegFSK(FSKRegRxBw, 0x0A); // 100kHz SSb
       break;
     case RF_RX_BANDWIDTH_SS_166KHZ:
-      writeReg(FSKRegRxBw, 0x11); // 166.6kHz SSB
+      writeRegFSK(FSKRegRxBw, 0x11); // 166.6kHz SSB
       break;
     case RF_RX_BANDWIDTH_SS_200KHZ:
-      writeReg(FSKRegRxBw, 0x09); // 200kHz SSB
+      writeRegFSK(FSKRegRxBw, 0x09); // 200kHz SSB
       break;
     case RF_RX_BANDWIDTH_SS_250KHZ:
-      writeReg(FSKRegRxBw, 0x01); // 250kHz SSB
+      writeRegFSK(FSKRegRxBw, 0x01); // 250kHz SSB
       break;
     case RF_RX_BANDWIDTH_SS_125KHZ:
     default:
-      writeReg(FSKRegRxBw, 0x02); // 125kHz SSb; BW >= (DR + 2 X FDEV)
+      writeRegFSK(FSKRegRxBw, 0x02); // 125kHz SSb; BW >= (DR + 2 X FDEV)
       break;
     }
 
     // set AFC bandwidth
 //    writeReg(FSKRegAfcBw, 0x0B); // 50kHz SSB  // PAW
 //    writeReg(FSKRegAfcBw, 0x12); // 83.3kHz SSB
-      writeReg(FSKRegAfcBw, 0x11); // 166.6kHz SSB
+      writeRegFSK(FSKRegAfcBw, 0x11); // 166.6kHz SSB
 //    writeReg(FSKRegAfcBw, 0x09); // 200kHz SSB
 //    writeReg(FSKRegAfcBw, 0x01); // 250kHz SSB
 
@@ -957,17 +978,17 @@ static void rxfsk (bool rxcontinuous) {
       //writeReg(FSKRegPreambleDetect, 0x05); // disable, 5 chip errors
     case 1:
       // Legacy, OGNTP
-      writeReg(FSKRegPreambleDetect, 0x85); // enable, 1 bytes, 5 chip errors
+      writeRegFSK(FSKRegPreambleDetect, 0x85); // enable, 1 bytes, 5 chip errors
       break;
     case 2:
-      writeReg(FSKRegPreambleDetect, 0xAA); // enable, 2 bytes, 10 chip errors
+      writeRegFSK(FSKRegPreambleDetect, 0xAA); // enable, 2 bytes, 10 chip errors
       break;
     case 3:
     case 4:
     case 5:
     default:
       // PAW
-      writeReg(FSKRegPreambleDetect, 0xCA); // enable, 3 bytes, 10 chip errors
+      writeRegFSK(FSKRegPreambleDetect, 0xCA); // enable, 3 bytes, 10 chip errors
       break;
     }
 
@@ -976,36 +997,36 @@ static void rxfsk (bool rxcontinuous) {
     switch (LMIC.protocol->preamble_type)
     {
     case RF_PREAMBLE_TYPE_AA:
-      writeReg(FSKRegSyncConfig, (0x10 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x10 | SyncConfig));
       break;
     case RF_PREAMBLE_TYPE_55:
     default:
-      writeReg(FSKRegSyncConfig, (0x30 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x30 | SyncConfig));
       break;
     }
 
     // set sync value
     int i=0;
     for (i=0; i < LMIC.protocol->syncword_size; i++) {
-      writeReg((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
+      writeRegFSK((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
     }
 
     // set packet config
     switch (LMIC.protocol->whitening)
     {
     case RF_WHITENING_MANCHESTER:
-      writeReg(FSKRegPacketConfig1, 0x20);
+      writeRegFSK(FSKRegPacketConfig1, 0x20);
       break;
     case RF_WHITENING_NONE:
     case RF_WHITENING_NICERF:
     default:
-      writeReg(FSKRegPacketConfig1, 0x00);
+      writeRegFSK(FSKRegPacketConfig1, 0x00);
       break;
     }
-    writeReg(FSKRegPacketConfig2, 0x40); // packet mode
+    writeRegFSK(FSKRegPacketConfig2, 0x40); // packet mode
 
     // set payload length
-    writeReg(FSKRegPayloadLength,
+    writeRegFSK(FSKRegPayloadLength,
       LMIC.protocol->payload_size +
       LMIC.protocol->payload_offset +
       LMIC.protocol->crc_size);
@@ -1014,21 +1035,21 @@ static void rxfsk (bool rxcontinuous) {
     switch (LMIC.protocol->deviation)
     {
     case RF_FREQUENCY_DEVIATION_9_6KHZ:
-      writeReg(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
-      writeReg(FSKRegFdevLsb, 0x9d);
+      writeRegFSK(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9d);
       break;
     case RF_FREQUENCY_DEVIATION_19_2KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
-      writeReg(FSKRegFdevLsb, 0x3b);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
+      writeRegFSK(FSKRegFdevLsb, 0x3b);
       break;
     case RF_FREQUENCY_DEVIATION_25KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 25kHz
-      writeReg(FSKRegFdevLsb, 0x9a);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 25kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9a);
       break;
     case RF_FREQUENCY_DEVIATION_50KHZ:
     default:
-      writeReg(FSKRegFdevMsb, 0x03); // +/- 50kHz
-      writeReg(FSKRegFdevLsb, 0x33);
+      writeRegFSK(FSKRegFdevMsb, 0x03); // +/- 50kHz
+      writeRegFSK(FSKRegFdevLsb, 0x33);
       break;
     }
 
@@ -1140,6 +1161,7 @@ static void sx127x_radio_init (void) {
 
     // reset radio (FSK/STANDBY)
     sx127x_radio_reset();
+    fskRegValid = 0;
 
     // go to SLEEP mode
     writeReg(RegOpMode, OPMODE_FSK_SLEEP);
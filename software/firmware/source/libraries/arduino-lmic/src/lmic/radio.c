@@ -318,6 +318,25 @@ static u1_t randbuf[16];
 
 //#define FIFO_Push_Inv(x)              writeReg(RegFifo, (u1_t)~(x))
 
+// Shadow copy of the FSK packet engine registers (0x00 - 0x3F).
+// Rx/Tx setup only talks SPI for the values that actually differ,
+// which keeps a protocol switch between two receive windows short.
+// The shadow is dropped on reset and whenever the LoRa modem is selected
+// because the same addresses then map onto the LoRa register page.
+static u1_t fskRegShadow[0x40];
+static uint64_t fskRegValid;
+
+static void writeRegFSK (u1_t addr, u1_t data) {
+    uint64_t bit = (uint64_t) 1 << addr;
+
+    if ((fskRegValid & bit) && fskRegShadow[addr] == data) {
+        return;
+    }
+    writeReg(addr, data);
+    fskRegShadow[addr] = data;
+    fskRegValid |= bit;
+}
+
 static void opmode (u1_t mode) {
 #if defined(ENERGIA_ARCH_CC13XX) || defined(ENERGIA_ARCH_CC13X2) || defined(RASPBERRY_PI)
     delay(1);
@@ -328,6 +347,7 @@ static void opmode (u1_t mode) {
 
 static void opmodeLora() {
     u1_t u = OPMODE_LORA;
+    fskRegValid = 0;
 #ifdef CFG_sx1276_radio
     if (LMIC.freq <= SX127X_FREQ_LF_MAX) {
         u |= OPMODE_LORA_SX1276_LowFrequencyModeOn;
@@ -503,14 +523,14 @@ static void txfsk () {
     switch (LMIC.protocol->bitrate)
     {
     case RF_BITRATE_38400:
-      writeReg(FSKRegBitrateMsb, 0x03); // 38400 bps
-      writeReg(FSKRegBitrateLsb, 0x41);
+      writeRegFSK(FSKRegBitrateMsb, 0x03); // 38400 bps
+      writeRegFSK(FSKRegBitrateLsb, 0x41);
       writeReg(RegBitRateFrac,   0x05);
       break;
     case RF_BITRATE_100KBPS:
     default:
-      writeReg(FSKRegBitrateMsb, 0x01); // 100 kbps
-      writeReg(FSKRegBitrateLsb, 0x40);
+      writeRegFSK(FSKRegBitrateMsb, 0x01); // 100 kbps
+      writeRegFSK(FSKRegBitrateLsb, 0x40);
       writeReg(RegBitRateFrac,   0x00);
       break;
     }
@@ -519,58 +539,58 @@ static void txfsk () {
     switch (LMIC.protocol->deviation)
     {
     case RF_FREQUENCY_DEVIATION_9_6KHZ:
-      writeReg(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
-      writeReg(FSKRegFdevLsb, 0x9d);
+      writeRegFSK(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9d);
       break;
     case RF_FREQUENCY_DEVIATION_19_2KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
-      writeReg(FSKRegFdevLsb, 0x3b);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
+      writeRegFSK(FSKRegFdevLsb, 0x3b);
       break;
     case RF_FREQUENCY_DEVIATION_25KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 25kHz
-      writeReg(FSKRegFdevLsb, 0x9a);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 25kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9a);
       break;
     case RF_FREQUENCY_DEVIATION_50KHZ:
     default:
-      writeReg(FSKRegFdevMsb, 0x03); // +/- 50kHz
-      writeReg(FSKRegFdevLsb, 0x33);
+      writeRegFSK(FSKRegFdevMsb, 0x03); // +/- 50kHz
+      writeRegFSK(FSKRegFdevLsb, 0x33);
       break;
     }
 
     // frame and packet handler settings
-    writeReg(FSKRegPreambleMsb, 0x00);
+    writeRegFSK(FSKRegPreambleMsb, 0x00);
     /* add extra preamble symbol at Tx to ease reception on partner's side */
-    writeReg(FSKRegPreambleLsb, LMIC.protocol->preamble_size > 2 ?
+    writeRegFSK(FSKRegPreambleLsb, LMIC.protocol->preamble_size > 2 ?
       LMIC.protocol->preamble_size : LMIC.protocol->preamble_size + 1);
 
     uint8_t SyncConfig = (LMIC.protocol->syncword_size - 1);
     switch (LMIC.protocol->preamble_type)
     {
     case RF_PREAMBLE_TYPE_AA:
-      writeReg(FSKRegSyncConfig, (0x10 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x10 | SyncConfig));
       break;
     case RF_PREAMBLE_TYPE_55:
     default:
-      writeReg(FSKRegSyncConfig, (0x30 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x30 | SyncConfig));
       break;
     }
 
     switch (LMIC.protocol->whitening)
     {
     case RF_WHITENING_MANCHESTER:
-      writeReg(FSKRegPacketConfig1, 0x20);
+      writeRegFSK(FSKRegPacketConfig1, 0x20);
       break;
     case RF_WHITENING_NONE:
     case RF_WHITENING_NICERF:
     default:
-      writeReg(FSKRegPacketConfig1, 0x00);
+      writeRegFSK(FSKRegPacketConfig1, 0x00);
       break;
     }
-    writeReg(FSKRegPacketConfig2, 0x40);
+    writeRegFSK(FSKRegPacketConfig2, 0x40);
 
     int i=0;
     for (i=0; i < LMIC.protocol->syncword_size; i++) {
-      writeReg((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
+      writeRegFSK((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
     }
 
     // configure frequency
@@ -583,10 +603,10 @@ static void txfsk () {
     writeReg(RegDioMapping1, MAP_DIO0_FSK_READY|MAP_DIO1_FSK_NOP|MAP_DIO2_FSK_TXNOP);
 
     // initialize the payload size and address pointers
-    writeReg(FSKRegPayloadLength, LMIC.dataLen); // (insert length byte into payload))
+    writeRegFSK(FSKRegPayloadLength, LMIC.dataLen); // (insert length byte into payload))
 
 
-    writeReg(FSKRegFifoThresh, RF_FIFOTHRESH_TXSTARTCONDITION_FIFONOTEMPTY  );
+    writeRegFSK(FSKRegFifoThresh, RF_FIFOTHRESH_TXSTARTCONDITION_FIFONOTEMPTY  );
 
     switch (LMIC.protocol->payload_type)
     {
@@ -789,37 +809,37 @@ static void rxfsk (u1_t rxmode) {
 
     // configure receiver
     //writeReg(FSKRegRxConfig, 0x1E); // AFC auto, AGC, trigger on preamble?!?
-    writeReg(FSKRegRxConfig, 0x0E); // AFC off, AGC on, trigger on preamble?!?
+    writeRegFSK(FSKRegRxConfig, 0x0E); // AFC off, AGC on, trigger on preamble?!?
     //writeReg(FSKRegRxConfig, 0x06); // AFC off, AGC off, trigger on preamble?!?
 
     // set receiver bandwidth
     switch (LMIC.protocol->bandwidth)
     {
     case RF_RX_BANDWIDTH_SS_50KHZ:
-      writeReg(FSKRegRxBw, 0x0B); // 50kHz SSb
+      writeRegFSK(FSKRegRxBw, 0x0B); // 50kHz SSb
       break;
     case RF_RX_BANDWIDTH_SS_100KHZ:
-      writeReg(FSKRegRxBw, 0x0A); // 100kHz SSb
+      writeRegFSK(FSKRegRxBw, 0x0A); // 100kHz SSb
       break;
     case RF_RX_BANDWIDTH_SS_166KHZ:
-      writeReg(FSKRegRxBw, 0x11); // 166.6kHz SSB
+      writeRegFSK(FSKRegRxBw, 0x11); // 166.6kHz SSB
       break;
     case RF_RX_BANDWIDTH_SS_200KHZ:
-      writeReg(FSKRegRxBw, 0x09); // 200kHz SSB
+      writeRegFSK(FSKRegRxBw, 0x09); // 200kHz SSB
       break;
     case RF_RX_BANDWIDTH_SS_250KHZ:
-      writeReg(FSKRegRxBw, 0x01); // 250kHz SSB
+      writeRegFSK(FSKRegRxBw, 0x01); // 250kHz SSB
       break;
     case RF_RX_BANDWIDTH_SS_125KHZ:
     default:
-      writeReg(FSKRegRxBw, 0x02); // 125kHz SSb; BW >= (DR + 2 X FDEV)
+      writeRegFSK(FSKRegRxBw, 0x02); // 125kHz SSb; BW >= (DR + 2 X FDEV)
       break;
     }
 
     // set AFC bandwidth
 //    writeReg(FSKRegAfcBw, 0x0B); // 50kHz SSB  // PAW
 //    writeReg(FSKRegAfcBw, 0x12); // 83.3kHz SSB
-      writeReg(FSKRegAfcBw, 0x11); // 166.6kHz SSB
+      writeRegFSK(FSKRegAfcBw, 0x11); // 166.6kHz SSB
 //    writeReg(FSKRegAfcBw, 0x09); // 200kHz SSB
 //    writeReg(FSKRegAfcBw, 0x01); // 250kHz SSB
 
@@ -830,17 +850,17 @@ static void rxfsk (u1_t rxmode) {
       //writeReg(FSKRegPreambleDetect, 0x05); // disable, 5 chip errors
     case 1:
       // Legacy, OGNTP
-      writeReg(FSKRegPreambleDetect, 0x85); // enable, 1 bytes, 5 chip errors
+      writeRegFSK(FSKRegPreambleDetect, 0x85); // enable, 1 bytes, 5 chip errors
       break;
     case 2:
-      writeReg(FSKRegPreambleDetect, 0xAA); // enable, 2 bytes, 10 chip errors
+      writeRegFSK(FSKRegPreambleDetect, 0xAA); // enable, 2 bytes, 10 chip errors
       break;
     case 3:
     case 4:
     case 5:
     default:
       // PAW
-      writeReg(FSKRegPreambleDetect, 0xCA); // enable, 3 bytes, 10 chip errors
+      writeRegFSK(FSKRegPreambleDetect, 0xCA); // enable, 3 bytes, 10 chip errors
       break;
     }
 
@@ -849,11 +869,11 @@ static void rxfsk (u1_t rxmode) {
     switch (LMIC.protocol->preamble_type)
     {
     case RF_PREAMBLE_TYPE_AA:
-      writeReg(FSKRegSyncConfig, (0x10 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x10 | SyncConfig));
       break;
     case RF_PREAMBLE_TYPE_55:
     default:
-      writeReg(FSKRegSyncConfig, (0x30 | SyncConfig));
+      writeRegFSK(FSKRegSyncConfig, (0x30 | SyncConfig));
       break;
     }
 
@@ -861,17 +881,17 @@ static void rxfsk (u1_t rxmode) {
     switch (LMIC.protocol->whitening)
     {
     case RF_WHITENING_MANCHESTER:
-      writeReg(FSKRegPacketConfig1, 0x20);
+      writeRegFSK(FSKRegPacketConfig1, 0x20);
       break;
     case RF_WHITENING_NONE:
     case RF_WHITENING_NICERF:
     default:
-      writeReg(FSKRegPacketConfig1, 0x00);
+      writeRegFSK(FSKRegPacketConfig1, 0x00);
       break;
     }
-    writeReg(FSKRegPacketConfig2, 0x40); // packet mode
+    writeRegFSK(FSKRegPacketConfig2, 0x40); // packet mode
 
-    writeReg(FSKRegPayloadLength,
+    writeRegFSK(FSKRegPayloadLength,
       LMIC.protocol->payload_size +
       LMIC.protocol->payload_offset +
       LMIC.protocol->crc_size);
@@ -879,7 +899,7 @@ static void rxfsk (u1_t rxmode) {
     // set sync value
     int i=0;
     for (i=0; i < LMIC.protocol->syncword_size; i++) {
-      writeReg((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
+      writeRegFSK((FSKRegSyncValue1 + i), LMIC.protocol->syncword[i]);
     }
 
     // set preamble timeout
@@ -888,13 +908,13 @@ static void rxfsk (u1_t rxmode) {
     switch (LMIC.protocol->bitrate)
     {
     case RF_BITRATE_38400:
-      writeReg(FSKRegBitrateMsb, 0x03); // 38400 bps
-      writeReg(FSKRegBitrateLsb, 0x41);
+      writeRegFSK(FSKRegBitrateMsb, 0x03); // 38400 bps
+      writeRegFSK(FSKRegBitrateLsb, 0x41);
       break;
     case RF_BITRATE_100KBPS:
     default:
-      writeReg(FSKRegBitrateMsb, 0x01); // 100kbps
-      writeReg(FSKRegBitrateLsb, 0x40);
+      writeRegFSK(FSKRegBitrateMsb, 0x01); // 100kbps
+      writeRegFSK(FSKRegBitrateLsb, 0x40);
       break;
     }
 
@@ -902,21 +922,21 @@ static void rxfsk (u1_t rxmode) {
     switch (LMIC.protocol->deviation)
     {
     case RF_FREQUENCY_DEVIATION_9_6KHZ:
-      writeReg(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
-      writeReg(FSKRegFdevLsb, 0x9d);
+      writeRegFSK(FSKRegFdevMsb, 0x00); // +/- 9.6kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9d);
       break;
     case RF_FREQUENCY_DEVIATION_19_2KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
-      writeReg(FSKRegFdevLsb, 0x3b);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 19.2kHz
+      writeRegFSK(FSKRegFdevLsb, 0x3b);
       break;
     case RF_FREQUENCY_DEVIATION_25KHZ:
-      writeReg(FSKRegFdevMsb, 0x01); // +/- 25kHz
-      writeReg(FSKRegFdevLsb, 0x9a);
+      writeRegFSK(FSKRegFdevMsb, 0x01); // +/- 25kHz
+      writeRegFSK(FSKRegFdevLsb, 0x9a);
       break;
     case RF_FREQUENCY_DEVIATION_50KHZ:
     default:
-      writeReg(FSKRegFdevMsb, 0x03); // +/- 50kHz
-      writeReg(FSKRegFdevLsb, 0x33);
+      writeRegFSK(FSKRegFdevMsb, 0x03); // +/- 50kHz
+      writeRegFSK(FSKRegFdevLsb, 0x33);
       break;
     }
 
@@ -962,6 +982,7 @@ void radio_init () {
     hal_waitUntil(os_getTime()+ms2osticks(1)); // wait >100us
     hal_pin_rst(2); // configure RST pin floating!
     hal_waitUntil(os_getTime()+ms2osticks(5)); // wait 5ms
+    fskRegValid = 0;
 
     // power-down TCXO
     hal_pin_tcxo(0);
@@ -28,6 +28,8 @@
 #include <string.h>
 #include <pthread.h>
 #include <assert.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 static pthread_mutex_t fifo_mutex = PTHREAD_MUTEX_INITIALIZER;        // mutex protecting the queues
 static pthread_cond_t fifo_notempty_cond = PTHREAD_COND_INITIALIZER;  // condition used to signal FIFO-not-empty
@@ -37,6 +39,7 @@ static struct mag_buf *fifo_head;          // head of queued buffers awaiting de
 static struct mag_buf *fifo_tail;          // tail of queued buffers awaiting demodulation
 static struct mag_buf *fifo_freelist;      // freelist of preallocated buffers
 static bool fifo_halted;                   // true if queue has been halted
+static int fifo_evfd = -1;                 // eventfd, readable while buffers are queued
 
 static unsigned overlap_length;     // desired overlap size in samples (size of overlap_buffer)
 static uint16_t *overlap_buffer;    // buffer used to save overlapping data
@@ -44,6 +47,9 @@ static uint16_t *overlap_buffer;    // buffer used to save overlapping data
 // Create the queue structures. Not threadsafe.
 bool fifo_create(unsigned buffer_count, unsigned buffer_size, unsigned overlap)
 {
+    if (fifo_evfd < 0)
+        fifo_evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
     if (!(overlap_buffer = calloc(overlap, sizeof(overlap_buffer[0]))))
         goto nomem;
 
@@ -92,6 +98,34 @@ void fifo_destroy()
 
     free(overlap_buffer);
     overlap_buffer = NULL;
+
+    if (fifo_evfd >= 0) {
+        close(fifo_evfd);
+        fifo_evfd = -1;
+    }
+}
+
+static void fifo_notify()
+{
+    uint64_t one = 1;
+
+    if (fifo_evfd >= 0 && write(fifo_evfd, &one, sizeof(one)) < 0) {
+        // counter is already non-zero, the reader is going to wake anyway
+    }
+}
+
+int fifo_notify_fd()
+{
+    return fifo_evfd;
+}
+
+void fifo_notify_clear()
+{
+    uint64_t count;
+
+    if (fifo_evfd >= 0 && read(fifo_evfd, &count, sizeof(count)) < 0) {
+        // nothing was pending
+    }
 }
 
 void fifo_drain()
@@ -123,6 +157,7 @@ void fifo_halt()
     pthread_cond_broadcast(&fifo_notempty_cond);
     pthread_cond_broadcast(&fifo_empty_cond);
     pthread_cond_broadcast(&fifo_free_cond);
+    fifo_notify();
     pthread_mutex_unlock(&fifo_mutex);
 }
 
@@ -203,6 +238,7 @@ void fifo_enqueue(struct mag_buf *buf)
         fifo_tail->next = buf;
         fifo_tail = buf;
     }
+    fifo_notify();
 
  done:
     pthread_mutex_unlock(&fifo_mutex);
@@ -120,6 +120,12 @@ struct mag_buf *fifo_dequeue(uint32_t timeout_ms);
 // Release a buffer previously returned by fifo_acquire() or fifo_pop() back to the freelist.
 void fifo_release(struct mag_buf *buf);
 
+// An eventfd that becomes readable when a buffer is enqueued or the FIFO is halted,
+// for a consumer that waits in poll()/epoll() instead of fifo_dequeue().
+// fifo_notify_clear() resets it; call it before draining the FIFO.
+int fifo_notify_fd();
+void fifo_notify_clear();
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -170,11 +170,12 @@ void *readerThreadEntryPoint(void *arg)
 void ModeS_demod_loop(mode_s_callback_t cb)
 {
    if (!state.exit) {
-        // get the next sample buffer off the FIFO; wait only up to 100ms
-        // this is fairly aggressive as all our network I/O runs out of the background work!
-        struct mag_buf *buf = fifo_dequeue(100 /* milliseconds */);
+        struct mag_buf *buf;
 
-        if (buf) {
+        // the caller waits on fifo_notify_fd(), so take what is queued and never block
+        fifo_notify_clear();
+
+        while ((buf = fifo_dequeue(0)) != NULL) {
             // Process one buffer
             uint16_t *mag = buf->data;
             uint32_t mlen = buf->validLength - buf->overlap;
@@ -201,7 +201,7 @@ class uCDB
     void zero();
 };
 
-#define CDB_DESCRIPTOR_SIZE 2 * (sizeof (unsigned long))
+#define CDB_DESCRIPTOR_SIZE 8 // Two 32-bit words, also where unsigned long is 64-bit
 #define CDB_HEADER_SIZE 256 * CDB_DESCRIPTOR_SIZE
 #define CDB_BUFF_SIZE 64
 
@@ -484,7 +484,7 @@ unsigned long DJBHash(const void *key, unsigned long keyLen) {
     ++curr;
   }
 
-  return h;
+  return h & 0xFFFFFFFFUL;
 }
 #undef DJB_START_HASH
 
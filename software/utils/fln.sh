@@ -23,6 +23,7 @@ FILENAME=fln
 GAWK=gawk/$FILENAME.gawk
 SQL=sql/$FILENAME.sql
 PTN=python/$FILENAME.py
+ADB=python/adb.py
 
 CSV=$FILENAME.csv
 DB=$FILENAME.db
@@ -37,4 +38,5 @@ sqlite3 -init $SQL $DB .exit
 rm -f $CSV $RAW
 $FLNJSON | grep registration | jq -r '[._id,.type,.registration,.tail | tostring] | @csv' | gawk -v id_type=hex -f $GAWK > $CSV
 python2 $PTN
+python3 $ADB $CSV $FILENAME.adb --key 0 --mam 1 --reg 2 --cn 3
 rm -f $CSV $RAW
@@ -23,6 +23,7 @@ FILENAME=ogn
 GAWK=gawk/$FILENAME.gawk
 SQL=sql/$FILENAME.sql
 PTN=python/$FILENAME.py
+ADB=python/adb.py
 
 RAW=$FILENAME.raw
 CSV=$FILENAME.csv
@@ -39,4 +40,5 @@ rm -f $CSV
 # wget -q -O - $URL > $CSV
 cat $RAW | gawk -v id_type=hex -f $GAWK > $CSV
 python2 $PTN
+python3 $ADB $CSV $FILENAME.adb --key 1 --mam 2 --reg 3 --cn 4
 rm -f $CSV $RAW
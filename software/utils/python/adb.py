@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+
+'''
+    Creates aircrafts binary DataBase (ADB) from a CSV data file.
+
+    Records are sorted by 24-bit address and have fixed width fields,
+    preceded by a block index that firmware keeps in RAM.
+    See SoftRF/src/system/ADB.h for the format description.
+
+    Usage:
+      adb.py ogn.csv ogn.adb --key 1 --mam 2 --reg 3 --cn 4
+      adb.py fln.csv fln.adb --key 0 --mam 1 --reg 2 --cn 3
+
+    Field widths are those of the longest value in the input, so that
+    nothing is cut, unless given with --mam-len, --reg-len or --cn-len.
+    Block index of firmware holds up to 512 entries, that limits
+    the database to about 27000 records of the OGN DDB.
+'''
+
+import argparse
+import csv
+import struct
+import sys
+
+ADB_MAGIC       = 0x42444153  # "SADB"
+ADB_VERSION     = 1
+ADB_INDEX_MAX   = 512
+ADB_BLOCK_BYTES = 2048
+ADB_BLOCK_MIN   = 16
+ADB_FIELD_MAX   = 32
+
+def value(row, col):
+    if col is None or col >= len(row):
+        return b''
+    return row[col].strip().encode('latin-1', 'replace')
+
+def field(s, width):
+    s = s[:width]
+    return s + b'\0' * (width - len(s))
+
+def adbmake(f, records, mam_len, reg_len, cn_len):
+    rec_size = 3 + mam_len + reg_len + cn_len
+    count = len(records)
+
+    block = ADB_BLOCK_MIN
+    while (count + block - 1) // block > ADB_INDEX_MAX:
+        block += 1
+    if block * rec_size > ADB_BLOCK_BYTES:
+        sys.exit("too many records (%d) for the block index" % count)
+
+    fp = open(f, "wb")
+    fp.write(struct.pack('<LBBBBLHH', ADB_MAGIC, ADB_VERSION,
+                         mam_len, reg_len, cn_len, count, block, 0))
+
+    for i in range(0, count, block):
+        fp.write(struct.pack('<L', records[i][0])[:3])
+
+    for (addr, data) in records:
+        fp.write(struct.pack('<L', addr)[:3])
+        fp.write(data)
+    fp.close()
+
+    return block
+
+if __name__ == "__main__":
+    ap = argparse.ArgumentParser()
+    ap.add_argument('input')
+    ap.add_argument('output')
+    ap.add_argument('--key', type = int, default = 0)
+    ap.add_argument('--mam', type = int)
+    ap.add_argument('--reg', type = int)
+    ap.add_argument('--cn',  type = int)
+    ap.add_argument('--int', action = 'store_true', help = 'decimal keys')
+    ap.add_argument('--mam-len', type = int)
+    ap.add_argument('--reg-len', type = int)
+    ap.add_argument('--cn-len',  type = int)
+    args = ap.parse_args()
+
+    air = {}
+    with open(args.input, encoding = 'latin-1') as csv_file:
+        csv_reader = csv.reader(csv_file, delimiter = ',')
+
+        for row in csv_reader:
+            try:
+                addr = int(row[args.key], 10 if args.int else 16)
+            except (ValueError, IndexError):
+                continue
+            if addr > 0xFFFFFF:
+                continue
+
+            air[addr] = (value(row, args.mam), value(row, args.reg),
+                         value(row, args.cn))
+
+    widths = [max([len(v[i]) for v in air.values()] + [0]) for i in range(3)]
+    for i, w in enumerate([args.mam_len, args.reg_len, args.cn_len]):
+        if w is not None:
+            widths[i] = w
+    if max(widths) > ADB_FIELD_MAX:
+        sys.exit("field width %d is over the limit of %d" %
+                 (max(widths), ADB_FIELD_MAX))
+
+    records = [(addr, b''.join(field(v[i], widths[i]) for i in range(3)))
+               for (addr, v) in sorted(air.items())]
+    block = adbmake(args.output, records, *widths)
+
+    print("%s: %d records, %d per block" % (args.output, len(records), block))